@@ -0,0 +1,43 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef BENCHMARKCHECK_H
+#define BENCHMARKCHECK_H
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+/**
+ * 输入/bench运行的测试(*Benchmark.cpp)共用的计时和检查
+ * 每组测试以beginChecks开始(打印标题, 清零失败数), 中间用check逐项打印PASS/FAIL, 最后endChecks打印结果
+ */
+namespace benchmark {
+    using Clock = std::chrono::steady_clock;
+
+    inline double elapsedMs(const Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 当前这组测试中失败的检查数
+    inline int failures = 0;
+
+    inline void check(const bool condition, const std::string& name) {
+        if (!condition) {
+            failures++;
+        }
+        std::cout << "  " << (condition ? "PASS " : "FAIL ") << name << std::endl;
+    }
+
+    inline void beginChecks(const std::string& name) {
+        std::cout << "[" << name << "]" << std::endl;
+        failures = 0;
+    }
+
+    inline void endChecks() {
+        std::cout << (failures == 0 ? "  all checks passed" : "  " + std::to_string(failures) + " checks FAILED") << std::endl;
+    }
+}
+
+#endif //BENCHMARKCHECK_H
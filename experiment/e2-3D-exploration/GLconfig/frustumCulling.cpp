@@ -0,0 +1,231 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <bit>
+#include <cfloat>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FRUSTUM_CULLING_SSE
+#endif
+
+#include "frustumCulling.h"
+
+// ===============================================================
+// ===视锥体=======================================================
+// ===============================================================
+
+Frustum Frustum::fromMatrix(const glm::mat4& viewProjection) {
+    // glm是列主序, m[列][行]. 取出矩阵的四行
+    const glm::mat4& m = viewProjection;
+    const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    // 裁剪空间中可见的条件为-w <= x, y, z <= w, 每个不等式对应一个平面
+    Frustum frustum{};
+    frustum.planes[LEFT_PLANE] = row3 + row0;
+    frustum.planes[RIGHT_PLANE] = row3 - row0;
+    frustum.planes[BOTTOM_PLANE] = row3 + row1;
+    frustum.planes[TOP_PLANE] = row3 - row1;
+    frustum.planes[NEAR_PLANE] = row3 + row2;
+    frustum.planes[FAR_PLANE] = row3 - row2;
+    // 归一化后平面方程的值才是真正的距离, 才能和半径比较
+    for (auto& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+bool Frustum::isVisible(const BoundingSphere& sphere) const {
+    for (const auto& plane : planes) {
+        if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Frustum::isVisible(const BoundingBox& box) const {
+    return isVisible(BoundingSphere{(box.min + box.max) * 0.5f, glm::length(box.max - box.min) * 0.5f});
+}
+
+// ===============================================================
+// ===SoA包围球====================================================
+// ===============================================================
+
+void SphereSoA::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+    count = 0;
+}
+
+void SphereSoA::reserve(const size_t capacity) {
+    const size_t padded = (capacity + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT;
+    x.reserve(padded);
+    y.reserve(padded);
+    z.reserve(padded);
+    radius.reserve(padded);
+}
+
+uint32_t SphereSoA::push(const BoundingSphere& sphere) {
+    // 补齐的部分用完了, 再追加一组补齐的包围球
+    if (count == x.size()) {
+        x.resize(x.size() + LANE_COUNT, 0.0f);
+        y.resize(y.size() + LANE_COUNT, 0.0f);
+        z.resize(z.size() + LANE_COUNT, 0.0f);
+        radius.resize(radius.size() + LANE_COUNT, -FLT_MAX);
+    }
+    const auto index = static_cast<uint32_t>(count++);
+    set(index, sphere);
+    return index;
+}
+
+void SphereSoA::set(const uint32_t index, const BoundingSphere& sphere) {
+    x[index] = sphere.center.x;
+    y[index] = sphere.center.y;
+    z[index] = sphere.center.z;
+    radius[index] = sphere.radius;
+}
+
+// ===============================================================
+// ===剔除=========================================================
+// ===============================================================
+
+FrustumCuller::FrustumCuller() : path(getBestPath()) {
+}
+
+void FrustumCuller::setPath(const CullingPath path) {
+    // 不支持的路径退回到最快的可用路径
+    this->path = isPathSupported(path) ? path : getBestPath();
+}
+
+CullingPath FrustumCuller::getBestPath() {
+    if (isPathSupported(CullingPath::AVX2)) {
+        return CullingPath::AVX2;
+    }
+    if (isPathSupported(CullingPath::SSE)) {
+        return CullingPath::SSE;
+    }
+    return CullingPath::Scalar;
+}
+
+bool FrustumCuller::isPathSupported(const CullingPath path) {
+    switch (path) {
+        case CullingPath::Scalar:
+            return true;
+        case CullingPath::SSE:
+#ifdef FRUSTUM_CULLING_SSE
+            return true;
+#else
+            return false;
+#endif
+        case CullingPath::AVX2:
+            // 编译时开启了AVX2内核, 并且运行的CPU支持AVX2
+#if defined(FRUSTUM_CULLING_AVX2) && (defined(__GNUC__) || defined(__clang__))
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* FrustumCuller::getPathName(const CullingPath path) {
+    switch (path) {
+        case CullingPath::Scalar: return "scalar";
+        case CullingPath::SSE: return "sse";
+        case CullingPath::AVX2: return "avx2";
+    }
+    return "unknown";
+}
+
+size_t FrustumCuller::cull(const Frustum& frustum) {
+    cull(frustum, spheres, visible);
+    return visible.size();
+}
+
+size_t FrustumCuller::cull(const Frustum& frustum, const SphereSoA& input, std::vector<uint32_t>& visible) const {
+    visible.resize(input.paddedSize());
+    size_t visibleCount = 0;
+    switch (path) {
+        case CullingPath::Scalar:
+            visibleCount = cullScalar(frustum, input, visible.data());
+            break;
+        case CullingPath::SSE:
+            visibleCount = cullSSE(frustum, input, visible.data());
+            break;
+        case CullingPath::AVX2:
+            visibleCount = cullAVX2(frustum, input, visible.data());
+            break;
+    }
+    visible.resize(visibleCount);
+    return visibleCount;
+}
+
+size_t FrustumCuller::cullScalar(const Frustum& frustum, const SphereSoA& input, uint32_t* out) {
+    size_t visibleCount = 0;
+    const size_t count = input.paddedSize();
+    for (size_t i = 0; i < count; i++) {
+        const float negRadius = -input.radius[i];
+        bool inside = true;
+        for (const auto& plane : frustum.planes) {
+            // 与SIMD路径保持相同的运算顺序
+            float distance = plane.x * input.x[i];
+            distance = distance + plane.y * input.y[i];
+            distance = distance + plane.z * input.z[i];
+            distance = distance + plane.w;
+            if (!(distance >= negRadius)) {
+                inside = false;
+                break;
+            }
+        }
+        if (inside) {
+            out[visibleCount++] = static_cast<uint32_t>(i);
+        }
+    }
+    return visibleCount;
+}
+
+size_t FrustumCuller::cullSSE(const Frustum& frustum, const SphereSoA& input, uint32_t* out) {
+#ifdef FRUSTUM_CULLING_SSE
+    // 平面系数提前广播到4个通道
+    __m128 planes[Frustum::PLANE_COUNT][4];
+    for (int p = 0; p < Frustum::PLANE_COUNT; p++) {
+        for (int c = 0; c < 4; c++) {
+            planes[p][c] = _mm_set1_ps(frustum.planes[p][c]);
+        }
+    }
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+
+    size_t visibleCount = 0;
+    const size_t count = input.paddedSize();
+    for (size_t i = 0; i < count; i += 4) {
+        const __m128 x = _mm_loadu_ps(&input.x[i]);
+        const __m128 y = _mm_loadu_ps(&input.y[i]);
+        const __m128 z = _mm_loadu_ps(&input.z[i]);
+        const __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(&input.radius[i]), signMask);
+
+        int mask = 0xF;
+        for (int p = 0; p < Frustum::PLANE_COUNT && mask; p++) {
+            __m128 distance = _mm_mul_ps(planes[p][0], x);
+            distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][1], y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(planes[p][2], z));
+            distance = _mm_add_ps(distance, planes[p][3]);
+            mask &= _mm_movemask_ps(_mm_cmpge_ps(distance, negRadius));
+        }
+        // 按位写出可见下标, 顺序与标量路径一致
+        while (mask) {
+            out[visibleCount++] = static_cast<uint32_t>(i + std::countr_zero(static_cast<unsigned>(mask)));
+            mask &= mask - 1;
+        }
+    }
+    return visibleCount;
+#else
+    return cullScalar(frustum, input, out);
+#endif
+}
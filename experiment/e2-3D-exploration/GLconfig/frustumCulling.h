@@ -0,0 +1,112 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef FRUSTUMCULLING_H
+#define FRUSTUMCULLING_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+#include "geometry.h"
+
+/**
+ * 视锥体. 六个平面(ax + by + cz + d = 0)的法线都指向视锥内部, 并且已经归一化
+ * 点到平面的有符号距离为dot(normal, p) + d, 包围球在某个平面外侧(距离 < -radius)即被剔除
+ */
+struct Frustum {
+    // 不用NEAR/FAR这样的名字, Windows头文件中有同名的宏
+    enum Plane { LEFT_PLANE = 0, RIGHT_PLANE, BOTTOM_PLANE, TOP_PLANE, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+    glm::vec4 planes[PLANE_COUNT];
+
+    // 从投影矩阵 * 视图矩阵中提取六个平面(Gribb-Hartmann方法)
+    static Frustum fromMatrix(const glm::mat4& viewProjection);
+
+    // 单个包围球的检测(标量)
+    bool isVisible(const BoundingSphere& sphere) const;
+    // AABB用外接球近似检测
+    bool isVisible(const BoundingBox& box) const;
+};
+
+/**
+ * 结构体数组(SoA)形式存放的包围球. x, y, z, radius分别连续存放, SIMD一次可以读取多个包围球的同一分量
+ * 数组长度总是补齐到LANE_COUNT的整数倍, 补齐的包围球半径为-FLT_MAX, 永远会被剔除, 内核不用处理尾部
+ */
+struct SphereSoA {
+    // 最宽的SIMD路径(AVX2)一次处理8个包围球
+    static constexpr size_t LANE_COUNT = 8;
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> radius;
+
+    void clear();
+    void reserve(size_t capacity);
+    // 加入一个包围球, 返回其下标
+    uint32_t push(const BoundingSphere& sphere);
+    void set(uint32_t index, const BoundingSphere& sphere);
+
+    size_t size() const { return count; }
+    // 补齐后的长度, 内核按这个长度遍历
+    size_t paddedSize() const { return x.size(); }
+
+private:
+    size_t count{0};
+};
+
+// 剔除使用的指令集
+enum class CullingPath {
+    Scalar,
+    SSE,  // 一次4个
+    AVX2, // 一次8个
+};
+
+/**
+ * 视锥剔除
+ * 三条路径的运算顺序完全相同(先乘后加, 不使用FMA), 对同样的输入得到完全相同的结果
+ * 输出为可见包围球的下标, 按下标升序排列
+ *
+ * AVX2内核单独放在frustumCullingAVX2.cpp中以-mavx2编译, 运行时检测CPU支持后才会使用
+ */
+class FrustumCuller {
+public:
+    // 默认使用当前CPU支持的最快路径
+    FrustumCuller();
+
+    void setPath(CullingPath path);
+    CullingPath getPath() const { return path; }
+    // 当前CPU与编译选项下可用的最快路径
+    static CullingPath getBestPath();
+    static bool isPathSupported(CullingPath path);
+    static const char* getPathName(CullingPath path);
+
+    // 包围球数据
+    void clear() { spheres.clear(); }
+    uint32_t add(const BoundingSphere& sphere) { return spheres.push(sphere); }
+    void set(const uint32_t index, const BoundingSphere& sphere) { spheres.set(index, sphere); }
+    const SphereSoA& getSpheres() const { return spheres; }
+
+    // 执行剔除, 返回可见数量. 结果通过getVisible获取
+    size_t cull(const Frustum& frustum);
+    // 不使用内部数据的版本, 方便对同一组数据比较不同路径
+    size_t cull(const Frustum& frustum, const SphereSoA& input, std::vector<uint32_t>& visible) const;
+
+    const std::vector<uint32_t>& getVisible() const { return visible; }
+    size_t getTestedCount() const { return spheres.size(); }
+    size_t getCulledCount() const { return spheres.size() - visible.size(); }
+
+    // 各路径的内核. out至少要有input.paddedSize()个元素, 返回写入的数量
+    static size_t cullScalar(const Frustum& frustum, const SphereSoA& input, uint32_t* out);
+    static size_t cullSSE(const Frustum& frustum, const SphereSoA& input, uint32_t* out);
+    static size_t cullAVX2(const Frustum& frustum, const SphereSoA& input, uint32_t* out);
+
+private:
+    CullingPath path;
+    SphereSoA spheres;
+    std::vector<uint32_t> visible;
+};
+
+#endif //FRUSTUMCULLING_H
@@ -0,0 +1,52 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+// 这个文件在CMakeLists.txt中单独以-mavx2编译. 其它文件不开启AVX2, 程序在不支持AVX2的CPU上也能运行
+// 未开启AVX2编译时退回SSE路径, FrustumCuller::isPathSupported也会返回false
+
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "frustumCulling.h"
+
+size_t FrustumCuller::cullAVX2(const Frustum& frustum, const SphereSoA& input, uint32_t* out) {
+#if defined(__AVX2__)
+    __m256 planes[Frustum::PLANE_COUNT][4];
+    for (int p = 0; p < Frustum::PLANE_COUNT; p++) {
+        for (int c = 0; c < 4; c++) {
+            planes[p][c] = _mm256_set1_ps(frustum.planes[p][c]);
+        }
+    }
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    size_t visibleCount = 0;
+    const size_t count = input.paddedSize();
+    for (size_t i = 0; i < count; i += SphereSoA::LANE_COUNT) {
+        const __m256 x = _mm256_loadu_ps(&input.x[i]);
+        const __m256 y = _mm256_loadu_ps(&input.y[i]);
+        const __m256 z = _mm256_loadu_ps(&input.z[i]);
+        const __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(&input.radius[i]), signMask);
+
+        int mask = 0xFF;
+        for (int p = 0; p < Frustum::PLANE_COUNT && mask; p++) {
+            // 不使用FMA, 与标量路径的舍入完全一致
+            __m256 distance = _mm256_mul_ps(planes[p][0], x);
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(planes[p][1], y));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(planes[p][2], z));
+            distance = _mm256_add_ps(distance, planes[p][3]);
+            mask &= _mm256_movemask_ps(_mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+        }
+        while (mask) {
+            out[visibleCount++] = static_cast<uint32_t>(i + std::countr_zero(static_cast<unsigned>(mask)));
+            mask &= mask - 1;
+        }
+    }
+    return visibleCount;
+#else
+    return cullSSE(frustum, input, out);
+#endif
+}
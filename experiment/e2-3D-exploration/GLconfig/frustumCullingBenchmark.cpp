@@ -0,0 +1,68 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "frustumCullingBenchmark.h"
+#include "frustumCulling.h"
+
+namespace {
+    // 每条路径重复剔除的次数, 取平均值
+    constexpr int REPEAT_COUNT = 20;
+
+    using Clock = std::chrono::steady_clock;
+}
+
+void benchmarkFrustumCulling(const int count) {
+    // 与游戏中相同的透视相机, 位于迷宫一角看向迷宫内部
+    const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.5f, 0.0f), glm::vec3(1.0f, 0.5f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    const Frustum frustum = Frustum::fromMatrix(projection * view);
+
+    // 包围球分布在相机四周的正方形区域内, 大部分在视锥外
+    const float extent = 2.0f * std::sqrt((float)count);
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-extent, extent);
+    std::uniform_real_distribution<float> radius(0.5f, 1.0f);
+    SphereSoA spheres;
+    spheres.reserve(count);
+    for (int i = 0; i < count; i++) {
+        spheres.push({glm::vec3(position(random), 0.5f, position(random)), radius(random)});
+    }
+
+    std::cout << "[frustum culling] " << count << " spheres" << std::endl;
+    FrustumCuller culler;
+    std::vector<uint32_t> reference;
+    for (const CullingPath path : {CullingPath::Scalar, CullingPath::SSE, CullingPath::AVX2}) {
+        if (!FrustumCuller::isPathSupported(path)) {
+            std::cout << "  " << FrustumCuller::getPathName(path) << ": not supported" << std::endl;
+            continue;
+        }
+        culler.setPath(path);
+        std::vector<uint32_t> visible;
+        const auto start = Clock::now();
+        for (int i = 0; i < REPEAT_COUNT; i++) {
+            culler.cull(frustum, spheres, visible);
+        }
+        const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / REPEAT_COUNT;
+
+        // 标量路径作为参照, 其它路径的结果必须完全相同
+        if (path == CullingPath::Scalar) {
+            reference = visible;
+        }
+        std::cout << "  " << FrustumCuller::getPathName(path) << ": " << us << " us, "
+                  << count / us << " tested/us, " << (count - visible.size()) / us << " culled/us, visible " << visible.size()
+                  << (visible == reference ? "" : " (MISMATCH)") << std::endl;
+    }
+}
+
+void runFrustumCullingBenchmarks() {
+    for (const int count : {10000, 100000, 1000000}) {
+        benchmarkFrustumCulling(count);
+    }
+}
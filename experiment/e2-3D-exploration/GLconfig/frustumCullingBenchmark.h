@@ -0,0 +1,19 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef FRUSTUMCULLINGBENCHMARK_H
+#define FRUSTUMCULLINGBENCHMARK_H
+
+/**
+ * 视锥剔除的性能对比, 在命令行中输入/bench运行
+ * 不需要OpenGL上下文
+ */
+
+// 在相机周围随机摆放count个包围球, 分别用标量/SSE/AVX2路径剔除, 输出每微秒检测/剔除的包围球数量, 并检查各路径结果是否一致
+void benchmarkFrustumCulling(int count);
+
+// 依次运行10k, 100k, 1M三个规模
+void runFrustumCullingBenchmarks();
+
+#endif //FRUSTUMCULLINGBENCHMARK_H
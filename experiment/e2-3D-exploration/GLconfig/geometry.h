@@ -5,9 +5,15 @@
 #ifndef GEOMETRY_H
 #define GEOMETRY_H
 
+#include <memory>
+#include <vector>
+
 #include "core.h"
 #include "TextureMipMap.h"
 
+// 共享的网格缓冲, 定义在geometryPool.h中
+class MeshBuffers;
+
 // 包围球
 struct BoundingSphere {
     glm::vec3 center{0.0f}; // 中心点
@@ -59,6 +65,16 @@ inline bool isCollide(const BoundingBox& a, const BoundingBox& b, glm::vec3& nor
     return true;
 }
 
+// CPU端保留的一份几何体顶点数据(模型空间), 供静态合批等需要在CPU上处理顶点的功能使用
+struct GeometryData {
+    std::vector<float> positions; // 每3个float一个顶点
+    std::vector<float> colors; // 每3个float一个顶点
+    std::vector<float> uvs; // 每2个float一个顶点
+    std::vector<GLuint> indices;
+
+    size_t getVertexCount() const { return positions.size() / 3; }
+};
+
 class Geometry {
 public:
     Geometry();
@@ -81,6 +97,13 @@ public:
 
     // 准备渲染
     void bind() const;
+    // 只绑定纹理, 不绑定VAO(静态合批后的网格有自己的VAO)
+    void bindTexture() const;
+
+    // CPU端的顶点数据
+    const GeometryData& getData() const;
+    // 共享的网格缓冲(几何体只保存VAO和纹理, 顶点数据来自GeometryPool)
+    const std::shared_ptr<MeshBuffers>& getMesh() const { return mesh; }
 
     // 获取几何体(模型空间)的中心位置
     static glm::vec3 getModelCenter() {
@@ -93,7 +116,11 @@ public:
         return glm::identity<glm::mat4>();
     }
 
+    // 用已有的网格缓冲创建几何体(只创建VAO). 例如GEOMETRY_POOL->acquire(MeshSource)按内容获取的网格
+    static Geometry* create(std::shared_ptr<MeshBuffers> mesh);
+
     // 创建几何体. 📌📌记得几何体中心都默认在世界坐标系原点
+    // 参数相同的几何体共享同一份顶点缓冲, 只有纹理不同
     // 创建长方体
     // 长宽高分别对应X, Z, Y轴. 因为相机视线方向是逆Z轴
     static Geometry* createBox(float length, float width, float height);
@@ -106,14 +133,11 @@ public:
     static Geometry* createPlane(float length, float width, float segments = 1.0f);
 
 private:
-    // VBO, VAO以及EBO成员
+    // VAO属于几何体自己, VBO和EBO在共享的网格缓冲中
     GLuint VAO{0};
-    GLuint VBOPosition{0};
-    GLuint VBOColor{0};
-    GLuint VBOUv{0};
-    GLuint EBO{0};
+    std::shared_ptr<MeshBuffers> mesh;
 
-    TextureMipMap* texture{nullptr}; // 纹理对象
+    std::shared_ptr<TextureMipMap> texture; // 纹理对象. 相同路径的纹理由GeometryPool共享
     GLenum primitiveType{GL_TRIANGLES}; // 绘制时的图元类型(三角形, 线框等)
 
     // 需要绘制的EBO索引数量(注意: 不是顶点数量)
@@ -159,6 +183,8 @@ public:
 
     // 是否检测碰撞
     bool detectCollision = true;
+    // 是否为静态物体(创建后不再移动). 静态物体会被合并进静态批次一起绘制, 不再单独提交
+    bool isStatic = false;
 
     // 需要每一帧更新的行为, 目前仅支持应用updateMatrix
     void update();
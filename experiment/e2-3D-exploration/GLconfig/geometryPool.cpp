@@ -0,0 +1,166 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <bit>
+#include <sstream>
+
+#include "geometryPool.h"
+
+// ===============================================================
+// ===网格缓冲=====================================================
+// ===============================================================
+
+MeshBuffers::MeshBuffers(std::string key, MeshSource source) : key(std::move(key)), source(std::move(source)) {
+    const GeometryData& data = this->source.data;
+    // 创建VBO
+    glGenBuffers(1, &VBOPosition);
+    glBindBuffer(GL_ARRAY_BUFFER, VBOPosition);
+    glBufferData(GL_ARRAY_BUFFER, data.positions.size() * sizeof(float), data.positions.data(), GL_STATIC_DRAW);
+    glGenBuffers(1, &VBOColor);
+    glBindBuffer(GL_ARRAY_BUFFER, VBOColor);
+    glBufferData(GL_ARRAY_BUFFER, data.colors.size() * sizeof(float), data.colors.data(), GL_STATIC_DRAW);
+    glGenBuffers(1, &VBOUv);
+    glBindBuffer(GL_ARRAY_BUFFER, VBOUv);
+    glBufferData(GL_ARRAY_BUFFER, data.uvs.size() * sizeof(float), data.uvs.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // 创建EBO. 先解绑VAO, 以免EBO被绑定到别人的VAO上
+    glBindVertexArray(0);
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.indices.size() * sizeof(GLuint), data.indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    bytes = (data.positions.size() + data.colors.size() + data.uvs.size()) * sizeof(float) +
+            data.indices.size() * sizeof(GLuint);
+    GeometryPool::stats.buffers += 4;
+    GeometryPool::stats.bufferBytes += bytes;
+}
+
+MeshBuffers::~MeshBuffers() {
+    const GLuint buffers[] = {VBOPosition, VBOColor, VBOUv, EBO};
+    glDeleteBuffers(4, buffers);
+    GeometryPool::stats.buffers -= 4;
+    GeometryPool::stats.bufferBytes -= bytes;
+}
+
+void MeshBuffers::bindAttributes() const {
+    glBindBuffer(GL_ARRAY_BUFFER, VBOPosition);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, VBOColor);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, VBOUv);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+}
+
+// ===============================================================
+// ===几何体池=====================================================
+// ===============================================================
+
+GeometryPool* GeometryPool::getInstance() {
+    static GeometryPool instance;
+    return &instance;
+}
+
+std::shared_ptr<MeshBuffers> GeometryPool::acquire(const std::string& key, const std::function<MeshSource()>& generator) {
+    if (const auto it = meshes.find(key); it != meshes.end()) {
+        if (auto mesh = it->second.lock()) {
+            stats.meshHits++;
+            return mesh;
+        }
+    }
+    stats.meshMisses++;
+    auto mesh = std::make_shared<MeshBuffers>(key, generator());
+    meshes[key] = mesh;
+    return mesh;
+}
+
+std::shared_ptr<MeshBuffers> GeometryPool::acquire(MeshSource source) {
+    std::ostringstream stream;
+    stream << "content:" << std::hex << hashContent(source.data);
+    const std::string key = stream.str();
+    if (const auto it = meshes.find(key); it != meshes.end()) {
+        if (auto mesh = it->second.lock()) {
+            // 哈希相同时再逐个比较, 真的发生碰撞就不共享
+            const GeometryData& a = mesh->getData();
+            const GeometryData& b = source.data;
+            if (a.positions == b.positions && a.colors == b.colors && a.uvs == b.uvs && a.indices == b.indices) {
+                stats.meshHits++;
+                return mesh;
+            }
+            stats.meshMisses++;
+            return std::make_shared<MeshBuffers>(key, std::move(source));
+        }
+    }
+    stats.meshMisses++;
+    auto mesh = std::make_shared<MeshBuffers>(key, std::move(source));
+    meshes[key] = mesh;
+    return mesh;
+}
+
+std::shared_ptr<TextureMipMap> GeometryPool::acquireTexture(const std::string& path) {
+    if (const auto it = textures.find(path); it != textures.end()) {
+        if (auto texture = it->second.lock()) {
+            stats.textureHits++;
+            return texture;
+        }
+    }
+    stats.textureMisses++;
+    stats.textures++;
+    // 最后一个引用释放时删除纹理对象
+    std::shared_ptr<TextureMipMap> texture(new TextureMipMap(path, 0), [](const TextureMipMap* t) {
+        delete t;
+        stats.textures--;
+    });
+    textures[path] = texture;
+    return texture;
+}
+
+std::string GeometryPool::makeKey(const char* type, const std::initializer_list<float> params) {
+    std::ostringstream stream;
+    stream << type << std::hex;
+    for (const float param : params) {
+        stream << ':' << std::bit_cast<uint32_t>(param);
+    }
+    return stream.str();
+}
+
+uint64_t GeometryPool::hashContent(const GeometryData& data) {
+    uint64_t hash = 14695981039346656037ull;
+    const auto feed = [&hash](const void* bytes, const size_t size) {
+        const auto* p = static_cast<const unsigned char*>(bytes);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ p[i]) * 1099511628211ull;
+        }
+    };
+    // 长度也参与哈希, 避免不同数组之间的边界被混淆
+    for (const auto* array : {&data.positions, &data.colors, &data.uvs}) {
+        const size_t size = array->size();
+        feed(&size, sizeof(size));
+        feed(array->data(), size * sizeof(float));
+    }
+    const size_t indexCount = data.indices.size();
+    feed(&indexCount, sizeof(indexCount));
+    feed(data.indices.data(), indexCount * sizeof(GLuint));
+    return hash;
+}
+
+size_t GeometryPool::getMeshCount() const {
+    size_t count = 0;
+    for (const auto& [key, mesh] : meshes) {
+        count += !mesh.expired();
+    }
+    return count;
+}
+
+size_t GeometryPool::getTextureCount() const {
+    size_t count = 0;
+    for (const auto& [path, texture] : textures) {
+        count += !texture.expired();
+    }
+    return count;
+}
@@ -0,0 +1,112 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef GEOMETRYPOOL_H
+#define GEOMETRYPOOL_H
+
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "core.h"
+#include "geometry.h"
+#include "TextureMipMap.h"
+
+// 获取几何体池的全局唯一实例
+#define GEOMETRY_POOL GeometryPool::getInstance()
+
+// 生成网格所需的全部数据: 顶点/索引 + 模型空间的包围体
+struct MeshSource {
+    GeometryData data;
+    BoundingSphere boundingSphere;
+    BoundingBox boundingBox;
+};
+
+// GL对象与显存占用的统计, 创建和删除时实时更新
+struct GeometryStats {
+    uint32_t buffers{0}; // VBO + EBO
+    uint32_t vertexArrays{0};
+    uint32_t textures{0};
+    size_t bufferBytes{0};
+    // 池的命中/未命中次数
+    uint32_t meshHits{0};
+    uint32_t meshMisses{0};
+    uint32_t textureHits{0};
+    uint32_t textureMisses{0};
+};
+
+/**
+ * 网格数据: GPU上的VBO/EBO以及CPU端副本
+ * 只包含顶点数据, 不包含纹理. 由GeometryPool创建并在多个Geometry之间共享, 最后一个引用释放时删除GL缓冲
+ * 每个Geometry仍有自己的VAO(实例化渲染会往VAO上挂各自的实例属性), VAO引用这里的缓冲
+ */
+class MeshBuffers {
+public:
+    MeshBuffers(std::string key, MeshSource source);
+    ~MeshBuffers();
+    MeshBuffers(const MeshBuffers&) = delete;
+    MeshBuffers& operator=(const MeshBuffers&) = delete;
+
+    const std::string& getKey() const { return key; }
+    const GeometryData& getData() const { return source.data; }
+    const BoundingSphere& getBoundingSphere() const { return source.boundingSphere; }
+    const BoundingBox& getBoundingBox() const { return source.boundingBox; }
+    uint32_t getIndicesCount() const { return static_cast<uint32_t>(source.data.indices.size()); }
+    size_t getBytes() const { return bytes; }
+
+    // 把缓冲绑定到当前绑定的VAO上(0 -> 位置, 1 -> 颜色, 2 -> uv坐标, 以及EBO)
+    void bindAttributes() const;
+
+private:
+    std::string key;
+    MeshSource source;
+    size_t bytes{0};
+
+    GLuint VBOPosition{0};
+    GLuint VBOColor{0};
+    GLuint VBOUv{0};
+    GLuint EBO{0};
+};
+
+/**
+ * 几何体池(按内容寻址)
+ * 网格按生成参数(如"box"和长宽高)或者顶点内容的哈希作为键, 相同的键返回同一份共享缓冲(引用计数)
+ * 纹理按文件路径共享. 池中只保存弱引用, 没有Geometry使用时资源自动释放
+ */
+class GeometryPool {
+public:
+    static GeometryPool* getInstance();
+
+    // 按生成参数获取网格. 池中没有时调用generator生成并上传
+    std::shared_ptr<MeshBuffers> acquire(const std::string& key, const std::function<MeshSource()>& generator);
+    // 按顶点内容获取网格. 内容完全相同的网格共享同一份缓冲
+    std::shared_ptr<MeshBuffers> acquire(MeshSource source);
+    // 按文件路径获取纹理
+    std::shared_ptr<TextureMipMap> acquireTexture(const std::string& path);
+
+    // 生成参数的键. 浮点数按位存储, 不会因为格式化丢失精度
+    static std::string makeKey(const char* type, std::initializer_list<float> params);
+    // 顶点内容的哈希(FNV-1a)
+    static uint64_t hashContent(const GeometryData& data);
+
+    // 当前存活的网格/纹理数量
+    size_t getMeshCount() const;
+    size_t getTextureCount() const;
+    static const GeometryStats& getStats() { return stats; }
+
+private:
+    GeometryPool() = default;
+
+    friend class MeshBuffers;
+    friend class Geometry;
+    static inline GeometryStats stats;
+
+    std::unordered_map<std::string, std::weak_ptr<MeshBuffers>> meshes;
+    std::unordered_map<std::string, std::weak_ptr<TextureMipMap>> textures;
+};
+
+#endif //GEOMETRYPOOL_H
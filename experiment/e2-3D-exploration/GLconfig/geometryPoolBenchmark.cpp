@@ -0,0 +1,103 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "geometryPoolBenchmark.h"
+#include "benchmarkCheck.h"
+#include "geometryPool.h"
+
+using namespace benchmark;
+
+void checkGeometryPoolSharing() {
+    std::cout << "  sharing:" << std::endl;
+    const GeometryStats before = GeometryPool::getStats();
+    const size_t meshesBefore = GEOMETRY_POOL->getMeshCount();
+
+    // 3个长方体(两个参数相同) + 2个参数相同的球体
+    Geometry* a = Geometry::createBox(1.25f, 0.75f, 0.5f);
+    Geometry* b = Geometry::createBox(1.25f, 0.75f, 0.5f);
+    Geometry* c = Geometry::createBox(0.75f, 1.25f, 0.5f);
+    Geometry* s1 = Geometry::createSphere(0.625f, 12, 24);
+    Geometry* s2 = Geometry::createSphere(0.625f, 12, 24);
+
+    const GeometryStats& stats = GeometryPool::getStats();
+    check(a->getMesh() == b->getMesh() && s1->getMesh() == s2->getMesh() && a->getMesh() != c->getMesh(),
+          "same parameters share one mesh, different parameters do not");
+    check(GEOMETRY_POOL->getMeshCount() - meshesBefore == 3 && stats.meshMisses - before.meshMisses == 3
+          && stats.meshHits - before.meshHits == 2, "5 geometries: 3 meshes, 3 misses, 2 hits");
+    check(stats.buffers - before.buffers == 12 && stats.vertexArrays - before.vertexArrays == 5,
+          "12 buffers (4 per mesh) and 5 VAOs (one per geometry)");
+    check(a->getVAO() != b->getVAO() && a->getIndicesCount() == b->getIndicesCount(), "shared mesh, separate VAOs");
+
+    // 删除一个共享者, 网格仍然存在
+    delete b;
+    check(a->getData().getVertexCount() > 0 && stats.buffers - before.buffers == 12, "mesh survives while another geometry uses it");
+
+    delete a;
+    delete c;
+    delete s1;
+    delete s2;
+    check(GEOMETRY_POOL->getMeshCount() == meshesBefore && stats.buffers == before.buffers
+          && stats.vertexArrays == before.vertexArrays && stats.bufferBytes == before.bufferBytes,
+          "deleting every geometry releases all buffers and VAOs");
+
+    // 池中只有弱引用, 释放后再次创建需要重新上传
+    Geometry* again = Geometry::createBox(1.25f, 0.75f, 0.5f);
+    check(stats.meshMisses - before.meshMisses == 4, "released mesh is uploaded again on next use");
+    delete again;
+}
+
+void checkGeometryPoolContent() {
+    std::cout << "  content:" << std::endl;
+    const GeometryStats before = GeometryPool::getStats();
+    Geometry* box = Geometry::createBox(0.5f, 1.75f, 0.25f);
+
+    MeshSource source;
+    source.data = box->getData();
+    std::shared_ptr<MeshBuffers> first = GEOMETRY_POOL->acquire(source);
+    std::shared_ptr<MeshBuffers> second = GEOMETRY_POOL->acquire(source);
+    check(first == second, "identical content shares one mesh");
+
+    MeshSource changed = source;
+    changed.data.positions[0] += 0.5f;
+    std::shared_ptr<MeshBuffers> third = GEOMETRY_POOL->acquire(changed);
+    check(third != first && GeometryPool::hashContent(changed.data) != GeometryPool::hashContent(source.data),
+          "changing one position gives a different mesh");
+
+    const GeometryStats& stats = GeometryPool::getStats();
+    check(stats.buffers - before.buffers == 12, "box + 2 content meshes: 12 buffers");
+    first.reset();
+    second.reset();
+    third.reset();
+    delete box;
+    check(stats.buffers == before.buffers && stats.vertexArrays == before.vertexArrays, "all released");
+}
+
+void benchmarkGeometryPool(const int count) {
+    std::vector<Geometry*> geometries;
+    geometries.reserve(count);
+    const auto start = Clock::now();
+    for (int i = 0; i < count; i++) {
+        geometries.push_back(Geometry::createBox(0.875f, 0.875f, 0.875f));
+    }
+    const double ms = elapsedMs(start);
+    const GeometryStats& stats = GeometryPool::getStats();
+    std::cout << "  " << count << " identical boxes: " << ms << " ms (" << ms * 1000.0 / count << " us each), "
+              << "buffer bytes " << stats.bufferBytes << std::endl;
+    for (const auto geometry : geometries) {
+        delete geometry;
+    }
+}
+
+void runGeometryPoolBenchmarks() {
+    beginChecks("geometry pool");
+    checkGeometryPoolSharing();
+    checkGeometryPoolContent();
+    benchmarkGeometryPool(1000);
+    endChecks();
+}
@@ -0,0 +1,23 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef GEOMETRYPOOLBENCHMARK_H
+#define GEOMETRYPOOLBENCHMARK_H
+
+/**
+ * 几何体池的测试, 在命令行中输入/bench运行
+ * 会创建真实的VBO/EBO和VAO, 需要OpenGL上下文, 所以由渲染线程在两帧之间执行(见main.cpp的runOnRenderThread)
+ * 使用场景中没有用到的尺寸, 只比较测试前后统计的变化量
+ */
+
+// 参数相同的长方体/球体共享网格缓冲, 每个几何体有自己的VAO; 全部删除后GL对象数量回到原值
+void checkGeometryPoolSharing();
+// 按内容获取: 内容相同的网格共享, 内容不同的不共享
+void checkGeometryPoolContent();
+// count次命中池的createBox的耗时
+void benchmarkGeometryPool(int count);
+
+void runGeometryPoolBenchmarks();
+
+#endif //GEOMETRYPOOLBENCHMARK_H
@@ -0,0 +1,143 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <cstring>
+
+#include "instancedRenderer.h"
+
+// ===============================================================
+// ===OpenGL后端===================================================
+// ===============================================================
+
+GLuint GLRenderBackend::createInstanceBuffer() {
+    GLuint buffer = 0;
+    glGenBuffers(1, &buffer);
+    return buffer;
+}
+
+void GLRenderBackend::deleteInstanceBuffer(GLuint buffer) {
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLRenderBackend::uploadInstanceBuffer(GLuint buffer, const void* data, size_t bytes) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    // 实例数据每帧都会变, 用GL_STREAM_DRAW. 整体重新分配也顺便让驱动丢弃上一帧还在使用的旧缓冲
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), data, GL_STREAM_DRAW);
+}
+
+void GLRenderBackend::attachInstanceBuffer(const Geometry* geometry, GLuint buffer) {
+    glBindVertexArray(geometry->getVAO());
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    // mat4属性要拆成4个vec4属性, 分别占用连续的4个location
+    for (GLuint i = 0; i < 4; i++) {
+        const GLuint location = InstancedRenderer::INSTANCE_MATRIX_LOCATION + i;
+        glEnableVertexAttribArray(location);
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * sizeof(glm::vec4)));
+        // 📌divisor = 1: 每绘制一个实例才前进一次, 而不是每个顶点前进一次
+        glVertexAttribDivisor(location, 1);
+    }
+    glBindVertexArray(0);
+}
+
+void GLRenderBackend::bindGeometry(const Geometry* geometry) {
+    geometry->bind();
+}
+
+void GLRenderBackend::drawElementsInstanced(GLenum mode, GLsizei count, GLsizei instanceCount) {
+    glDrawElementsInstanced(mode, count, GL_UNSIGNED_INT, nullptr, instanceCount);
+}
+
+// ===============================================================
+// ===记录调用的后端================================================
+// ===============================================================
+
+GLuint RecordingRenderBackend::createInstanceBuffer() {
+    return nextBuffer++;
+}
+
+void RecordingRenderBackend::deleteInstanceBuffer(GLuint buffer) {
+    bufferContents.erase(buffer);
+}
+
+void RecordingRenderBackend::uploadInstanceBuffer(GLuint buffer, const void* data, size_t bytes) {
+    auto& content = bufferContents[buffer];
+    content.resize(bytes);
+    if (bytes > 0) {
+        std::memcpy(content.data(), data, bytes);
+    }
+}
+
+void RecordingRenderBackend::attachInstanceBuffer(const Geometry* geometry, GLuint buffer) {
+    attachedBuffers[geometry] = buffer;
+}
+
+void RecordingRenderBackend::bindGeometry(const Geometry* geometry) {
+    boundGeometry = geometry;
+}
+
+void RecordingRenderBackend::drawElementsInstanced(GLenum mode, GLsizei count, GLsizei instanceCount) {
+    drawCalls.push_back({boundGeometry, mode, count, instanceCount});
+}
+
+// ===============================================================
+// ===实例化渲染器==================================================
+// ===============================================================
+
+InstancedRenderer::InstancedRenderer(RenderBackend* backend) : backend(backend) {
+    if (!this->backend) {
+        this->backend = new GLRenderBackend();
+        ownsBackend = true;
+    }
+}
+
+InstancedRenderer::~InstancedRenderer() {
+    for (const auto& batch : batches) {
+        backend->deleteInstanceBuffer(batch.instanceBuffer);
+    }
+    if (ownsBackend) {
+        delete backend;
+    }
+}
+
+void InstancedRenderer::begin() {
+    // 只清空矩阵, 保留批次和实例VBO, 下一帧直接复用
+    for (auto& batch : batches) {
+        batch.matrices.clear();
+    }
+}
+
+void InstancedRenderer::submit(GeometryInstance* instance) {
+    submit(instance->geometry, instance->getModelMatrix());
+}
+
+void InstancedRenderer::submit(const Geometry* geometry, const glm::mat4& modelMatrix) {
+    auto it = batchIndex.find(geometry);
+    if (it == batchIndex.end()) {
+        // 第一次遇到这个几何体, 为它创建实例VBO并挂到VAO上
+        Batch batch;
+        batch.geometry = geometry;
+        batch.instanceBuffer = backend->createInstanceBuffer();
+        backend->attachInstanceBuffer(geometry, batch.instanceBuffer);
+        it = batchIndex.emplace(geometry, batches.size()).first;
+        batches.push_back(std::move(batch));
+    }
+    batches[it->second].matrices.push_back(modelMatrix);
+}
+
+void InstancedRenderer::flush() {
+    drawCallCount = 0;
+    instanceCount = 0;
+    for (const auto& batch : batches) {
+        if (batch.matrices.empty()) {
+            continue;
+        }
+        backend->uploadInstanceBuffer(batch.instanceBuffer, batch.matrices.data(), batch.matrices.size() * sizeof(glm::mat4));
+        backend->bindGeometry(batch.geometry);
+        backend->drawElementsInstanced(batch.geometry->getPrimitiveType(),
+                                       static_cast<GLsizei>(batch.geometry->getIndicesCount()),
+                                       static_cast<GLsizei>(batch.matrices.size()));
+        drawCallCount++;
+        instanceCount += static_cast<uint32_t>(batch.matrices.size());
+    }
+}
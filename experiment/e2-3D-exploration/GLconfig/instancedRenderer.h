@@ -0,0 +1,133 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef INSTANCEDRENDERER_H
+#define INSTANCEDRENDERER_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "core.h"
+#include "geometry.h"
+
+/**
+ * 实例化渲染用到的GL调用的抽象. 渲染器只通过它来访问OpenGL,
+ * 这样不需要GPU也能用RecordingRenderBackend检查draw call数量和缓冲区内容
+ */
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    // 创建/删除存放实例数据(模型矩阵)的VBO
+    virtual GLuint createInstanceBuffer() = 0;
+    virtual void deleteInstanceBuffer(GLuint buffer) = 0;
+    // 上传实例数据. 每帧都会整体覆盖一次
+    virtual void uploadInstanceBuffer(GLuint buffer, const void* data, size_t bytes) = 0;
+    // 把实例VBO作为per-instance属性挂到几何体的VAO上. 每个几何体只需要做一次
+    virtual void attachInstanceBuffer(const Geometry* geometry, GLuint buffer) = 0;
+    // 绑定几何体的VAO和纹理
+    virtual void bindGeometry(const Geometry* geometry) = 0;
+    // 一次绘制instanceCount个实例
+    virtual void drawElementsInstanced(GLenum mode, GLsizei count, GLsizei instanceCount) = 0;
+};
+
+/**
+ * 真正调用OpenGL的后端
+ */
+class GLRenderBackend : public RenderBackend {
+public:
+    GLuint createInstanceBuffer() override;
+    void deleteInstanceBuffer(GLuint buffer) override;
+    void uploadInstanceBuffer(GLuint buffer, const void* data, size_t bytes) override;
+    void attachInstanceBuffer(const Geometry* geometry, GLuint buffer) override;
+    void bindGeometry(const Geometry* geometry) override;
+    void drawElementsInstanced(GLenum mode, GLsizei count, GLsizei instanceCount) override;
+};
+
+/**
+ * 只记录调用而不访问GPU的后端. 用于在没有OpenGL上下文时检查渲染器的行为
+ */
+class RecordingRenderBackend : public RenderBackend {
+public:
+    // 记录下来的一次绘制
+    struct DrawCall {
+        const Geometry* geometry; // 绘制时绑定的几何体
+        GLenum mode;
+        GLsizei count; // 索引数量
+        GLsizei instanceCount; // 实例数量
+    };
+
+    GLuint createInstanceBuffer() override;
+    void deleteInstanceBuffer(GLuint buffer) override;
+    void uploadInstanceBuffer(GLuint buffer, const void* data, size_t bytes) override;
+    void attachInstanceBuffer(const Geometry* geometry, GLuint buffer) override;
+    void bindGeometry(const Geometry* geometry) override;
+    void drawElementsInstanced(GLenum mode, GLsizei count, GLsizei instanceCount) override;
+
+    // 所有的绘制记录
+    std::vector<DrawCall> drawCalls;
+    // 每个实例VBO最后一次上传的内容
+    std::unordered_map<GLuint, std::vector<uint8_t>> bufferContents;
+    // 每个几何体挂上的实例VBO
+    std::unordered_map<const Geometry*, GLuint> attachedBuffers;
+
+    // 清空绘制记录(缓冲区内容保留)
+    void clear() { drawCalls.clear(); }
+private:
+    GLuint nextBuffer{1};
+    const Geometry* boundGeometry{nullptr};
+};
+
+/**
+ * 实例化渲染器
+ * 每帧把几何体实例按共享的Geometry(同时也决定了纹理)分组, 把模型矩阵打包进per-instance属性缓冲,
+ * 然后每组只发出一次glDrawElementsInstanced
+ *
+ * 使用方式: begin() -> submit()每个实例 -> flush()
+ * 着色器需要在location 3~6声明mat4的实例属性(见assets/shader/instanced/vertex.glsl)
+ */
+class InstancedRenderer {
+public:
+    // 实例矩阵属性在着色器中的起始location. mat4占用连续4个location
+    static constexpr GLuint INSTANCE_MATRIX_LOCATION = 3;
+
+    // backend为nullptr时使用GLRenderBackend
+    explicit InstancedRenderer(RenderBackend* backend = nullptr);
+    ~InstancedRenderer();
+
+    // 开始新的一帧, 清空上一帧收集的实例
+    void begin();
+    // 提交一个实例. 使用实例当前的模型矩阵
+    void submit(GeometryInstance* instance);
+    // 直接提交几何体和模型矩阵, 用于模型矩阵不在GeometryInstance中的情况(比如TransformStore)
+    void submit(const Geometry* geometry, const glm::mat4& modelMatrix);
+    // 按组上传实例矩阵并绘制
+    void flush();
+
+    // 上一次flush的统计信息
+    uint32_t getDrawCallCount() const { return drawCallCount; }
+    uint32_t getInstanceCount() const { return instanceCount; }
+    uint32_t getBatchCount() const { return static_cast<uint32_t>(batches.size()); }
+
+private:
+    // 共享同一个几何体的一组实例
+    struct Batch {
+        const Geometry* geometry{nullptr};
+        GLuint instanceBuffer{0};
+        std::vector<glm::mat4> matrices;
+    };
+
+    RenderBackend* backend{nullptr};
+    bool ownsBackend{false};
+
+    // 批次按第一次出现的顺序存放, 保证绘制顺序稳定
+    std::vector<Batch> batches;
+    std::unordered_map<const Geometry*, size_t> batchIndex;
+
+    uint32_t drawCallCount{0};
+    uint32_t instanceCount{0};
+};
+
+#endif //INSTANCEDRENDERER_H
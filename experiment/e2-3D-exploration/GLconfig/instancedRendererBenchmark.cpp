@@ -0,0 +1,164 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "instancedRendererBenchmark.h"
+#include "benchmarkCheck.h"
+#include "instancedRenderer.h"
+
+using namespace benchmark;
+
+namespace {
+    // 实例VBO中最后一次上传的矩阵
+    std::vector<glm::mat4> uploadedMatrices(const RecordingRenderBackend& backend, const GLuint buffer) {
+        const auto it = backend.bufferContents.find(buffer);
+        if (it == backend.bufferContents.end()) {
+            return {};
+        }
+        std::vector<glm::mat4> matrices(it->second.size() / sizeof(glm::mat4));
+        std::memcpy(matrices.data(), it->second.data(), matrices.size() * sizeof(glm::mat4));
+        return matrices;
+    }
+
+    // 几何体的实例按提交顺序上传
+    bool matchesInstances(const std::vector<glm::mat4>& uploaded, const std::vector<GeometryInstance*>& instances,
+                          const Geometry* geometry) {
+        size_t next = 0;
+        for (const auto instance : instances) {
+            if (instance->geometry != geometry) {
+                continue;
+            }
+            if (next >= uploaded.size() || uploaded[next] != instance->getModelMatrix()) {
+                return false;
+            }
+            next++;
+        }
+        return next == uploaded.size();
+    }
+}
+
+void checkInstancedRendererBatching() {
+    std::cout << "  batching:" << std::endl;
+    Geometry box, sphere;
+    sphere.setPrimitiveType(GL_LINES);
+    std::vector<GeometryInstance*> instances;
+    for (int i = 0; i < 1000; i++) {
+        instances.push_back(new GeometryInstance(i % 3 ? &box : &sphere, (float)i, 0.0f, (float)-i));
+    }
+
+    RecordingRenderBackend backend;
+    InstancedRenderer renderer(&backend);
+    renderer.begin();
+    for (const auto instance : instances) {
+        renderer.submit(instance);
+    }
+    renderer.flush();
+
+    check(backend.drawCalls.size() == 2 && renderer.getDrawCallCount() == 2, "1000 instances of 2 geometries: 2 draw calls ("
+          + std::to_string(backend.drawCalls.size()) + ")");
+    // 第一个实例是sphere(0 % 3 == 0), 批次按第一次出现的顺序绘制
+    check(backend.drawCalls.size() == 2 && backend.drawCalls[0].geometry == &sphere && backend.drawCalls[1].geometry == &box,
+          "batches drawn in first-submission order");
+    check(backend.drawCalls.size() == 2 && backend.drawCalls[0].instanceCount == 334 && backend.drawCalls[1].instanceCount == 666
+          && renderer.getInstanceCount() == 1000, "instanceCount per draw: 334 + 666 = 1000");
+    check(backend.drawCalls.size() == 2 && backend.drawCalls[0].mode == GL_LINES && backend.drawCalls[1].mode == GL_TRIANGLES
+          && backend.drawCalls[0].count == (GLsizei)sphere.getIndicesCount(), "draw uses the geometry's primitive type and index count");
+
+    const GLuint sphereBuffer = backend.attachedBuffers[&sphere];
+    const GLuint boxBuffer = backend.attachedBuffers[&box];
+    check(backend.attachedBuffers.size() == 2 && sphereBuffer != boxBuffer, "one instance buffer attached per geometry");
+    check(matchesInstances(uploadedMatrices(backend, sphereBuffer), instances, &sphere)
+          && matchesInstances(uploadedMatrices(backend, boxBuffer), instances, &box),
+          "uploaded instance buffers hold every model matrix in submission order");
+
+    for (const auto instance : instances) {
+        delete instance;
+    }
+}
+
+void checkInstancedRendererFrames() {
+    std::cout << "  frames:" << std::endl;
+    Geometry box;
+    std::vector<GeometryInstance*> instances;
+    for (int i = 0; i < 100; i++) {
+        instances.push_back(new GeometryInstance(&box, (float)i, 0.0f, 0.0f));
+    }
+
+    RecordingRenderBackend backend;
+    InstancedRenderer renderer(&backend);
+    for (int frame = 0; frame < 3; frame++) {
+        renderer.begin();
+        for (const auto instance : instances) {
+            renderer.submit(instance);
+        }
+        renderer.flush();
+        // 每帧移动一个实例, 下一帧上传它的新矩阵
+        instances[frame]->translate(glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    check(backend.drawCalls.size() == 3 && backend.attachedBuffers.size() == 1 && backend.bufferContents.size() == 1,
+          "3 frames: 1 draw call each, instance buffer created once");
+
+    backend.clear();
+    renderer.begin();
+    // 只提交一半的实例
+    for (int i = 0; i < 50; i++) {
+        renderer.submit(instances[i]);
+    }
+    renderer.flush();
+    const std::vector<glm::mat4> uploaded = uploadedMatrices(backend, backend.attachedBuffers[&box]);
+    const std::vector<GeometryInstance*> submitted(instances.begin(), instances.begin() + 50);
+    check(backend.drawCalls.size() == 1 && backend.drawCalls[0].instanceCount == 50 && matchesInstances(uploaded, submitted, &box),
+          "fewer instances next frame: buffer overwritten with 50 current matrices");
+    check(uploaded.size() == 50 && uploaded[0][3].y == 1.0f && uploaded[3][3].y == 0.0f, "moved instances upload their new position");
+
+    // 没有提交实例的几何体不绘制
+    backend.clear();
+    renderer.begin();
+    renderer.flush();
+    check(backend.drawCalls.empty() && renderer.getDrawCallCount() == 0 && renderer.getInstanceCount() == 0,
+          "empty frame issues no draw calls");
+
+    for (const auto instance : instances) {
+        delete instance;
+    }
+}
+
+void benchmarkInstancedRenderer(const int count) {
+    Geometry geometries[8];
+    std::vector<GeometryInstance*> instances;
+    instances.reserve(count);
+    for (int i = 0; i < count; i++) {
+        instances.push_back(new GeometryInstance(&geometries[i % 8], (float)i, 0.0f, 0.0f));
+        instances.back()->getModelMatrix();
+    }
+    RecordingRenderBackend backend;
+    InstancedRenderer renderer(&backend);
+    constexpr int frames = 10;
+    const auto start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        renderer.begin();
+        for (const auto instance : instances) {
+            renderer.submit(instance);
+        }
+        renderer.flush();
+    }
+    const double ms = elapsedMs(start) / frames;
+    std::cout << "  " << count << " instances of 8 geometries: " << ms << " ms/frame (submit + flush), "
+              << renderer.getDrawCallCount() << " draw calls" << std::endl;
+    for (const auto instance : instances) {
+        delete instance;
+    }
+}
+
+void runInstancedRendererBenchmarks() {
+    beginChecks("instanced renderer");
+    checkInstancedRendererBatching();
+    checkInstancedRendererFrames();
+    benchmarkInstancedRenderer(100000);
+    endChecks();
+}
@@ -0,0 +1,22 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef INSTANCEDRENDERERBENCHMARK_H
+#define INSTANCEDRENDERERBENCHMARK_H
+
+/**
+ * 实例化渲染器的测试, 在命令行中输入/bench运行
+ * 使用RecordingRenderBackend, 不需要OpenGL上下文. 检查draw call数量, 每次绘制的实例数和上传的实例矩阵
+ */
+
+// 1000个实例共享2个几何体: 每帧2次draw call, 实例矩阵按提交顺序上传到各自几何体的实例VBO
+void checkInstancedRendererBatching();
+// 连续多帧复用批次和实例VBO, 移动的实例在下一帧上传新的矩阵
+void checkInstancedRendererFrames();
+// count个实例提交和flush的耗时
+void benchmarkInstancedRenderer(int count);
+
+void runInstancedRendererBenchmarks();
+
+#endif //INSTANCEDRENDERERBENCHMARK_H
@@ -0,0 +1,230 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "staticBatch.h"
+
+bool MergedMesh::hasValidIndices() const {
+    if (indices.size() % 3 != 0) {
+        return false;
+    }
+    const size_t vertexCount = getVertexCount();
+    return std::all_of(indices.begin(), indices.end(), [vertexCount](const GLuint index) {
+        return index < vertexCount;
+    });
+}
+
+MergedMesh StaticBatcher::merge(const Geometry* geometry, const std::vector<GeometryInstance*>& instances) {
+    return merge(geometry->getData(), instances);
+}
+
+MergedMesh StaticBatcher::merge(const GeometryData& data, const std::vector<GeometryInstance*>& instances) {
+    MergedMesh mesh;
+    const size_t vertexCount = data.getVertexCount();
+
+    // 一次性分配好空间, 避免合并大量实例时反复扩容
+    mesh.positions.reserve(vertexCount * 3 * instances.size());
+    mesh.colors.reserve(data.colors.size() * instances.size());
+    mesh.uvs.reserve(data.uvs.size() * instances.size());
+    mesh.indices.reserve(data.indices.size() * instances.size());
+
+    mesh.bounds.min = glm::vec3(std::numeric_limits<float>::max());
+    mesh.bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+    for (GeometryInstance* instance : instances) {
+        const glm::mat4& modelMatrix = instance->getModelMatrix();
+        // 当前实例的顶点在合并网格中的起始位置, 索引需要加上这个偏移
+        const auto baseVertex = static_cast<GLuint>(mesh.getVertexCount());
+
+        // 顶点位置预先变换到世界空间
+        for (size_t i = 0; i < vertexCount; i++) {
+            const glm::vec3 world = glm::vec3(modelMatrix * glm::vec4(data.positions[i * 3], data.positions[i * 3 + 1], data.positions[i * 3 + 2], 1.0f));
+            mesh.positions.push_back(world.x);
+            mesh.positions.push_back(world.y);
+            mesh.positions.push_back(world.z);
+            mesh.bounds.min = glm::min(mesh.bounds.min, world);
+            mesh.bounds.max = glm::max(mesh.bounds.max, world);
+        }
+        // 颜色和uv不受变换影响, 直接拷贝
+        mesh.colors.insert(mesh.colors.end(), data.colors.begin(), data.colors.end());
+        mesh.uvs.insert(mesh.uvs.end(), data.uvs.begin(), data.uvs.end());
+        for (const GLuint index : data.indices) {
+            mesh.indices.push_back(baseVertex + index);
+        }
+        mesh.instanceCount++;
+    }
+
+    if (instances.empty()) {
+        mesh.bounds = BoundingBox{};
+    }
+    return mesh;
+}
+
+StaticBatcher::~StaticBatcher() {
+    clear();
+}
+
+StaticBatcher::BatchKey StaticBatcher::keyOf(GeometryInstance* instance) {
+    // 按实例中心所在的区域划分
+    const glm::vec3& center = instance->getWorldCenter();
+    return {instance->geometry,
+            static_cast<int>(std::floor(center.x / REGION_SIZE)),
+            static_cast<int>(std::floor(center.z / REGION_SIZE))};
+}
+
+void StaticBatcher::add(GeometryInstance* instance) {
+    if (!instance->isStatic || contains(instance)) {
+        return;
+    }
+    const BatchKey key = keyOf(instance);
+    Batch& batch = batches[key];
+    batch.instances.push_back(instance);
+    batch.dirty = true;
+    regionOf[instance] = key;
+}
+
+void StaticBatcher::remove(GeometryInstance* instance) {
+    const auto it = regionOf.find(instance);
+    if (it == regionOf.end()) {
+        return;
+    }
+    Batch& batch = batches[it->second];
+    std::erase(batch.instances, instance);
+    batch.dirty = true;
+    regionOf.erase(it);
+}
+
+void StaticBatcher::markDirty(GeometryInstance* instance) {
+    const auto it = regionOf.find(instance);
+    if (it == regionOf.end()) {
+        return;
+    }
+    // 原来所在的区域一定要重建
+    batches[it->second].dirty = true;
+    // 移动后可能换了区域
+    const BatchKey key = keyOf(instance);
+    if (key != it->second) {
+        std::erase(batches[it->second].instances, instance);
+        Batch& target = batches[key];
+        target.instances.push_back(instance);
+        target.dirty = true;
+        it->second = key;
+    }
+}
+
+void StaticBatcher::mergeDirty(const GeometryData* data) {
+    for (auto it = batches.begin(); it != batches.end();) {
+        Batch& batch = it->second;
+        if (!batch.dirty) {
+            ++it;
+            continue;
+        }
+        // 区域里已经没有实例了, 直接删除批次
+        if (batch.instances.empty()) {
+            release(batch);
+            it = batches.erase(it);
+            continue;
+        }
+        batch.merged = merge(data ? *data : std::get<0>(it->first)->getData(), batch.instances);
+        batch.uploadPending = true;
+        batch.dirty = false;
+        ++it;
+    }
+}
+
+void StaticBatcher::rebuildDirty() {
+    mergeDirty();
+    for (auto& [key, batch] : batches) {
+        if (!batch.uploadPending) {
+            continue;
+        }
+        upload(batch, batch.merged);
+        // 上传后不再保留CPU端的副本
+        batch.merged = MergedMesh{};
+        batch.uploadPending = false;
+    }
+}
+
+std::vector<StaticBatcher::MergedRegion> StaticBatcher::getMergedRegions() const {
+    std::vector<MergedRegion> regions;
+    for (const auto& [key, batch] : batches) {
+        if (batch.uploadPending) {
+            regions.push_back({std::get<0>(key), std::get<1>(key), std::get<2>(key), &batch.instances, &batch.merged});
+        }
+    }
+    return regions;
+}
+
+void StaticBatcher::clear() {
+    for (auto& [key, batch] : batches) {
+        release(batch);
+    }
+    batches.clear();
+    regionOf.clear();
+}
+
+void StaticBatcher::draw(const Shader* shader, const std::string& modelMatrixName, const Frustum* frustum) const {
+    // 顶点已经在世界空间了
+    shader->setMat4(modelMatrixName, glm::identity<glm::mat4>());
+    drawnBatchCount = 0;
+    for (const auto& [key, batch] : batches) {
+        if (batch.indicesCount == 0) {
+            continue;
+        }
+        if (frustum && !frustum->isVisible(batch.bounds)) {
+            continue;
+        }
+        drawnBatchCount++;
+        const Geometry* geometry = std::get<0>(key);
+        geometry->bindTexture();
+        glBindVertexArray(batch.VAO);
+        glDrawElements(geometry->getPrimitiveType(), batch.indicesCount, GL_UNSIGNED_INT, nullptr);
+    }
+    glBindVertexArray(0);
+}
+
+void StaticBatcher::upload(Batch& batch, const MergedMesh& mesh) {
+    // 第一次上传时创建缓冲, 之后重建区域直接覆盖缓冲内容
+    if (!batch.VAO) {
+        glGenBuffers(1, &batch.VBOPosition);
+        glGenBuffers(1, &batch.VBOColor);
+        glGenBuffers(1, &batch.VBOUv);
+        glGenBuffers(1, &batch.EBO);
+        glGenVertexArrays(1, &batch.VAO);
+    }
+    glBindVertexArray(batch.VAO);
+    // 属性布局与Geometry保持一致(0 -> 位置, 1 -> 颜色, 2 -> uv坐标), 可以直接复用原来的着色器
+    glBindBuffer(GL_ARRAY_BUFFER, batch.VBOPosition);
+    glBufferData(GL_ARRAY_BUFFER, mesh.positions.size() * sizeof(float), mesh.positions.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, batch.VBOColor);
+    glBufferData(GL_ARRAY_BUFFER, mesh.colors.size() * sizeof(float), mesh.colors.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, batch.VBOUv);
+    glBufferData(GL_ARRAY_BUFFER, mesh.uvs.size() * sizeof(float), mesh.uvs.data(), GL_STATIC_DRAW);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(GLuint), mesh.indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+
+    batch.indicesCount = static_cast<uint32_t>(mesh.indices.size());
+    batch.bounds = mesh.bounds;
+}
+
+void StaticBatcher::release(Batch& batch) {
+    if (batch.VAO) {
+        glDeleteVertexArrays(1, &batch.VAO);
+        glDeleteBuffers(1, &batch.VBOPosition);
+        glDeleteBuffers(1, &batch.VBOColor);
+        glDeleteBuffers(1, &batch.VBOUv);
+        glDeleteBuffers(1, &batch.EBO);
+    }
+    batch = Batch{};
+}
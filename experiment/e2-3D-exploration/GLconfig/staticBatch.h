@@ -0,0 +1,127 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef STATICBATCH_H
+#define STATICBATCH_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "core.h"
+#include "frustumCulling.h"
+#include "geometry.h"
+#include "shader.h"
+
+/**
+ * 合并后的网格(CPU端). 所有实例的顶点都已经变换到世界空间, 绘制时模型矩阵为单位阵
+ */
+struct MergedMesh {
+    std::vector<float> positions; // 世界空间坐标, 每3个float一个顶点
+    std::vector<float> colors;
+    std::vector<float> uvs;
+    std::vector<GLuint> indices;
+    BoundingBox bounds; // 世界空间AABB
+    uint32_t instanceCount{0};
+
+    size_t getVertexCount() const { return positions.size() / 3; }
+    // 检查所有索引都指向合法顶点, 并且索引数量是三角形的整数倍
+    bool hasValidIndices() const;
+};
+
+/**
+ * 静态合批
+ * 把标记为isStatic, 且共享同一个Geometry(同时也决定了纹理)的实例在CPU上预先变换到世界空间,
+ * 合并为一个大的顶点/索引缓冲, 整个迷宫只需要少数几次draw call
+ *
+ * 世界按XZ平面上REGION_SIZE大小的区域划分, 每个(几何体, 区域)是一个批次.
+ * 静态实例被修改后调用markDirty, 下一次rebuildDirty只会重建受影响的区域
+ */
+class StaticBatcher {
+public:
+    // 区域边长(世界单位)
+    static constexpr float REGION_SIZE = 16.0f;
+
+    StaticBatcher() = default;
+    ~StaticBatcher();
+
+    // 把一组实例合并为一个网格. 纯CPU操作, 不需要OpenGL上下文
+    static MergedMesh merge(const Geometry* geometry, const std::vector<GeometryInstance*>& instances);
+    // 直接使用顶点数据合并(实例的几何体不需要有网格缓冲)
+    static MergedMesh merge(const GeometryData& data, const std::vector<GeometryInstance*>& instances);
+
+    // 加入一个静态实例(非静态实例会被忽略). 加入后需要rebuildDirty才会生效
+    void add(GeometryInstance* instance);
+    // 移除一个静态实例
+    void remove(GeometryInstance* instance);
+    // 静态实例被修改(平移/旋转/缩放)后调用, 标记新旧所在区域需要重建
+    void markDirty(GeometryInstance* instance);
+    // 重建所有被标记的区域, 并把结果上传到GPU. 即mergeDirty之后上传每个合并结果
+    void rebuildDirty();
+    // rebuildDirty的CPU部分: 重新合并所有被标记的区域(没有实例的区域直接删除), 结果留在批次中等待上传.
+    // 不调用OpenGL(删除的区域没有上传过时). data非空时代替每个几何体自己的顶点数据(几何体不需要有网格缓冲)
+    void mergeDirty(const GeometryData* data = nullptr);
+    // 清空所有批次
+    void clear();
+
+    // 是否已经被合批. 被合批的实例不需要再单独绘制
+    bool contains(GeometryInstance* instance) const { return regionOf.contains(instance); }
+
+    // 绘制所有批次. 着色器的模型矩阵uniform会被设置为单位阵
+    // 传入frustum时跳过包围盒完全在视锥外的批次
+    void draw(const Shader* shader, const std::string& modelMatrixName = "transform",
+              const Frustum* frustum = nullptr) const;
+
+    // 统计信息
+    uint32_t getBatchCount() const { return static_cast<uint32_t>(batches.size()); }
+    uint32_t getInstanceCount() const { return static_cast<uint32_t>(regionOf.size()); }
+    // 上一次draw实际绘制的批次数
+    uint32_t getDrawnBatchCount() const { return drawnBatchCount; }
+
+    // 一个区域合并后还没有上传的结果, 以及合并时区域中的实例
+    struct MergedRegion {
+        const Geometry* geometry;
+        int x;
+        int z;
+        const std::vector<GeometryInstance*>* instances;
+        const MergedMesh* mesh;
+    };
+    // mergeDirty之后, rebuildDirty上传之前的所有合并结果, 按区域排序
+    std::vector<MergedRegion> getMergedRegions() const;
+
+private:
+    // 批次的键: 几何体 + 区域坐标
+    using BatchKey = std::tuple<const Geometry*, int, int>;
+
+    struct Batch {
+        std::vector<GeometryInstance*> instances;
+        bool dirty{true};
+        // 已经合并, 等待上传
+        bool uploadPending{false};
+        MergedMesh merged;
+        // GPU资源
+        GLuint VAO{0};
+        GLuint VBOPosition{0};
+        GLuint VBOColor{0};
+        GLuint VBOUv{0};
+        GLuint EBO{0};
+        uint32_t indicesCount{0};
+        BoundingBox bounds;
+    };
+
+    // 用std::map保证绘制顺序稳定(相同几何体的批次相邻, 纹理不用来回切换)
+    std::map<BatchKey, Batch> batches;
+    // 每个实例当前所在的批次
+    std::unordered_map<GeometryInstance*, BatchKey> regionOf;
+    mutable uint32_t drawnBatchCount{0};
+
+    static BatchKey keyOf(GeometryInstance* instance);
+    static void upload(Batch& batch, const MergedMesh& mesh);
+    static void release(Batch& batch);
+};
+
+#endif //STATICBATCH_H
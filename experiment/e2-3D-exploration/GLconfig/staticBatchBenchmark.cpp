@@ -0,0 +1,194 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "staticBatchBenchmark.h"
+#include "benchmarkCheck.h"
+#include "staticBatch.h"
+
+using namespace benchmark;
+
+namespace {
+    // 单位立方体: 8个顶点, 12个三角形. 与createBox不同, 不经过GeometryPool, 不需要上传
+    GeometryData makeCube() {
+        GeometryData data;
+        for (int i = 0; i < 8; i++) {
+            data.positions.insert(data.positions.end(), {i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f});
+            data.colors.insert(data.colors.end(), {1.0f, 1.0f, 1.0f});
+            data.uvs.insert(data.uvs.end(), {(float)(i & 1), (float)((i >> 1) & 1)});
+        }
+        data.indices = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+                        2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+        return data;
+    }
+
+    bool containsBox(const BoundingBox& outer, const BoundingBox& inner) {
+        constexpr float epsilon = 1e-4f;
+        return glm::all(glm::lessThanEqual(outer.min, inner.min + epsilon))
+               && glm::all(glm::greaterThanEqual(outer.max, inner.max - epsilon));
+    }
+
+    // 合并结果的检查, 返回失败的原因(空串表示通过)
+    std::string validate(const MergedMesh& mesh, const GeometryData& data, std::vector<GeometryInstance*>& instances) {
+        if (mesh.getVertexCount() != data.getVertexCount() * instances.size() || mesh.instanceCount != instances.size()) {
+            return "vertex count " + std::to_string(mesh.getVertexCount());
+        }
+        if (mesh.indices.size() != data.indices.size() * instances.size() || !mesh.hasValidIndices()) {
+            return "invalid indices";
+        }
+        for (const auto instance : instances) {
+            if (!containsBox(mesh.bounds, instance->getBoundingBox())) {
+                return "bounds miss an instance";
+            }
+        }
+        return "";
+    }
+}
+
+void checkStaticBatchMerge() {
+    std::cout << "  merge:" << std::endl;
+    const GeometryData cube = makeCube();
+    Geometry geometry;
+    geometry.boundingBox = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+
+    // 平移, 旋转和缩放过的实例
+    std::vector<GeometryInstance*> instances;
+    for (int i = 0; i < 64; i++) {
+        auto* instance = new GeometryInstance(&geometry, (float)(i % 8) * 3.0f, (float)(i % 3), (float)(i / 8) * -3.0f);
+        instance->rotate((float)i * 17.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        if (i % 4 == 0) {
+            instance->scale(1.0f, 2.0f + (float)i * 0.1f, 1.0f);
+        }
+        instances.push_back(instance);
+    }
+
+    const MergedMesh mesh = StaticBatcher::merge(cube, instances);
+    const std::string error = validate(mesh, cube, instances);
+    check(error.empty(), "64 instances: " + std::to_string(mesh.getVertexCount()) + " merged vertices = 64 * 8, valid indices, bounds contain every instance"
+          + (error.empty() ? "" : " (" + error + ")"));
+    // 每个实例的第一个顶点等于它的模型矩阵变换后的位置
+    bool transformed = true;
+    for (size_t i = 0; i < instances.size(); i++) {
+        const glm::vec3 expected = glm::vec3(instances[i]->getModelMatrix() * glm::vec4(-0.5f, -0.5f, -0.5f, 1.0f));
+        const glm::vec3 merged(mesh.positions[i * 24], mesh.positions[i * 24 + 1], mesh.positions[i * 24 + 2]);
+        transformed = transformed && glm::length(merged - expected) < 1e-4f;
+    }
+    check(transformed, "vertices transformed to world space by each instance's model matrix");
+
+    // 非法索引能被发现
+    MergedMesh broken = mesh;
+    broken.indices.back() = (GLuint)broken.getVertexCount();
+    MergedMesh partial = mesh;
+    partial.indices.pop_back();
+    check(!broken.hasValidIndices() && !partial.hasValidIndices(), "hasValidIndices rejects out-of-range and partial triangles");
+
+    // 没有网格缓冲的几何体和空的实例列表
+    const MergedMesh empty = StaticBatcher::merge(&geometry, instances);
+    const MergedMesh none = StaticBatcher::merge(cube, {});
+    check(empty.getVertexCount() == 0 && empty.hasValidIndices() && none.getVertexCount() == 0 && none.instanceCount == 0,
+          "empty geometry or no instances merge to an empty mesh");
+
+    for (const auto instance : instances) {
+        delete instance;
+    }
+}
+
+void checkStaticBatchRemoval() {
+    std::cout << "  removal:" << std::endl;
+    const GeometryData cube = makeCube();
+    Geometry geometry;
+    geometry.boundingBox = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+
+    // 一行墙体, 跨越3个区域
+    std::vector<GeometryInstance*> instances;
+    StaticBatcher batcher;
+    for (int i = 0; i < 40; i++) {
+        auto* instance = new GeometryInstance(&geometry, (float)i + 0.5f, 0.5f, 0.5f);
+        instance->isStatic = true;
+        instances.push_back(instance);
+        batcher.add(instance);
+    }
+    GeometryInstance dynamic(&geometry, 0.0f, 0.0f, 0.0f);
+    batcher.add(&dynamic);
+    check(batcher.getInstanceCount() == 40 && batcher.getBatchCount() == 3 && !batcher.contains(&dynamic),
+          "40 static instances in 3 regions, dynamic instance ignored");
+
+    // 移除每隔一个的实例, 再把一个实例移到另一个区域
+    std::vector<GeometryInstance*> remaining;
+    for (size_t i = 0; i < instances.size(); i++) {
+        if (i % 2 == 0) {
+            batcher.remove(instances[i]);
+        } else {
+            remaining.push_back(instances[i]);
+        }
+    }
+    remaining[0]->translate(glm::vec3(0.0f, 0.0f, StaticBatcher::REGION_SIZE));
+    batcher.markDirty(remaining[0]);
+    check(batcher.getInstanceCount() == 20 && !batcher.contains(instances[0]) && batcher.contains(remaining[0])
+          && batcher.getBatchCount() == 4, "after removing 20 and moving 1: 20 instances, moved one in a new region");
+
+    // rebuildDirty的CPU部分: 每个区域按自己剩下的实例重新合并. 期望的划分按实例中心独立计算
+    batcher.mergeDirty(&cube);
+    std::map<std::pair<int, int>, std::set<GeometryInstance*>> expected;
+    for (const auto instance : remaining) {
+        const glm::vec3 center = instance->getWorldCenter();
+        expected[{(int)std::floor(center.x / StaticBatcher::REGION_SIZE), (int)std::floor(center.z / StaticBatcher::REGION_SIZE)}]
+            .insert(instance);
+    }
+    const std::vector<StaticBatcher::MergedRegion> regions = batcher.getMergedRegions();
+    bool sameRegions = regions.size() == expected.size();
+    std::string error;
+    for (const StaticBatcher::MergedRegion& region : regions) {
+        const auto it = expected.find({region.x, region.z});
+        std::vector<GeometryInstance*> instancesInRegion = *region.instances;
+        sameRegions = sameRegions && region.geometry == &geometry && it != expected.end()
+                      && std::set(instancesInRegion.begin(), instancesInRegion.end()) == it->second
+                      && instancesInRegion.size() == it->second.size();
+        if (error.empty()) {
+            error = validate(*region.mesh, cube, instancesInRegion);
+        }
+    }
+    check(sameRegions, std::to_string(regions.size()) + " regions re-merged, each holds exactly the surviving instances whose center lies in it");
+    check(error.empty(), "each region's mesh has its instances' vertex count, valid indices and bounds"
+          + (error.empty() ? "" : " (" + error + ")"));
+
+    batcher.clear();
+    check(batcher.getInstanceCount() == 0 && batcher.getBatchCount() == 0, "clear drops every batch");
+    for (const auto instance : instances) {
+        delete instance;
+    }
+}
+
+void benchmarkStaticBatchMerge(const int count) {
+    const GeometryData cube = makeCube();
+    Geometry geometry;
+    std::vector<GeometryInstance*> instances;
+    instances.reserve(count);
+    for (int i = 0; i < count; i++) {
+        instances.push_back(new GeometryInstance(&geometry, (float)(i % 100), 0.0f, (float)(i / 100)));
+        instances.back()->getModelMatrix();
+    }
+    const auto start = Clock::now();
+    const MergedMesh mesh = StaticBatcher::merge(cube, instances);
+    const double ms = elapsedMs(start);
+    std::cout << "  " << count << " cubes merged: " << ms << " ms, " << mesh.getVertexCount() << " vertices, "
+              << mesh.indices.size() / 3 << " triangles" << std::endl;
+    for (const auto instance : instances) {
+        delete instance;
+    }
+}
+
+void runStaticBatchBenchmarks() {
+    beginChecks("static batch");
+    checkStaticBatchMerge();
+    checkStaticBatchRemoval();
+    benchmarkStaticBatchMerge(10000);
+    endChecks();
+}
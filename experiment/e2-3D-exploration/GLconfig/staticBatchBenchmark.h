@@ -0,0 +1,22 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef STATICBATCHBENCHMARK_H
+#define STATICBATCHBENCHMARK_H
+
+/**
+ * 静态合批的测试, 在命令行中输入/bench运行
+ * 只检查CPU上的合并(StaticBatcher::merge和mergeDirty)和批次的记录, 不调用rebuildDirty的上传, 不需要OpenGL上下文
+ */
+
+// 合并后的顶点数等于所有实例之和, 包围盒包含每个实例的包围盒, 索引都指向合法顶点
+void checkStaticBatchMerge();
+// 加入, 移动和移除实例后批次的记录正确, mergeDirty后每个区域的网格恰好由该区域剩下的实例合并而成
+void checkStaticBatchRemoval();
+// count个长方体实例合并的耗时
+void benchmarkStaticBatchMerge(int count);
+
+void runStaticBatchBenchmarks();
+
+#endif //STATICBATCHBENCHMARK_H
@@ -0,0 +1,221 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <bit>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define TRANSFORM_STORE_SSE
+#endif
+
+#include "transformStore.h"
+
+void TransformStore::reserve(const uint32_t capacity) {
+    const uint32_t padded = (capacity + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT;
+    for (auto* array : {&positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW,
+                        &scaleX, &scaleY, &scaleZ}) {
+        array->reserve(padded);
+    }
+    matrices.reserve(padded);
+    dirtyBits.reserve((padded + 63) / 64);
+}
+
+void TransformStore::grow() {
+    // 一次追加LANE_COUNT个单位变换, 保证SIMD按组读取时不会越界
+    const size_t size = matrices.size() + LANE_COUNT;
+    for (auto* array : {&positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &scaleX, &scaleY, &scaleZ}) {
+        array->resize(size, 0.0f);
+    }
+    rotationW.resize(size, 1.0f);
+    std::fill(scaleX.end() - LANE_COUNT, scaleX.end(), 1.0f);
+    std::fill(scaleY.end() - LANE_COUNT, scaleY.end(), 1.0f);
+    std::fill(scaleZ.end() - LANE_COUNT, scaleZ.end(), 1.0f);
+    matrices.resize(size, glm::mat4(1.0f));
+    dirtyBits.resize((size + 63) / 64, 0);
+}
+
+uint32_t TransformStore::create(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+    uint32_t handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+    } else {
+        if (used == matrices.size()) {
+            grow();
+        }
+        handle = used++;
+    }
+    count++;
+    setPosition(handle, position);
+    setRotation(handle, rotation);
+    setScale(handle, scale);
+    return handle;
+}
+
+void TransformStore::destroy(const uint32_t handle) {
+    // 恢复为单位变换, 同组计算时不会产生无意义的数值
+    setPosition(handle, glm::vec3(0.0f));
+    setRotation(handle, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+    setScale(handle, glm::vec3(1.0f));
+    freeHandles.push_back(handle);
+    count--;
+}
+
+void TransformStore::clear() {
+    for (auto* array : {&positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW,
+                        &scaleX, &scaleY, &scaleZ}) {
+        array->clear();
+    }
+    matrices.clear();
+    dirtyBits.clear();
+    freeHandles.clear();
+    used = 0;
+    count = 0;
+}
+
+// ===============================================================
+// ===修改变换=====================================================
+// ===============================================================
+
+void TransformStore::setPosition(const uint32_t handle, const glm::vec3& position) {
+    positionX[handle] = position.x;
+    positionY[handle] = position.y;
+    positionZ[handle] = position.z;
+    markDirty(handle);
+}
+
+void TransformStore::setRotation(const uint32_t handle, const glm::quat& rotation) {
+    rotationX[handle] = rotation.x;
+    rotationY[handle] = rotation.y;
+    rotationZ[handle] = rotation.z;
+    rotationW[handle] = rotation.w;
+    markDirty(handle);
+}
+
+void TransformStore::setScale(const uint32_t handle, const glm::vec3& scale) {
+    scaleX[handle] = scale.x;
+    scaleY[handle] = scale.y;
+    scaleZ[handle] = scale.z;
+    markDirty(handle);
+}
+
+// 与GeometryInstance::translate相同, 平移量直接累加到位置上
+void TransformStore::translate(const uint32_t handle, const glm::vec3& translation) {
+    setPosition(handle, getPosition(handle) + translation);
+}
+
+// 与glm::rotate(rotationMatrix, angle, axis)相同, 新的旋转右乘
+void TransformStore::rotate(const uint32_t handle, const float angle, const glm::vec3& axis) {
+    setRotation(handle, glm::normalize(getRotation(handle) * glm::angleAxis(glm::radians(angle), glm::normalize(axis))));
+}
+
+void TransformStore::scale(const uint32_t handle, const glm::vec3& scale) {
+    setScale(handle, getScale(handle) * scale);
+}
+
+glm::vec3 TransformStore::getPosition(const uint32_t handle) const {
+    return {positionX[handle], positionY[handle], positionZ[handle]};
+}
+
+glm::quat TransformStore::getRotation(const uint32_t handle) const {
+    return {rotationW[handle], rotationX[handle], rotationY[handle], rotationZ[handle]};
+}
+
+glm::vec3 TransformStore::getScale(const uint32_t handle) const {
+    return {scaleX[handle], scaleY[handle], scaleZ[handle]};
+}
+
+size_t TransformStore::getMemoryUsage() const {
+    return (positionX.capacity() * 10) * sizeof(float) + matrices.capacity() * sizeof(glm::mat4) +
+           dirtyBits.capacity() * sizeof(uint64_t) + freeHandles.capacity() * sizeof(uint32_t);
+}
+
+// ===============================================================
+// ===组合模型矩阵==================================================
+// ===============================================================
+
+uint32_t TransformStore::updateMatrices() {
+    uint32_t composed = 0;
+    for (size_t word = 0; word < dirtyBits.size(); word++) {
+        uint64_t bits = dirtyBits[word];
+        while (bits) {
+            // 最低的脏条目所在的组, 整组一起计算
+            const uint32_t bit = std::countr_zero(bits) & ~(LANE_COUNT - 1);
+            const auto first = static_cast<uint32_t>(word * 64 + bit);
+#ifdef TRANSFORM_STORE_SSE
+            composeSSE(*this, first);
+#else
+            composeScalar(*this, first);
+#endif
+            bits &= ~(uint64_t{(1u << LANE_COUNT) - 1} << bit);
+            composed += LANE_COUNT;
+        }
+        dirtyBits[word] = 0;
+    }
+    return composed;
+}
+
+// 四元数转旋转矩阵后每一列乘以对应的缩放, 最后一列为平移. 公式与glm::mat3_cast相同
+void TransformStore::composeScalar(const TransformStore& store, const uint32_t first) {
+    for (uint32_t i = first; i < first + LANE_COUNT; i++) {
+        const float qx = store.rotationX[i], qy = store.rotationY[i], qz = store.rotationZ[i], qw = store.rotationW[i];
+        const float xx = qx * qx, yy = qy * qy, zz = qz * qz;
+        const float xy = qx * qy, xz = qx * qz, yz = qy * qz;
+        const float wx = qw * qx, wy = qw * qy, wz = qw * qz;
+        const float sx = store.scaleX[i], sy = store.scaleY[i], sz = store.scaleZ[i];
+
+        glm::mat4& m = store.matrices[i];
+        m[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * sx, 2.0f * (xy + wz) * sx, 2.0f * (xz - wy) * sx, 0.0f);
+        m[1] = glm::vec4(2.0f * (xy - wz) * sy, (1.0f - 2.0f * (xx + zz)) * sy, 2.0f * (yz + wx) * sy, 0.0f);
+        m[2] = glm::vec4(2.0f * (xz + wy) * sz, 2.0f * (yz - wx) * sz, (1.0f - 2.0f * (xx + yy)) * sz, 0.0f);
+        m[3] = glm::vec4(store.positionX[i], store.positionY[i], store.positionZ[i], 1.0f);
+    }
+}
+
+void TransformStore::composeSSE(const TransformStore& store, const uint32_t first) {
+#ifdef TRANSFORM_STORE_SSE
+    const __m128 qx = _mm_loadu_ps(&store.rotationX[first]);
+    const __m128 qy = _mm_loadu_ps(&store.rotationY[first]);
+    const __m128 qz = _mm_loadu_ps(&store.rotationZ[first]);
+    const __m128 qw = _mm_loadu_ps(&store.rotationW[first]);
+    const __m128 sx = _mm_loadu_ps(&store.scaleX[first]);
+    const __m128 sy = _mm_loadu_ps(&store.scaleY[first]);
+    const __m128 sz = _mm_loadu_ps(&store.scaleZ[first]);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+
+    const __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+    const __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+    const __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+    // 每个寄存器保存4个矩阵的同一个元素, 最后转置为4个矩阵的列
+    __m128 columns[4][4];
+    columns[0][0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+    columns[0][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+    columns[0][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+    columns[0][3] = _mm_setzero_ps();
+    columns[1][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+    columns[1][1] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+    columns[1][2] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+    columns[1][3] = _mm_setzero_ps();
+    columns[2][0] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+    columns[2][1] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+    columns[2][2] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+    columns[2][3] = _mm_setzero_ps();
+    columns[3][0] = _mm_loadu_ps(&store.positionX[first]);
+    columns[3][1] = _mm_loadu_ps(&store.positionY[first]);
+    columns[3][2] = _mm_loadu_ps(&store.positionZ[first]);
+    columns[3][3] = one;
+
+    for (int c = 0; c < 4; c++) {
+        _MM_TRANSPOSE4_PS(columns[c][0], columns[c][1], columns[c][2], columns[c][3]);
+        for (int k = 0; k < 4; k++) {
+            _mm_storeu_ps(&store.matrices[first + k][c][0], columns[c][k]);
+        }
+    }
+#else
+    composeScalar(store, first);
+#endif
+}
@@ -0,0 +1,91 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef TRANSFORMSTORE_H
+#define TRANSFORMSTORE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+#include <glm/gtc/quaternion.hpp>
+
+/**
+ * 紧凑的TRS变换存储
+ * GeometryInstance每个对象带有平移/旋转/缩放/模型/update五个mat4, 单独new在堆上, 大量物体时缓存命中很差
+ * 这里把位置(vec3), 旋转(四元数), 缩放(vec3)按分量分别连续存放(SoA), 模型矩阵也连续存放在一个数组中
+ *
+ * 修改变换只会在脏标记位图中置位, updateMatrices()统一重新计算被标记的模型矩阵.
+ * 一次计算4个(SSE), 只处理含有脏标记的4个一组的条目. 每个条目约占104字节(10个float + 1个mat4 + 1个bit)
+ *
+ * 变换的语义与GeometryInstance一致: 模型矩阵 = T * R * S, translate/rotate/scale都是累加变换
+ */
+class TransformStore {
+public:
+    // 一次组合的矩阵数量, 数组长度总是补齐到它的整数倍
+    static constexpr uint32_t LANE_COUNT = 4;
+    static constexpr uint32_t INVALID_HANDLE = 0xFFFFFFFF;
+
+    TransformStore() = default;
+    ~TransformStore() = default;
+
+    void reserve(uint32_t capacity);
+    // 创建一个变换, 返回句柄. 句柄在destroy前保持不变
+    uint32_t create(const glm::vec3& position = glm::vec3(0.0f),
+                    const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                    const glm::vec3& scale = glm::vec3(1.0f));
+    // 销毁后句柄会被之后的create复用
+    void destroy(uint32_t handle);
+    void clear();
+
+    // 直接设置
+    void setPosition(uint32_t handle, const glm::vec3& position);
+    void setRotation(uint32_t handle, const glm::quat& rotation);
+    void setScale(uint32_t handle, const glm::vec3& scale);
+    // 累加变换. angle为角度
+    void translate(uint32_t handle, const glm::vec3& translation);
+    void rotate(uint32_t handle, float angle, const glm::vec3& axis);
+    void scale(uint32_t handle, const glm::vec3& scale);
+
+    glm::vec3 getPosition(uint32_t handle) const;
+    glm::quat getRotation(uint32_t handle) const;
+    glm::vec3 getScale(uint32_t handle) const;
+
+    bool isDirty(const uint32_t handle) const { return dirtyBits[handle / 64] & (uint64_t{1} << (handle % 64)); }
+    // 重新计算所有脏条目的模型矩阵并清除脏标记, 返回实际计算的矩阵数量(含同组中顺带计算的干净条目)
+    uint32_t updateMatrices();
+    // 模型矩阵. 修改变换后需要先调用updateMatrices
+    const glm::mat4& getMatrix(const uint32_t handle) const { return matrices[handle]; }
+    const glm::mat4* getMatrices() const { return matrices.data(); }
+
+    uint32_t getCount() const { return count; }
+    uint32_t getCapacity() const { return static_cast<uint32_t>(matrices.size()); }
+    // 估算占用的内存(字节)
+    size_t getMemoryUsage() const;
+
+    // 组合[first, first + LANE_COUNT)的模型矩阵. SSE不可用时退回标量版本
+    static void composeSSE(const TransformStore& store, uint32_t first);
+    static void composeScalar(const TransformStore& store, uint32_t first);
+
+private:
+    // SoA数组
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+    std::vector<float> scaleX, scaleY, scaleZ;
+    // 模型矩阵在const的compose中写入
+    mutable std::vector<glm::mat4> matrices;
+    // 每个条目一位
+    std::vector<uint64_t> dirtyBits;
+
+    std::vector<uint32_t> freeHandles;
+    // 已使用的最大句柄 + 1
+    uint32_t used{0};
+    // 存活的条目数
+    uint32_t count{0};
+
+    void markDirty(const uint32_t handle) { dirtyBits[handle / 64] |= uint64_t{1} << (handle % 64); }
+    void grow();
+};
+
+#endif //TRANSFORMSTORE_H
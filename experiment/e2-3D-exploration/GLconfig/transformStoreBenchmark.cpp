@@ -0,0 +1,111 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "transformStoreBenchmark.h"
+#include "geometry.h"
+#include "transformStore.h"
+
+namespace {
+    // 模拟的帧数
+    constexpr int FRAME_COUNT = 10;
+
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(const Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+void benchmarkTransformStore(const int count, const int dirtyPercent) {
+    // 所有实例共享一个几何体, 只用到包围盒, 不会调用OpenGL
+    Geometry box;
+    box.boundingBox = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+    box.boundingSphere = {glm::vec3(0.0f), glm::length(glm::vec3(0.5f))};
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::vector<glm::vec3> positions(count);
+    for (auto& p : positions) {
+        p = glm::vec3(position(random), position(random), position(random));
+    }
+    // 每帧被修改的物体, 两条路径使用同一组下标
+    std::vector<int> moving;
+    for (int i = 0; i < count; i++) {
+        if ((int)(random() % 100) < dirtyPercent) {
+            moving.push_back(i);
+        }
+    }
+    const glm::vec3 step(0.01f, 0.0f, 0.02f);
+    const glm::vec3 axis(0.0f, 1.0f, 0.0f);
+
+    // ===原来的方式: 每个实例单独new, 各自计算T * R * S===
+    std::vector<GeometryInstance*> instances;
+    instances.reserve(count);
+    for (int i = 0; i < count; i++) {
+        instances.push_back(new GeometryInstance(&box, positions[i]));
+        instances.back()->getModelMatrix();
+    }
+    auto start = Clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        for (const int i : moving) {
+            instances[i]->translate(step)->rotate(1.0f, axis);
+        }
+        for (const int i : moving) {
+            instances[i]->getModelMatrix();
+        }
+    }
+    const double instanceMs = elapsedMs(start) / FRAME_COUNT;
+
+    // ===TRS变换存储===
+    TransformStore store;
+    store.reserve(count);
+    for (int i = 0; i < count; i++) {
+        store.create(positions[i]);
+    }
+    store.updateMatrices();
+    uint32_t composed = 0;
+    start = Clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; frame++) {
+        for (const int i : moving) {
+            store.translate(i, step);
+            store.rotate(i, 1.0f, axis);
+        }
+        composed = store.updateMatrices();
+    }
+    const double storeMs = elapsedMs(start) / FRAME_COUNT;
+
+    // 两条路径的结果应该一致(四元数与矩阵累乘的舍入误差不同, 只比较最大误差)
+    float maxError = 0.0f;
+    for (int i = 0; i < count; i++) {
+        const glm::mat4& a = instances[i]->getModelMatrix();
+        const glm::mat4& b = store.getMatrix(i);
+        for (int c = 0; c < 4; c++) {
+            const glm::vec4 diff = glm::abs(a[c] - b[c]);
+            maxError = glm::max(maxError, glm::max(glm::max(diff.x, diff.y), glm::max(diff.z, diff.w)));
+        }
+    }
+
+    std::cout << "[transform store] " << count << " objects, " << moving.size() << " moving per frame" << std::endl;
+    std::cout << "  instance: " << instanceMs << " ms/frame, " << sizeof(GeometryInstance) << " bytes/object" << std::endl;
+    std::cout << "  store:    " << storeMs << " ms/frame, " << (double)store.getMemoryUsage() / count << " bytes/object, "
+              << composed << " matrices composed" << std::endl;
+    std::cout << "  speed-up: " << instanceMs / storeMs << "x, max error " << maxError << std::endl;
+
+    for (const auto instance : instances) {
+        delete instance;
+    }
+}
+
+void runTransformStoreBenchmarks() {
+    for (const int count : {100000, 1000000}) {
+        for (const int dirtyPercent : {10, 100}) {
+            benchmarkTransformStore(count, dirtyPercent);
+        }
+    }
+}
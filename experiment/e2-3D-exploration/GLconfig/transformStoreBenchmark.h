@@ -0,0 +1,19 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef TRANSFORMSTOREBENCHMARK_H
+#define TRANSFORMSTOREBENCHMARK_H
+
+/**
+ * TRS变换存储与GeometryInstance逐个计算模型矩阵的性能对比, 在命令行中输入/bench运行
+ * 不需要OpenGL上下文
+ */
+
+// count个物体, 每帧有dirtyPercent%的物体平移+旋转, 对比重新计算模型矩阵的耗时和每个物体占用的内存
+void benchmarkTransformStore(int count, int dirtyPercent);
+
+// 依次运行100k, 1M两个规模, 每个规模分别测试10%和100%的物体被修改
+void runTransformStoreBenchmarks();
+
+#endif //TRANSFORMSTOREBENCHMARK_H
@@ -132,8 +132,19 @@ void GameCameraController::update() {
 
         // 碰撞法向
         glm::vec3 normal(0.0f);
-        // 检测碰撞
-        for (const auto g : geometries) {
+        // 粗检测: 只取出包围盒与相机移动前后范围相交的实例
+        // checkCollision要求AABB必须相交, 所以用AABB粗筛不会漏掉碰撞.
+        // 碰撞后stride会沿墙面改变方向(长度不变), 所以按stride长度向各个方向外扩
+        candidates.clear();
+        if (broadphase) {
+            const glm::vec3 reach(glm::length(stride));
+            const BoundingBox sweptBox{boundingBox.min - reach, boundingBox.max + reach};
+            broadphase->query(sweptBox, candidates);
+        } else {
+            candidates.assign(geometries.begin(), geometries.end());
+        }
+        // 精确检测
+        for (const auto g : candidates) {
             if (g->detectCollision && checkCollision(g, stride, normal)) {
                 // std::cout << "collision detected" << std::endl;
 
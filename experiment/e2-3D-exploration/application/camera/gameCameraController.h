@@ -8,6 +8,7 @@
 #include "cameraController.h"
 #include "gameControlMoveStrategy.h"
 #include "../../GLconfig/geometry.h"
+#include "../collision/broadphase.h"
 
 class GameCameraController : public CameraController {
 public:
@@ -33,6 +34,8 @@ public:
     BoundingBox& getBoundingBox() { return boundingBox; }
 
     void setMoveStrategy(GameControlMoveStrategy* moveStrategy) { this->moveStrategy = moveStrategy; }
+    // 设置碰撞检测的粗检测结构. 为nullptr时退化为遍历全部几何体
+    void setBroadphase(Broadphase* broadphase) { this->broadphase = broadphase; }
 private:
     // 记录俯仰角的累计变化量, 以便检测是否超过90度
     float pitchAngle = 0.0f;
@@ -45,6 +48,11 @@ private:
     // 相机控制器的移动策略, 默认是允许任意方向的移动(构造函数中初始化)
     GameControlMoveStrategy* moveStrategy;
 
+    // 碰撞检测的粗检测结构, 只把相机附近的实例交给checkCollision
+    Broadphase* broadphase = nullptr;
+    // 粗检测得到的候选实例, 作为成员复用内存
+    std::vector<GeometryInstance*> candidates;
+
     // 检测相机移动stride距离时是否会与几何体实例相撞
     bool checkCollision(GeometryInstance* b, const glm::vec3& stride, glm::vec3& normal);
 
@@ -0,0 +1,394 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <functional>
+
+#include "aabbTree.h"
+
+AABBTree::AABBTree() {
+    nodes.reserve(64);
+}
+
+// ===============================================================
+// ===节点池=======================================================
+// ===============================================================
+
+int AABBTree::allocateNode() {
+    // 空闲链表用完了就扩容. 注意扩容后之前拿到的Node引用都会失效, 所以内部只用下标访问节点
+    if (freeList == NULL_NODE) {
+        nodes.emplace_back();
+        freeList = static_cast<int>(nodes.size()) - 1;
+        nodes[freeList].parent = NULL_NODE;
+    }
+    const int index = freeList;
+    freeList = nodes[index].parent;
+    nodes[index] = Node{};
+    nodes[index].height = 0;
+    return index;
+}
+
+void AABBTree::freeNode(const int node) {
+    nodes[node].parent = freeList;
+    nodes[node].userData = nullptr;
+    nodes[node].height = -1;
+    freeList = node;
+}
+
+// ===============================================================
+// ===代理操作=====================================================
+// ===============================================================
+
+int AABBTree::createProxy(const BoundingBox& box, GeometryInstance* userData) {
+    const int proxy = allocateNode();
+    // 包围盒外扩, 小幅移动时不需要修改树
+    nodes[proxy].box.min = box.min - glm::vec3(FAT_MARGIN);
+    nodes[proxy].box.max = box.max + glm::vec3(FAT_MARGIN);
+    nodes[proxy].userData = userData;
+    insertLeaf(proxy);
+    return proxy;
+}
+
+void AABBTree::destroyProxy(const int proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+}
+
+bool AABBTree::moveProxy(const int proxy, const BoundingBox& box) {
+    if (contains(nodes[proxy].box, box)) {
+        return false;
+    }
+    removeLeaf(proxy);
+    nodes[proxy].box.min = box.min - glm::vec3(FAT_MARGIN);
+    nodes[proxy].box.max = box.max + glm::vec3(FAT_MARGIN);
+    insertLeaf(proxy);
+    return true;
+}
+
+void AABBTree::refit() {
+    // 后序遍历: 先算子节点再算父节点
+    std::function<void(int)> refitNode = [&](const int index) {
+        Node& node = nodes[index];
+        if (node.isLeaf()) {
+            return;
+        }
+        refitNode(node.child1);
+        refitNode(node.child2);
+        node.box = combine(nodes[node.child1].box, nodes[node.child2].box);
+        node.height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+    };
+    if (root != NULL_NODE) {
+        refitNode(root);
+    }
+}
+
+// ===============================================================
+// ===插入与删除===================================================
+// ===============================================================
+
+void AABBTree::insertLeaf(const int leaf) {
+    if (root == NULL_NODE) {
+        root = leaf;
+        nodes[root].parent = NULL_NODE;
+        return;
+    }
+
+    // 1. 从根节点往下, 用表面积启发找到最合适的兄弟节点
+    const BoundingBox leafBox = nodes[leaf].box;
+    int index = root;
+    while (!nodes[index].isLeaf()) {
+        const Node& node = nodes[index];
+        const float area = surfaceArea(node.box);
+        const float combinedArea = surfaceArea(combine(node.box, leafBox));
+        // 直接与当前节点成为兄弟的代价
+        const float cost = 2.0f * combinedArea;
+        // 继续往下走时, 当前节点的包围盒也会被撑大, 这部分代价要算在子节点头上
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto childCost = [&](const int child) {
+            const BoundingBox combined = combine(leafBox, nodes[child].box);
+            if (nodes[child].isLeaf()) {
+                return surfaceArea(combined) + inheritanceCost;
+            }
+            return surfaceArea(combined) - surfaceArea(nodes[child].box) + inheritanceCost;
+        };
+        const float cost1 = childCost(node.child1);
+        const float cost2 = childCost(node.child2);
+
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+    const int sibling = index;
+
+    // 2. 新建一个父节点, 把兄弟节点和叶子挂在下面
+    const int oldParent = nodes[sibling].parent;
+    const int newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = combine(leafBox, nodes[sibling].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+
+    if (oldParent != NULL_NODE) {
+        if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        } else {
+            nodes[oldParent].child2 = newParent;
+        }
+    } else {
+        root = newParent;
+    }
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    // 3. 往上回溯, 平衡并更新祖先节点的包围盒和高度
+    index = nodes[leaf].parent;
+    while (index != NULL_NODE) {
+        index = balance(index);
+        const int child1 = nodes[index].child1;
+        const int child2 = nodes[index].child2;
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+        nodes[index].box = combine(nodes[child1].box, nodes[child2].box);
+        index = nodes[index].parent;
+    }
+}
+
+void AABBTree::removeLeaf(const int leaf) {
+    if (leaf == root) {
+        root = NULL_NODE;
+        return;
+    }
+
+    const int parent = nodes[leaf].parent;
+    const int grandParent = nodes[parent].parent;
+    const int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    if (grandParent == NULL_NODE) {
+        root = sibling;
+        nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    // 用兄弟节点顶替父节点的位置
+    if (nodes[grandParent].child1 == parent) {
+        nodes[grandParent].child1 = sibling;
+    } else {
+        nodes[grandParent].child2 = sibling;
+    }
+    nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    int index = grandParent;
+    while (index != NULL_NODE) {
+        index = balance(index);
+        const int child1 = nodes[index].child1;
+        const int child2 = nodes[index].child2;
+        nodes[index].box = combine(nodes[child1].box, nodes[child2].box);
+        nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+        index = nodes[index].parent;
+    }
+}
+
+/**
+ * 旋转平衡. 设A的子节点为B, C:
+ *       A                C
+ *      / \              / \
+ *     B   C     =>     A   F/G
+ *        / \          / \
+ *       F   G        B  G/F
+ * C比B高2层以上时把C提上来, F, G中较高的留在C下面, 较矮的挂到A下面. 反之同理
+ */
+int AABBTree::balance(const int iA) {
+    if (nodes[iA].isLeaf() || nodes[iA].height < 2) {
+        return iA;
+    }
+
+    const int iB = nodes[iA].child1;
+    const int iC = nodes[iA].child2;
+    const int difference = nodes[iC].height - nodes[iB].height;
+
+    // C比较高, 把C提上来
+    if (difference > 1) {
+        const int iF = nodes[iC].child1;
+        const int iG = nodes[iC].child2;
+
+        nodes[iC].child1 = iA;
+        nodes[iC].parent = nodes[iA].parent;
+        nodes[iA].parent = iC;
+
+        if (nodes[iC].parent != NULL_NODE) {
+            if (nodes[nodes[iC].parent].child1 == iA) {
+                nodes[nodes[iC].parent].child1 = iC;
+            } else {
+                nodes[nodes[iC].parent].child2 = iC;
+            }
+        } else {
+            root = iC;
+        }
+
+        if (nodes[iF].height > nodes[iG].height) {
+            nodes[iC].child2 = iF;
+            nodes[iA].child2 = iG;
+            nodes[iG].parent = iA;
+            nodes[iA].box = combine(nodes[iB].box, nodes[iG].box);
+            nodes[iC].box = combine(nodes[iA].box, nodes[iF].box);
+            nodes[iA].height = 1 + std::max(nodes[iB].height, nodes[iG].height);
+            nodes[iC].height = 1 + std::max(nodes[iA].height, nodes[iF].height);
+        } else {
+            nodes[iC].child2 = iG;
+            nodes[iA].child2 = iF;
+            nodes[iF].parent = iA;
+            nodes[iA].box = combine(nodes[iB].box, nodes[iF].box);
+            nodes[iC].box = combine(nodes[iA].box, nodes[iG].box);
+            nodes[iA].height = 1 + std::max(nodes[iB].height, nodes[iF].height);
+            nodes[iC].height = 1 + std::max(nodes[iA].height, nodes[iG].height);
+        }
+        return iC;
+    }
+
+    // B比较高, 把B提上来
+    if (difference < -1) {
+        const int iD = nodes[iB].child1;
+        const int iE = nodes[iB].child2;
+
+        nodes[iB].child1 = iA;
+        nodes[iB].parent = nodes[iA].parent;
+        nodes[iA].parent = iB;
+
+        if (nodes[iB].parent != NULL_NODE) {
+            if (nodes[nodes[iB].parent].child1 == iA) {
+                nodes[nodes[iB].parent].child1 = iB;
+            } else {
+                nodes[nodes[iB].parent].child2 = iB;
+            }
+        } else {
+            root = iB;
+        }
+
+        if (nodes[iD].height > nodes[iE].height) {
+            nodes[iB].child2 = iD;
+            nodes[iA].child1 = iE;
+            nodes[iE].parent = iA;
+            nodes[iA].box = combine(nodes[iC].box, nodes[iE].box);
+            nodes[iB].box = combine(nodes[iA].box, nodes[iD].box);
+            nodes[iA].height = 1 + std::max(nodes[iC].height, nodes[iE].height);
+            nodes[iB].height = 1 + std::max(nodes[iA].height, nodes[iD].height);
+        } else {
+            nodes[iB].child2 = iE;
+            nodes[iA].child1 = iD;
+            nodes[iD].parent = iA;
+            nodes[iA].box = combine(nodes[iC].box, nodes[iD].box);
+            nodes[iB].box = combine(nodes[iA].box, nodes[iE].box);
+            nodes[iA].height = 1 + std::max(nodes[iC].height, nodes[iD].height);
+            nodes[iB].height = 1 + std::max(nodes[iA].height, nodes[iE].height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+// ===============================================================
+// ===查询=========================================================
+// ===============================================================
+
+GeometryInstance* AABBTree::raycastClosest(const glm::vec3& origin, const glm::vec3& direction, const float maxFraction, float& hitFraction) const {
+    GeometryInstance* closest = nullptr;
+    const glm::vec3 invDirection = 1.0f / direction;
+    hitFraction = maxFraction;
+    raycast(origin, direction, maxFraction, [&](const int proxy, float) {
+        // 叶子存的是fat AABB, 还要用实例本身的包围盒确认
+        GeometryInstance* instance = nodes[proxy].userData;
+        float t;
+        if (rayIntersects(instance->getBoundingBox(), origin, invDirection, hitFraction, t)) {
+            closest = instance;
+            hitFraction = t;
+        }
+        // 裁剪射线, 之后只需要找更近的
+        return hitFraction;
+    });
+    return closest;
+}
+
+float AABBTree::getAreaRatio() const {
+    if (root == NULL_NODE) {
+        return 0.0f;
+    }
+    const float rootArea = surfaceArea(nodes[root].box);
+    float totalArea = 0.0f;
+    for (const auto& node : nodes) {
+        if (node.height > 0) {
+            totalArea += surfaceArea(node.box);
+        }
+    }
+    return rootArea > 0.0f ? totalArea / rootArea : 0.0f;
+}
+
+// ===============================================================
+// ===Broadphase接口===============================================
+// ===============================================================
+
+void AABBTree::insert(GeometryInstance* instance) {
+    if (proxyOf.contains(instance)) {
+        return;
+    }
+    proxyOf[instance] = createProxy(instance->getBoundingBox(), instance);
+}
+
+void AABBTree::remove(GeometryInstance* instance) {
+    const auto it = proxyOf.find(instance);
+    if (it == proxyOf.end()) {
+        return;
+    }
+    destroyProxy(it->second);
+    proxyOf.erase(it);
+}
+
+void AABBTree::update(GeometryInstance* instance) {
+    const auto it = proxyOf.find(instance);
+    if (it == proxyOf.end()) {
+        return;
+    }
+    moveProxy(it->second, instance->getBoundingBox());
+}
+
+void AABBTree::query(const BoundingBox& box, std::vector<GeometryInstance*>& result) const {
+    query(box, [&](const int proxy) {
+        result.push_back(nodes[proxy].userData);
+        return true;
+    });
+}
+
+// ===============================================================
+// ===包围盒工具函数================================================
+// ===============================================================
+
+BoundingBox AABBTree::combine(const BoundingBox& a, const BoundingBox& b) {
+    return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+}
+
+float AABBTree::surfaceArea(const BoundingBox& box) {
+    const glm::vec3 d = box.max - box.min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+bool AABBTree::contains(const BoundingBox& outer, const BoundingBox& inner) {
+    return glm::all(glm::lessThanEqual(outer.min, inner.min)) && glm::all(glm::greaterThanEqual(outer.max, inner.max));
+}
+
+bool AABBTree::rayIntersects(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& invDirection,
+                             const float maxFraction, float& tEnter) {
+    // slab检测: 分别求射线进出三对平行平面的t, 取最晚的进入和最早的离开
+    const glm::vec3 t1 = (box.min - origin) * invDirection;
+    const glm::vec3 t2 = (box.max - origin) * invDirection;
+    const glm::vec3 tNear = glm::min(t1, t2);
+    const glm::vec3 tFar = glm::max(t1, t2);
+    const float tMin = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+    const float tMax = std::min(std::min(tFar.x, tFar.y), tFar.z);
+    tEnter = tMin;
+    return tMin <= tMax && tMin <= maxFraction;
+}
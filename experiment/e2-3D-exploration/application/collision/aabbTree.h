@@ -0,0 +1,157 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef AABBTREE_H
+#define AABBTREE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "broadphase.h"
+
+/**
+ * 动态AABB树(dynamic bounding volume tree)
+ * 叶子节点存放实例"加胖"后的包围盒(fat AABB, 每个方向外扩FAT_MARGIN), 内部节点的包围盒包含两个子节点.
+ * 实例的小幅移动只要还在fat AABB内部就不需要修改树; 超出后才把叶子拆下来重新插入.
+ * 插入时用表面积启发(SAH)选择兄弟节点, 并通过旋转保持平衡, 查询复杂度约为O(log N)
+ */
+class AABBTree : public Broadphase {
+public:
+    // 叶子包围盒的外扩距离
+    static constexpr float FAT_MARGIN = 0.1f;
+    // 空节点
+    static constexpr int NULL_NODE = -1;
+
+    AABBTree();
+    ~AABBTree() override = default;
+
+    // ===底层接口: 直接操作代理(proxy, 即叶子节点编号)===
+    // 插入一个包围盒, 返回代理编号
+    int createProxy(const BoundingBox& box, GeometryInstance* userData);
+    void destroyProxy(int proxy);
+    // 更新代理的包围盒. 仍在fat AABB内时什么都不做, 返回值表示是否重新插入了
+    bool moveProxy(int proxy, const BoundingBox& box);
+    // 自底向上重新计算所有内部节点的包围盒(叶子的fat AABB不变)
+    void refit();
+
+    GeometryInstance* getUserData(const int proxy) const { return nodes[proxy].userData; }
+    const BoundingBox& getFatBox(const int proxy) const { return nodes[proxy].box; }
+
+    // 查询与box相交的所有叶子. callback(int proxy)返回false时提前结束
+    template <typename Callback>
+    void query(const BoundingBox& box, Callback&& callback) const;
+    /**
+     * 射线查询. direction不需要归一化, 射线范围是origin + t * direction, t∈[0, maxFraction]
+     * callback(int proxy, float tEnter)返回新的maxFraction: 返回0结束查询, 返回更小的值可以裁剪射线
+     */
+    template <typename Callback>
+    void raycast(const glm::vec3& origin, const glm::vec3& direction, float maxFraction, Callback&& callback) const;
+    // 找出射线最先碰到的实例(精确到实例本身的AABB). 没有碰到时返回nullptr
+    GeometryInstance* raycastClosest(const glm::vec3& origin, const glm::vec3& direction, float maxFraction, float& hitFraction) const;
+
+    // ===Broadphase接口===
+    void insert(GeometryInstance* instance) override;
+    void remove(GeometryInstance* instance) override;
+    void update(GeometryInstance* instance) override;
+    void query(const BoundingBox& box, std::vector<GeometryInstance*>& result) const override;
+
+    // 统计信息
+    int getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+    size_t getProxyCount() const { return proxyOf.size(); }
+    // 所有内部节点面积之和与根节点面积之比, 越小说明树的质量越好
+    float getAreaRatio() const;
+
+private:
+    struct Node {
+        BoundingBox box;
+        GeometryInstance* userData{nullptr};
+        // 使用中的节点: 父节点; 空闲节点: 下一个空闲节点
+        int parent{NULL_NODE};
+        int child1{NULL_NODE};
+        int child2{NULL_NODE};
+        // 叶子为0, 空闲节点为-1
+        int height{-1};
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+    std::vector<Node> nodes;
+    int root{NULL_NODE};
+    int freeList{NULL_NODE};
+    // Broadphase接口中实例到代理的映射
+    std::unordered_map<GeometryInstance*, int> proxyOf;
+
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    // 对节点做一次旋转使左右子树高度差不超过1, 返回旋转后该位置的节点
+    int balance(int a);
+
+    static BoundingBox combine(const BoundingBox& a, const BoundingBox& b);
+    static float surfaceArea(const BoundingBox& box);
+    static bool contains(const BoundingBox& outer, const BoundingBox& inner);
+    // 射线与AABB的slab检测, 相交时返回进入点的t
+    static bool rayIntersects(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& invDirection,
+                              float maxFraction, float& tEnter);
+};
+
+template <typename Callback>
+void AABBTree::query(const BoundingBox& box, Callback&& callback) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+    // 用显式栈代替递归
+    int stack[256];
+    int top = 0;
+    stack[top++] = root;
+    while (top > 0) {
+        const int index = stack[--top];
+        const Node& node = nodes[index];
+        if (!isCollide(node.box, box)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            if (!callback(index)) {
+                return;
+            }
+        } else {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+}
+
+template <typename Callback>
+void AABBTree::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxFraction, Callback&& callback) const {
+    if (root == NULL_NODE) {
+        return;
+    }
+    // 分量为0时得到inf, slab检测仍然成立
+    const glm::vec3 invDirection = 1.0f / direction;
+    int stack[256];
+    int top = 0;
+    stack[top++] = root;
+    while (top > 0) {
+        const int index = stack[--top];
+        const Node& node = nodes[index];
+        float tEnter;
+        if (!rayIntersects(node.box, origin, invDirection, maxFraction, tEnter)) {
+            continue;
+        }
+        if (node.isLeaf()) {
+            const float value = callback(index, tEnter);
+            if (value <= 0.0f) {
+                return;
+            }
+            maxFraction = value;
+        } else {
+            stack[top++] = node.child1;
+            stack[top++] = node.child2;
+        }
+    }
+}
+
+#endif //AABBTREE_H
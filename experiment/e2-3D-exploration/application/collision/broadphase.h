@@ -0,0 +1,50 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "../../GLconfig/geometry.h"
+
+/**
+ * 碰撞检测的粗检测阶段(broadphase)
+ * 只负责快速找出可能发生碰撞的候选实例, 精确的检测(包围球 + AABB)仍然由相机控制器完成
+ * 实现类只存储实例指针, 实例移动后需要调用update通知
+ */
+class Broadphase {
+public:
+    virtual ~Broadphase() = default;
+
+    // 加入/移除一个参与碰撞检测的实例
+    virtual void insert(GeometryInstance* instance) = 0;
+    virtual void remove(GeometryInstance* instance) = 0;
+    // 实例移动或变换后调用, 重新读取它的包围盒
+    virtual void update(GeometryInstance* instance) = 0;
+    // 找出包围盒可能与box相交的实例, 结果追加到result中
+    virtual void query(const BoundingBox& box, std::vector<GeometryInstance*>& result) const = 0;
+};
+
+/**
+ * 最朴素的实现: 逐个检查所有实例. 每次查询O(N), 作为对照
+ */
+class LinearBroadphase : public Broadphase {
+public:
+    void insert(GeometryInstance* instance) override { instances.push_back(instance); }
+    void remove(GeometryInstance* instance) override { std::erase(instances, instance); }
+    void update(GeometryInstance* /*instance*/) override {}
+    void query(const BoundingBox& box, std::vector<GeometryInstance*>& result) const override {
+        for (const auto instance : instances) {
+            if (isCollide(box, instance->getBoundingBox())) {
+                result.push_back(instance);
+            }
+        }
+    }
+private:
+    std::vector<GeometryInstance*> instances;
+};
+
+#endif //BROADPHASE_H
@@ -0,0 +1,179 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "broadphaseBenchmark.h"
+#include "aabbTree.h"
+#include "spatialGrid.h"
+#include "../util.h"
+
+namespace {
+    // 查询次数. 模拟相机每帧一次的碰撞查询
+    constexpr int QUERY_COUNT = 1000;
+    // 逐个遍历在大迷宫中太慢, 只做少量查询取平均值
+    constexpr int LINEAR_QUERY_COUNT = 100;
+
+    using Clock = std::chrono::steady_clock;
+
+    double elapsedMs(const Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 对一个粗检测结构执行所有查询, 返回平均每次查询的耗时(微秒)以及候选数量
+    double runQueries(const Broadphase& broadphase, const std::vector<BoundingBox>& queries, size_t& candidateCount) {
+        std::vector<GeometryInstance*> result;
+        candidateCount = 0;
+        const auto start = Clock::now();
+        for (const auto& box : queries) {
+            result.clear();
+            broadphase.query(box, result);
+            candidateCount += result.size();
+        }
+        return elapsedMs(start) * 1000.0 / queries.size();
+    }
+}
+
+void benchmarkBroadphase(const int count) {
+    // 所有实例共享一个1x1x1的几何体. 只用到模型空间的包围盒, 不会调用OpenGL
+    Geometry box;
+    box.boundingBox = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+    box.boundingSphere = {glm::vec3(0.0f), glm::length(glm::vec3(0.5f))};
+
+    // 摆放在边长约为2 * sqrt(count)的正方形区域内, 密度与迷宫相近
+    const float extent = 2.0f * std::sqrt((float)count);
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> position(0.0f, extent);
+
+    std::vector<GeometryInstance> instances;
+    instances.reserve(count);
+    for (int i = 0; i < count; i++) {
+        instances.emplace_back(&box, position(random), 0.5f, position(random));
+        // 提前计算好包围盒, 不把矩阵运算算进建树时间
+        instances.back().getBoundingBox();
+    }
+
+    // 相机大小的查询盒
+    std::vector<BoundingBox> queries;
+    queries.reserve(QUERY_COUNT);
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        const glm::vec3 center(position(random), 0.25f, position(random));
+        queries.push_back({center - glm::vec3(0.25f), center + glm::vec3(0.25f)});
+    }
+
+    LinearBroadphase linear;
+    auto start = Clock::now();
+    for (auto& instance : instances) {
+        linear.insert(&instance);
+    }
+    const double linearBuild = elapsedMs(start);
+
+    AABBTree tree;
+    start = Clock::now();
+    for (auto& instance : instances) {
+        tree.insert(&instance);
+    }
+    const double treeBuild = elapsedMs(start);
+
+    size_t linearCandidates, treeCandidates;
+    const double linearQuery = runQueries(linear, queries, linearCandidates);
+    const double treeQuery = runQueries(tree, queries, treeCandidates);
+
+    std::cout << "[broadphase] " << count << " instances" << std::endl;
+    std::cout << "  linear: build " << linearBuild << " ms, query " << linearQuery << " us, candidates " << linearCandidates << std::endl;
+    std::cout << "  tree:   build " << treeBuild << " ms, query " << treeQuery << " us, candidates " << treeCandidates
+              << ", height " << tree.getHeight() << std::endl;
+    std::cout << "  speed-up: " << linearQuery / treeQuery << "x" << std::endl;
+}
+
+void runBroadphaseBenchmarks() {
+    for (const int count : {1000, 10000, 100000}) {
+        benchmarkBroadphase(count);
+    }
+}
+
+void benchmarkMazeGrid(const int size) {
+    const vector<vector<int>> maze = generateMaze(size, size, 1, 1, size - 2, size - 2);
+
+    // 与游戏中一样, 墙体位于(j, -i). 上下两层方块的XZ范围相同, 这里合并为一个高度为2的包围盒
+    std::vector<BoundingBox> walls;
+    std::vector<glm::vec3> openCells;
+    for (int i = 0; i < (int)maze.size(); i++) {
+        for (int j = 0; j < (int)maze[i].size(); j++) {
+            const glm::vec3 center((float)j, 1.0f, (float)-i);
+            if (maze[i][j] == 1) {
+                walls.push_back({center - glm::vec3(0.5f, 1.0f, 0.5f), center + glm::vec3(0.5f, 1.0f, 0.5f)});
+            } else {
+                openCells.push_back(center);
+            }
+        }
+    }
+
+    SpatialGrid grid;
+    auto start = Clock::now();
+    for (const auto& box : walls) {
+        grid.createProxy(box, nullptr);
+    }
+    const double gridBuild = elapsedMs(start);
+
+    // 相机在通路中随机移动, 查询盒为相机碰撞体积加上一帧的步长
+    std::mt19937 random(42);
+    std::uniform_int_distribution<size_t> pick(0, openCells.size() - 1);
+    std::uniform_real_distribution<float> offset(-0.3f, 0.3f);
+    std::vector<BoundingBox> queries;
+    queries.reserve(QUERY_COUNT);
+    for (int i = 0; i < QUERY_COUNT; i++) {
+        const glm::vec3 center = openCells[pick(random)] + glm::vec3(offset(random), -0.75f, offset(random));
+        queries.push_back({center - glm::vec3(0.3f), center + glm::vec3(0.3f)});
+    }
+
+    size_t gridCandidates = 0;
+    start = Clock::now();
+    for (const auto& box : queries) {
+        grid.query(box, [&](int) {
+            gridCandidates++;
+            return true;
+        });
+    }
+    const double gridQuery = elapsedMs(start) * 1000.0 / queries.size();
+
+    size_t neighborhoodCandidates = 0;
+    start = Clock::now();
+    for (const auto& box : queries) {
+        grid.queryNeighborhood((box.min + box.max) * 0.5f, [&](int) {
+            neighborhoodCandidates++;
+            return true;
+        });
+    }
+    const double neighborhoodQuery = elapsedMs(start) * 1000.0 / queries.size();
+
+    size_t linearCandidates = 0;
+    start = Clock::now();
+    for (int i = 0; i < LINEAR_QUERY_COUNT; i++) {
+        for (const auto& wall : walls) {
+            if (isCollide(wall, queries[i])) {
+                linearCandidates++;
+            }
+        }
+    }
+    const double linearQuery = elapsedMs(start) * 1000.0 / LINEAR_QUERY_COUNT;
+
+    std::cout << "[maze grid] " << maze.size() << "x" << maze[0].size() << ", " << walls.size() << " walls" << std::endl;
+    std::cout << "  grid:   build " << gridBuild << " ms, query " << gridQuery << " us, candidates " << gridCandidates
+              << ", cells " << grid.getCellCount() << ", memory " << grid.getMemoryUsage() / 1024 << " KB" << std::endl;
+    std::cout << "  3x3:    query " << neighborhoodQuery << " us, candidates " << neighborhoodCandidates << std::endl;
+    std::cout << "  linear: query " << linearQuery << " us, candidates " << linearCandidates
+              << " (" << LINEAR_QUERY_COUNT << " queries)" << std::endl;
+    std::cout << "  speed-up: " << linearQuery / gridQuery << "x" << std::endl;
+}
+
+void runMazeGridBenchmarks() {
+    for (const int size : {31, 301, 2001}) {
+        benchmarkMazeGrid(size);
+    }
+}
@@ -0,0 +1,25 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef BROADPHASEBENCHMARK_H
+#define BROADPHASEBENCHMARK_H
+
+/**
+ * 粗检测结构的性能对比, 在命令行中输入/bench运行
+ * 不需要OpenGL上下文, 可以在命令行线程中执行
+ */
+
+// 随机摆放count个1x1x1的方块, 对比动态AABB树与逐个遍历的建立和查询耗时
+void benchmarkBroadphase(int count);
+
+// 依次运行1k, 10k, 100k三个规模
+void runBroadphaseBenchmarks();
+
+// 用generateMaze生成size x size的迷宫, 对比均匀网格与逐个遍历的查询耗时以及网格的内存占用
+void benchmarkMazeGrid(int size);
+
+// 依次运行31, 301, 2001三个迷宫尺寸
+void runMazeGridBenchmarks();
+
+#endif //BROADPHASEBENCHMARK_H
@@ -0,0 +1,167 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+
+#include "spatialGrid.h"
+
+SpatialGrid::SpatialGrid(const float cellSize) : cellSize(cellSize), inverseCellSize(1.0f / cellSize) {
+}
+
+// ===============================================================
+// ===代理操作=====================================================
+// ===============================================================
+
+int SpatialGrid::createProxy(const BoundingBox& box, GeometryInstance* userData) {
+    int index;
+    if (freeList != NULL_PROXY) {
+        index = freeList;
+        freeList = proxies[index].nextFree;
+        proxies[index] = Proxy{};
+    } else {
+        index = static_cast<int>(proxies.size());
+        proxies.emplace_back();
+    }
+    Proxy& proxy = proxies[index];
+    proxy.box = box;
+    proxy.userData = userData;
+    proxy.alive = true;
+    computeRange(proxy);
+    addToCells(index);
+    proxyCount++;
+    return index;
+}
+
+void SpatialGrid::destroyProxy(const int proxy) {
+    removeFromCells(proxy);
+    proxies[proxy].alive = false;
+    proxies[proxy].userData = nullptr;
+    proxies[proxy].nextFree = freeList;
+    freeList = proxy;
+    proxyCount--;
+}
+
+bool SpatialGrid::moveProxy(const int proxy, const BoundingBox& box) {
+    Proxy moved = proxies[proxy];
+    moved.box = box;
+    computeRange(moved);
+    const Proxy& old = proxies[proxy];
+    // 占用的格子没变, 只需要更新包围盒
+    if (moved.large == old.large && moved.minX == old.minX && moved.minZ == old.minZ &&
+        moved.maxX == old.maxX && moved.maxZ == old.maxZ) {
+        proxies[proxy].box = box;
+        return false;
+    }
+    removeFromCells(proxy);
+    proxies[proxy] = moved;
+    addToCells(proxy);
+    return true;
+}
+
+void SpatialGrid::computeRange(Proxy& proxy) const {
+    proxy.minX = cellMin(proxy.box.min.x);
+    proxy.minZ = cellMin(proxy.box.min.z);
+    proxy.maxX = std::max(cellMax(proxy.box.max.x), proxy.minX);
+    proxy.maxZ = std::max(cellMax(proxy.box.max.z), proxy.minZ);
+    const int64_t cellCount = static_cast<int64_t>(proxy.maxX - proxy.minX + 1) * (proxy.maxZ - proxy.minZ + 1);
+    proxy.large = cellCount > MAX_CELLS_PER_PROXY;
+}
+
+void SpatialGrid::addToCells(const int proxy) {
+    const Proxy& p = proxies[proxy];
+    if (p.large) {
+        largeProxies.push_back(proxy);
+        return;
+    }
+    for (int x = p.minX; x <= p.maxX; x++) {
+        for (int z = p.minZ; z <= p.maxZ; z++) {
+            Cell& cell = cells[cellKey(x, z)];
+            if (cell.first == NULL_PROXY) {
+                cell.first = proxy;
+            } else {
+                cell.overflow.push_back(proxy);
+            }
+        }
+    }
+}
+
+void SpatialGrid::removeFromCells(const int proxy) {
+    const Proxy& p = proxies[proxy];
+    if (p.large) {
+        std::erase(largeProxies, proxy);
+        return;
+    }
+    for (int x = p.minX; x <= p.maxX; x++) {
+        for (int z = p.minZ; z <= p.maxZ; z++) {
+            const auto it = cells.find(cellKey(x, z));
+            if (it == cells.end()) {
+                continue;
+            }
+            // 格子里通常只有一两个代理, 与末尾交换后删除
+            Cell& cell = it->second;
+            if (cell.first == proxy) {
+                if (cell.overflow.empty()) {
+                    cells.erase(it);
+                    continue;
+                }
+                cell.first = cell.overflow.back();
+                cell.overflow.pop_back();
+            } else {
+                const auto found = std::find(cell.overflow.begin(), cell.overflow.end(), proxy);
+                if (found != cell.overflow.end()) {
+                    *found = cell.overflow.back();
+                    cell.overflow.pop_back();
+                }
+            }
+        }
+    }
+}
+
+// ===============================================================
+// ===Broadphase接口===============================================
+// ===============================================================
+
+void SpatialGrid::insert(GeometryInstance* instance) {
+    if (proxyOf.contains(instance)) {
+        return;
+    }
+    proxyOf[instance] = createProxy(instance->getBoundingBox(), instance);
+}
+
+void SpatialGrid::remove(GeometryInstance* instance) {
+    const auto it = proxyOf.find(instance);
+    if (it == proxyOf.end()) {
+        return;
+    }
+    destroyProxy(it->second);
+    proxyOf.erase(it);
+}
+
+void SpatialGrid::update(GeometryInstance* instance) {
+    const auto it = proxyOf.find(instance);
+    if (it == proxyOf.end()) {
+        return;
+    }
+    moveProxy(it->second, instance->getBoundingBox());
+}
+
+void SpatialGrid::query(const BoundingBox& box, std::vector<GeometryInstance*>& result) const {
+    query(box, [&](const int proxy) {
+        result.push_back(proxies[proxy].userData);
+        return true;
+    });
+}
+
+size_t SpatialGrid::getMemoryUsage() const {
+    size_t bytes = proxies.capacity() * sizeof(Proxy) + largeProxies.capacity() * sizeof(int);
+    // 哈希表: 桶数组 + 每个节点(键值对和next指针)
+    bytes += cells.bucket_count() * sizeof(void*);
+    bytes += cells.size() * (sizeof(std::pair<const int64_t, Cell>) + sizeof(void*));
+    for (const auto& [key, cell] : cells) {
+        bytes += cell.overflow.capacity() * sizeof(int);
+    }
+    bytes += proxyOf.bucket_count() * sizeof(void*);
+    bytes += proxyOf.size() * (sizeof(std::pair<GeometryInstance* const, int>) + sizeof(void*));
+    return bytes;
+}
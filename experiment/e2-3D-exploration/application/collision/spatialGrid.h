@@ -0,0 +1,179 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "broadphase.h"
+
+/**
+ * 均匀网格(空间哈希)
+ * 迷宫本身就是整数网格, 把XZ平面按cellSize划分为格子, 每个格子记录与它重叠的实例(Y方向不划分).
+ * 格子用哈希表存储, 世界大小没有限制. 查询时只需要访问查询范围覆盖的几个格子, 与实例总数无关
+ *
+ * 格子以整数坐标为中心: 格子i覆盖[(i - 0.5) * cellSize, (i + 0.5) * cellSize), 这样对齐到整数坐标的1x1方块正好只占一个格子
+ * 覆盖格子过多的大物体(比如地面)不放进格子, 单独存放, 每次查询都会检查
+ */
+class SpatialGrid : public Broadphase {
+public:
+    // 一个实例最多占用的格子数, 超过的按大物体处理
+    static constexpr int MAX_CELLS_PER_PROXY = 16;
+    static constexpr int NULL_PROXY = -1;
+
+    explicit SpatialGrid(float cellSize = 1.0f);
+    ~SpatialGrid() override = default;
+
+    // ===底层接口: 直接操作代理===
+    int createProxy(const BoundingBox& box, GeometryInstance* userData);
+    void destroyProxy(int proxy);
+    // 更新代理的包围盒, 只有所在格子变化时才会修改格子. 返回值表示格子是否变化
+    bool moveProxy(int proxy, const BoundingBox& box);
+
+    GeometryInstance* getUserData(const int proxy) const { return proxies[proxy].userData; }
+    const BoundingBox& getBox(const int proxy) const { return proxies[proxy].box; }
+
+    // 查询与box相交的代理. callback(int proxy)返回false时提前结束
+    template <typename Callback>
+    void query(const BoundingBox& box, Callback&& callback) const;
+    // 查询position所在格子及其周围3x3格子中的所有代理
+    template <typename Callback>
+    void queryNeighborhood(const glm::vec3& position, Callback&& callback) const;
+
+    // ===Broadphase接口===
+    void insert(GeometryInstance* instance) override;
+    void remove(GeometryInstance* instance) override;
+    void update(GeometryInstance* instance) override;
+    void query(const BoundingBox& box, std::vector<GeometryInstance*>& result) const override;
+
+    // 统计信息
+    size_t getCellCount() const { return cells.size(); }
+    size_t getProxyCount() const { return proxyCount; }
+    size_t getLargeProxyCount() const { return largeProxies.size(); }
+    float getCellSize() const { return cellSize; }
+    // 估算占用的内存(字节), 包括代理数组, 哈希表的桶和节点以及每个格子的列表
+    size_t getMemoryUsage() const;
+
+private:
+    struct Proxy {
+        BoundingBox box;
+        GeometryInstance* userData{nullptr};
+        // 覆盖的格子范围(闭区间)
+        int minX{0}, minZ{0}, maxX{0}, maxZ{0};
+        bool large{false};
+        bool alive{false};
+        // 空闲链表
+        int nextFree{NULL_PROXY};
+        // 一个代理可能在多个格子里, 用查询编号去重
+        mutable uint32_t queryStamp{0};
+    };
+
+    // 迷宫中绝大多数格子只有一个代理, 第一个代理直接存放在格子里, 避免为每个格子单独分配内存
+    struct Cell {
+        int first{NULL_PROXY};
+        std::vector<int> overflow;
+    };
+
+    float cellSize{1.0f};
+    float inverseCellSize{1.0f};
+
+    std::vector<Proxy> proxies;
+    int freeList{NULL_PROXY};
+    size_t proxyCount{0};
+    // 格子坐标 -> 格子中的代理
+    std::unordered_map<int64_t, Cell> cells;
+    std::vector<int> largeProxies;
+    std::unordered_map<GeometryInstance*, int> proxyOf;
+    mutable uint32_t queryStamp{0};
+
+    static int64_t cellKey(const int x, const int z) {
+        return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(z);
+    }
+    int cellMin(const float v) const { return static_cast<int>(std::floor(v * inverseCellSize + 0.5f)); }
+    // 上界用ceil - 1, 正好落在格子边界上的包围盒不会多占一个格子
+    int cellMax(const float v) const { return static_cast<int>(std::ceil(v * inverseCellSize + 0.5f)) - 1; }
+
+    void computeRange(Proxy& proxy) const;
+    void addToCells(int proxy);
+    void removeFromCells(int proxy);
+
+    template <typename Callback>
+    bool visitCell(int x, int z, const BoundingBox* box, Callback& callback) const;
+    template <typename Callback>
+    bool visitProxy(int index, const BoundingBox* box, Callback& callback) const;
+};
+
+template <typename Callback>
+bool SpatialGrid::visitProxy(const int index, const BoundingBox* box, Callback& callback) const {
+    const Proxy& proxy = proxies[index];
+    if (proxy.queryStamp == queryStamp) {
+        return true;
+    }
+    proxy.queryStamp = queryStamp;
+    if (box && !isCollide(proxy.box, *box)) {
+        return true;
+    }
+    return callback(index);
+}
+
+template <typename Callback>
+bool SpatialGrid::visitCell(const int x, const int z, const BoundingBox* box, Callback& callback) const {
+    const auto it = cells.find(cellKey(x, z));
+    if (it == cells.end()) {
+        return true;
+    }
+    const Cell& cell = it->second;
+    if (!visitProxy(cell.first, box, callback)) {
+        return false;
+    }
+    for (const int index : cell.overflow) {
+        if (!visitProxy(index, box, callback)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Callback>
+void SpatialGrid::query(const BoundingBox& box, Callback&& callback) const {
+    queryStamp++;
+    for (const int index : largeProxies) {
+        if (isCollide(proxies[index].box, box) && !callback(index)) {
+            return;
+        }
+    }
+    const int minX = cellMin(box.min.x), maxX = cellMax(box.max.x);
+    const int minZ = cellMin(box.min.z), maxZ = cellMax(box.max.z);
+    for (int x = minX; x <= maxX; x++) {
+        for (int z = minZ; z <= maxZ; z++) {
+            if (!visitCell(x, z, &box, callback)) {
+                return;
+            }
+        }
+    }
+}
+
+template <typename Callback>
+void SpatialGrid::queryNeighborhood(const glm::vec3& position, Callback&& callback) const {
+    queryStamp++;
+    for (const int index : largeProxies) {
+        if (!callback(index)) {
+            return;
+        }
+    }
+    const int cx = cellMin(position.x), cz = cellMin(position.z);
+    for (int x = cx - 1; x <= cx + 1; x++) {
+        for (int z = cz - 1; z <= cz + 1; z++) {
+            if (!visitCell(x, z, nullptr, callback)) {
+                return;
+            }
+        }
+    }
+}
+
+#endif //SPATIALGRID_H
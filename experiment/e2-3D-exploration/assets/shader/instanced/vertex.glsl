@@ -0,0 +1,26 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aColor;
+layout (location = 2) in vec2 aTexCoord;
+// 每个实例的模型变换矩阵. mat4占用location 3~6, 由glVertexAttribDivisor设置为每个实例前进一次
+layout (location = 3) in mat4 aInstanceMatrix;
+
+out vec3 color;
+// 输出纹理坐标到片段着色器
+out vec2 uvTexCoord;
+
+// 视图变换矩阵(view matrix)
+uniform mat4 viewMatrix;
+// 投影变换矩阵(projection matrix)
+uniform mat4 projectionMatrix;
+
+void main() {
+    // 变换顶点坐标
+    vec4 position = vec4(aPos, 1.0);
+    // 变换顺序: 模型变换(来自实例属性) -> 视图变换 -> 投影变换
+    position = projectionMatrix * viewMatrix * aInstanceMatrix * position;
+
+    gl_Position = position;
+    color = aColor;
+    uvTexCoord = aTexCoord;
+}
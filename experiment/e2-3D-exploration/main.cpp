@@ -1,4 +1,6 @@
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <thread>
 
 #include "core.h"
@@ -10,7 +12,18 @@
 #include "application/camera/perspectiveCamera.h"
 #include "application/camera/gameCameraController.h"
 #include "application/camera/gameControlMoveStrategy.h"
+#include "application/collision/spatialGrid.h"
+#include "application/collision/broadphaseBenchmark.h"
+#include "GLconfig/frustumCulling.h"
+#include "GLconfig/frustumCullingBenchmark.h"
 #include "GLconfig/geometry.h"
+#include "GLconfig/geometryPool.h"
+#include "GLconfig/geometryPoolBenchmark.h"
+#include "GLconfig/instancedRenderer.h"
+#include "GLconfig/instancedRendererBenchmark.h"
+#include "GLconfig/staticBatch.h"
+#include "GLconfig/staticBatchBenchmark.h"
+#include "GLconfig/transformStoreBenchmark.h"
 #include "shader.h"
 #include "application/util.h"
 
@@ -18,6 +31,20 @@
 
 // 封装的着色器程序对象
 Shader* shader = nullptr;
+// 静态合批使用的着色器(顶点已在世界空间, 模型矩阵用uniform传单位阵)
+Shader* staticShader = nullptr;
+// 实例化渲染器. 共享同一个几何体的实例合并为一次draw call
+InstancedRenderer* instancedRenderer = nullptr;
+// 静态合批. 迷宫墙体和地面预先合并为少数几个大网格
+StaticBatcher* staticBatcher = nullptr;
+// 碰撞检测的粗检测结构(均匀网格). 迷宫对齐到整数网格, 每帧只需检查相机周围的几个格子
+SpatialGrid* collisionGrid = nullptr;
+// 视锥剔除. 每帧把动态实例的包围球写入SoA数组, 只提交视锥内的实例
+FrustumCuller* frustumCuller = nullptr;
+std::vector<GeometryInstance*> cullingCandidates;
+// 命令行线程中修改场景的命令. 渲染线程在每帧开始时执行, 避免与渲染循环同时访问几何体, 批次和网格
+std::mutex pendingCommandsMutex;
+std::vector<std::function<void()>> pendingCommands;
 // 相机及其控制器对象
 PerspectiveCamera* perspectiveCamera = nullptr;
 Camera * currentCamera = nullptr; // 当前使用的相机
@@ -61,10 +88,17 @@ void mouseScrollCallback(const double offsetX, const double offsetY) {
 
 // 定义和编译着色器
 void prepareShader() {
+    // 模型矩阵作为per-instance顶点属性传入, 而不是uniform
     shader = new Shader(
+        "assets/shader/instanced/vertex.glsl",
+        "assets/shader/instanced/fragment.glsl"
+    );
+    staticShader = new Shader(
         "assets/shader/default/vertex.glsl",
         "assets/shader/default/fragment.glsl"
     );
+    instancedRenderer = new InstancedRenderer();
+    frustumCuller = new FrustumCuller();
 }
 
 // 创建几何体, 组成地图场景
@@ -116,8 +150,11 @@ void prepareGeometries() {
             if (maze[i][j] == 1) {
                 auto* brickBlockInstance = new GeometryInstance(brickBlock, j, 0.5f, -i);
                 // brickBlockInstance->scale(glm::vec3(2, 2, 2));
+                // 墙体创建后就不会再动, 交给静态合批
+                brickBlockInstance->isStatic = true;
                 geometries.push_back(brickBlockInstance);
                 brickBlockInstance = new GeometryInstance(stoneBrickBlock, j, 1.5f, -i);
+                brickBlockInstance->isStatic = true;
                 geometries.push_back(brickBlockInstance);
             }
             cout << maze[i][j] << " ";
@@ -126,7 +163,23 @@ void prepareGeometries() {
     }
 
     auto* floorPlaneInstance = new GeometryInstance(floorPlane, 0, 0, 0);
+    floorPlaneInstance->isStatic = true;
     geometries.push_back(floorPlaneInstance);
+
+    // 合并所有静态实例
+    staticBatcher = new StaticBatcher();
+    for (const auto instance : geometries) {
+        staticBatcher->add(instance);
+    }
+    staticBatcher->rebuildDirty();
+
+    // 参与碰撞检测的实例放进均匀网格
+    collisionGrid = new SpatialGrid();
+    for (const auto instance : geometries) {
+        if (instance->detectCollision) {
+            collisionGrid->insert(instance);
+        }
+    }
 }
 
 // 摄像机状态
@@ -146,6 +199,8 @@ void prepareCamera() {
     gameCameraController = new GameCameraController(new OrthoMove());
     // 初始化游戏控制方式下的相机碰撞体积
     gameCameraController->setBoundingSpace(currentCamera, 0.2f);
+    // 碰撞检测只检查网格中相机附近的实例
+    gameCameraController->setBroadphase(collisionGrid);
     // 设置当前的相机控制器
     currentCameraController = gameCameraController;
     // 游戏控制模式下隐藏并捕获鼠标光标
@@ -161,19 +216,93 @@ void prepareState() {
     glClearDepth(1.0f); // 设置清除时的深度值. 默认值也为1.0f(远平面)
 }
 
+// 命令行线程: 把访问场景的操作交给渲染线程
+void runOnRenderThread(std::function<void()> task) {
+    std::lock_guard lock(pendingCommandsMutex);
+    pendingCommands.push_back(std::move(task));
+}
+
+// 渲染线程: 执行命令行线程提交的操作
+void runPendingCommands() {
+    std::vector<std::function<void()>> tasks;
+    {
+        std::lock_guard lock(pendingCommandsMutex);
+        tasks.swap(pendingCommands);
+    }
+    for (const auto& task : tasks) {
+        task();
+    }
+}
+
 // 命令行线程
 void command() {
     std::string cmd;
     while (true) {
         std::cin >> cmd;
         if (cmd == "/clear") {
-            geometries.clear();
-            std::cout << "cleared all geometries" << std::endl;
+            // 渲染循环正在遍历批次和网格, 删除放到下一帧开始时进行. 静态批次只标记需要重建, GL资源在rebuildDirty中释放
+            runOnRenderThread([] {
+                for (const auto geometry : geometries) {
+                    staticBatcher->remove(geometry);
+                    collisionGrid->remove(geometry);
+                }
+                geometries.clear();
+                std::cout << "cleared all geometries" << std::endl;
+            });
+        } else if (cmd == "/raise") {
+            // 编辑静态实例: 每次把下一个合批的实例升高一格. 只标记它所在的区域, 下一帧rebuildDirty只重建这个区域
+            runOnRenderThread([] {
+                static size_t next = 0;
+                for (; next < geometries.size(); next++) {
+                    GeometryInstance* instance = geometries[next];
+                    if (!staticBatcher->contains(instance)) {
+                        continue;
+                    }
+                    instance->translate(glm::vec3(0.0f, 1.0f, 0.0f));
+                    staticBatcher->markDirty(instance);
+                    if (instance->detectCollision) {
+                        collisionGrid->update(instance);
+                    }
+                    std::cout << "raised static instance to " << glm::to_string(instance->getWorldCenter()) << std::endl;
+                    next++;
+                    return;
+                }
+                std::cout << "no static instance to raise" << std::endl;
+            });
         } else if (cmd == "/center") {
-            std::cout << "geometries center: " << std::endl;
-            for (const auto geometry : geometries) {
-                std::cout << glm::to_string(geometry->getWorldCenter()) << std::endl;
-            }
+            runOnRenderThread([] {
+                std::cout << "geometries center: " << std::endl;
+                for (const auto geometry : geometries) {
+                    std::cout << glm::to_string(geometry->getWorldCenter()) << std::endl;
+                }
+            });
+        } else if (cmd == "/stats") {
+            runOnRenderThread([] {
+                std::cout << "instances: " << instancedRenderer->getInstanceCount()
+                          << ", draw calls: " << instancedRenderer->getDrawCallCount() << std::endl;
+                std::cout << "static instances: " << staticBatcher->getInstanceCount()
+                          << ", static batches: " << staticBatcher->getBatchCount()
+                          << ", drawn batches: " << staticBatcher->getDrawnBatchCount() << std::endl;
+                const GeometryStats& geometryStats = GeometryPool::getStats();
+                std::cout << "meshes: " << GEOMETRY_POOL->getMeshCount()
+                          << ", textures: " << GEOMETRY_POOL->getTextureCount()
+                          << ", GL buffers: " << geometryStats.buffers
+                          << ", VAOs: " << geometryStats.vertexArrays
+                          << ", buffer bytes: " << geometryStats.bufferBytes
+                          << ", mesh hits/misses: " << geometryStats.meshHits << "/" << geometryStats.meshMisses << std::endl;
+                std::cout << "culling path: " << FrustumCuller::getPathName(frustumCuller->getPath())
+                          << ", tested: " << frustumCuller->getTestedCount()
+                          << ", culled: " << frustumCuller->getCulledCount() << std::endl;
+            });
+        } else if (cmd == "/bench") {
+            runBroadphaseBenchmarks();
+            runMazeGridBenchmarks();
+            runFrustumCullingBenchmarks();
+            runTransformStoreBenchmarks();
+            runInstancedRendererBenchmarks();
+            runStaticBatchBenchmarks();
+            // 几何体池的测试会创建GL对象, 在渲染线程中执行
+            runOnRenderThread(runGeometryPoolBenchmarks);
         } else if (cmd == "/exit") {
             APP->closeWindow();
             std::cout << "shutting down..." << std::endl;
@@ -186,29 +315,56 @@ void command() {
 
 // 执行渲染操作
 void render() {
+    // 先执行命令行线程提交的修改, 本帧之后的部分不会与它们并发
+    runPendingCommands();
+
     // 执行画布清理操作(用glClearColor设置的颜色来清理(填充)画布)
     GL_CALL(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
 
     // 相机在每一帧都需要更新的操作. 比如游戏相机的WSAD移动
     currentCameraController->update();
 
+    // 每帧从相机矩阵中提取一次视锥体
+    const glm::mat4 viewMatrix = currentCamera->getViewMatrix();
+    const glm::mat4 projectionMatrix = currentCamera->getProjectionMatrix();
+    const Frustum frustum = Frustum::fromMatrix(projectionMatrix * viewMatrix);
+
+    // 静态批次: 重建被修改过的区域后绘制视锥内的批次
+    staticBatcher->rebuildDirty();
+    staticShader->begin();
+    staticShader->setInt("sampler", 0);
+    staticShader->setMat4("viewMatrix", viewMatrix);
+    staticShader->setMat4("projectionMatrix", projectionMatrix);
+    staticBatcher->draw(staticShader, "transform", &frustum);
+
     shader->begin();
 
     shader->setInt("sampler", 0);
-    shader->setMat4("viewMatrix", currentCamera->getViewMatrix());
-    shader->setMat4("projectionMatrix", currentCamera->getProjectionMatrix());
+    shader->setMat4("viewMatrix", viewMatrix);
+    shader->setMat4("projectionMatrix", projectionMatrix);
 
-    // 循环渲染所有的几何体
+    // 更新所有动态的几何体实例, 并收集它们的包围球
+    frustumCuller->clear();
+    cullingCandidates.clear();
     for (const auto instance : geometries) {
-        const Geometry* geometry = instance->geometry;
-        // 绑定几何体对应的模型的VAO
-        geometry->bind();
+        if (staticBatcher->contains(instance)) {
+            continue;
+        }
         instance->update();
-        // 设置变换矩阵
-        shader->setMat4("transform", instance->getModelMatrix());
-        // 绘制几何体
-        glDrawElements(geometry->getPrimitiveType(), geometry->getIndicesCount(), GL_UNSIGNED_INT, nullptr);
+        // 动态实例移动后同步到网格(仍在原来的格子内时不会修改格子)
+        if (instance->detectCollision) {
+            collisionGrid->update(instance);
+        }
+        frustumCuller->add(instance->getBoundingSphere());
+        cullingCandidates.push_back(instance);
+    }
+    // 视锥内的实例按几何体分组后每组只绘制一次
+    frustumCuller->cull(frustum);
+    instancedRenderer->begin();
+    for (const uint32_t index : frustumCuller->getVisible()) {
+        instancedRenderer->submit(cullingCandidates[index]);
     }
+    instancedRenderer->flush();
 
     Shader::end();
 }
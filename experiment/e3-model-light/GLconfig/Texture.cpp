@@ -111,3 +111,44 @@ GLuint Texture::TextureFromFile(const char *path, const std::string &directory)
 
     return textureID;
 }
+
+bool Texture::decodeImage(const std::string& path, const TextureParams& params, DecodedImage& image) {
+    stbi_set_flip_vertically_on_load_thread(params.flipVertically);
+    unsigned char* data = stbi_load(path.c_str(), &image.width, &image.height, &image.channels, params.desiredChannels);
+    if (!data) {
+        std::cout << "Texture failed to load at path: " << path << std::endl;
+        return false;
+    }
+    // channels返回的是文件中的通道数, 转换后以转换的为准
+    if (params.desiredChannels != 0) {
+        image.channels = params.desiredChannels;
+    }
+    image.pixels.assign(data, data + (size_t)image.width * image.height * image.channels);
+    stbi_image_free(data);
+    return true;
+}
+
+GLuint Texture::createFromImage(const DecodedImage& image, const TextureParams& params) {
+    GLenum format = GL_RGBA;
+    if (image.channels == 1)
+        format = GL_RED;
+    else if (image.channels == 2)
+        format = GL_RG;
+    else if (image.channels == 3)
+        format = GL_RGB;
+
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    // 行宽不一定是4字节的倍数(单通道或三通道)
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint)format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, params.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, params.wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, params.magFilter);
+    return textureID;
+}
@@ -6,6 +6,30 @@
 #define TEXTURE_H
 #include "core.h"
 #include <string>
+#include <vector>
+
+// 解码后的图像数据, 不涉及OpenGL, 可以在工作线程中生成
+struct DecodedImage {
+    int width{0};
+    int height{0};
+    int channels{0};
+    std::vector<unsigned char> pixels;
+};
+
+// 纹理的解码和采样参数. 同一张图片用不同的参数加载是不同的纹理(见TextureCache)
+struct TextureParams {
+    bool flipVertically{false};
+    // 解码时转换成的通道数, 0表示保持文件中的通道数
+    int desiredChannels{0};
+    GLint minFilter{GL_LINEAR_MIPMAP_LINEAR};
+    GLint magFilter{GL_LINEAR};
+    GLint wrap{GL_REPEAT};
+
+    // 模型纹理: 不翻转, 三线性过滤(与TextureFromFile相同)
+    static TextureParams model() { return {}; }
+    // 几何体纹理: 翻转, RGBA, 放大时不插值(与Texture的构造函数相同)
+    static TextureParams nearest() { return {true, 4, GL_NEAREST_MIPMAP_LINEAR, GL_NEAREST, GL_REPEAT}; }
+};
 
 /**
  * 纹理类, 调用了OpenGL的自动MipMap实现
@@ -27,6 +51,10 @@ public:
 
     // 仅加载纹理返回纹理对象ID, 不绑定纹理单元
     static GLuint TextureFromFile(const char* path, const std::string& directory);
+    // 只解码图片, 可以在任意线程调用. 翻转只对当前线程生效, 不受其他地方设置的全局翻转影响
+    static bool decodeImage(const std::string& path, const TextureParams& params, DecodedImage& image);
+    // 用解码后的图像创建纹理对象, 需要在OpenGL线程调用
+    static GLuint createFromImage(const DecodedImage& image, const TextureParams& params = {});
 private:
     GLuint texture{0}; // OpenGL纹理对象
     int width{0}; // 纹理宽高
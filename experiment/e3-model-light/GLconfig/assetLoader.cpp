@@ -0,0 +1,117 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "assetLoader.h"
+
+AssetLoader::AssetLoader(UploadBackend& backend, uint32_t workerCount) : backend(backend) {
+    if (workerCount == 0) {
+        workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+    for (uint32_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(&AssetLoader::workerLoop, this);
+    }
+}
+
+AssetLoader::~AssetLoader() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+        loadQueue.clear();
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+AssetLoader::Handle AssetLoader::submit(AssetRequest request) {
+    Handle handle;
+    {
+        std::lock_guard lock(mutex);
+        handle = (Handle)assets.size();
+        assets.push_back(std::make_unique<Asset>());
+        assets.back()->request = std::move(request);
+        loadQueue.push_back(handle);
+    }
+    wake.notify_one();
+    return handle;
+}
+
+void AssetLoader::workerLoop() {
+    while (true) {
+        Handle handle;
+        Asset* asset;
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this] { return stopping || !loadQueue.empty(); });
+            if (stopping) {
+                return;
+            }
+            handle = loadQueue.front();
+            loadQueue.pop_front();
+            asset = assets[handle].get();
+            asset->state = AssetState::Loading;
+        }
+
+        const bool loaded = asset->request.load ? asset->request.load() : true;
+
+        std::lock_guard lock(mutex);
+        if (loaded) {
+            asset->state = AssetState::Uploading;
+            uploadQueue.push_back(handle);
+        } else {
+            asset->state = AssetState::Failed;
+            asset->request.load = nullptr;
+            asset->request.upload = nullptr;
+            std::cout << "ERROR::ASSET_LOADER::failed to load " << asset->request.name << std::endl;
+        }
+    }
+}
+
+uint32_t AssetLoader::update(const double budgetMs) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    uint32_t steps = 0;
+    while (true) {
+        Asset* asset;
+        {
+            std::lock_guard lock(mutex);
+            if (uploadQueue.empty()) {
+                break;
+            }
+            asset = assets[uploadQueue.front()].get();
+        }
+        // 上传只在GL线程中进行, 队首在这里不会被其他线程改变
+        const bool finished = asset->request.upload ? asset->request.upload(backend) : true;
+        steps++;
+        if (finished) {
+            std::lock_guard lock(mutex);
+            uploadQueue.pop_front();
+            asset->state = AssetState::Ready;
+            // 闭包可能持有大量的CPU端数据(解码的图像, 导入的网格), 上传完就释放
+            asset->request.load = nullptr;
+            asset->request.upload = nullptr;
+        }
+        if (std::chrono::duration<double, std::milli>(Clock::now() - start).count() >= budgetMs) {
+            break;
+        }
+    }
+    return steps;
+}
+
+AssetState AssetLoader::getState(const Handle handle) const {
+    std::lock_guard lock(mutex);
+    return assets[handle]->state;
+}
+
+bool AssetLoader::isIdle() const {
+    std::lock_guard lock(mutex);
+    return std::all_of(assets.begin(), assets.end(), [](const std::unique_ptr<Asset>& asset) {
+        return asset->state == AssetState::Ready || asset->state == AssetState::Failed;
+    });
+}
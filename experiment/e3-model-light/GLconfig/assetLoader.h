@@ -0,0 +1,88 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "uploadBackend.h"
+
+enum class AssetState {
+    Queued,    // 等待工作线程
+    Loading,   // 工作线程正在读取, 解析和解码
+    Uploading, // 等待或正在GL线程中上传
+    Ready,
+    Failed
+};
+
+// 一个资源的加载过程, 分为两个阶段
+struct AssetRequest {
+    // 只用于打印
+    std::string name;
+    // 在工作线程中执行: 读取文件, 解析, 解码. 不能调用OpenGL. 返回false表示失败, 不再上传
+    std::function<bool()> load;
+    // 在GL线程中反复执行, 每次上传一小块(一张纹理或一个网格), 返回true表示全部完成
+    std::function<bool(UploadBackend&)> upload;
+};
+
+/**
+ * 异步资源加载器. 原来的Model在构造函数中依次解析文件, 解码纹理, 上传到GPU, 第一帧要等它们全部完成
+ *  - 工作线程从队列中取出请求执行load, 完成后放入上传队列
+ *  - GL线程每帧调用update, 按提交顺序执行上传步骤, 直到用完这一帧的时间预算. 每帧至少执行一步, 保证进度
+ *    (单个步骤本身超过预算时这一帧会超出, 例如非常大的网格)
+ *  - 资源就绪之前, 使用者自己决定画什么(占位几何体), 通过getState查询状态
+ * 请求中的闭包引用的对象(例如Model)必须存活到资源变为Ready或Failed
+ */
+class AssetLoader {
+public:
+    using Handle = uint32_t;
+
+    // workerCount为0时使用硬件线程数减一(至少一个)
+    explicit AssetLoader(UploadBackend& backend, uint32_t workerCount = 0);
+    // 停止工作线程. 还在排队的请求被丢弃, 正在执行的load会执行完
+    ~AssetLoader();
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    Handle submit(AssetRequest request);
+    // 在GL线程中每帧调用. 返回这一帧执行的上传步骤数
+    uint32_t update(double budgetMs);
+
+    AssetState getState(Handle handle) const;
+    // 没有排队, 加载中或者等待上传的资源
+    bool isIdle() const;
+    UploadBackend& getBackend() const { return backend; }
+
+    // 一帧的默认上传预算(毫秒)
+    static constexpr double DEFAULT_BUDGET_MS = 2.0;
+
+private:
+    struct Asset {
+        AssetRequest request;
+        AssetState state{AssetState::Queued};
+    };
+
+    UploadBackend& backend;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping{false};
+    // 资源的地址在整个生命周期内不变, 工作线程可以在不持有锁时使用
+    std::vector<std::unique_ptr<Asset>> assets;
+    std::deque<Handle> loadQueue;
+    std::deque<Handle> uploadQueue;
+    std::vector<std::thread> workers;
+
+    void workerLoop();
+};
+
+#endif //ASSETLOADER_H
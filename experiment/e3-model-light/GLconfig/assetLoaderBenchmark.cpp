@@ -0,0 +1,177 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "assetLoaderBenchmark.h"
+#include "benchmarkCheck.h"
+#include "assetLoader.h"
+#include "meshGenerator.h"
+
+using namespace benchmark;
+
+namespace {
+    // 模拟一个模型: 工作线程中解码纹理并处理网格, 上传时每步一个纹理或一个网格
+    struct FakeModel {
+        std::vector<std::string> imagePaths;
+        std::vector<DecodedImage> images;
+        std::vector<CookedMesh> cooked;
+        std::vector<Mesh> meshes;
+        std::vector<GLuint> textures;
+        size_t next{0};
+    };
+
+    AssetRequest makeModelRequest(const std::shared_ptr<FakeModel>& model, const std::string& name) {
+        AssetRequest request;
+        request.name = name;
+        request.load = [model] {
+            model->images.resize(model->imagePaths.size());
+            for (size_t i = 0; i < model->imagePaths.size(); i++) {
+                if (!Texture::decodeImage(model->imagePaths[i], TextureParams::model(), model->images[i])) {
+                    return false;
+                }
+            }
+            const GeneratedMesh sphere = MeshGenerator::sphere(1.0f, 48, 48);
+            std::vector<Vertex> vertices(sphere.vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++) {
+                vertices[i].position = sphere.vertices[i].position;
+                unpackVertex(sphere.vertices[i], sphere.uvScale, vertices[i].normal, vertices[i].uv);
+            }
+            model->cooked.push_back(Mesh::cook(vertices, {sphere.indices.begin(), sphere.indices.end()}, 2, "sphere"));
+            model->cooked.push_back(Mesh::cook(std::move(vertices), {sphere.indices.begin(), sphere.indices.end()}, 0, "sphere2"));
+            return true;
+        };
+        request.upload = [model](UploadBackend& backend) {
+            if (model->next < model->images.size()) {
+                model->textures.push_back(backend.createTexture(model->images[model->next++], TextureParams::model()));
+                return false;
+            }
+            const size_t mesh = model->next++ - model->images.size();
+            const MeshView view = model->cooked[mesh].view();
+            model->meshes.emplace_back(view, std::vector<TextureInfo>{}, backend.uploadMesh(view));
+            return mesh + 1 == model->cooked.size();
+        };
+        return request;
+    }
+
+    // 每帧调用update, 直到没有待处理的资源. 返回帧数
+    uint32_t runFrames(AssetLoader& loader, const double budgetMs, uint32_t* maxSteps = nullptr, double* maxFrameMs = nullptr) {
+        uint32_t frames = 0;
+        const auto start = Clock::now();
+        while (!loader.isIdle() && elapsedMs(start) < 10000.0) {
+            const auto frameStart = Clock::now();
+            const uint32_t steps = loader.update(budgetMs);
+            const double frameMs = elapsedMs(frameStart);
+            if (steps > 0) {
+                frames++;
+                if (maxSteps) *maxSteps = std::max(*maxSteps, steps);
+                if (maxFrameMs) *maxFrameMs = std::max(*maxFrameMs, frameMs);
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        return frames;
+    }
+}
+
+void checkAssetLoaderStates() {
+    std::cout << "asset loader states:" << std::endl;
+    const std::string diffuse = writeImage(std::filesystem::temp_directory_path() / "e3_asset_diffuse.ppm", 64, 32);
+    const std::string specular = writeImage(std::filesystem::temp_directory_path() / "e3_asset_specular.ppm", 16, 16);
+
+    NullUploadBackend backend;
+    AssetLoader loader(backend, 2);
+
+    // 加载阶段被阻塞时状态停在Queued/Loading, 上传队列为空
+    std::atomic<bool> release{false};
+    AssetRequest blocked;
+    blocked.name = "blocked";
+    blocked.load = [&release] {
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    };
+    blocked.upload = [](UploadBackend&) { return true; };
+    const AssetLoader::Handle blockedHandle = loader.submit(std::move(blocked));
+
+    auto model = std::make_shared<FakeModel>();
+    model->imagePaths = {diffuse, specular};
+    const AssetLoader::Handle modelHandle = loader.submit(makeModelRequest(model, "model"));
+
+    auto missing = std::make_shared<FakeModel>();
+    missing->imagePaths = {diffuse + ".missing"};
+    const AssetLoader::Handle missingHandle = loader.submit(makeModelRequest(missing, "missing"));
+
+    const AssetState blockedState = loader.getState(blockedHandle);
+    check(blockedState == AssetState::Queued || blockedState == AssetState::Loading, "blocked asset waits in queued/loading");
+    check(loader.update(AssetLoader::DEFAULT_BUDGET_MS) == 0 || loader.getState(blockedHandle) != AssetState::Ready,
+          "nothing uploads before loading finishes");
+    release = true;
+
+    runFrames(loader, AssetLoader::DEFAULT_BUDGET_MS);
+    check(loader.getState(blockedHandle) == AssetState::Ready, "blocked asset becomes ready");
+    check(loader.getState(modelHandle) == AssetState::Ready, "model becomes ready");
+    check(loader.getState(missingHandle) == AssetState::Failed, "missing file fails");
+    check(model->textures.size() == 2 && model->meshes.size() == 2 && model->meshes[0].getLodCount() == 3,
+          "model uploaded 2 textures and 2 meshes (3 LOD levels)");
+    check(backend.textureCount == 2 && backend.meshCount == 2, "uploads went through the backend");
+    check(missing->textures.empty() && missing->meshes.empty(), "failed asset uploaded nothing");
+    std::cout << "  null backend received " << backend.uploadedBytes << " bytes" << std::endl;
+
+    std::filesystem::remove(diffuse);
+    std::filesystem::remove(specular);
+}
+
+void benchmarkAssetLoaderBudget() {
+    std::cout << "asset loader frame budget:" << std::endl;
+    // 每次上传模拟1ms, 预算3ms: 每帧最多3步(第3步开始时已用约2ms, 之后超出)
+    NullUploadBackend backend(1.0);
+    AssetLoader loader(backend, 1);
+
+    // 工作线程中很慢的加载: 第一帧不应该等它
+    AssetRequest slow;
+    slow.name = "slow";
+    slow.load = [] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        return true;
+    };
+    auto remaining = std::make_shared<uint32_t>(30);
+    slow.upload = [remaining](UploadBackend& uploader) {
+        uploader.createTexture(DecodedImage{}, TextureParams::model());
+        return --*remaining == 0;
+    };
+    const auto submitStart = Clock::now();
+    const AssetLoader::Handle handle = loader.submit(std::move(slow));
+    const auto frameStart = Clock::now();
+    loader.update(3.0);
+    const double firstFrameMs = elapsedMs(frameStart);
+    const double submitMs = std::chrono::duration<double, std::milli>(frameStart - submitStart).count();
+    check(firstFrameMs < 1.0 && loader.getState(handle) != AssetState::Ready,
+          "first frame does not wait for loading (submit " + std::to_string(submitMs) + " ms, update " +
+          std::to_string(firstFrameMs) + " ms)");
+
+    uint32_t maxSteps = 0;
+    double maxFrameMs = 0.0;
+    const uint32_t frames = runFrames(loader, 3.0, &maxSteps, &maxFrameMs);
+    std::cout << "  30 upload steps of 1 ms with a 3 ms budget: " << frames << " frames, at most " << maxSteps
+              << " steps and " << maxFrameMs << " ms per frame" << std::endl;
+    check(loader.getState(handle) == AssetState::Ready, "slow asset becomes ready");
+    check(maxSteps <= 3 && frames >= 10, "uploads are spread over frames within the budget");
+}
+
+void runAssetLoaderBenchmarks() {
+    beginChecks("asset loader");
+    checkAssetLoaderStates();
+    benchmarkAssetLoaderBudget();
+    endChecks();
+}
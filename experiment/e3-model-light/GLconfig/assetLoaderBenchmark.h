@@ -0,0 +1,21 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef ASSETLOADERBENCHMARK_H
+#define ASSETLOADERBENCHMARK_H
+
+/**
+ * 异步资源加载器的测试, 在窗口中按B键运行. 使用NullUploadBackend, 不需要OpenGL上下文
+ * 纹理用临时目录中生成的PPM图片(stb_image可以直接解码), 网格用生成器的网格经过Mesh::cook
+ */
+
+// 状态机: 排队 -> 加载 -> 上传 -> 就绪, 读取失败 -> 失败. 网格和纹理都经过上传接口
+void checkAssetLoaderStates();
+
+// 每帧的时间预算: 上传步骤模拟固定耗时, 检查每帧执行的步数; 加载很慢时update立即返回(第一帧不被阻塞)
+void benchmarkAssetLoaderBudget();
+
+void runAssetLoaderBenchmarks();
+
+#endif //ASSETLOADERBENCHMARK_H
@@ -0,0 +1,60 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef BENCHMARKCHECK_H
+#define BENCHMARKCHECK_H
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/**
+ * 按B键运行的测试(*Benchmark.cpp)共用的计时和检查
+ * 每组测试以beginChecks开始(打印标题, 清零失败数), 中间用check逐项打印PASS/FAIL, 最后endChecks打印结果
+ */
+namespace benchmark {
+    using Clock = std::chrono::steady_clock;
+
+    inline double elapsedMs(const Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // 当前这组测试中失败的检查数
+    inline int failures = 0;
+
+    inline void check(const bool condition, const std::string& name) {
+        if (!condition) {
+            failures++;
+        }
+        std::cout << "  " << (condition ? "PASS " : "FAIL ") << name << std::endl;
+    }
+
+    inline void beginChecks(const std::string& name) {
+        std::cout << "==========" << name << " benchmark==========" << std::endl;
+        failures = 0;
+    }
+
+    inline void endChecks() {
+        std::cout << (failures == 0 ? "all checks passed" : std::to_string(failures) + " checks FAILED") << std::endl;
+    }
+
+    // 写一张PPM图片(P6, 不依赖任何编码库): 红绿分量是坐标的渐变, 蓝色分量为blue. 返回文件路径
+    inline std::string writeImage(const std::filesystem::path& path, const int width, const int height,
+                                  const char blue = (char)128) {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream file(path, std::ios::binary);
+        file << "P6\n" << width << " " << height << "\n255\n";
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                const char pixel[3] = {(char)(x * 255 / width), (char)(y * 255 / height), blue};
+                file.write(pixel, 3);
+            }
+        }
+        return path.string();
+    }
+}
+
+#endif //BENCHMARKCHECK_H
@@ -5,24 +5,15 @@
 #include <iostream>
 #include <vector>
 #include "geometry.h"
+#include "meshOptimizer.h"
+#include "meshGenerator.h"
 #include "shader.h"
 
 Geometry::Geometry() = default;
 Geometry::~Geometry() {
-    if (VAO) {
-        glDeleteVertexArrays(1, &VAO);
-    }
-    if (VBOPosition) {
-        glDeleteBuffers(1, &VBOPosition);
-    }
-    if (VBOColor) {
-        glDeleteBuffers(1, &VBOColor);
-    }
-    if (VBOUv) {
-        glDeleteBuffers(1, &VBOUv);
-    }
-    if (EBO) {
-        glDeleteBuffers(1, &EBO);
+    // 归还共享缓冲中的空间. 没有上传过的几何体(比如只用包围盒的测试)不需要创建共享缓冲
+    if (arenaMesh.vertices != RangeAllocator::INVALID_HANDLE || arenaMesh.indices != RangeAllocator::INVALID_HANDLE) {
+        getArena()->release(arenaMesh);
     }
 }
 
@@ -50,16 +41,75 @@ void GeometryInstance::initBoundingSpace() {
 }
 
 void Geometry::loadTexture(const std::string& filePath) {
-    texture = new Texture(filePath, 0);
+    texture = TEXTURE_CACHE->load(filePath, TextureParams::nearest());
+    material.setTexture(0, texture.getId());
 }
 
-void Geometry::bind() const {
-    // 绑定VAO
-    glBindVertexArray(VAO);
-    // 绑定纹理对象
-    if (texture) {
-        texture->bindTexture();
+GeometryArena* Geometry::getArena() {
+    // 与Application一样只创建不释放, 程序结束时OpenGL上下文已经销毁
+    static GeometryArena* arena = new GeometryArena("geometry", sizeof(PackedVertex), setupVertexAttributes);
+    return arena;
+}
+
+void Geometry::setupVertexAttributes() {
+    // 加入属性描述信息(0 -> 位置, 2 -> uv坐标, 3 -> 法向). 颜色(1)改为uniform, 不再是顶点属性
+    // 📌stride都是整个PackedVertex的大小, offset为属性在结构体中的偏移
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, position));
+    // normalized = GL_TRUE: 整数在着色器中会被映射为[0, 1]的浮点数
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, uv));
+    // 有符号整数则映射为[-1, 1]. 只有两个分量, 着色器中的z分量会被补0, 由着色器做八面体解码
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, normal));
+}
+
+uint32_t Geometry::getLodIndicesCount(const uint32_t lod) const {
+    uint32_t count = 0;
+    for (const IndexedDraw& draw : arenaMesh.levels[lod]) {
+        count += draw.count;
     }
+    return count;
+}
+
+void Geometry::bind() const {
+    // 绑定共享的VAO
+    getArena()->bind();
+    // 绑定纹理和材质常量(与上一次相同时跳过)
+    material.bind();
+}
+
+void Geometry::draw(const uint32_t lod) const {
+    drawCommands.clear();
+    appendDrawCommands(lod, drawCommands);
+    getArena()->draw(primitiveType, drawCommands);
+}
+
+void Geometry::appendDrawCommands(const uint32_t lod, std::vector<DrawElementsIndirectCommand>& commands) const {
+    getArena()->appendCommands(arenaMesh, lod, commands);
+}
+
+void Geometry::submit(RenderQueue& queue, const RenderQueue::ShaderId shader, const glm::mat4& modelMatrix,
+                      const uint32_t lod) const {
+    ObjectConstants object;
+    object.model = modelMatrix;
+    object.normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
+    object.color = getColor();
+    object.uvScale = uvScale;
+    // 紧凑顶点格式的法线是八面体编码
+    object.octNormal = true;
+    drawCommands.clear();
+    appendDrawCommands(lod, drawCommands);
+    const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4(boundingSphere.center, 1.0f));
+    queue.submit(RenderPass::Opaque, shader, &material, getArena()->getVAO(), queue.addObject(object), center,
+                 drawCommands);
+}
+
+uint32_t Geometry::selectLod(const glm::mat4& modelMatrix, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix,
+                             const float viewportHeight, const float maxPixelError) const {
+    const float pixelsPerUnit = MeshSimplifier::getPixelsPerUnit(boundingSphere.center, modelMatrix, viewMatrix,
+                                                                 projectionMatrix, viewportHeight);
+    return MeshSimplifier::selectLod(lodErrors, pixelsPerUnit, maxPixelError);
 }
 
 GeometryInstance* GeometryInstance::translate(const glm::vec3& translation) {
@@ -173,374 +223,89 @@ BoundingBox& GeometryInstance::getBoundingBox() {
     return boundingBox;
 }
 
+void Geometry::uploadVertices(Geometry* geometry, [[maybe_unused]] const char* name, const std::vector<PackedVertex>& vertices,
+                              const std::vector<GLuint>& indices, const std::vector<LodLevel>& lodLevels) {
+    geometry->vertexCount = vertices.size();
+
+    // 原始网格和各级LOD的索引依次存放在共享EBO的同一段中
+    std::vector<IndexSpan> levels{{indices.data(), indices.size()}};
+    geometry->lodErrors = {0.0f};
+    for (const LodLevel& level : lodLevels) {
+        levels.push_back({level.indices.data(), level.indices.size()});
+        geometry->lodErrors.push_back(level.error);
+    }
+    GeometryArena* arena = getArena();
+    geometry->arenaMesh = arena->upload(vertices.data(), (uint32_t)vertices.size(), levels);
+
+#ifdef DEBUG
+    // 每次工厂调用的顶点和索引统计只在调试构建中输出
+    std::cout << name << ": " << vertices.size() << " vertices, " << sizeof(PackedVertex) << " bytes/vertex (unpacked: "
+              << UNPACKED_VERTEX_SIZE << "), vertex buffer " << geometry->getVertexBytes() << " bytes, indices "
+              << geometry->getIndexBytes() << " bytes (" << indexTypeName(getIndexType()) << ", "
+              << geometry->arenaMesh.levels[0].size() << " draws, 32-bit: " << indices.size() * sizeof(GLuint) << ")";
+    if (!lodLevels.empty()) {
+        std::cout << ", LOD triangles:";
+        for (uint32_t lod = 0; lod < geometry->getLodCount(); lod++) {
+            std::cout << " " << geometry->getLodIndicesCount(lod) / 3;
+        }
+    }
+    std::cout << std::endl;
+    arena->printStats();
+#endif
+}
+
 // ===============================================================
 // ===创建几何体的工厂方法==========================================
 // =========创建的时候几何体中心都会在世界坐标系的原点================
 // ===============================================================
 
-Geometry* Geometry::createBox(float length, float width, float height, const glm::vec3 color) {
-    Geometry* box = new Geometry();
+Geometry* Geometry::createFromMesh(const GeneratedMesh& mesh, const char* name, const uint32_t lodLevels) {
+    Geometry* geometry = new Geometry();
+    geometry->indicesCount = mesh.indices.size();
+    geometry->boundingSphere = mesh.boundingSphere;
+    geometry->boundingBox = mesh.boundingBox;
+    geometry->uvScale = mesh.uvScale;
+
+    std::vector<LodLevel> lodChain;
+    if (lodLevels > 0) {
+        // 简化使用解码后的位置和法线, 与着色器中看到的一致
+        std::vector<glm::vec3> positions(mesh.vertices.size()), normals(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            glm::vec2 uv;
+            positions[i] = mesh.vertices[i].position;
+            unpackVertex(mesh.vertices[i], mesh.uvScale, normals[i], uv);
+        }
+        lodChain = MeshSimplifier::buildLodChain(mesh.indices, positions, normals, lodLevels);
+        for (auto& level : lodChain) {
+            MeshOptimizer::optimizeVertexCache(level.indices, (uint32_t)mesh.vertices.size());
+        }
+    }
+    uploadVertices(geometry, name, mesh.vertices, mesh.indices, lodChain);
+    return geometry;
+}
 
-    float halfLength = length / 2.0f,
-          halfWidth = width / 2.0f,
-          halfHeight = height / 2.0f;
-    // 顶点位置. 几何体中心在几何体本地坐标系的原点
-    // 平面和平面之间共用的顶点不能只定义一次, 因为后续还会有法线信息
+Geometry* Geometry::createBox(float length, float width, float height, const glm::vec3 color) {
     // 注意长宽高分别对应X, Z, Y轴. 因为相机视线方向是逆Z轴
-    float positions[] = {
-        // 正面四个点
-        -halfLength, -halfHeight, halfWidth,
-         halfLength, -halfHeight, halfWidth,
-         halfLength,  halfHeight, halfWidth,
-        -halfLength,  halfHeight, halfWidth,
-        // 背面
-        -halfLength, -halfHeight, -halfWidth,
-         halfLength, -halfHeight, -halfWidth,
-         halfLength,  halfHeight, -halfWidth,
-        -halfLength,  halfHeight, -halfWidth,
-        // 左面
-        -halfLength, -halfHeight, -halfWidth,
-        -halfLength, -halfHeight,  halfWidth,
-        -halfLength,  halfHeight,  halfWidth,
-        -halfLength,  halfHeight, -halfWidth,
-        // 右面
-         halfLength, -halfHeight, -halfWidth,
-         halfLength, -halfHeight,  halfWidth,
-         halfLength,  halfHeight,  halfWidth,
-         halfLength,  halfHeight, -halfWidth,
-        // 顶面
-        -halfLength,  halfHeight, -halfWidth,
-         halfLength,  halfHeight, -halfWidth,
-         halfLength,  halfHeight,  halfWidth,
-        -halfLength,  halfHeight,  halfWidth,
-        // 底面
-        -halfLength, -halfHeight, -halfWidth,
-         halfLength, -halfHeight, -halfWidth,
-         halfLength, -halfHeight,  halfWidth,
-        -halfLength, -halfHeight,  halfWidth,
-    };
-    // 法线数据
-    float normals[] = {
-        // 正面
-        0.0f, 0.0f, 1.0f,
-        0.0f, 0.0f, 1.0f,
-        0.0f, 0.0f, 1.0f,
-        0.0f, 0.0f, 1.0f,
-        // 背面
-        0.0f, 0.0f, -1.0f,
-        0.0f, 0.0f, -1.0f,
-        0.0f, 0.0f, -1.0f,
-        0.0f, 0.0f, -1.0f,
-        // 左面
-        -1.0f, 0.0f, 0.0f,
-        -1.0f, 0.0f, 0.0f,
-        -1.0f, 0.0f, 0.0f,
-        -1.0f, 0.0f, 0.0f,
-        // 右面
-        1.0f, 0.0f, 0.0f,
-        1.0f, 0.0f, 0.0f,
-        1.0f, 0.0f, 0.0f,
-        1.0f, 0.0f, 0.0f,
-        // 顶面
-        0.0f, 1.0f, 0.0f,
-        0.0f, 1.0f, 0.0f,
-        0.0f, 1.0f, 0.0f,
-        0.0f, 1.0f, 0.0f,
-        // 底面
-        0.0f, -1.0f, 0.0f,
-        0.0f, -1.0f, 0.0f,
-        0.0f, -1.0f, 0.0f,
-        0.0f, -1.0f, 0.0f,
-    };
-    // 颜色
-    float colors[4 * 6 * 3];
-    for (int i = 0; i < 24; ++i) {
-        colors[i * 3 + 0] = color.r;
-        colors[i * 3 + 1] = color.g;
-        colors[i * 3 + 2] = color.b;
-    }
-    // Material材质属性的颜色
-    box->material.ambient = color;
-    box->material.diffuse = color;
-    // 纹理坐标数据
-    float uvs[] = {
-        // 正面
-        0.0f, 0.0f,
-        1.0f, 0.0f,
-        1.0f, 1.0f,
-        0.0f, 1.0f,
-        // 背面
-        1.0f, 0.0f,
-        0.0f, 0.0f,
-        0.0f, 1.0f,
-        1.0f, 1.0f,
-        // 左面
-        0.0f, 0.0f,
-        1.0f, 0.0f,
-        1.0f, 1.0f,
-        0.0f, 1.0f,
-        // 右面
-        1.0f, 0.0f,
-        0.0f, 0.0f,
-        0.0f, 1.0f,
-        1.0f, 1.0f,
-        // 顶面
-        0.0f, 1.0f,
-        1.0f, 1.0f,
-        1.0f, 0.0f,
-        0.0f, 0.0f,
-        // 底面
-        0.0f, 0.0f,
-        1.0f, 0.0f,
-        1.0f, 1.0f,
-        0.0f, 1.0f
-    };
-    // 顶点索引顺序
-    unsigned int indices[] = {
-        0, 1, 2, 2, 3, 0, // 正面
-        4, 5, 6, 6, 7, 4, // 背面
-        8, 9, 10, 10, 11, 8, // 左面
-        12, 13, 14, 14, 15, 12, // 右面
-        16, 17, 18, 18, 19, 16, // 顶面
-        20, 21, 22, 22, 23, 20 // 底面
-    };
-    // 顶点索引数量
-    box->indicesCount = sizeof(indices) / sizeof(unsigned int);
-
-    // 计算包围球和AABB包围盒
-    box->boundingSphere.center = glm::vec3(0.0f);
-    box->boundingSphere.radius = glm::length(glm::vec3(halfLength, halfHeight, halfWidth));
-    box->boundingBox.min = glm::vec3(-halfLength, -halfHeight, -halfWidth);
-    box->boundingBox.max = glm::vec3(halfLength, halfHeight, halfWidth);
-
-    // 创建VBO
-    glGenBuffers(1, &box->VBOPosition);
-    glBindBuffer(GL_ARRAY_BUFFER, box->VBOPosition);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions, GL_STATIC_DRAW);
-    glGenBuffers(1, &box->VBOColor);
-    glBindBuffer(GL_ARRAY_BUFFER, box->VBOColor);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors, GL_STATIC_DRAW);
-    glGenBuffers(1, &box->VBOUv);
-    glBindBuffer(GL_ARRAY_BUFFER, box->VBOUv);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(uvs), uvs, GL_STATIC_DRAW);
-    glGenBuffers(1, &box->VBONormal);
-    glBindBuffer(GL_ARRAY_BUFFER, box->VBONormal);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(normals), normals, GL_STATIC_DRAW);
-    // 创建EBO
-    glGenBuffers(1, &box->EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, box->EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-    // 创建VAO
-    glGenVertexArrays(1, &box->VAO);
-    glBindVertexArray(box->VAO);
-    // 加入属性描述信息(0 -> 位置, 1 -> 颜色, 2 -> uv坐标, 3 -> 法向)
-    glBindBuffer(GL_ARRAY_BUFFER, box->VBOPosition);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, box->VBOColor);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, box->VBOUv);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, box->VBONormal);
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    // 绑定EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, box->EBO);
-    // 解绑VAO
-    glBindVertexArray(0);
+    Geometry* box = createFromMesh(MeshGenerator::box(length, width, height), "box");
+    // Material材质属性的颜色. 颜色不再作为顶点属性存储
+    MaterialProperties properties = box->material.getProperties();
+    properties.ambient = color;
+    properties.diffuse = color;
+    box->material.setProperties(properties);
     return box;
 }
 
 Geometry* Geometry::createSphere(float radius, int latitudeSegments, int longitudeSegments, const glm::vec3 color) {
-    Geometry* sphere = new Geometry();
-
-    // 计算出的球体顶点, uv, EBO索引数据以及法向存到vector中
-    std::vector<GLfloat> positions{};
-    std::vector<GLfloat> uvs{};
-    std::vector<GLuint> indices{};
-    std::vector<GLfloat> normals{};
-
-    // 计算球体顶点.
-    // 双层循环, 计算每条纬线(外循环)与每条经线(内循环)的交点坐标以及uv坐标
-    for (int i = 0; i <= latitudeSegments; i++) {
-        float phi = glm::pi<float>() * i / latitudeSegments; // 纬线角度
-
-        for (int j = 0; j <= longitudeSegments; j++) {
-            float theta = 2 * glm::pi<float>() * j / longitudeSegments; // 经线角度
-
-            // 计算球体顶点坐标(极坐标转直角坐标, 但是没有乘上半径, 是为了先赋值给顶点法向)
-            float x = sin(phi) * cos(theta);
-            float y = cos(phi);
-            float z = sin(phi) * sin(theta);
-
-            // uv坐标直接线性映射即可(当前经/纬线比上经/纬线总条数)
-            // 算出1.0的互补数, 以防贴图翻转, 更符合直觉
-            float u = 1.0f - (float)j / (float)longitudeSegments;
-            float v = 1.0f - (float)i / (float)latitudeSegments;
-
-            // 法线坐标
-            normals.push_back(x);
-            normals.push_back(y);
-            normals.push_back(z);
-
-            positions.push_back(x * radius);
-            positions.push_back(y * radius);
-            positions.push_back(z * radius);
-
-            uvs.push_back(u);
-            uvs.push_back(v);
-        }
-    }
-
-    // 计算EBO索引
-    for (int i = 0; i < latitudeSegments; i++) {
-        for (int j = 0; j < longitudeSegments; j++) {
-            int p1 = i * (longitudeSegments + 1) + j; // 当前点
-            int p2 = p1 + longitudeSegments + 1; // 下一个纬线的同一经线点
-            int p3 = p1 + 1; // 当前纬线的下一个经线点
-            int p4 = p2 + 1; // 下一个纬线的下一个经线点
-            // 计算出两个三角形的索引(注意逆时针顺序)
-            indices.push_back(p1);
-            indices.push_back(p2);
-            indices.push_back(p3);
-
-            indices.push_back(p3);
-            indices.push_back(p2);
-            indices.push_back(p4);
-        }
-    }
-    // 绘制的索引数量
-    sphere->indicesCount = indices.size();
-
-    // 颜色属性
-    std::vector<GLfloat> colors{};
-    for (int i = 0; i < positions.size() / 3; ++i) {
-        colors.push_back(color.r);
-        colors.push_back(color.g);
-        colors.push_back(color.b);
-    }
-    // Material材质属性的颜色
-    sphere->material.ambient = color;
-    sphere->material.diffuse = color;
-
-    // 计算包围球和AABB包围盒
-    sphere->boundingSphere.center = glm::vec3(0.0f);
-    sphere->boundingSphere.radius = radius;
-    sphere->boundingBox.min = glm::vec3(-radius, -radius, -radius);
-    sphere->boundingBox.max = glm::vec3(radius, radius, radius);
-
-    // 创建VBO
-    glGenBuffers(1, &sphere->VBOPosition);
-    glBindBuffer(GL_ARRAY_BUFFER, sphere->VBOPosition);
-    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float), positions.data(), GL_STATIC_DRAW);
-    glGenBuffers(1, &sphere->VBOColor);
-    glBindBuffer(GL_ARRAY_BUFFER, sphere->VBOColor);
-    glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(float), colors.data(), GL_STATIC_DRAW);
-    glGenBuffers(1, &sphere->VBOUv);
-    glBindBuffer(GL_ARRAY_BUFFER, sphere->VBOUv);
-    glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(float), uvs.data(), GL_STATIC_DRAW);
-    glGenBuffers(1, &sphere->VBONormal);
-    glBindBuffer(GL_ARRAY_BUFFER, sphere->VBONormal);
-    glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(float), normals.data(), GL_STATIC_DRAW);
-    // 创建EBO
-    glGenBuffers(1, &sphere->EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphere->EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
-    // 创建VAO
-    glGenVertexArrays(1, &sphere->VAO);
-    glBindVertexArray(sphere->VAO);
-    // 加入属性描述信息(0 -> 位置, 1 -> 颜色, 2 -> uv坐标)
-    glBindBuffer(GL_ARRAY_BUFFER, sphere->VBOPosition);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, sphere->VBOColor);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, sphere->VBOUv);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, sphere->VBONormal);
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    // 绑定EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphere->EBO);
-    // 解绑VAO
-    glBindVertexArray(0);
-
+    Geometry* sphere = createFromMesh(MeshGenerator::sphere(radius, latitudeSegments, longitudeSegments), "sphere", LOD_LEVELS);
+    // Material材质属性的颜色. 颜色不再作为顶点属性存储
+    MaterialProperties properties = sphere->material.getProperties();
+    properties.ambient = color;
+    properties.diffuse = color;
+    sphere->material.setProperties(properties);
     return sphere;
 }
 
 Geometry* Geometry::createPlane(float length, float width, float segments) {
-    Geometry* plane = new Geometry();
-
-    float halfLength = length / 2.0f,
-          halfWidth = width / 2.0f;
-
-    float positions[] = {
-        -halfLength, 0.0f, -halfWidth,
-         halfLength, 0.0f, -halfWidth,
-         halfLength, 0.0f,  halfWidth,
-        -halfLength, 0.0f,  halfWidth
-    };
-    float colors[] = {
-        1.0f, 1.0f, 1.0f,
-        1.0f, 1.0f, 1.0f,
-        1.0f, 1.0f, 1.0f,
-        1.0f, 1.0f, 1.0f
-    };
-    float uvs[] = {
-        0.0f, segments,
-        segments, segments,
-        segments, 0.0f,
-        0.0f, 0.0f
-    };
-    unsigned int indices[] = {
-        0, 1, 2,
-        2, 3, 0
-    };
-    // 顶点索引数量
-    plane->indicesCount = sizeof(indices) / sizeof(unsigned int);
-
-    // 计算包围球和AABB包围盒
-    plane->boundingSphere.center = glm::vec3(0.0f);
-    plane->boundingSphere.radius = glm::length(glm::vec3(halfLength, 0.0f, halfWidth));
-    // 平面增加些许厚度以免碰撞检测不到
-    plane->boundingBox.min = glm::vec3(-halfLength, -0.005f, -halfWidth);
-    plane->boundingBox.max = glm::vec3(halfLength, 0.005f, halfWidth);
-
-    // 创建VBO
-    glGenBuffers(1, &plane->VBOPosition);
-    glBindBuffer(GL_ARRAY_BUFFER, plane->VBOPosition);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(positions), positions, GL_STATIC_DRAW);
-    glGenBuffers(1, &plane->VBOColor);
-    glBindBuffer(GL_ARRAY_BUFFER, plane->VBOColor);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(colors), colors, GL_STATIC_DRAW);
-    glGenBuffers(1, &plane->VBOUv);
-    glBindBuffer(GL_ARRAY_BUFFER, plane->VBOUv);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(uvs), uvs, GL_STATIC_DRAW);
-    // 创建EBO
-    glGenBuffers(1, &plane->EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, plane->EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-    // 创建VAO
-    glGenVertexArrays(1, &plane->VAO);
-    glBindVertexArray(plane->VAO);
-    // 加入属性描述信息(0 -> 位置, 1 -> 颜色, 2 -> uv坐标)
-    glBindBuffer(GL_ARRAY_BUFFER, plane->VBOPosition);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, plane->VBOColor);
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glBindBuffer(GL_ARRAY_BUFFER, plane->VBOUv);
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
-    // 绑定EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, plane->EBO);
-    // 解绑VAO
-    glBindVertexArray(0);
-
-    return plane;
+    // 只有一个格子, 纹理在平面上重复segments * segments次
+    return createFromMesh(MeshGenerator::plane(length, width, 1, 1, segments), "plane");
 }
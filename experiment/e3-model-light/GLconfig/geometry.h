@@ -5,8 +5,16 @@
 #ifndef GEOMETRY_H
 #define GEOMETRY_H
 
+#include <vector>
+
 #include "core.h"
-#include "Texture.h"
+#include "geometryArena.h"
+#include "indexFormat.h"
+#include "material.h"
+#include "meshSimplifier.h"
+#include "renderQueue.h"
+#include "textureCache.h"
+#include "vertexFormat.h"
 
 // 包围球
 struct BoundingSphere {
@@ -58,14 +66,7 @@ inline bool isCollide(const BoundingBox& a, const BoundingBox& b, glm::vec3& nor
     }
     return true;
 }
-// 几何体的材质属性
-struct Material {
-    // ambient 和 diffuse 一般就是物体本身颜色
-    glm::vec3 ambient; // 环境光照下的颜色
-    glm::vec3 diffuse; // 漫反射光照下的颜色
-    glm::vec3 specular; // 镜面高光的颜色
-    float shininess; // 镜面高光的散射/半径. 值越大, 散射越小(集中)
-};
+struct GeneratedMesh;
 
 class Geometry {
 public:
@@ -77,25 +78,48 @@ public:
     BoundingSphere boundingSphere;
     // 模型空间的AABB包围盒
     BoundingBox boundingBox;
-    // 材质默认为白色
-    Material material = {
-        glm::vec3(1, 1, 1),
-        glm::vec3(1, 1, 1),
-        glm::vec3(1, 1, 1),
-        32
-    };
-
-    GLuint getVAO() const { return VAO; }
+    // 材质默认为白色. 几何体的纹理放在材质的0号纹理单元
+    Material material;
+
+    // 所有几何体共用同一个VAO(见GeometryArena)
+    GLuint getVAO() const { return getArena()->getVAO(); }
     GLuint getIndicesCount() const { return indicesCount; }
+    // 共享缓冲中统一使用16位索引(较大的几何体切分为多段), 以及索引(包括所有LOD)的字节数
+    static GLenum getIndexType() { return GeometryArena::INDEX_TYPE; }
+    size_t getIndexBytes() const { return arenaMesh.indexCount * sizeof(GLushort); }
+    // LOD数量(包括原始网格), 每一级的索引数量
+    uint32_t getLodCount() const { return (uint32_t)arenaMesh.levels.size(); }
+    uint32_t getLodIndicesCount(uint32_t lod) const;
+    // 按包围球中心处投影后的屏幕尺寸选择LOD: 屏幕误差不超过maxPixelError像素的最粗的一级
+    uint32_t selectLod(const glm::mat4& modelMatrix, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix,
+                       float viewportHeight, float maxPixelError = 1.0f) const;
 
     void setPrimitiveType(const GLenum type) { primitiveType = type; }
     GLenum getPrimitiveType() const { return primitiveType; }
 
-    // 加载纹理
+    // 顶点颜色不再逐顶点存储, 绘制时通过uniform objectColor传入
+    const glm::vec3& getColor() const { return material.getProperties().ambient; }
+    // uv以unorm16存储, 需要在着色器中乘回的缩放(uniform uvScale)
+    float getUvScale() const { return uvScale; }
+    // 顶点数量以及GPU中顶点数据的字节数
+    uint32_t getVertexCount() const { return vertexCount; }
+    size_t getVertexBytes() const { return vertexCount * sizeof(PackedVertex); }
+
+    // 加载纹理. 通过全局纹理缓存, 使用同一张图片的几何体共享一个纹理对象
     void loadTexture(const std::string& filePath);
 
-    // 准备渲染
+    // 准备渲染: 绑定共享的VAO(已绑定时跳过)和材质(纹理与材质常量)
     void bind() const;
+    // 绘制第lod级. 需要先bind. 通过一次glMultiDrawElementsIndirect提交, 超过65535个顶点的几何体是其中的多条命令
+    void draw(uint32_t lod = 0) const;
+    // 生成绘制第lod级的间接绘制命令, 用于与其他几何体合并为一次绘制
+    void appendDrawCommands(uint32_t lod, std::vector<DrawElementsIndirectCommand>& commands) const;
+    // 把第lod级作为一个物体提交到渲染队列(变换, 颜色和uv缩放作为物体的uniform), 不调用OpenGL
+    // 渲染队列只绘制三角形, 其他图元类型的几何体仍然用bind/draw
+    void submit(RenderQueue& queue, RenderQueue::ShaderId shader, const glm::mat4& modelMatrix, uint32_t lod) const;
+
+    // 所有几何体(PackedVertex格式)共用的顶点/索引缓冲
+    static GeometryArena* getArena();
 
     // 获取几何体(模型空间)的中心位置
     static glm::vec3 getModelCenter() {
@@ -115,25 +139,37 @@ public:
     // 创建球体
     // latitude/longitudeSegments: 经纬划分数量(数字越大, 球体越光滑细致)
     // longitudeCount等于经线数量, latitudeCount等于纬线数量 + 1. 实际上都等于经纬线方向上被划分的段数
+    // 球体会额外生成LOD_LEVELS级简化的LOD
     static Geometry* createSphere(float radius, int latitudeSegments, int longitudeSegments, glm::vec3 color);
     // 创建平面
     // 长宽分别对应X, Z轴, segments: 平面材质被划分的次数. 例如: 当segment=2时, 纹理贴图会在平面上重复2*2=4次
     static Geometry* createPlane(float length, float width, float segments = 1.0f);
+    // 上传MeshGenerator生成的网格(圆柱, 圆环, 胶囊体等都通过它创建). name只用于打印
+    // lodLevels > 0时用MeshSimplifier生成简化的LOD, 每一级三角形减半
+    static Geometry* createFromMesh(const GeneratedMesh& mesh, const char* name, uint32_t lodLevels = 0);
+    static constexpr uint32_t LOD_LEVELS = 4;
 
 private:
-    // VBO, VAO以及EBO成员
-    GLuint VAO{0};
-    GLuint VBOPosition{0};
-    GLuint VBOColor{0};
-    GLuint VBOUv{0};
-    GLuint VBONormal{0};
-    GLuint EBO{0};
-
-    Texture* texture{nullptr}; // 纹理对象
+    // 顶点和所有LOD的索引在共享缓冲中的位置
+    ArenaMesh arenaMesh;
+
+    TextureHandle texture; // 纹理对象(缓存中的引用)
     GLenum primitiveType{GL_TRIANGLES}; // 绘制时的图元类型(三角形, 线框等)
 
     // 需要绘制的EBO索引数量(注意: 不是顶点数量)
     uint32_t indicesCount{0};
+    uint32_t vertexCount{0};
+    // 每一级LOD在模型空间中的误差, lodErrors[0]为原始网格
+    std::vector<float> lodErrors;
+    float uvScale{1.0f};
+    // draw()每次复用的命令数组
+    mutable std::vector<DrawElementsIndirectCommand> drawCommands;
+
+    // PackedVertex的顶点属性: 0 -> 位置, 2 -> uv坐标, 3 -> 法向
+    static void setupVertexAttributes();
+    // 把顶点和各级索引上传到共享缓冲, 并打印每个顶点以及索引占用的字节数
+    static void uploadVertices(Geometry* geometry, const char* name, const std::vector<PackedVertex>& vertices,
+                               const std::vector<GLuint>& indices, const std::vector<LodLevel>& lodLevels);
 };
 
 /**
@@ -0,0 +1,199 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "geometryArena.h"
+
+GLuint GeometryArena::boundVAO = 0;
+
+GeometryArena::GeometryArena(const char* name, const size_t vertexSize, const AttributeSetup setupAttributes,
+                             const uint64_t vertexCapacity, const uint64_t indexCapacity)
+    : name(name), vertexSize(vertexSize), setupAttributes(setupAttributes), vertexAllocator(vertexCapacity),
+      indexAllocator(indexCapacity) {
+    VBO = copyToNewBuffer(0, vertexCapacity * vertexSize, {}, vertexSize);
+    EBO = copyToNewBuffer(0, indexCapacity * sizeof(GLushort), {}, sizeof(GLushort));
+    glGenBuffers(1, &indirectBuffer);
+    glGenVertexArrays(1, &VAO);
+    setupVAO();
+}
+
+GeometryArena::~GeometryArena() {
+    if (boundVAO == VAO) {
+        boundVAO = 0;
+    }
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+    glDeleteBuffers(1, &indirectBuffer);
+}
+
+void GeometryArena::setupVAO() {
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    setupAttributes();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBindVertexArray(0);
+    boundVAO = 0;
+}
+
+GLuint GeometryArena::copyToNewBuffer(const GLuint buffer, const uint64_t newBytes,
+                                      const std::vector<RangeAllocator::Move>& moves, const size_t elementSize) {
+    // 通过COPY_READ/COPY_WRITE绑定点操作, 不影响任何VAO中记录的EBO
+    GLuint newBuffer;
+    glGenBuffers(1, &newBuffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)newBytes, nullptr, GL_STATIC_DRAW);
+    if (buffer) {
+        glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+        for (const RangeAllocator::Move& move : moves) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)(move.from * elementSize),
+                                (GLintptr)(move.to * elementSize), (GLsizeiptr)(move.size * elementSize));
+        }
+        glDeleteBuffers(1, &buffer);
+    }
+    return newBuffer;
+}
+
+RangeAllocator::Handle GeometryArena::allocate(RangeAllocator& allocator, GLuint& buffer, const size_t elementSize,
+                                               const uint64_t count) {
+    RangeAllocator::Handle handle = allocator.allocate(count);
+    if (handle != RangeAllocator::INVALID_HANDLE) {
+        return handle;
+    }
+    if (allocator.getFree() >= count) {
+        // 空闲空间足够, 只是不连续: 整理后末尾是一整块空闲空间
+        buffer = copyToNewBuffer(buffer, allocator.getCapacity() * elementSize, allocator.compact(), elementSize);
+    } else {
+        const uint64_t extent = allocator.getUsedExtent();
+        const uint64_t capacity = std::max(allocator.getCapacity() * 2, allocator.getUsed() + count);
+        buffer = copyToNewBuffer(buffer, capacity * elementSize, {{0, 0, extent}}, elementSize);
+        allocator.grow(capacity);
+        handle = allocator.allocate(count);
+        if (handle == RangeAllocator::INVALID_HANDLE) {
+            // 扩容后末尾的空闲块仍然放不下(前面的空闲块不连续), 再整理一次
+            buffer = copyToNewBuffer(buffer, capacity * elementSize, allocator.compact(), elementSize);
+        }
+    }
+    setupVAO();
+    return handle != RangeAllocator::INVALID_HANDLE ? handle : allocator.allocate(count);
+}
+
+ArenaMesh GeometryArena::upload(const void* vertices, const uint32_t vertexCount, const std::vector<IndexSpan>& levels) {
+    ArenaMesh mesh;
+    // 顶点直接从调用者的内存(可能是文件映射)上传, 只有被复制的少量顶点需要额外的存储
+    // 每一级按indexFormat.h切分为16位索引, 所有级的索引连续存放
+    PackedIndices indices;
+    mesh.vertexCount = vertexCount;
+    for (const IndexSpan& level : levels) {
+        const size_t firstDraw = indices.draws.size();
+        appendShortIndices(level.data, level.count, mesh.vertexCount, indices);
+        mesh.levels.emplace_back(indices.draws.begin() + (std::ptrdiff_t)firstDraw, indices.draws.end());
+    }
+    mesh.indexCount = (uint32_t)indices.indices.size();
+    if (mesh.vertexCount == 0 || mesh.indexCount == 0) {
+        return mesh;
+    }
+
+    mesh.vertices = allocate(vertexAllocator, VBO, vertexSize, mesh.vertexCount);
+    mesh.indices = allocate(indexAllocator, EBO, sizeof(GLushort), mesh.indexCount);
+    const size_t vertexOffset = vertexAllocator.getOffset(mesh.vertices) * vertexSize;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)vertexOffset, (GLsizeiptr)(vertexCount * vertexSize), vertices);
+    if (!indices.duplicatedVertices.empty()) {
+        std::vector<uint8_t> extraVertices(indices.duplicatedVertices.size() * vertexSize);
+        for (size_t i = 0; i < indices.duplicatedVertices.size(); i++) {
+            std::memcpy(extraVertices.data() + i * vertexSize,
+                        (const uint8_t*)vertices + (size_t)indices.duplicatedVertices[i] * vertexSize, vertexSize);
+        }
+        glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(vertexOffset + vertexCount * vertexSize),
+                        (GLsizeiptr)extraVertices.size(), extraVertices.data());
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(indexAllocator.getOffset(mesh.indices) * sizeof(GLushort)),
+                    (GLsizeiptr)(indices.indices.size() * sizeof(GLushort)), indices.indices.data());
+    return mesh;
+}
+
+ArenaMesh GeometryArena::upload(const void* vertices, const uint32_t vertexCount, const GLushort* indices,
+                                const uint32_t indexCount, const std::vector<std::vector<IndexedDraw>>& levels) {
+    ArenaMesh mesh;
+    mesh.vertexCount = vertexCount;
+    mesh.indexCount = indexCount;
+    mesh.levels = levels;
+    if (mesh.vertexCount == 0 || mesh.indexCount == 0) {
+        return mesh;
+    }
+
+    mesh.vertices = allocate(vertexAllocator, VBO, vertexSize, mesh.vertexCount);
+    mesh.indices = allocate(indexAllocator, EBO, sizeof(GLushort), mesh.indexCount);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(vertexAllocator.getOffset(mesh.vertices) * vertexSize),
+                    (GLsizeiptr)(vertexCount * vertexSize), vertices);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)(indexAllocator.getOffset(mesh.indices) * sizeof(GLushort)),
+                    (GLsizeiptr)(indexCount * sizeof(GLushort)), indices);
+    return mesh;
+}
+
+void GeometryArena::release(ArenaMesh& mesh) {
+    vertexAllocator.free(mesh.vertices);
+    indexAllocator.free(mesh.indices);
+    mesh = ArenaMesh();
+}
+
+void GeometryArena::appendCommands(const ArenaMesh& mesh, const uint32_t level,
+                                   std::vector<DrawElementsIndirectCommand>& commands, const uint32_t instanceCount,
+                                   const uint32_t baseInstance) const {
+    if (mesh.indices == RangeAllocator::INVALID_HANDLE) {
+        return;
+    }
+    appendIndirectCommands(mesh.levels[level], sizeof(GLushort), (uint32_t)indexAllocator.getOffset(mesh.indices),
+                           (GLint)vertexAllocator.getOffset(mesh.vertices), commands, instanceCount, baseInstance);
+}
+
+void GeometryArena::appendCommands(const ArenaMesh& mesh, const uint32_t level, const std::vector<MeshletRange>& ranges,
+                                   std::vector<DrawElementsIndirectCommand>& commands, const uint32_t instanceCount,
+                                   const uint32_t baseInstance) const {
+    if (mesh.indices == RangeAllocator::INVALID_HANDLE) {
+        return;
+    }
+    appendIndirectCommands(mesh.levels[level], sizeof(GLushort), (uint32_t)indexAllocator.getOffset(mesh.indices),
+                           (GLint)vertexAllocator.getOffset(mesh.vertices), ranges, commands, instanceCount,
+                           baseInstance);
+}
+
+void GeometryArena::bind() const {
+    if (boundVAO != VAO) {
+        glBindVertexArray(VAO);
+        boundVAO = VAO;
+    }
+}
+
+void GeometryArena::draw(const GLenum mode, const std::vector<DrawElementsIndirectCommand>& commands) const {
+    if (commands.empty()) {
+        return;
+    }
+    // 每次重新分配存储(orphan), 驱动不需要等待上一次绘制读完旧的命令
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, (GLsizeiptr)(commands.size() * sizeof(DrawElementsIndirectCommand)),
+                 commands.data(), GL_STREAM_DRAW);
+    glMultiDrawElementsIndirect(mode, INDEX_TYPE, nullptr, (GLsizei)commands.size(), 0);
+}
+
+void GeometryArena::compact() {
+    VBO = copyToNewBuffer(VBO, vertexAllocator.getCapacity() * vertexSize, vertexAllocator.compact(), vertexSize);
+    EBO = copyToNewBuffer(EBO, indexAllocator.getCapacity() * sizeof(GLushort), indexAllocator.compact(), sizeof(GLushort));
+    setupVAO();
+}
+
+void GeometryArena::printStats() const {
+    std::cout << "arena " << name << ": " << vertexAllocator.getAllocationCount() << " meshes, vertices "
+              << vertexAllocator.getUsed() << "/" << vertexAllocator.getCapacity() << " (fragmentation "
+              << vertexAllocator.getFragmentation() << "), indices " << indexAllocator.getUsed() << "/"
+              << indexAllocator.getCapacity() << " (fragmentation " << indexAllocator.getFragmentation() << ")"
+              << std::endl;
+}
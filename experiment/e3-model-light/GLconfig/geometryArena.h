@@ -0,0 +1,106 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef GEOMETRYARENA_H
+#define GEOMETRYARENA_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+#include "indirectDraw.h"
+#include "rangeAllocator.h"
+#include "vertexFormat.h"
+
+// 一段32位索引, 可以指向vector, 也可以直接指向文件映射中的数据
+struct IndexSpan {
+    const GLuint* data{nullptr};
+    size_t count{0};
+};
+
+// 网格在GeometryArena中的位置. 偏移在整理碎片后会改变, 绘制时总是通过句柄重新查询
+struct ArenaMesh {
+    RangeAllocator::Handle vertices{RangeAllocator::INVALID_HANDLE};
+    RangeAllocator::Handle indices{RangeAllocator::INVALID_HANDLE};
+    // 实际占用的顶点数(可能因为16位索引的切分复制了少量顶点)和索引数
+    uint32_t vertexCount{0};
+    uint32_t indexCount{0};
+    // 每一级(LOD)的绘制调用. byteOffset相对于索引分配的起点, baseVertex相对于顶点分配的起点
+    std::vector<std::vector<IndexedDraw>> levels;
+    // 顶点位置的反量化参数(模型网格, 见Mesh::upload). 顶点是float位置时(几何体)为单位变换
+    VertexQuantization quantization;
+};
+
+/**
+ * 同一种顶点格式的所有网格共用的大缓冲: 一个VAO, 一个VBO和一个EBO
+ * 每个网格在其中子分配一段顶点和一段索引(RangeAllocator), 绘制时把各自的绘制调用转为DrawElementsIndirectCommand,
+ * 再用一次glMultiDrawElementsIndirect提交. 切换网格不再需要重新绑定VAO
+ *
+ * 索引统一使用16位, 上传时按indexFormat.h切分(appendShortIndices): 存储相对于每段起始顶点的下标, 起始顶点放在命令的baseVertex中
+ * 空间不足时先尝试整理碎片(空闲空间足够但不连续), 否则容量翻倍. 两者都是把数据复制到新的缓冲, 再重新设置VAO
+ */
+class GeometryArena {
+public:
+    static constexpr GLenum INDEX_TYPE = GL_UNSIGNED_SHORT;
+    // 在VAO和VBO绑定的状态下设置顶点属性
+    using AttributeSetup = void (*)();
+
+    // name只用于打印. 容量的单位是顶点数和索引数
+    GeometryArena(const char* name, size_t vertexSize, AttributeSetup setupAttributes,
+                  uint64_t vertexCapacity = 1 << 16, uint64_t indexCapacity = 1 << 18);
+    ~GeometryArena();
+
+    // 上传顶点和多级索引, 每一级都是完整的32位索引
+    ArenaMesh upload(const void* vertices, uint32_t vertexCount, const std::vector<IndexSpan>& levels);
+    // 上传已经切分好的16位索引(见indexFormat.h), vertexCount包括切分时复制的顶点. 不经过CPU处理, 可以直接来自文件映射
+    ArenaMesh upload(const void* vertices, uint32_t vertexCount, const GLushort* indices, uint32_t indexCount,
+                     const std::vector<std::vector<IndexedDraw>>& levels);
+    void release(ArenaMesh& mesh);
+
+    // 生成绘制第level级的命令
+    void appendCommands(const ArenaMesh& mesh, uint32_t level, std::vector<DrawElementsIndirectCommand>& commands,
+                        uint32_t instanceCount = 1, uint32_t baseInstance = 0) const;
+    // 只绘制第level级中ranges覆盖的部分(meshlet剔除的结果)
+    void appendCommands(const ArenaMesh& mesh, uint32_t level, const std::vector<MeshletRange>& ranges,
+                        std::vector<DrawElementsIndirectCommand>& commands, uint32_t instanceCount = 1,
+                        uint32_t baseInstance = 0) const;
+
+    // 绑定共享的VAO. 已经绑定时跳过
+    void bind() const;
+    // 其他代码(RenderQueue)直接绑定了VAO之后同步记录, 之后的bind仍然可以跳过
+    static void setBoundVAO(const GLuint vao) { boundVAO = vao; }
+    static GLuint getBoundVAO() { return boundVAO; }
+    // 上传命令并执行glMultiDrawElementsIndirect. 需要先bind
+    void draw(GLenum mode, const std::vector<DrawElementsIndirectCommand>& commands) const;
+
+    // 整理顶点和索引的碎片
+    void compact();
+
+    GLuint getVAO() const { return VAO; }
+    const RangeAllocator& getVertexAllocator() const { return vertexAllocator; }
+    const RangeAllocator& getIndexAllocator() const { return indexAllocator; }
+    void printStats() const;
+
+private:
+    const char* name;
+    size_t vertexSize;
+    AttributeSetup setupAttributes;
+
+    RangeAllocator vertexAllocator;
+    RangeAllocator indexAllocator;
+    GLuint VAO{0};
+    GLuint VBO{0};
+    GLuint EBO{0};
+    GLuint indirectBuffer{0};
+    // 当前绑定的VAO, 所有GeometryArena共用
+    static GLuint boundVAO;
+
+    RangeAllocator::Handle allocate(RangeAllocator& allocator, GLuint& buffer, size_t elementSize, uint64_t count);
+    // 把旧缓冲中的数据按moves复制到一个新的缓冲中, 返回新缓冲. 旧缓冲会被删除
+    static GLuint copyToNewBuffer(GLuint buffer, uint64_t newBytes, const std::vector<RangeAllocator::Move>& moves,
+                                  size_t elementSize);
+    void setupVAO();
+};
+
+#endif //GEOMETRYARENA_H
@@ -0,0 +1,234 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geometryArenaBenchmark.h"
+#include "benchmarkCheck.h"
+#include "indirectDraw.h"
+#include "rangeAllocator.h"
+
+using namespace benchmark;
+
+namespace {
+    // 模拟GPU缓冲: 按moves的顺序复制数据(与GeometryArena复制到新缓冲的结果相同)
+    void applyMoves(std::vector<uint8_t>& buffer, const std::vector<RangeAllocator::Move>& moves) {
+        // 没有移动的区间原样保留
+        std::vector<uint8_t> moved = buffer;
+        for (const auto& move : moves) {
+            std::memmove(moved.data() + move.to, buffer.data() + move.from, move.size);
+        }
+        buffer.swap(moved);
+    }
+
+    // 与GeometryArena::allocate相同的策略: 空闲空间足够时整理, 否则容量翻倍
+    struct SimulatedArena {
+        RangeAllocator allocator{1 << 16};
+        std::vector<uint8_t> buffer = std::vector<uint8_t>(1 << 16, 0);
+        uint32_t compactions{0};
+        uint32_t grows{0};
+        uint64_t bytesMoved{0};
+
+        void compact() {
+            const auto moves = allocator.compact();
+            for (const auto& move : moves) {
+                bytesMoved += move.size;
+            }
+            applyMoves(buffer, moves);
+            compactions++;
+        }
+
+        RangeAllocator::Handle allocate(const uint64_t size) {
+            RangeAllocator::Handle handle = allocator.allocate(size);
+            if (handle != RangeAllocator::INVALID_HANDLE) {
+                return handle;
+            }
+            if (allocator.getFree() < size) {
+                const uint64_t capacity = std::max(allocator.getCapacity() * 2, allocator.getUsed() + size);
+                bytesMoved += allocator.getUsedExtent();
+                buffer.resize(capacity, 0);
+                allocator.grow(capacity);
+                grows++;
+                handle = allocator.allocate(size);
+                if (handle != RangeAllocator::INVALID_HANDLE) {
+                    return handle;
+                }
+            }
+            compact();
+            return allocator.allocate(size);
+        }
+    };
+}
+
+void checkRangeAllocator() {
+    std::cout << "range allocator:" << std::endl;
+    RangeAllocator allocator(1000);
+    const auto a = allocator.allocate(100);
+    const auto b = allocator.allocate(100);
+    const auto c = allocator.allocate(100);
+    check(allocator.getOffset(a) == 0 && allocator.getOffset(b) == 100 && allocator.getOffset(c) == 200,
+          "sequential allocations are packed");
+
+    allocator.free(b);
+    const auto d = allocator.allocate(80);
+    check(allocator.getOffset(d) == 100, "freed block is reused");
+    check(d == b, "freed handle is reused");
+
+    allocator.free(a);
+    allocator.free(d);
+    check(allocator.getFreeBlockCount() == 2 && allocator.getLargestFreeBlock() == 700,
+          "adjacent free blocks are merged");
+    allocator.free(c);
+    check(allocator.getFreeBlockCount() == 1 && allocator.getFree() == 1000 && allocator.getFragmentation() == 0.0f,
+          "everything merges back into one block");
+
+    // 最佳适配: 填满后空出50(在100处)和200(在300处)两个空洞, 40应当放进50的空洞
+    std::vector<RangeAllocator::Handle> handles;
+    for (int i = 0; i < 20; i++) {
+        handles.push_back(allocator.allocate(50));
+    }
+    allocator.free(handles[2]);
+    allocator.free(handles[6]);
+    allocator.free(handles[7]);
+    allocator.free(handles[8]);
+    allocator.free(handles[9]);
+    const auto small = allocator.allocate(40);
+    check(allocator.getOffset(small) == 100, "best fit picks the smallest hole");
+    // 剩余空间共210, 但最大的空闲块只有200
+    check(allocator.getFree() == 210 && allocator.allocate(210) == RangeAllocator::INVALID_HANDLE,
+          "allocation larger than any block fails");
+    check(allocator.getFragmentation() > 0.0f, "fragmentation is reported");
+
+    // 整理碎片: 用句柄编号填充每段数据, 整理后检查数据是否跟着句柄移动. small复用了最后释放的句柄, 也在handles中
+    std::vector<uint8_t> buffer(allocator.getCapacity(), 0xEE);
+    std::vector<RangeAllocator::Handle> live;
+    for (const RangeAllocator::Handle handle : handles) {
+        if (allocator.getSize(handle) > 0) {
+            live.push_back(handle);
+        }
+    }
+    for (const RangeAllocator::Handle handle : live) {
+        std::memset(buffer.data() + allocator.getOffset(handle), (int)handle + 1, allocator.getSize(handle));
+    }
+    const auto moves = allocator.compact();
+    applyMoves(buffer, moves);
+    bool dataIntact = true;
+    uint64_t end = 0;
+    for (const auto handle : live) {
+        for (uint64_t i = 0; i < allocator.getSize(handle); i++) {
+            dataIntact &= buffer[allocator.getOffset(handle) + i] == (uint8_t)(handle + 1);
+        }
+        end = std::max(end, allocator.getOffset(handle) + allocator.getSize(handle));
+    }
+    check(dataIntact, "compaction keeps data with its handle");
+    check(end == allocator.getUsed() && allocator.getFreeBlockCount() == 1 && allocator.getFragmentation() == 0.0f,
+          "compaction leaves one free block at the end");
+    check(allocator.allocate(210) != RangeAllocator::INVALID_HANDLE, "large allocation succeeds after compaction");
+
+    RangeAllocator growing(100);
+    const auto first = growing.allocate(60);
+    growing.grow(200);
+    check(growing.getFreeBlockCount() == 1 && growing.getLargestFreeBlock() == 140, "grow merges with the trailing free block");
+    const auto second = growing.allocate(140);
+    check(growing.getOffset(first) == 0 && growing.getOffset(second) == 60 && growing.getFree() == 0,
+          "grown space is allocatable");
+}
+
+void checkIndirectCommands() {
+    std::cout << "indirect commands:" << std::endl;
+    // 两段16位索引: [0, 30)基础顶点0, [30, 60)基础顶点70000. byteOffset以16位索引计
+    const std::vector<IndexedDraw> draws = {{0, 30, 0}, {30 * sizeof(GLushort), 30, 70000}};
+    std::vector<DrawElementsIndirectCommand> commands;
+    appendIndirectCommands(draws, sizeof(GLushort), 1000, 500, commands);
+    check(commands.size() == 2 && commands[0].firstIndex == 1000 && commands[0].baseVertex == 500 &&
+          commands[1].firstIndex == 1030 && commands[1].baseVertex == 70500 && commands[1].count == 30 &&
+          commands[1].instanceCount == 1, "draws are offset by the mesh allocation");
+
+    // 范围[24, 42)跨越两段, 应拆成[24, 30)和[30, 42); [54, 60)在第二段内
+    commands.clear();
+    appendIndirectCommands(draws, sizeof(GLushort), 1000, 500, {{24, 18}, {54, 6}}, commands);
+    check(commands.size() == 3 && commands[0].firstIndex == 1024 && commands[0].count == 6 &&
+          commands[0].baseVertex == 500 && commands[1].firstIndex == 1030 && commands[1].count == 12 &&
+          commands[1].baseVertex == 70500 && commands[2].firstIndex == 1054 && commands[2].count == 6,
+          "visible ranges are split at segment boundaries");
+
+    // 第二级LOD从索引60开始, 范围相对于这一级的开头
+    commands.clear();
+    const std::vector<IndexedDraw> level = {{60 * sizeof(GLushort), 12, 0}};
+    appendIndirectCommands(level, sizeof(GLushort), 0, 0, {{3, 6}}, commands);
+    check(commands.size() == 1 && commands[0].firstIndex == 63 && commands[0].count == 6,
+          "ranges are relative to the level start");
+}
+
+void benchmarkArenaChurn() {
+    std::cout << "arena churn:" << std::endl;
+    std::mt19937 random(12345);
+    // 网格大小在几十到两万个顶点之间, 小网格更多
+    std::uniform_real_distribution<float> logSize(std::log(24.0f), std::log(20000.0f));
+    std::uniform_int_distribution<int> action(0, 99);
+
+    SimulatedArena arena;
+    std::vector<RangeAllocator::Handle> live;
+    float fragmentationSum = 0.0f, maxFragmentation = 0.0f;
+    constexpr int OPERATIONS = 20000;
+    const auto start = Clock::now();
+    for (int i = 0; i < OPERATIONS; i++) {
+        // 前半段以加载为主, 后半段加载和卸载各占一半
+        const int loadChance = i < OPERATIONS / 2 ? 70 : 50;
+        if (live.empty() || action(random) < loadChance) {
+            const auto size = (uint64_t)std::exp(logSize(random));
+            live.push_back(arena.allocate(size));
+        } else {
+            std::uniform_int_distribution<size_t> pick(0, live.size() - 1);
+            const size_t index = pick(random);
+            arena.allocator.free(live[index]);
+            live[index] = live.back();
+            live.pop_back();
+        }
+        fragmentationSum += arena.allocator.getFragmentation();
+        maxFragmentation = std::max(maxFragmentation, arena.allocator.getFragmentation());
+    }
+    const double ms = elapsedMs(start);
+    std::cout << "  " << OPERATIONS << " load/unload operations in " << ms << " ms (including simulated copies), "
+              << live.size() << " meshes live, " << arena.allocator.getUsed() << "/" << arena.allocator.getCapacity()
+              << " used, " << arena.allocator.getFreeBlockCount() << " free blocks" << std::endl;
+    std::cout << "  fragmentation avg " << fragmentationSum / OPERATIONS << ", max " << maxFragmentation << ", "
+              << arena.compactions << " compactions, " << arena.grows << " grows, " << arena.bytesMoved
+              << " elements moved" << std::endl;
+
+    // 每个网格1~3段, 生成所有网格的命令
+    std::vector<std::vector<IndexedDraw>> meshDraws(live.size());
+    for (auto& draws : meshDraws) {
+        const int segments = 1 + action(random) % 3;
+        for (int s = 0; s < segments; s++) {
+            draws.push_back({(size_t)s * 3000 * sizeof(GLushort), 3000, s * 65536});
+        }
+    }
+    std::vector<DrawElementsIndirectCommand> commands;
+    constexpr int FRAMES = 100;
+    const auto commandStart = Clock::now();
+    for (int frame = 0; frame < FRAMES; frame++) {
+        commands.clear();
+        for (size_t m = 0; m < live.size(); m++) {
+            appendIndirectCommands(meshDraws[m], sizeof(GLushort), (uint32_t)arena.allocator.getOffset(live[m]), 0,
+                                   commands);
+        }
+    }
+    std::cout << "  " << commands.size() << " commands for " << live.size() << " meshes in "
+              << elapsedMs(commandStart) / FRAMES * 1000.0 << " us per frame" << std::endl;
+}
+
+void runGeometryArenaBenchmarks() {
+    beginChecks("geometry arena");
+    checkRangeAllocator();
+    checkIndirectCommands();
+    benchmarkArenaChurn();
+    endChecks();
+}
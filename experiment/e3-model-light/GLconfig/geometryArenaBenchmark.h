@@ -0,0 +1,24 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef GEOMETRYARENABENCHMARK_H
+#define GEOMETRYARENABENCHMARK_H
+
+/**
+ * 共享缓冲的子分配器(RangeAllocator)和间接绘制命令生成的测试, 在窗口中按B键运行
+ * 只测试CPU端的逻辑, 不需要OpenGL上下文: GPU中的数据移动用一个字节数组模拟
+ */
+
+// 固定场景的正确性检查: 空闲块复用, 相邻空闲块合并, 最佳适配, 扩容, 整理碎片后数据和句柄是否正确
+void checkRangeAllocator();
+
+// 命令生成的正确性检查: 偏移, 16位分段的基础顶点, 可见范围跨越分段时的拆分
+void checkIndirectCommands();
+
+// 随机分配/释放模拟加载和卸载网格, 统计碎片率, 整理和扩容的次数, 以及命令生成的耗时
+void benchmarkArenaChurn();
+
+void runGeometryArenaBenchmarks();
+
+#endif //GEOMETRYARENABENCHMARK_H
@@ -0,0 +1,189 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include "glRecorder.h"
+
+GLRecorder* GLRecorder::active = nullptr;
+
+struct GLRecorder::SavedPointers {
+    PFNGLUSEPROGRAMPROC useProgram;
+    PFNGLBINDVERTEXARRAYPROC bindVertexArray;
+    PFNGLACTIVETEXTUREPROC activeTexture;
+    PFNGLBINDTEXTUREPROC bindTexture;
+    PFNGLBINDBUFFERPROC bindBuffer;
+    PFNGLBINDBUFFERRANGEPROC bindBufferRange;
+    PFNGLGENBUFFERSPROC genBuffers;
+    PFNGLDELETEBUFFERSPROC deleteBuffers;
+    PFNGLBUFFERDATAPROC bufferData;
+    PFNGLBUFFERSUBDATAPROC bufferSubData;
+    PFNGLPROGRAMUNIFORM1IPROC programUniform1i;
+    PFNGLUNIFORM1IPROC uniform1i;
+    PFNGLUNIFORM1FPROC uniform1f;
+    PFNGLUNIFORM3FVPROC uniform3fv;
+    PFNGLUNIFORMMATRIX3FVPROC uniformMatrix3fv;
+    PFNGLUNIFORMMATRIX4FVPROC uniformMatrix4fv;
+    PFNGLMULTIDRAWELEMENTSINDIRECTPROC multiDrawElementsIndirect;
+    PFNGLENABLEVERTEXARRAYATTRIBPROC enableVertexArrayAttrib;
+    PFNGLVERTEXARRAYATTRIBFORMATPROC vertexArrayAttribFormat;
+    PFNGLVERTEXARRAYATTRIBBINDINGPROC vertexArrayAttribBinding;
+    PFNGLVERTEXARRAYBINDINGDIVISORPROC vertexArrayBindingDivisor;
+    PFNGLVERTEXARRAYVERTEXBUFFERPROC vertexArrayVertexBuffer;
+    PFNGLGETINTEGERVPROC getIntegerv;
+};
+
+GLRecorder::GLRecorder() : saved(new SavedPointers) {
+    *saved = {
+        glad_glUseProgram, glad_glBindVertexArray, glad_glActiveTexture, glad_glBindTexture, glad_glBindBuffer,
+        glad_glBindBufferRange, glad_glGenBuffers, glad_glDeleteBuffers, glad_glBufferData, glad_glBufferSubData,
+        glad_glProgramUniform1i, glad_glUniform1i, glad_glUniform1f, glad_glUniform3fv, glad_glUniformMatrix3fv,
+        glad_glUniformMatrix4fv, glad_glMultiDrawElementsIndirect, glad_glEnableVertexArrayAttrib,
+        glad_glVertexArrayAttribFormat, glad_glVertexArrayAttribBinding, glad_glVertexArrayBindingDivisor,
+        glad_glVertexArrayVertexBuffer, glad_glGetIntegerv
+    };
+    glad_glUseProgram = useProgram;
+    glad_glBindVertexArray = bindVertexArray;
+    glad_glActiveTexture = activeTexture;
+    glad_glBindTexture = bindTexture;
+    glad_glBindBuffer = bindBuffer;
+    glad_glBindBufferRange = bindBufferRange;
+    glad_glGenBuffers = genBuffers;
+    glad_glDeleteBuffers = deleteBuffers;
+    glad_glBufferData = bufferData;
+    glad_glBufferSubData = bufferSubData;
+    glad_glProgramUniform1i = programUniform1i;
+    glad_glUniform1i = uniform1i;
+    glad_glUniform1f = uniform1f;
+    glad_glUniform3fv = uniform3fv;
+    glad_glUniformMatrix3fv = uniformMatrix3fv;
+    glad_glUniformMatrix4fv = uniformMatrix4fv;
+    glad_glMultiDrawElementsIndirect = multiDrawElementsIndirect;
+    glad_glEnableVertexArrayAttrib = enableVertexArrayAttrib;
+    glad_glVertexArrayAttribFormat = vertexArrayAttribFormat;
+    glad_glVertexArrayAttribBinding = vertexArrayAttribBinding;
+    glad_glVertexArrayBindingDivisor = vertexArrayBindingDivisor;
+    glad_glVertexArrayVertexBuffer = vertexArrayVertexBuffer;
+    glad_glGetIntegerv = getIntegerv;
+    active = this;
+}
+
+GLRecorder::~GLRecorder() {
+    glad_glUseProgram = saved->useProgram;
+    glad_glBindVertexArray = saved->bindVertexArray;
+    glad_glActiveTexture = saved->activeTexture;
+    glad_glBindTexture = saved->bindTexture;
+    glad_glBindBuffer = saved->bindBuffer;
+    glad_glBindBufferRange = saved->bindBufferRange;
+    glad_glGenBuffers = saved->genBuffers;
+    glad_glDeleteBuffers = saved->deleteBuffers;
+    glad_glBufferData = saved->bufferData;
+    glad_glBufferSubData = saved->bufferSubData;
+    glad_glProgramUniform1i = saved->programUniform1i;
+    glad_glUniform1i = saved->uniform1i;
+    glad_glUniform1f = saved->uniform1f;
+    glad_glUniform3fv = saved->uniform3fv;
+    glad_glUniformMatrix3fv = saved->uniformMatrix3fv;
+    glad_glUniformMatrix4fv = saved->uniformMatrix4fv;
+    glad_glMultiDrawElementsIndirect = saved->multiDrawElementsIndirect;
+    glad_glEnableVertexArrayAttrib = saved->enableVertexArrayAttrib;
+    glad_glVertexArrayAttribFormat = saved->vertexArrayAttribFormat;
+    glad_glVertexArrayAttribBinding = saved->vertexArrayAttribBinding;
+    glad_glVertexArrayBindingDivisor = saved->vertexArrayBindingDivisor;
+    glad_glVertexArrayVertexBuffer = saved->vertexArrayVertexBuffer;
+    glad_glGetIntegerv = saved->getIntegerv;
+    delete saved;
+    active = nullptr;
+}
+
+void GLRecorder::clear() {
+    records.clear();
+    for (auto& count : counts) {
+        count = 0;
+    }
+}
+
+void GLRecorder::record(const GLCall call, const uint64_t a, const uint64_t b, const uint64_t c) {
+    active->records.push_back({call, {a, b, c}});
+    active->counts[(size_t)call]++;
+}
+
+void APIENTRY GLRecorder::useProgram(const GLuint program) {
+    record(GLCall::UseProgram, program);
+}
+void APIENTRY GLRecorder::bindVertexArray(const GLuint array) {
+    record(GLCall::BindVertexArray, array);
+}
+void APIENTRY GLRecorder::activeTexture(const GLenum texture) {
+    record(GLCall::ActiveTexture, texture - GL_TEXTURE0);
+}
+void APIENTRY GLRecorder::bindTexture(const GLenum target, const GLuint texture) {
+    record(GLCall::BindTexture, target, texture);
+}
+void APIENTRY GLRecorder::bindBuffer(const GLenum target, const GLuint buffer) {
+    record(GLCall::BindBuffer, target, buffer);
+}
+void APIENTRY GLRecorder::bindBufferRange(const GLenum /*target*/, const GLuint index, const GLuint buffer,
+                                          const GLintptr offset, const GLsizeiptr /*size*/) {
+    record(GLCall::BindBufferRange, index, buffer, (uint64_t)offset);
+}
+void APIENTRY GLRecorder::genBuffers(const GLsizei n, GLuint* buffers) {
+    for (GLsizei i = 0; i < n; i++) {
+        buffers[i] = active->nextName++;
+    }
+    record(GLCall::GenBuffers, (uint64_t)n);
+}
+void APIENTRY GLRecorder::deleteBuffers(const GLsizei n, const GLuint* buffers) {
+    record(GLCall::DeleteBuffers, (uint64_t)n, n > 0 ? buffers[0] : 0);
+}
+void APIENTRY GLRecorder::bufferData(const GLenum target, const GLsizeiptr size, const void* /*data*/, const GLenum /*usage*/) {
+    record(GLCall::BufferData, target, (uint64_t)size);
+}
+void APIENTRY GLRecorder::bufferSubData(const GLenum target, const GLintptr offset, const GLsizeiptr size, const void* /*data*/) {
+    record(GLCall::BufferSubData, target, (uint64_t)offset, (uint64_t)size);
+}
+void APIENTRY GLRecorder::programUniform1i(const GLuint program, const GLint location, const GLint value) {
+    record(GLCall::ProgramUniform1i, program, (uint64_t)location, (uint64_t)value);
+}
+void APIENTRY GLRecorder::uniform1i(const GLint location, const GLint /*value*/) {
+    record(GLCall::Uniform, (uint64_t)location);
+}
+void APIENTRY GLRecorder::uniform1f(const GLint location, const GLfloat /*value*/) {
+    record(GLCall::Uniform, (uint64_t)location);
+}
+void APIENTRY GLRecorder::uniform3fv(const GLint location, const GLsizei /*count*/, const GLfloat* /*value*/) {
+    record(GLCall::Uniform, (uint64_t)location);
+}
+void APIENTRY GLRecorder::uniformMatrix3fv(const GLint location, const GLsizei /*count*/, const GLboolean /*transpose*/,
+                                           const GLfloat* /*value*/) {
+    record(GLCall::Uniform, (uint64_t)location);
+}
+void APIENTRY GLRecorder::uniformMatrix4fv(const GLint location, const GLsizei /*count*/, const GLboolean /*transpose*/,
+                                           const GLfloat* /*value*/) {
+    record(GLCall::Uniform, (uint64_t)location);
+}
+void APIENTRY GLRecorder::multiDrawElementsIndirect(const GLenum mode, const GLenum /*type*/, const void* indirect,
+                                                    const GLsizei drawCount, const GLsizei /*stride*/) {
+    record(GLCall::MultiDrawElementsIndirect, mode, (uint64_t)drawCount, (uint64_t)indirect);
+}
+void APIENTRY GLRecorder::enableVertexArrayAttrib(const GLuint vaobj, const GLuint index) {
+    record(GLCall::VertexArrayAttrib, vaobj, index);
+}
+void APIENTRY GLRecorder::vertexArrayAttribFormat(const GLuint vaobj, const GLuint attribindex, const GLint /*size*/,
+                                                  const GLenum /*type*/, const GLboolean /*normalized*/,
+                                                  const GLuint /*relativeoffset*/) {
+    record(GLCall::VertexArrayAttrib, vaobj, attribindex);
+}
+void APIENTRY GLRecorder::vertexArrayAttribBinding(const GLuint vaobj, const GLuint attribindex,
+                                                   const GLuint /*bindingindex*/) {
+    record(GLCall::VertexArrayAttrib, vaobj, attribindex);
+}
+void APIENTRY GLRecorder::vertexArrayBindingDivisor(const GLuint vaobj, const GLuint bindingindex, const GLuint /*divisor*/) {
+    record(GLCall::VertexArrayAttrib, vaobj, bindingindex);
+}
+void APIENTRY GLRecorder::vertexArrayVertexBuffer(const GLuint vaobj, const GLuint bindingindex, const GLuint buffer,
+                                                  const GLintptr /*offset*/, const GLsizei /*stride*/) {
+    record(GLCall::VertexArrayVertexBuffer, vaobj, bindingindex, buffer);
+}
+void APIENTRY GLRecorder::getIntegerv(const GLenum name, GLint* data) {
+    *data = name == GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT ? 256 : 0;
+}
@@ -0,0 +1,98 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef GLRECORDER_H
+#define GLRECORDER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+
+// 被记录的OpenGL调用
+enum class GLCall : uint8_t {
+    UseProgram,
+    BindVertexArray,
+    ActiveTexture,
+    BindTexture,
+    BindBuffer,
+    BindBufferRange,
+    GenBuffers,
+    DeleteBuffers,
+    BufferData,
+    BufferSubData,
+    ProgramUniform1i,
+    // glUniform1i/1f/3fv/Matrix3fv/Matrix4fv, 参数为位置
+    Uniform,
+    MultiDrawElementsIndirect,
+    // glEnableVertexArrayAttrib/VertexArrayAttribFormat/VertexArrayAttribBinding/VertexArrayBindingDivisor,
+    // 参数为VAO和属性(或绑定点)
+    VertexArrayAttrib,
+    // 参数为VAO, 绑定点和缓冲
+    VertexArrayVertexBuffer,
+    Count
+};
+
+// 一次调用和它的前几个整数参数
+struct GLRecord {
+    GLCall call;
+    uint64_t args[3];
+};
+
+/**
+ * 录制用的OpenGL替身: 构造时把glad中上面这些函数的指针换成只记录参数的函数, 析构时恢复原来的指针
+ * 不需要OpenGL上下文, 用来在CPU上检查渲染代码发出了哪些状态切换. 同一时间只能有一个
+ * glGenBuffers返回递增的名字, glGetIntegerv对GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT返回256, 其他返回0
+ */
+class GLRecorder {
+public:
+    GLRecorder();
+    ~GLRecorder();
+    GLRecorder(const GLRecorder&) = delete;
+    GLRecorder& operator=(const GLRecorder&) = delete;
+
+    uint32_t count(GLCall call) const { return counts[(size_t)call]; }
+    const std::vector<GLRecord>& getRecords() const { return records; }
+    void clear();
+
+private:
+    std::vector<GLRecord> records;
+    uint32_t counts[(size_t)GLCall::Count]{};
+    GLuint nextName{1};
+
+    struct SavedPointers;
+    SavedPointers* saved;
+
+    static GLRecorder* active;
+    static void record(GLCall call, uint64_t a = 0, uint64_t b = 0, uint64_t c = 0);
+
+    // 录制函数
+    static void APIENTRY useProgram(GLuint program);
+    static void APIENTRY bindVertexArray(GLuint array);
+    static void APIENTRY activeTexture(GLenum texture);
+    static void APIENTRY bindTexture(GLenum target, GLuint texture);
+    static void APIENTRY bindBuffer(GLenum target, GLuint buffer);
+    static void APIENTRY bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    static void APIENTRY genBuffers(GLsizei n, GLuint* buffers);
+    static void APIENTRY deleteBuffers(GLsizei n, const GLuint* buffers);
+    static void APIENTRY bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+    static void APIENTRY bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+    static void APIENTRY programUniform1i(GLuint program, GLint location, GLint value);
+    static void APIENTRY uniform1i(GLint location, GLint value);
+    static void APIENTRY uniform1f(GLint location, GLfloat value);
+    static void APIENTRY uniform3fv(GLint location, GLsizei count, const GLfloat* value);
+    static void APIENTRY uniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    static void APIENTRY uniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    static void APIENTRY multiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawCount, GLsizei stride);
+    static void APIENTRY enableVertexArrayAttrib(GLuint vaobj, GLuint index);
+    static void APIENTRY vertexArrayAttribFormat(GLuint vaobj, GLuint attribindex, GLint size, GLenum type,
+                                                 GLboolean normalized, GLuint relativeoffset);
+    static void APIENTRY vertexArrayAttribBinding(GLuint vaobj, GLuint attribindex, GLuint bindingindex);
+    static void APIENTRY vertexArrayBindingDivisor(GLuint vaobj, GLuint bindingindex, GLuint divisor);
+    static void APIENTRY vertexArrayVertexBuffer(GLuint vaobj, GLuint bindingindex, GLuint buffer, GLintptr offset,
+                                                 GLsizei stride);
+    static void APIENTRY getIntegerv(GLenum name, GLint* data);
+};
+
+#endif //GLRECORDER_H
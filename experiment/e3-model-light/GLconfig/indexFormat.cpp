@@ -0,0 +1,88 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+
+#include "indexFormat.h"
+
+namespace {
+    constexpr uint32_t MAX_SHORT_INDEX = 0xFFFF;
+}
+
+GLenum chooseIndexType(const uint32_t maxIndex) {
+    if (maxIndex <= 0xFF) {
+        return GL_UNSIGNED_BYTE;
+    }
+    if (maxIndex <= MAX_SHORT_INDEX) {
+        return GL_UNSIGNED_SHORT;
+    }
+    return GL_UNSIGNED_INT;
+}
+
+size_t indexTypeSize(const GLenum type) {
+    switch (type) {
+        case GL_UNSIGNED_BYTE:
+            return sizeof(GLubyte);
+        case GL_UNSIGNED_SHORT:
+            return sizeof(GLushort);
+        default:
+            return sizeof(GLuint);
+    }
+}
+
+const char* indexTypeName(const GLenum type) {
+    switch (type) {
+        case GL_UNSIGNED_BYTE:
+            return "8-bit";
+        case GL_UNSIGNED_SHORT:
+            return "16-bit";
+        default:
+            return "32-bit";
+    }
+}
+
+void appendShortIndices(const GLuint* indices, const size_t indexCount, uint32_t& vertexCount, PackedIndices& packed) {
+    packed.unpackedBytes += indexCount * sizeof(GLuint);
+    // 当前段的32位索引, 以及段内的顶点下标范围
+    std::vector<GLuint> segment;
+    GLuint min = UINT32_MAX, max = 0;
+    auto flush = [&] {
+        if (segment.empty()) {
+            return;
+        }
+        packed.draws.push_back({packed.indices.size() * sizeof(GLushort), (uint32_t)segment.size(), (GLint)min});
+        for (const GLuint index : segment) {
+            packed.indices.push_back((GLushort)(index - min));
+        }
+        segment.clear();
+        min = UINT32_MAX;
+        max = 0;
+    };
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        GLuint triangle[3] = {indices[i], indices[i + 1], indices[i + 2]};
+        GLuint triangleMin = std::min({triangle[0], triangle[1], triangle[2]});
+        GLuint triangleMax = std::max({triangle[0], triangle[1], triangle[2]});
+        if (triangleMax - triangleMin > MAX_SHORT_INDEX) {
+            for (GLuint& index : triangle) {
+                packed.duplicatedVertices.push_back(index);
+                index = vertexCount++;
+            }
+            triangleMin = triangle[0];
+            triangleMax = triangle[2];
+        }
+        if (!segment.empty() && std::max(max, triangleMax) - std::min(min, triangleMin) > MAX_SHORT_INDEX) {
+            flush();
+        }
+        segment.insert(segment.end(), triangle, triangle + 3);
+        min = std::min(min, triangleMin);
+        max = std::max(max, triangleMax);
+    }
+    flush();
+}
+
+PackedIndices packIndices(const GLuint* indices, const size_t indexCount, uint32_t vertexCount) {
+    PackedIndices packed;
+    appendShortIndices(indices, indexCount, vertexCount, packed);
+    return packed;
+}
@@ -0,0 +1,52 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef INDEXFORMAT_H
+#define INDEXFORMAT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+
+/**
+ * 索引缓冲的紧凑格式. 原来所有索引都是GL_UNSIGNED_INT, 24个顶点的长方体每个索引也要4字节
+ * 现在所有网格的索引都以16位上传到GeometryArena(GeometryArena::INDEX_TYPE):
+ *  - 按三角形的原有顺序切分成若干段, 每段内的顶点下标跨度不超过65535, 存储相对于段起始顶点的下标,
+ *    起始顶点放在绘制命令的baseVertex中
+ *  - 单个三角形的顶点下标跨度超过65535时(很少见), 把它的三个顶点复制一份接在原顶点后面, 让它能够单独成段
+ * 经过MeshOptimizer的顶点读取优化后, 相邻三角形的顶点下标很接近, 段数接近顶点数 / 65536
+ */
+
+// 一次绘制调用: 在索引缓冲中的字节偏移, 索引数量, 以及加到每个索引上的基础顶点
+struct IndexedDraw {
+    size_t byteOffset{0};
+    uint32_t count{0};
+    GLint baseVertex{0};
+};
+
+// 切分后的16位索引
+struct PackedIndices {
+    std::vector<GLushort> indices;
+    std::vector<IndexedDraw> draws;
+    // 复制出来的顶点依次接在原顶点后面, 这里记录每个新顶点复制的是哪个原顶点
+    std::vector<GLuint> duplicatedVertices;
+    // 全部使用32位索引时的字节数, 用于统计节省的显存
+    size_t unpackedBytes{0};
+};
+
+// 能表示maxIndex的最窄的索引类型. 只用于统计和打印, 上传时总是使用16位
+GLenum chooseIndexType(uint32_t maxIndex);
+// 索引类型的字节数
+size_t indexTypeSize(GLenum type);
+// 用于打印: "8-bit", "16-bit", "32-bit"
+const char* indexTypeName(GLenum type);
+
+// 把一级32位索引切分为16位的段, 追加到packed中(字节偏移接在已有的索引之后). 索引数量需要是3的倍数
+// vertexCount是当前的顶点数(包括之前复制的顶点), 复制的顶点从这里开始编号, 之后vertexCount随之增加
+void appendShortIndices(const GLuint* indices, size_t indexCount, uint32_t& vertexCount, PackedIndices& packed);
+// 只切分一级索引, vertexCount是原顶点数
+PackedIndices packIndices(const GLuint* indices, size_t indexCount, uint32_t vertexCount);
+
+#endif //INDEXFORMAT_H
@@ -0,0 +1,141 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "indexFormatBenchmark.h"
+#include "benchmarkCheck.h"
+#include "geometryArena.h"
+#include "indexFormat.h"
+#include "meshGenerator.h"
+
+using namespace benchmark;
+
+namespace {
+    // 按绘制调用还原为32位索引, 与GPU读取的方式相同: 读出16位相对下标, 再加上基础顶点
+    // 复制出来的顶点(下标不小于vertexCount)换回它复制的原顶点
+    std::vector<GLuint> unpack(const PackedIndices& packed, const uint32_t vertexCount, uint32_t& maxVertex) {
+        std::vector<GLuint> indices;
+        maxVertex = 0;
+        for (const IndexedDraw& draw : packed.draws) {
+            const size_t first = draw.byteOffset / sizeof(GLushort);
+            if (first + draw.count > packed.indices.size()) {
+                return {};
+            }
+            for (uint32_t i = 0; i < draw.count; i++) {
+                GLuint value = packed.indices[first + i] + (GLuint)draw.baseVertex;
+                maxVertex = std::max(maxVertex, value);
+                if (value >= vertexCount) {
+                    if (value - vertexCount >= packed.duplicatedVertices.size()) {
+                        return {};
+                    }
+                    value = packed.duplicatedVertices[value - vertexCount];
+                }
+                indices.push_back(value);
+            }
+        }
+        return indices;
+    }
+
+    uint32_t vertexCountOf(const std::vector<GLuint>& indices) {
+        return indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1;
+    }
+
+    // 打包后检查还原结果, 返回打包结果
+    PackedIndices checkRoundTrip(const std::string& name, const std::vector<GLuint>& indices) {
+        const uint32_t vertexCount = vertexCountOf(indices);
+        uint32_t totalVertices = vertexCount;
+        PackedIndices packed;
+        appendShortIndices(indices.data(), indices.size(), totalVertices, packed);
+        uint32_t maxVertex;
+        const bool sameIndices = unpack(packed, vertexCount, maxVertex) == indices;
+        bool trianglesWhole = true;
+        for (const IndexedDraw& draw : packed.draws) {
+            trianglesWhole = trianglesWhole && draw.count % 3 == 0;
+        }
+        check(sameIndices && trianglesWhole && maxVertex < totalVertices
+              && totalVertices == vertexCount + packed.duplicatedVertices.size()
+              && packed.unpackedBytes == indices.size() * sizeof(GLuint),
+              name + ": " + std::to_string(packed.draws.size()) + " draws, "
+              + std::to_string(packed.duplicatedVertices.size()) + " duplicated vertices, "
+              + std::to_string(packed.indices.size() * sizeof(GLushort)) + "/" + std::to_string(packed.unpackedBytes)
+              + " bytes, round trip " + (sameIndices ? "identical" : "MISMATCH"));
+        return packed;
+    }
+}
+
+void checkIndexFormat() {
+    std::cout << "type selection (report only):" << std::endl;
+    check(chooseIndexType(255) == GL_UNSIGNED_BYTE && chooseIndexType(256) == GL_UNSIGNED_SHORT
+          && chooseIndexType(65535) == GL_UNSIGNED_SHORT && chooseIndexType(65536) == GL_UNSIGNED_INT,
+          "boundaries: 255 -> 8-bit, 256/65535 -> 16-bit, 65536 -> 32-bit");
+    check(indexTypeSize(GL_UNSIGNED_BYTE) == 1 && indexTypeSize(GeometryArena::INDEX_TYPE) == 2 && indexTypeSize(GL_UNSIGNED_INT) == 4,
+          "type sizes 1, 2, 4 bytes, the arena uploads 2");
+
+    std::cout << "16-bit split (GeometryArena::upload):" << std::endl;
+    const PackedIndices box = checkRoundTrip("box", MeshGenerator::box(1.0f, 1.0f, 1.0f).indices);
+    const PackedIndices sphere = checkRoundTrip("sphere 60", MeshGenerator::sphere(1.0f, 60, 60).indices);
+    check(box.draws.size() == 1 && sphere.draws.size() == 1 && box.draws[0].baseVertex == 0,
+          "meshes under 65536 vertices are a single draw");
+    // 263169个顶点, 至少切分为5段
+    const PackedIndices split = checkRoundTrip("sphere 512", MeshGenerator::sphere(1.0f, 512, 512).indices);
+    check(split.draws.size() >= 5 && split.draws.size() <= 10 && split.duplicatedVertices.empty(),
+          "sphere 512 split into " + std::to_string(split.draws.size()) + " ranges (minimum 5) without duplicating vertices");
+    const bool increasing = std::is_sorted(split.draws.begin(), split.draws.end(), [](const IndexedDraw& a, const IndexedDraw& b) {
+        return a.byteOffset < b.byteOffset;
+    });
+    check(increasing && split.indices.size() * sizeof(GLushort) == split.unpackedBytes / 2, "ranges are contiguous 16-bit spans");
+
+    // 打乱顶点下标: 大部分三角形自己的跨度就超过65535, 只能复制顶点单独成段
+    std::vector<GLuint> shuffled = MeshGenerator::sphere(1.0f, 512, 512).indices;
+    std::vector<GLuint> order(513 * 513);
+    for (GLuint i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::mt19937 random(1);
+    std::shuffle(order.begin(), order.end(), random);
+    for (auto& index : shuffled) {
+        index = order[index];
+    }
+    const PackedIndices scattered = checkRoundTrip("shuffled sphere 512", shuffled);
+    check(!scattered.duplicatedVertices.empty() && scattered.duplicatedVertices.size() % 3 == 0,
+          "triangles spanning more than 65535 vertices get their own copies");
+
+    // 多级索引连续存放, 与GeometryArena::upload相同: 第二级的偏移接在第一级之后, 复制的顶点继续编号
+    const std::vector<GLuint> first = MeshGenerator::sphere(1.0f, 60, 60).indices;
+    const std::vector<GLuint> second = {0, 1, 70000, 0, 1, 2};
+    uint32_t vertexCount = 70001;
+    PackedIndices levels;
+    appendShortIndices(first.data(), first.size(), vertexCount, levels);
+    const size_t firstDraws = levels.draws.size();
+    appendShortIndices(second.data(), second.size(), vertexCount, levels);
+    check(levels.draws[firstDraws].byteOffset == first.size() * sizeof(GLushort) && vertexCount == 70004
+          && levels.duplicatedVertices == std::vector<GLuint>({0, 1, 70000}),
+          "levels are appended after each other, duplicated vertices keep counting");
+
+    uint32_t emptyMax;
+    const PackedIndices empty = packIndices(nullptr, 0, 0);
+    check(empty.indices.empty() && empty.draws.empty() && unpack(empty, 0, emptyMax).empty(), "empty index list packs to nothing");
+}
+
+void benchmarkIndexFormat() {
+    std::cout << "pack:" << std::endl;
+    const std::vector<GLuint> indices = MeshGenerator::sphere(1.0f, 2048, 2048).indices;
+    const auto start = Clock::now();
+    const PackedIndices packed = packIndices(indices.data(), indices.size(), vertexCountOf(indices));
+    const double ms = elapsedMs(start);
+    std::cout << "  sphere 2048: " << indices.size() << " indices in " << ms << " ms, " << packed.draws.size() << " draws, "
+              << packed.indices.size() * sizeof(GLushort) / 1024 << "/" << packed.unpackedBytes / 1024 << " KB" << std::endl;
+}
+
+void runIndexFormatBenchmarks() {
+    beginChecks("index format");
+    checkIndexFormat();
+    benchmarkIndexFormat();
+    endChecks();
+}
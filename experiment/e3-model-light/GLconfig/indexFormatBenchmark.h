@@ -0,0 +1,21 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef INDEXFORMATBENCHMARK_H
+#define INDEXFORMATBENCHMARK_H
+
+/**
+ * 索引类型统计和16位切分(GeometryArena上传时使用)的测试, 在窗口中按B键运行. 只处理CPU端的数据, 不需要OpenGL上下文
+ * 打包后的索引按绘制调用(字节偏移 + 基础顶点)还原, 与原来的32位索引逐个比较
+ */
+
+// 类型统计的边界; 小网格一段; 大网格切分为多段; 跨度过大的三角形复制顶点; 多级索引连续存放; 所有情况都能还原
+void checkIndexFormat();
+
+// 大网格打包的耗时
+void benchmarkIndexFormat();
+
+void runIndexFormatBenchmarks();
+
+#endif //INDEXFORMATBENCHMARK_H
@@ -0,0 +1,55 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+
+#include "indirectDraw.h"
+
+void appendIndirectCommands(const std::vector<IndexedDraw>& draws, const size_t indexSize, const uint32_t firstIndex,
+                            const GLint baseVertex, std::vector<DrawElementsIndirectCommand>& commands,
+                            const uint32_t instanceCount, const uint32_t baseInstance) {
+    for (const IndexedDraw& draw : draws) {
+        DrawElementsIndirectCommand command;
+        command.count = draw.count;
+        command.instanceCount = instanceCount;
+        command.firstIndex = firstIndex + (GLuint)(draw.byteOffset / indexSize);
+        command.baseVertex = baseVertex + draw.baseVertex;
+        command.baseInstance = baseInstance;
+        commands.push_back(command);
+    }
+}
+
+void appendIndirectCommands(const std::vector<IndexedDraw>& draws, const size_t indexSize, const uint32_t firstIndex,
+                            const GLint baseVertex, const std::vector<MeshletRange>& ranges,
+                            std::vector<DrawElementsIndirectCommand>& commands, const uint32_t instanceCount,
+                            const uint32_t baseInstance) {
+    if (draws.empty()) {
+        return;
+    }
+    // 这一级索引的开头. ranges和draws都是按位置递增的, 双指针求交
+    const size_t levelFirst = draws[0].byteOffset / indexSize;
+    size_t drawIndex = 0;
+    for (const MeshletRange& range : ranges) {
+        size_t first = levelFirst + range.firstIndex;
+        const size_t end = first + range.count;
+        while (first < end && drawIndex < draws.size()) {
+            const IndexedDraw& draw = draws[drawIndex];
+            const size_t drawFirst = draw.byteOffset / indexSize;
+            const size_t drawEnd = drawFirst + draw.count;
+            if (first >= drawEnd) {
+                drawIndex++;
+                continue;
+            }
+            const size_t last = std::min(end, drawEnd);
+            DrawElementsIndirectCommand command;
+            command.count = (GLuint)(last - first);
+            command.instanceCount = instanceCount;
+            command.firstIndex = firstIndex + (GLuint)first;
+            command.baseVertex = baseVertex + draw.baseVertex;
+            command.baseInstance = baseInstance;
+            commands.push_back(command);
+            first = last;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef INDIRECTDRAW_H
+#define INDIRECTDRAW_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+#include "indexFormat.h"
+#include "meshlet.h"
+
+// glMultiDrawElementsIndirect读取的命令, 布局由OpenGL规定
+struct DrawElementsIndirectCommand {
+    GLuint count{0};
+    GLuint instanceCount{1};
+    GLuint firstIndex{0};
+    GLint baseVertex{0};
+    GLuint baseInstance{0};
+};
+
+/**
+ * 把网格的绘制调用(见indexFormat.h)转为间接绘制命令, 只填充数据, 不调用OpenGL
+ * draws中的byteOffset是相对于网格索引分配起点的字节偏移, baseVertex是相对于网格顶点分配起点的
+ * firstIndex/baseVertex为网格在共享缓冲(GeometryArena)中的索引/顶点偏移, 会加到每条命令上
+ */
+void appendIndirectCommands(const std::vector<IndexedDraw>& draws, size_t indexSize, uint32_t firstIndex,
+                            GLint baseVertex, std::vector<DrawElementsIndirectCommand>& commands,
+                            uint32_t instanceCount = 1, uint32_t baseInstance = 0);
+
+// 只绘制ranges中的部分(例如meshlet剔除后的可见范围). ranges的位置相对于这一级索引的开头
+// 每个范围与draws求交, 一个范围可能跨越16位索引的分段, 会拆成多条命令
+void appendIndirectCommands(const std::vector<IndexedDraw>& draws, size_t indexSize, uint32_t firstIndex,
+                            GLint baseVertex, const std::vector<MeshletRange>& ranges,
+                            std::vector<DrawElementsIndirectCommand>& commands,
+                            uint32_t instanceCount = 1, uint32_t baseInstance = 0);
+
+#endif //INDIRECTDRAW_H
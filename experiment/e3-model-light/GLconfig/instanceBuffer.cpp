@@ -0,0 +1,45 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+
+#include "instanceBuffer.h"
+
+std::vector<GLuint> InstanceBuffer::configuredVAOs;
+
+InstanceBuffer::~InstanceBuffer() {
+    if (buffer) {
+        glDeleteBuffers(1, &buffer);
+    }
+}
+
+void InstanceBuffer::upload(const GLuint vao) {
+    if (matrices.empty()) {
+        return;
+    }
+    if (!buffer) {
+        glGenBuffers(1, &buffer);
+    }
+    // 通过COPY_WRITE绑定点上传, 不影响GL_ARRAY_BUFFER和任何VAO
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)(matrices.size() * sizeof(glm::mat4)), matrices.data(),
+                 GL_STREAM_DRAW);
+    setupAttributes(vao);
+    glVertexArrayVertexBuffer(vao, INSTANCE_BINDING, buffer, 0, sizeof(glm::mat4));
+}
+
+void InstanceBuffer::setupAttributes(const GLuint vao) {
+    if (std::find(configuredVAOs.begin(), configuredVAOs.end(), vao) != configuredVAOs.end()) {
+        return;
+    }
+    // mat4占4个location, 每一列一个vec4
+    for (GLuint column = 0; column < 4; column++) {
+        const GLuint location = MATRIX_LOCATION + column;
+        glEnableVertexArrayAttrib(vao, location);
+        glVertexArrayAttribFormat(vao, location, 4, GL_FLOAT, GL_FALSE, column * sizeof(glm::vec4));
+        glVertexArrayAttribBinding(vao, location, INSTANCE_BINDING);
+    }
+    glVertexArrayBindingDivisor(vao, INSTANCE_BINDING, 1);
+    configuredVAOs.push_back(vao);
+}
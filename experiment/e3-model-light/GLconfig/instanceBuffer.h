@@ -0,0 +1,54 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef INSTANCEBUFFER_H
+#define INSTANCEBUFFER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+
+/**
+ * 逐实例的模型矩阵. CPU端先追加所有实例, 再一次上传到一个顶点缓冲, 挂到VAO的INSTANCE_BINDING绑定点上
+ * 着色器中是location为MATRIX_LOCATION ~ MATRIX_LOCATION + 3的mat4 aInstanceMatrix, 绑定点的divisor为1,
+ * 每个实例读取一个矩阵. 间接绘制命令的baseInstance指向命令的第一个实例
+ *
+ * 属性格式和绑定点只通过DSA设置(glVertexArray*), 不需要绑定VAO, 也不影响VAO中原来的顶点属性.
+ * 一个VAO第一次挂上实例缓冲时才启用这些属性, 之前着色器读到的是属性的默认值(不应该使用)
+ */
+class InstanceBuffer {
+public:
+    static constexpr GLuint MATRIX_LOCATION = 4;
+    static constexpr GLuint INSTANCE_BINDING = 4;
+
+    InstanceBuffer() = default;
+    ~InstanceBuffer();
+    InstanceBuffer(const InstanceBuffer&) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    void clear() { matrices.clear(); }
+    void reserve(const uint32_t count) { matrices.reserve(count); }
+    // 返回实例的下标
+    uint32_t append(const glm::mat4& matrix) {
+        matrices.push_back(matrix);
+        return (uint32_t)(matrices.size() - 1);
+    }
+    uint32_t size() const { return (uint32_t)matrices.size(); }
+    const std::vector<glm::mat4>& getMatrices() const { return matrices; }
+
+    // 上传所有实例(每次重新分配存储, 不等待上一帧的绘制), 并挂到vao上. 没有实例时什么都不做
+    void upload(GLuint vao);
+    GLuint getBuffer() const { return buffer; }
+
+private:
+    std::vector<glm::mat4> matrices;
+    GLuint buffer{0};
+
+    // 设置过实例属性格式的VAO, 所有实例缓冲共用. VAO很少, 线性查找
+    static std::vector<GLuint> configuredVAOs;
+    static void setupAttributes(GLuint vao);
+};
+
+#endif //INSTANCEBUFFER_H
@@ -0,0 +1,268 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+#include "material.h"
+
+namespace {
+    /**
+     * 所有材质共享的uniform缓冲. CPU端保留每个槽的内容, 只把修改过的槽写入GPU; 槽数超过容量时重新分配整个缓冲
+     */
+    struct MaterialBuffer {
+        GLuint buffer{0};
+        GLsizeiptr stride{0};
+        uint32_t capacity{0};
+        std::vector<MaterialBlock> blocks;
+        std::vector<bool> used;
+        std::vector<uint32_t> freeSlots;
+        std::vector<uint32_t> dirtySlots;
+
+        uint32_t allocate() {
+            uint32_t slot;
+            if (!freeSlots.empty()) {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            } else {
+                slot = (uint32_t)blocks.size();
+                blocks.emplace_back();
+                used.push_back(false);
+            }
+            used[slot] = true;
+            return slot;
+        }
+
+        void release(const uint32_t slot) {
+            used[slot] = false;
+            freeSlots.push_back(slot);
+        }
+
+        void write(const uint32_t slot, const MaterialProperties& properties) {
+            blocks[slot].ambient = glm::vec4(properties.ambient, 1.0f);
+            blocks[slot].diffuse = glm::vec4(properties.diffuse, 1.0f);
+            blocks[slot].specular = glm::vec4(properties.specular, properties.shininess);
+            dirtySlots.push_back(slot);
+        }
+
+        // 返回true表示缓冲被重新分配, 之前的绑定失效
+        bool flush() {
+            if (dirtySlots.empty() && buffer != 0) {
+                return false;
+            }
+            glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+            if (buffer == 0 || blocks.size() > capacity) {
+                if (buffer == 0) {
+                    GLint alignment = 0;
+                    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+                    alignment = std::max(alignment, 16);
+                    stride = (GLsizeiptr)((sizeof(MaterialBlock) + alignment - 1) / alignment * alignment);
+                    glGenBuffers(1, &buffer);
+                    glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+                }
+                capacity = std::max<uint32_t>(64, capacity);
+                while (capacity < blocks.size()) {
+                    capacity *= 2;
+                }
+                // 按对齐后的间隔排列所有槽, 一次上传
+                std::vector<uint8_t> staging((size_t)capacity * stride);
+                for (size_t i = 0; i < blocks.size(); i++) {
+                    std::memcpy(staging.data() + i * stride, &blocks[i], sizeof(MaterialBlock));
+                }
+                glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)staging.size(), staging.data(), GL_DYNAMIC_DRAW);
+                dirtySlots.clear();
+                return true;
+            }
+            std::sort(dirtySlots.begin(), dirtySlots.end());
+            dirtySlots.erase(std::unique(dirtySlots.begin(), dirtySlots.end()), dirtySlots.end());
+            for (const uint32_t slot : dirtySlots) {
+                if (used[slot]) {
+                    glBufferSubData(GL_UNIFORM_BUFFER, slot * stride, sizeof(MaterialBlock), &blocks[slot]);
+                }
+            }
+            dirtySlots.clear();
+            return false;
+        }
+    };
+
+    // 全局共享, 永不释放(与Mesh::getArena相同)
+    MaterialBuffer& getBuffer() {
+        static auto* buffer = new MaterialBuffer();
+        return *buffer;
+    }
+
+    uint32_t nextMaterialId = 1;
+    // bind之前的绑定状态是否已知. 未知时所有纹理单元和缓冲都重新绑定
+    bool bindingsKnown = false;
+    GLuint activeUnit = 0;
+}
+
+Material::Material(const MaterialProperties& properties) : id(nextMaterialId++), properties(properties) {
+    slot = getBuffer().allocate();
+    getBuffer().write(slot, properties);
+    updateSortKey();
+}
+
+Material::~Material() {
+    if (boundMaterial == this) {
+        boundMaterial = nullptr;
+    }
+    getBuffer().release(slot);
+}
+
+bool Material::addTexture(const std::string& type, const GLuint texture) {
+    unsigned int number = 0;
+    if (type == "texture_diffuse")
+        number = ++diffuseCount;
+    else if (type == "texture_specular")
+        number = ++specularCount;
+    const int unit = getTextureUnit(type, number);
+    if (unit < 0) {
+        std::cout << "WARNING::MATERIAL::no texture unit for " << type << number << std::endl;
+        return false;
+    }
+    setTexture((GLuint)unit, texture);
+    return true;
+}
+
+void Material::setTexture(const GLuint unit, const GLuint texture) {
+    const auto it = std::find_if(textures.begin(), textures.end(), [unit](const MaterialTexture& bound) {
+        return bound.unit == unit;
+    });
+    if (it != textures.end()) {
+        it->texture = texture;
+    } else {
+        textures.push_back({texture, unit});
+    }
+    if (boundMaterial == this) {
+        boundMaterial = nullptr;
+    }
+    updateSortKey();
+}
+
+bool Material::hasSameTextures(const Material& other) const {
+    return textures.size() == other.textures.size() &&
+           std::equal(textures.begin(), textures.end(), other.textures.begin(), [](const MaterialTexture& a, const MaterialTexture& b) {
+               return a.texture == b.texture && a.unit == b.unit;
+           });
+}
+
+void Material::setProperties(const MaterialProperties& properties) {
+    this->properties = properties;
+    getBuffer().write(slot, properties);
+}
+
+void Material::updateSortKey() {
+    const GLuint primary = textures.empty() ? 0 : textures.front().texture;
+    sortKey = (uint64_t)primary << 32 | id;
+}
+
+void Material::bind() const {
+    stats.binds++;
+    if (getBuffer().flush()) {
+        boundSlot = UINT32_MAX;
+    }
+    if (!bindingsKnown) {
+        std::fill(std::begin(boundTextures), std::end(boundTextures), UINT32_MAX);
+        boundSlot = UINT32_MAX;
+        activeUnit = UINT32_MAX;
+        bindingsKnown = true;
+    }
+    if (boundMaterial == this) {
+        stats.elidedBinds++;
+        return;
+    }
+    boundMaterial = this;
+
+    for (const MaterialTexture& texture : textures) {
+        if (boundTextures[texture.unit] == texture.texture) {
+            stats.elidedTextureBinds++;
+            continue;
+        }
+        if (activeUnit != texture.unit) {
+            glActiveTexture(GL_TEXTURE0 + texture.unit);
+            activeUnit = texture.unit;
+        }
+        glBindTexture(GL_TEXTURE_2D, texture.texture);
+        boundTextures[texture.unit] = texture.texture;
+        stats.textureBinds++;
+    }
+    // 其他代码默认激活的是0号纹理单元
+    if (activeUnit != 0) {
+        glActiveTexture(GL_TEXTURE0);
+        activeUnit = 0;
+    }
+
+    if (boundSlot != slot) {
+        const MaterialBuffer& buffer = getBuffer();
+        glBindBufferRange(GL_UNIFORM_BUFFER, BLOCK_BINDING, buffer.buffer, slot * buffer.stride, sizeof(MaterialBlock));
+        boundSlot = slot;
+        stats.blockBinds++;
+    }
+}
+
+void Material::resetBindings() {
+    boundMaterial = nullptr;
+    bindingsKnown = false;
+}
+
+void Material::releaseBuffer() {
+    MaterialBuffer& buffer = getBuffer();
+    if (buffer.buffer != 0) {
+        glDeleteBuffers(1, &buffer.buffer);
+    }
+    buffer.buffer = 0;
+    buffer.capacity = 0;
+    buffer.dirtySlots.clear();
+    resetBindings();
+}
+
+UniformName Material::getSamplerUniform(const std::string& type, const unsigned int number) {
+    static constexpr UniformName diffuseNames[] = {
+        "material.texture_diffuse1", "material.texture_diffuse2", "material.texture_diffuse3", "material.texture_diffuse4"
+    };
+    static constexpr UniformName specularNames[] = {
+        "material.texture_specular1", "material.texture_specular2", "material.texture_specular3", "material.texture_specular4"
+    };
+    constexpr unsigned int count = std::size(diffuseNames);
+    if (type == "texture_diffuse" && number >= 1 && number <= count)
+        return diffuseNames[number - 1];
+    if (type == "texture_specular" && number >= 1 && number <= count)
+        return specularNames[number - 1];
+    // 其他类型(原来不加序号)或者更多的纹理, 运行时拼接
+    stats.samplerNameConcatenations++;
+    if (type != "texture_diffuse" && type != "texture_specular")
+        return "material." + type;
+    return "material." + type + std::to_string(number);
+}
+
+int Material::getTextureUnit(const std::string& type, const unsigned int number) {
+    if (number < 1 || number > TEXTURES_PER_TYPE)
+        return -1;
+    if (type == "texture_diffuse")
+        return (int)number - 1;
+    if (type == "texture_specular")
+        return (int)(TEXTURES_PER_TYPE + number - 1);
+    return -1;
+}
+
+void Material::setupSamplers(const Shader* shader) {
+    const GLuint program = shader->getProgram();
+    const auto setSampler = [&](const UniformName name, const GLint unit) {
+        const GLint location = shader->getLocation(name);
+        if (location >= 0) {
+            glProgramUniform1i(program, location, unit);
+        }
+    };
+    for (unsigned int number = 1; number <= TEXTURES_PER_TYPE; number++) {
+        setSampler(getSamplerUniform("texture_diffuse", number), getTextureUnit("texture_diffuse", number));
+        setSampler(getSamplerUniform("texture_specular", number), getTextureUnit("texture_specular", number));
+    }
+    // 几何体和光照贴图着色器的采样器都从0号单元采样(与原来render中每帧设置的相同)
+    setSampler("sampler", 0);
+    setSampler("material.diffuse", 0);
+    setSampler("material.specular", 0);
+}
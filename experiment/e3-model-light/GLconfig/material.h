@@ -0,0 +1,122 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MATERIAL_H
+#define MATERIAL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core.h"
+#include "shader.h"
+
+// 材质的常量. 几何体和模型网格共用
+struct MaterialProperties {
+    // ambient 和 diffuse 一般就是物体本身颜色
+    glm::vec3 ambient{1.0f}; // 环境光照下的颜色
+    glm::vec3 diffuse{1.0f}; // 漫反射光照下的颜色
+    glm::vec3 specular{1.0f}; // 镜面高光的颜色
+    float shininess{32.0f}; // 镜面高光的散射/半径. 值越大, 散射越小(集中)
+};
+
+// 着色器中MaterialBlock的std140布局
+struct MaterialBlock {
+    glm::vec4 ambient;
+    glm::vec4 diffuse;
+    // w为shininess
+    glm::vec4 specular;
+};
+
+// 一张纹理和它固定使用的纹理单元
+struct MaterialTexture {
+    GLuint texture;
+    GLuint unit;
+};
+
+struct MaterialStats {
+    uint64_t binds{0};
+    // 与上一次绑定的材质相同, 什么都没做
+    uint64_t elidedBinds{0};
+    uint64_t textureBinds{0};
+    // 纹理单元上已经是这张纹理
+    uint64_t elidedTextureBinds{0};
+    uint64_t blockBinds{0};
+    // 采样器名字在运行时拼接的次数(其他类型, 或者超过TEXTURES_PER_TYPE张纹理). 只有这时会分配内存
+    uint64_t samplerNameConcatenations{0};
+};
+
+/**
+ * 材质: 纹理和材质常量. 原来每次绘制网格都要比较纹理类型字符串, 拼接采样器名字, 设置采样器并重新绑定每个纹理单元,
+ * render中每个物体还要按名字设置material.ambient/diffuse/specular/shininess
+ *  - 纹理单元在添加纹理时按约定确定: 第N张漫反射纹理用N-1号单元, 第N张镜面纹理用4+N-1号单元.
+ *    单元固定, 所以采样器uniform对每个着色器只需要设置一次(setupSamplers), 绘制时不再设置
+ *  - 常量放在所有材质共享的uniform缓冲中, 每个材质占一段(按GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT对齐),
+ *    绑定时只需要一次glBindBufferRange
+ *  - bind与上一次绑定的材质相同时直接返回, 纹理单元上已经是同一张纹理时也不再绑定
+ * 只在GL线程中使用. 构造时不调用OpenGL, 共享缓冲在第一次bind时创建
+ */
+class Material {
+public:
+    explicit Material(const MaterialProperties& properties = {});
+    ~Material();
+    Material(const Material&) = delete;
+    Material& operator=(const Material&) = delete;
+
+    // 按添加顺序给同类型的纹理编号. 只支持漫反射和镜面纹理(Model只导入这两种), 超出单元数或其他类型返回false
+    bool addTexture(const std::string& type, GLuint texture);
+    // 替换某个单元上的纹理(例如几何体重新加载纹理), 单元上还没有纹理时添加
+    void setTexture(GLuint unit, GLuint texture);
+    const std::vector<MaterialTexture>& getTextures() const { return textures; }
+    bool hasSameTextures(const Material& other) const;
+
+    const MaterialProperties& getProperties() const { return properties; }
+    // 修改常量. 下一次bind之前写入共享缓冲
+    void setProperties(const MaterialProperties& properties);
+
+    // 绑定纹理和常量
+    void bind() const;
+
+    uint32_t getId() const { return id; }
+    // 排序键: 高32位是第一张纹理(纹理相同的材质排在一起), 低32位是材质编号
+    uint64_t getSortKey() const { return sortKey; }
+
+    // 把着色器中所有约定的采样器设置为对应的纹理单元(glProgramUniform, 不需要先begin). 每个着色器只需一次
+    static void setupSamplers(const Shader* shader);
+    // 纹理的采样器名"material.<type><number>"和约定的纹理单元. 不支持时单元为-1
+    static UniformName getSamplerUniform(const std::string& type, unsigned int number);
+    static int getTextureUnit(const std::string& type, unsigned int number);
+    // 其他代码改变了纹理绑定(例如上传纹理)之后调用, 下一次bind时全部重新绑定
+    static void resetBindings();
+    // 删除共享的uniform缓冲, 下一次bind时重新创建并上传所有材质. 测试中替换OpenGL函数(GLRecorder)的前后使用
+    static void releaseBuffer();
+
+    static const MaterialStats& getStats() { return stats; }
+    static void resetStats() { stats = MaterialStats(); }
+
+    // 与着色器中MaterialBlock的binding一致
+    static constexpr GLuint BLOCK_BINDING = 1;
+    static constexpr unsigned int TEXTURES_PER_TYPE = 4;
+    static constexpr unsigned int TEXTURE_UNITS = 2 * TEXTURES_PER_TYPE;
+
+private:
+    uint32_t id;
+    // 在共享uniform缓冲中的位置
+    uint32_t slot;
+    MaterialProperties properties;
+    std::vector<MaterialTexture> textures;
+    unsigned int diffuseCount{0};
+    unsigned int specularCount{0};
+    uint64_t sortKey{0};
+
+    void updateSortKey();
+
+    static inline MaterialStats stats;
+    // 当前绑定的状态, 用于跳过重复的绑定
+    static inline const Material* boundMaterial{nullptr};
+    static inline GLuint boundTextures[TEXTURE_UNITS]{};
+    static inline uint32_t boundSlot{UINT32_MAX};
+};
+
+#endif //MATERIAL_H
@@ -0,0 +1,167 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "materialBenchmark.h"
+#include "benchmarkCheck.h"
+#include "glRecorder.h"
+#include "material.h"
+
+using namespace benchmark;
+
+namespace {
+    // 状态切换的调用数(纹理, 纹理单元和uniform缓冲)
+    uint32_t countStateCalls(const GLRecorder& gl) {
+        return gl.count(GLCall::BindTexture) + gl.count(GLCall::ActiveTexture) + gl.count(GLCall::BindBufferRange);
+    }
+}
+
+void checkMaterialSetup() {
+    std::cout << "setup:" << std::endl;
+    Material material;
+    const bool added = material.addTexture("texture_diffuse", 11) && material.addTexture("texture_specular", 12)
+                       && material.addTexture("texture_diffuse", 13);
+    const auto& textures = material.getTextures();
+    check(added && textures.size() == 3 && textures[0].unit == 0 && textures[1].unit == Material::TEXTURES_PER_TYPE
+          && textures[2].unit == 1, "diffuse N uses unit N-1, specular N uses unit 4+N-1");
+    for (int i = 0; i < 2; i++) {
+        material.addTexture("texture_diffuse", 20 + i);
+    }
+    check(!material.addTexture("texture_diffuse", 30) && !material.addTexture("texture_normal", 31),
+          "fifth diffuse texture and unsupported types are rejected");
+    check(Material::getSamplerUniform("texture_specular", 2).hash == UniformName("material.texture_specular2").hash,
+          "sampler names match the texture numbering");
+
+    Material untextured, sharedA, sharedB;
+    sharedA.addTexture("texture_diffuse", 5);
+    sharedB.addTexture("texture_diffuse", 5);
+    sharedB.addTexture("texture_specular", 6);
+    check(untextured.getSortKey() < sharedA.getSortKey() && sharedA.getSortKey() < sharedB.getSortKey()
+          && sharedB.getSortKey() < material.getSortKey(), "sort key orders by first texture, then by material");
+    check(sharedA.getSortKey() >> 32 == sharedB.getSortKey() >> 32 && sharedA.getId() != sharedB.getId(),
+          "materials sharing a texture share the key's high bits");
+}
+
+void checkMaterialBinding() {
+    std::cout << "binding:" << std::endl;
+    Material::releaseBuffer();
+    {
+        GLRecorder gl;
+        Material first, second;
+        first.addTexture("texture_diffuse", 7);
+        first.addTexture("texture_specular", 8);
+        second.addTexture("texture_diffuse", 7);
+        second.addTexture("texture_specular", 9);
+
+        first.bind();
+        check(gl.count(GLCall::GenBuffers) == 1 && gl.count(GLCall::BufferData) == 1,
+              "first bind creates and fills the shared uniform buffer");
+        check(gl.count(GLCall::BindTexture) == 2 && gl.count(GLCall::BindBufferRange) == 1, "first bind: 2 textures, 1 block range");
+
+        gl.clear();
+        for (int i = 0; i < 100; i++) {
+            first.bind();
+        }
+        check(gl.getRecords().empty(), "100 repeated binds of the same material issue no GL calls");
+
+        gl.clear();
+        second.bind();
+        check(gl.count(GLCall::BindTexture) == 1 && gl.count(GLCall::BindBufferRange) == 1,
+              "switching to a material sharing unit 0 rebinds only the other unit");
+        const auto& records = gl.getRecords();
+        const auto range = std::find_if(records.begin(), records.end(), [](const GLRecord& record) {
+            return record.call == GLCall::BindBufferRange;
+        });
+        check(range != records.end() && range->args[0] == Material::BLOCK_BINDING && range->args[2] % 256 == 0,
+              "block range is bound at an aligned offset");
+
+        gl.clear();
+        MaterialProperties properties = second.getProperties();
+        properties.shininess = 64.0f;
+        second.setProperties(properties);
+        second.bind();
+        check(gl.count(GLCall::BufferSubData) == 1 && countStateCalls(gl) == 0,
+              "changing constants writes one slot and rebinds nothing");
+
+        gl.clear();
+        std::vector<std::unique_ptr<Material>> many;
+        for (int i = 0; i < 100; i++) {
+            many.push_back(std::make_unique<Material>());
+        }
+        many.back()->bind();
+        check(gl.count(GLCall::BufferData) == 1, "growing past the buffer capacity reallocates once");
+
+        Material::resetBindings();
+        gl.clear();
+        first.bind();
+        check(gl.count(GLCall::BindTexture) == 2, "resetBindings forces a full rebind");
+        Material::releaseBuffer();
+    }
+    Material::resetBindings();
+}
+
+void benchmarkMaterialSorting() {
+    std::cout << "sorting:" << std::endl;
+    Material::releaseBuffer();
+    {
+        GLRecorder gl;
+        // 16个材质, 共用8张漫反射纹理, 一半有镜面纹理
+        std::vector<std::unique_ptr<Material>> materials;
+        for (int i = 0; i < 16; i++) {
+            materials.push_back(std::make_unique<Material>());
+            materials.back()->addTexture("texture_diffuse", 100 + i % 8);
+            if (i % 2 == 0) {
+                materials.back()->addTexture("texture_specular", 200 + i);
+            }
+        }
+        // 400次绘制, 场景顺序是随机的
+        std::mt19937 random(7);
+        std::vector<const Material*> draws;
+        for (int i = 0; i < 400; i++) {
+            draws.push_back(materials[random() % materials.size()].get());
+        }
+
+        const auto bindAll = [&] {
+            Material::resetBindings();
+            Material::resetStats();
+            gl.clear();
+            for (const Material* material : draws) {
+                material->bind();
+            }
+        };
+        bindAll();
+        const uint32_t unsortedCalls = countStateCalls(gl);
+        const MaterialStats unsorted = Material::getStats();
+
+        std::stable_sort(draws.begin(), draws.end(), [](const Material* a, const Material* b) {
+            return a->getSortKey() < b->getSortKey();
+        });
+        bindAll();
+        const uint32_t sortedCalls = countStateCalls(gl);
+        const MaterialStats sorted = Material::getStats();
+
+        std::cout << "  scene order: " << unsortedCalls << " state calls (" << unsorted.textureBinds << " texture binds, "
+                  << unsorted.elidedBinds << " binds elided)" << std::endl;
+        std::cout << "  sorted:      " << sortedCalls << " state calls (" << sorted.textureBinds << " texture binds, "
+                  << sorted.elidedBinds << " binds elided)" << std::endl;
+        check(sorted.textureBinds <= 8 + 8 && sorted.elidedBinds == 400 - 16, "sorted draws bind each material once");
+        check(sortedCalls < unsortedCalls, "sorting by material key reduces state changes");
+        Material::releaseBuffer();
+    }
+    Material::resetBindings();
+}
+
+void runMaterialBenchmarks() {
+    beginChecks("material");
+    checkMaterialSetup();
+    checkMaterialBinding();
+    benchmarkMaterialSorting();
+    endChecks();
+}
@@ -0,0 +1,24 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MATERIALBENCHMARK_H
+#define MATERIALBENCHMARK_H
+
+/**
+ * 材质的测试, 在窗口中按B键运行. 通过GLRecorder记录发出的OpenGL调用, 不需要OpenGL上下文
+ * (在窗口中运行时, 测试前后会重新创建材质共享的uniform缓冲)
+ */
+
+// 纹理单元的约定和排序键
+void checkMaterialSetup();
+
+// 重复绑定同一个材质不发出任何调用; 切换材质只绑定不同的纹理单元; 修改常量只写入一个槽
+void checkMaterialBinding();
+
+// 模拟一帧: 几百次绘制使用十几个材质, 按场景顺序和按排序键排序后的绑定次数
+void benchmarkMaterialSorting();
+
+void runMaterialBenchmarks();
+
+#endif //MATERIALBENCHMARK_H
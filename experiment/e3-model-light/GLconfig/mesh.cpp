@@ -2,65 +2,255 @@
 // Created by ROG on 2025/5/8.
 //
 
+#include <iostream>
+#include <sstream>
 #include <string>
 
 #include "mesh.h"
+#include "meshOptimizer.h"
+#include "modelPacker.h"
+#include "vertexQuantizer.h"
 
-Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<TextureInfo>& textures) {
-    this->vertices = vertices;
-    this->indices = indices;
+MeshView CookedMesh::view() const {
+    MeshView view;
+    view.vertices = vertices.data();
+    view.vertexCount = (uint32_t)vertices.size();
+    view.indices = indices.data();
+    view.indexCount = (uint32_t)indices.size();
+    for (const auto& level : lods) {
+        view.lods.push_back({level.indices.data(), (uint32_t)level.indices.size(), level.error});
+    }
+    view.meshlets = meshlets.data();
+    view.meshletCount = (uint32_t)meshlets.size();
+    return view;
+}
+
+Mesh::Mesh(const MeshView& view, const std::vector<TextureInfo>& textures)
+    : Mesh(view, textures, upload(view)) {
+}
+
+Mesh::Mesh(const MeshView& view, const std::vector<TextureInfo>& textures, const ArenaMesh& uploaded) {
+    initialize(view, textures);
+    arenaMesh = uploaded;
+    for (const auto& level : arenaMesh.levels) {
+        uint32_t count = 0;
+        for (const IndexedDraw& draw : level) {
+            count += draw.count;
+        }
+        levelRanges.push_back({0, count});
+    }
+}
+
+Mesh::Mesh(const MeshView& view, const std::vector<TextureInfo>& textures, const ArenaMesh* packed,
+           const SubmeshRange& range) {
+    initialize(view, textures);
+    packedMesh = packed;
+    levelRanges = range.levels;
+}
+
+void Mesh::initialize(const MeshView& view, const std::vector<TextureInfo>& textures) {
     this->textures = textures;
+    vertexCount = view.vertexCount;
+    indexCount = view.indexCount;
+    meshlets.assign(view.meshlets, view.meshlets + view.meshletCount);
 
-    setupMesh();
+    center = view.vertices ? getCenter(view.vertices, vertexCount) : view.center;
+    lodErrors = {0.0f};
+    for (const auto& level : view.lods) {
+        lodErrors.push_back(level.error);
+    }
 }
 
-void Mesh::setupMesh() {
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+size_t Mesh::getIndexBytes() const {
+    size_t count = 0;
+    for (const MeshletRange& range : levelRanges) {
+        count += range.count;
+    }
+    return count * sizeof(GLushort);
+}
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+CookedMesh Mesh::cook(std::vector<Vertex> vertices, std::vector<unsigned int> indices, const uint32_t lodLevels,
+                      const std::string& name) {
+    CookedMesh cooked;
+    cooked.name = name;
+    if (vertices.empty() || indices.empty()) {
+        return cooked;
+    }
+#ifdef DEBUG
+    // 可能在多个线程中同时处理(见MeshImporter), 统计先写到report中, 最后一次输出
+    std::ostringstream report;
+    const size_t unweldedVertices = vertices.size();
+#endif
+    // 先合并相同的顶点, 之后的优化, 简化和meshlet都基于共享顶点的网格
+    MeshOptimizer::weldVertices(vertices, indices);
+    // 重排三角形和顶点: 顶点缓存 -> 过度绘制 -> 顶点读取. 文件中的原始顺序对GPU的缓存很不友好
+#ifdef DEBUG
+    report << "mesh " << name << ": welded " << unweldedVertices << " -> " << vertices.size() << " vertices\n";
+    const VertexCacheStats cacheBefore = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+    const VertexFetchStats fetchBefore = MeshOptimizer::analyzeVertexFetch(indices, vertices.size(), sizeof(Vertex));
+    const OverdrawStats overdrawBefore = MeshOptimizer::analyzeOverdraw(indices, &vertices[0].position, sizeof(Vertex), vertices.size());
+#endif
+    MeshOptimizer::optimize(vertices, indices);
+#ifdef DEBUG
+    const VertexCacheStats cacheAfter = MeshOptimizer::analyzeVertexCache(indices, vertices.size());
+    const VertexFetchStats fetchAfter = MeshOptimizer::analyzeVertexFetch(indices, vertices.size(), sizeof(Vertex));
+    const OverdrawStats overdrawAfter = MeshOptimizer::analyzeOverdraw(indices, &vertices[0].position, sizeof(Vertex), vertices.size());
+    report << "mesh " << name << ": " << indices.size() / 3 << " triangles, ACMR " << cacheBefore.acmr
+           << " -> " << cacheAfter.acmr << ", ATVR " << cacheBefore.atvr << " -> " << cacheAfter.atvr
+           << ", overfetch " << fetchBefore.overfetch << " -> " << fetchAfter.overfetch
+           << ", overdraw " << overdrawBefore.overdraw << " -> " << overdrawAfter.overdraw << "\n";
+#endif
+    // 生成LOD链: 简化只产生新的索引, 与原始网格共用优化后的顶点. 每一级也按顶点缓存重排
+    std::vector<glm::vec3> positions(vertices.size()), normals(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++) {
+        positions[i] = vertices[i].position;
+        normals[i] = vertices[i].normal;
+    }
+    cooked.lods = MeshSimplifier::buildLodChain(indices, positions, normals, lodLevels);
+    for (auto& level : cooked.lods) {
+        MeshOptimizer::optimizeVertexCache(level.indices, (uint32_t)vertices.size());
+    }
+#ifdef DEBUG
+    report << "mesh " << name << " LOD triangles: " << indices.size() / 3;
+    for (const auto& level : cooked.lods) {
+        report << " " << level.indices.size() / 3 << "(error " << level.error << ")";
+    }
+    report << "\n";
+    std::cout << report.str() << std::flush;
+#endif
+    // 划分meshlet, 并把索引换成meshlet的顺序. meshlet内部会按顶点缓存重排, ACMR只比整体优化的结果高约10%
+    MeshletData meshletData = MeshletBuilder::build(indices, positions);
+    cooked.indices = MeshletBuilder::flatten(meshletData);
+    cooked.meshlets = std::move(meshletData.meshlets);
+    cooked.vertices = std::move(vertices);
+    return cooked;
+}
+
+uint32_t Mesh::selectLod(const glm::mat4& modelMatrix, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix,
+                         const float viewportHeight, const float maxPixelError) const {
+    const float pixelsPerUnit = MeshSimplifier::getPixelsPerUnit(center, modelMatrix, viewMatrix, projectionMatrix, viewportHeight);
+    return MeshSimplifier::selectLod(lodErrors, pixelsPerUnit, maxPixelError);
+}
+
+GeometryArena* Mesh::getArena() {
+    // 与Application一样只创建不释放, 程序结束时OpenGL上下文已经销毁
+    static GeometryArena* arena = new GeometryArena("mesh", sizeof(QuantizedVertex), setupVertexAttributes);
+    return arena;
+}
 
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+ArenaMesh Mesh::upload(const MeshView& view) {
+    std::vector<QuantizedVertex> quantized;
+    const QuantizedVertex* vertices = view.quantizedVertices;
+    VertexQuantization quantization = view.quantization;
+    if (!vertices) {
+        quantization = VertexQuantizer::quantize(view.vertices, view.vertexCount, quantized);
+        vertices = quantized.data();
+    }
+    // 打包好的模型已经切分过索引, 顶点和索引(可能是文件映射)直接复制到共享缓冲
+    ArenaMesh mesh = view.shortIndices
+                         ? getArena()->upload(vertices, view.vertexCount, view.shortIndices, view.shortIndexCount,
+                                              view.levelDraws)
+                         : getArena()->upload(vertices, view.vertexCount, getIndexSpans(view));
+    mesh.quantization = quantization;
+    return mesh;
+}
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+void Mesh::setDequantization(const Shader* shader, const VertexQuantization& quantization) {
+    shader->setVec3("positionOffset", quantization.offset);
+    shader->setVec3("positionScale", quantization.scale);
+    shader->setBool("octNormal", true);
+}
 
-    // 顶点位置
+void Mesh::resetDequantization(const Shader* shader) {
+    setDequantization(shader, VertexQuantization());
+    shader->setBool("octNormal", false);
+}
+
+void Mesh::setupVertexAttributes() {
+    // 顶点位置: unorm16, 在着色器中映射为[0, 1], 再按包围盒还原
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    // 顶点纹理坐标
+    glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(QuantizedVertex),
+                          (void*)offsetof(QuantizedVertex, position));
+    // 顶点纹理坐标: 半精度浮点数
     glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
-    // 顶点法线
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(QuantizedVertex), (void*)offsetof(QuantizedVertex, uv));
+    // 顶点法线: 八面体编码的两个snorm8分量, 着色器中z补0
     glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-
-    glBindVertexArray(0);
-}
-
-void Mesh::draw(const Shader* shader) const {
-    unsigned int diffuseNr = 1;
-    unsigned int specularNr = 1;
-    // 绑定模型中的多个纹理对象
-    for(unsigned int i = 0; i < textures.size(); i++) {
-        glActiveTexture(GL_TEXTURE0 + i); // 在绑定之前激活相应的纹理单元
-        // 获取纹理序号（diffuse_textureN 中的 N）
-        std::string number;
-        std::string name = textures[i].type;
-        if(name == "texture_diffuse")
-            number = std::to_string(diffuseNr++);
-        else if(name == "texture_specular")
-            number = std::to_string(specularNr++);
-
-        shader->setInt("material." + name + number, i);
-        glBindTexture(GL_TEXTURE_2D, textures[i].id);
-    }
-    glActiveTexture(GL_TEXTURE0);
-
-    // 绘制网格
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    glVertexAttribPointer(3, 2, GL_BYTE, GL_TRUE, sizeof(QuantizedVertex), (void*)offsetof(QuantizedVertex, normal));
+}
+
+glm::vec3 Mesh::getCenter(const Vertex* vertices, const uint32_t count) {
+    if (count == 0) {
+        return glm::vec3(0.0f);
+    }
+    glm::vec3 minPosition = vertices[0].position, maxPosition = vertices[0].position;
+    for (uint32_t i = 0; i < count; i++) {
+        minPosition = glm::min(minPosition, vertices[i].position);
+        maxPosition = glm::max(maxPosition, vertices[i].position);
+    }
+    return (minPosition + maxPosition) * 0.5f;
+}
+
+std::vector<IndexSpan> Mesh::getIndexSpans(const MeshView& view) {
+    std::vector<IndexSpan> levels{{view.indices, view.indexCount}};
+    for (const auto& level : view.lods) {
+        levels.push_back({level.indices, level.indexCount});
+    }
+    return levels;
+}
+
+void Mesh::draw(const Shader* shader, const uint32_t lod) const {
+    drawCommands.clear();
+    drawRanges.assign(1, levelRanges[lod]);
+    getArena()->appendCommands(getArenaMesh(), lod, drawRanges, drawCommands);
+
+    if (material) {
+        material->bind();
+    }
+    setDequantization(shader, getArenaMesh().quantization);
+    getArena()->bind();
+    getArena()->draw(GL_TRIANGLES, drawCommands);
+    resetDequantization(shader);
+}
+
+void Mesh::drawCulled(const Shader* shader, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                      const glm::mat4& projectionMatrix, MeshletCullStats* stats) const {
+    drawCommands.clear();
+    appendDrawCommands(0, modelMatrix, viewMatrix, projectionMatrix, drawCommands, stats);
+    if (drawCommands.empty()) {
+        return;
+    }
+
+    if (material) {
+        material->bind();
+    }
+    setDequantization(shader, getArenaMesh().quantization);
+    getArena()->bind();
+    getArena()->draw(GL_TRIANGLES, drawCommands);
+    resetDequantization(shader);
+}
+
+void Mesh::appendDrawCommands(const uint32_t lod, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                              const glm::mat4& projectionMatrix, std::vector<DrawElementsIndirectCommand>& commands,
+                              MeshletCullStats* stats) const {
+    drawRanges.clear();
+    appendRanges(lod, modelMatrix, viewMatrix, projectionMatrix, drawRanges, stats);
+    // 可见范围与16位索引分段求交, 每段交集是一条命令
+    getArena()->appendCommands(getArenaMesh(), lod, drawRanges, commands);
+}
+
+void Mesh::appendRanges(const uint32_t lod, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                        const glm::mat4& projectionMatrix, std::vector<MeshletRange>& ranges,
+                        MeshletCullStats* stats) const {
+    const MeshletRange& level = levelRanges[lod];
+    // 简化后的LOD三角形很少, 整级绘制
+    if (lod != 0 || meshlets.empty()) {
+        ranges.push_back(level);
+        return;
+    }
+    // 剔除的结果相对于网格自己的原始索引, 加上网格在这一级中的起点
+    MeshletCuller::cull(meshlets, modelMatrix, viewMatrix, projectionMatrix, visibleRanges, stats);
+    for (const MeshletRange& range : visibleRanges) {
+        ranges.push_back({level.firstIndex + range.firstIndex, range.count});
+    }
 }
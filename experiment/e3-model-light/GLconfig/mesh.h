@@ -5,12 +5,21 @@
 #ifndef MESH_H
 #define MESH_H
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "core.h"
 #include "shader.h"
+#include "geometryArena.h"
+#include "material.h"
+#include "meshSimplifier.h"
+#include "meshlet.h"
+#include "vertexFormat.h"
 #include "assimp/types.h"
 
+struct SubmeshRange;
+
 struct Vertex {
     glm::vec3 position;
     glm::vec3 normal;
@@ -23,6 +32,50 @@ struct TextureInfo {
     // 纹理的路径. 用于判断是否已经加载过对应纹理
     aiString path;
 };
+// 纹理的引用: 类型和相对于模型目录的路径, 由Model加载为TextureInfo. 网格缓存中保存的是它
+struct TextureRef {
+    std::string type;
+    std::string path;
+};
+
+// 一级LOD的索引
+struct MeshLodView {
+    const unsigned int* indices{nullptr};
+    uint32_t indexCount{0};
+    float error{0.0f};
+};
+// 网格数据的只读视图, 可以指向CookedMesh, 也可以直接指向网格缓存的文件映射(见meshCache.h)
+struct MeshView {
+    const Vertex* vertices{nullptr};
+    uint32_t vertexCount{0};
+    // 原始网格的索引, 按meshlet的顺序排列
+    const unsigned int* indices{nullptr};
+    uint32_t indexCount{0};
+    std::vector<MeshLodView> lods;
+    const Meshlet* meshlets{nullptr};
+    uint32_t meshletCount{0};
+    // 已经量化好的顶点(与vertices一一对应)和反量化参数. 为空时上传前再量化(见Mesh::upload)
+    const QuantizedVertex* quantizedVertices{nullptr};
+    VertexQuantization quantization;
+    // 已经切分好的16位索引和每一级的绘制调用(见indexFormat.h). 不为空时直接上传, 不再切分, 这时vertexCount包括切分时复制的顶点
+    // 打包后的模型(见modelPacker.h)有它们, 从网格缓存加载时直接指向文件映射, 没有vertices和indices
+    const GLushort* shortIndices{nullptr};
+    uint32_t shortIndexCount{0};
+    std::vector<std::vector<IndexedDraw>> levelDraws;
+    // 包围盒的中心. 只在没有vertices时使用(网格缓存中的网格只保存了打包后量化的顶点)
+    glm::vec3 center{0.0f};
+};
+// 导入后处理完成的网格, 与网格缓存中的一个网格一一对应
+struct CookedMesh {
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<LodLevel> lods;
+    std::vector<Meshlet> meshlets;
+    std::vector<TextureRef> textures;
+
+    MeshView view() const;
+};
 
 /**
  * 网格类. 用于转化, 存储assimp读取的模型数据以便OpenGL识别和绘制
@@ -30,16 +83,79 @@ struct TextureInfo {
 class Mesh {
 public:
     /*  网格数据  */
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
     std::vector<TextureInfo> textures;
     /*  函数  */
-    Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<TextureInfo>& textures);
-    void draw(const Shader* shader) const;
+    // 直接从视图上传到共享缓冲(见upload), 不在CPU端保留顶点和索引. 简化后的LOD与原始网格共用顶点, 索引依次存放在共享EBO的同一段中
+    Mesh(const MeshView& view, const std::vector<TextureInfo>& textures);
+    // 顶点和索引已经上传过(见assetLoader.h中的UploadBackend), 只建立CPU端的数据(LOD误差, meshlet, 中心)
+    Mesh(const MeshView& view, const std::vector<TextureInfo>& textures, const ArenaMesh& uploaded);
+    // 模型的子网格: 顶点和索引是模型打包后(见modelPacker.h)的一次分配packed中的一段, range给出每一级的位置
+    // packed归模型所有, 需要比网格存活得久
+    Mesh(const MeshView& view, const std::vector<TextureInfo>& textures, const ArenaMesh* packed, const SubmeshRange& range);
+    // 导入时的预处理: 合并相同的顶点 -> 顶点缓存/过度绘制/顶点读取优化 -> 生成lodLevels级LOD链 -> 划分meshlet. name只用于打印
+    static CookedMesh cook(std::vector<Vertex> vertices, std::vector<unsigned int> indices, uint32_t lodLevels,
+                           const std::string& name);
+    // 绘制第lod级, 0为原始网格
+    void draw(const Shader* shader, uint32_t lod = 0) const;
+    // 绘制原始网格, 但先在CPU上按meshlet剔除背向相机和视锥外的部分, 剩下的范围用一次glMultiDrawElementsIndirect绘制
+    void drawCulled(const Shader* shader, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                    const glm::mat4& projectionMatrix, MeshletCullStats* stats = nullptr) const;
+    // 生成间接绘制命令, 不绑定任何状态. lod为0时按meshlet剔除. 用于把使用相同纹理的网格合并为一次绘制
+    void appendDrawCommands(uint32_t lod, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                            const glm::mat4& projectionMatrix, std::vector<DrawElementsIndirectCommand>& commands,
+                            MeshletCullStats* stats = nullptr) const;
+    // 第lod级要绘制的范围(相对于所在分配这一级索引的开头). lod为0时按meshlet剔除, 可见的部分是多个范围
+    // 同一模型的子网格的范围可以合并后一起生成命令(见Model)
+    void appendRanges(uint32_t lod, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                      const glm::mat4& projectionMatrix, std::vector<MeshletRange>& ranges,
+                      MeshletCullStats* stats = nullptr) const;
+    // 第lod级完整的范围, 不剔除. 实例化绘制时每个实例的位置不同, 不能共用一次剔除的结果
+    const MeshletRange& getLevelRange(const uint32_t lod) const { return levelRanges[lod]; }
+    // 顶点和索引所在的分配: 子网格是模型的那一次分配, 否则是自己的
+    const ArenaMesh& getArenaMesh() const { return packedMesh ? *packedMesh : arenaMesh; }
+    // 网格的材质(由textures创建, 纹理相同的网格共用一个, 见Model). 没有材质时绘制不绑定纹理
+    void setMaterial(std::shared_ptr<const Material> material) { this->material = std::move(material); }
+    const Material* getMaterial() const { return material.get(); }
+    // 所有模型网格共用的顶点/索引缓冲. 顶点是量化后的QuantizedVertex(见vertexFormat.h)
+    static GeometryArena* getArena();
+    // 量化顶点(视图中没有量化好的顶点时)并上传到共享缓冲, 反量化参数记录在返回的ArenaMesh中. 视图中有切分好的索引时直接上传
+    static ArenaMesh upload(const MeshView& view);
+    // 设置着色器的反量化参数(位置的包围盒, 八面体法线), 用于直接绘制. reset恢复为float顶点(几何体)的默认值
+    static void setDequantization(const Shader* shader, const VertexQuantization& quantization);
+    static void resetDequantization(const Shader* shader);
+    // 原始网格和各级LOD的索引, 按GeometryArena::upload的顺序
+    static std::vector<IndexSpan> getIndexSpans(const MeshView& view);
+    // 顶点包围盒的中心, 用于选择LOD. 网格缓存写入时也用它计算, 与从float顶点计算的结果相同
+    static glm::vec3 getCenter(const Vertex* vertices, uint32_t count);
+    const std::vector<Meshlet>& getMeshlets() const { return meshlets; }
+    // 按网格中心处的屏幕尺寸选择LOD, 屏幕误差不超过maxPixelError像素
+    uint32_t selectLod(const glm::mat4& modelMatrix, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix,
+                       float viewportHeight, float maxPixelError = 1.0f) const;
+    uint32_t getLodCount() const { return (uint32_t)lodErrors.size(); }
+    // GPU中索引(包括所有LOD)的字节数, 以及原始网格全部使用32位索引时的字节数
+    size_t getIndexBytes() const;
+    size_t getUnpackedIndexBytes() const { return indexCount * sizeof(unsigned int); }
 private:
     /*  渲染数据  */
-    unsigned int VAO, VBO, EBO;
+    // 顶点和所有LOD的索引在共享缓冲中的位置. 网格会被复制(存放在Model的vector中), 所以不在析构时释放
+    ArenaMesh arenaMesh;
+    // 子网格所在的模型分配, 以及每一级在其中的范围. 不是子网格时范围是自己的每一级
+    const ArenaMesh* packedMesh{nullptr};
+    std::vector<MeshletRange> levelRanges;
+    std::shared_ptr<const Material> material;
+    uint32_t vertexCount{0};
+    uint32_t indexCount{0};
+    // 每一级LOD在模型空间中的误差, 以及网格包围盒的中心(用于计算屏幕尺寸)
+    std::vector<float> lodErrors;
+    glm::vec3 center{0.0f};
+    // 原始网格的索引按meshlet的顺序排列, 每个meshlet的三角形是连续的一段
+    std::vector<Meshlet> meshlets;
+    // 每帧剔除时复用的临时数组
+    mutable std::vector<MeshletRange> visibleRanges;
+    mutable std::vector<MeshletRange> drawRanges;
+    mutable std::vector<DrawElementsIndirectCommand> drawCommands;
     /*  函数  */
-    void setupMesh();
+    static void setupVertexAttributes();
+    void initialize(const MeshView& view, const std::vector<TextureInfo>& textures);
 };
 #endif //MESH_H
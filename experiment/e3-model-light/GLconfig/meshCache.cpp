@@ -0,0 +1,630 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "meshCache.h"
+
+static_assert(sizeof(QuantizedVertex) == 12, "QuantizedVertex应当紧密排列, 缓存中的顶点与内存中逐字节相同");
+static_assert(sizeof(MeshletRange) == 8, "子网格的范围直接存放MeshletRange");
+static_assert(sizeof(Meshlet) == 48, "Meshlet应当紧密排列, 缓存中的meshlet与内存中逐字节相同");
+static_assert(sizeof(glm::mat4) == sizeof(MeshCacheNode::local), "节点的局部矩阵直接复制为16个float");
+
+namespace {
+    constexpr char MAGIC[4] = {'E', '3', 'M', 'C'};
+    constexpr uint64_t SECTION_ALIGNMENT = 16;
+
+    uint64_t alignUp(const uint64_t offset) {
+        return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+    }
+
+    // 源文件的大小和修改时间. 文件不存在时返回false
+    bool getSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& time) {
+        std::error_code error;
+        size = std::filesystem::file_size(sourcePath, error);
+        if (error) {
+            return false;
+        }
+        time = (int64_t)std::filesystem::last_write_time(sourcePath, error).time_since_epoch().count();
+        return !error;
+    }
+
+    // [offset, offset + count * elementSize)是否在文件内, 考虑溢出
+    bool inBounds(const uint64_t offset, const uint64_t count, const uint64_t elementSize, const uint64_t size) {
+        return offset <= size && count <= (size - offset) / elementSize;
+    }
+
+    bool inRange(const uint64_t first, const uint64_t count, const uint64_t total) {
+        return first <= total && count <= total - first;
+    }
+
+    // 按偏移写入: 先补0到offset, 再写数据
+    void writeAt(std::ofstream& file, const uint64_t offset, const void* data, const size_t bytes) {
+        static const char zeros[SECTION_ALIGNMENT] = {};
+        const uint64_t position = (uint64_t)file.tellp();
+        if (offset > position) {
+            file.write(zeros, (std::streamsize)(offset - position));
+        }
+        if (bytes > 0) {
+            file.write((const char*)data, (std::streamsize)bytes);
+        }
+    }
+}
+
+MeshCacheFile::~MeshCacheFile() {
+    close();
+}
+
+bool MeshCacheFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cout << "ERROR::MESH_CACHE::cannot open " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        std::cout << "ERROR::MESH_CACHE::empty file " << path << std::endl;
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    // 映射视图会保持文件打开, 两个句柄可以立即关闭
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    if (!view) {
+        std::cout << "ERROR::MESH_CACHE::cannot map " << path << std::endl;
+        return false;
+    }
+    data = (const uint8_t*)view;
+    size = (size_t)fileSize.QuadPart;
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        std::cout << "ERROR::MESH_CACHE::cannot open " << path << std::endl;
+        return false;
+    }
+    struct stat status{};
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        ::close(file);
+        std::cout << "ERROR::MESH_CACHE::empty file " << path << std::endl;
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (view == MAP_FAILED) {
+        std::cout << "ERROR::MESH_CACHE::cannot map " << path << std::endl;
+        return false;
+    }
+    // 接下来会顺序读完整个文件并上传
+    madvise(view, (size_t)status.st_size, MADV_SEQUENTIAL);
+    data = (const uint8_t*)view;
+    size = (size_t)status.st_size;
+#endif
+    if (!validate(path)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MeshCacheFile::close() {
+    if (!data) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap((void*)data, size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+bool MeshCacheFile::validate(const std::string& path) const {
+    auto fail = [&path](const char* reason) {
+        std::cout << "ERROR::MESH_CACHE::" << reason << ": " << path << std::endl;
+        return false;
+    };
+    if (size < sizeof(MeshCacheHeader)) {
+        return fail("file too small");
+    }
+    const MeshCacheHeader& header = getHeader();
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return fail("not a mesh cache");
+    }
+    if (header.version != MeshCache::VERSION || header.vertexSize != sizeof(QuantizedVertex) ||
+        header.meshletSize != sizeof(Meshlet)) {
+        return fail("version or layout mismatch");
+    }
+    if (header.fileSize != size) {
+        return fail("truncated");
+    }
+    if (!inBounds(header.meshTableOffset, header.meshCount, sizeof(MeshCacheEntry), size) ||
+        !inBounds(header.lodTableOffset, header.lodCount, sizeof(MeshCacheLod), size) ||
+        !inBounds(header.textureTableOffset, header.textureCount, sizeof(MeshCacheTexture), size) ||
+        !inBounds(header.nodeTableOffset, header.nodeCount, sizeof(MeshCacheNode), size) ||
+        !inBounds(header.submeshTableOffset, header.submeshCount, sizeof(MeshCacheSubmesh), size) ||
+        !inBounds(header.submeshLevelOffset, (uint64_t)header.submeshCount * header.levelCount, sizeof(MeshletRange), size) ||
+        !inBounds(header.groupTableOffset, header.groupCount, sizeof(MeshCacheGroup), size) ||
+        !inBounds(header.levelTableOffset, header.levelCount, sizeof(MeshCacheLevel), size) ||
+        !inBounds(header.drawTableOffset, header.drawCount, sizeof(MeshCacheDraw), size) ||
+        !inBounds(header.stringOffset, header.stringSize, 1, size) ||
+        !inBounds(header.vertexOffset, header.vertexCount, sizeof(QuantizedVertex), size) ||
+        !inBounds(header.indexOffset, header.indexCount, sizeof(GLushort), size) ||
+        !inBounds(header.meshletOffset, header.meshletCount, sizeof(Meshlet), size)) {
+        return fail("section out of bounds");
+    }
+    const uint64_t offsets[] = {
+        header.meshTableOffset, header.lodTableOffset, header.textureTableOffset, header.nodeTableOffset,
+        header.submeshTableOffset, header.submeshLevelOffset, header.groupTableOffset, header.levelTableOffset,
+        header.drawTableOffset, header.vertexOffset, header.indexOffset, header.meshletOffset
+    };
+    for (const uint64_t offset : offsets) {
+        if (offset % SECTION_ALIGNMENT != 0) {
+            return fail("misaligned section");
+        }
+    }
+
+    const auto* textures = (const MeshCacheTexture*)(data + header.textureTableOffset);
+    const auto* meshlets = (const Meshlet*)(data + header.meshletOffset);
+    for (uint32_t i = 0; i < header.meshCount; i++) {
+        const MeshCacheEntry& entry = getEntry(i);
+        if (!inRange(entry.nameOffset, entry.nameLength, header.stringSize) ||
+            !inRange(entry.firstLod, entry.lodCount, header.lodCount) ||
+            !inRange(entry.firstMeshlet, entry.meshletCount, header.meshletCount) ||
+            !inRange(entry.firstTexture, entry.textureCount, header.textureCount)) {
+            return fail("mesh entry out of range");
+        }
+        for (uint32_t j = 0; j < entry.meshletCount; j++) {
+            const Meshlet& meshlet = meshlets[entry.firstMeshlet + j];
+            if (!inRange(meshlet.triangleOffset, meshlet.triangleCount, entry.indexCount / 3)) {
+                return fail("meshlet out of range");
+            }
+        }
+        for (uint32_t j = 0; j < entry.textureCount; j++) {
+            const MeshCacheTexture& texture = textures[entry.firstTexture + j];
+            if (!inRange(texture.typeOffset, texture.typeLength, header.stringSize) ||
+                !inRange(texture.pathOffset, texture.pathLength, header.stringSize)) {
+                return fail("texture reference out of range");
+            }
+        }
+    }
+
+    // 索引越界会让GPU读到模型的分配以外的顶点, 这里逐个检查. 只是顺序扫描, 上传时这些页面也要读一遍
+    const auto* levels = (const MeshCacheLevel*)(data + header.levelTableOffset);
+    const auto* draws = (const MeshCacheDraw*)(data + header.drawTableOffset);
+    const auto* indices = (const GLushort*)(data + header.indexOffset);
+    std::vector<uint64_t> levelIndexCounts(header.levelCount, 0);
+    for (uint32_t level = 0; level < header.levelCount; level++) {
+        if (!inRange(levels[level].firstDraw, levels[level].drawCount, header.drawCount)) {
+            return fail("level out of range");
+        }
+        for (uint32_t j = 0; j < levels[level].drawCount; j++) {
+            const MeshCacheDraw& draw = draws[levels[level].firstDraw + j];
+            if (!inRange(draw.firstIndex, draw.count, header.indexCount) || draw.baseVertex < 0) {
+                return fail("draw out of range");
+            }
+            for (uint32_t k = 0; k < draw.count; k++) {
+                if ((uint64_t)indices[draw.firstIndex + k] + (uint64_t)draw.baseVertex >= header.vertexCount) {
+                    return fail("index out of range");
+                }
+            }
+            levelIndexCounts[level] += draw.count;
+        }
+    }
+    const auto* submeshes = (const MeshCacheSubmesh*)(data + header.submeshTableOffset);
+    const auto* submeshLevels = (const MeshletRange*)(data + header.submeshLevelOffset);
+    for (uint32_t i = 0; i < header.submeshCount; i++) {
+        const MeshCacheSubmesh& submesh = submeshes[i];
+        if (submesh.mesh >= header.meshCount || !inRange(submesh.baseVertex, submesh.vertexCount, header.vertexCount)) {
+            return fail("submesh out of range");
+        }
+        for (uint32_t level = 0; level < header.levelCount; level++) {
+            const MeshletRange& range = submeshLevels[(uint64_t)i * header.levelCount + level];
+            if (!inRange(range.firstIndex, range.count, levelIndexCounts[level])) {
+                return fail("submesh level out of range");
+            }
+        }
+    }
+    const auto* groups = (const MeshCacheGroup*)(data + header.groupTableOffset);
+    for (uint32_t i = 0; i < header.groupCount; i++) {
+        if (!inRange(groups[i].firstSubmesh, groups[i].submeshCount, header.submeshCount)) {
+            return fail("group out of range");
+        }
+    }
+    // 世界矩阵按数组顺序一次计算, 要求父节点在前
+    const auto* nodes = (const MeshCacheNode*)(data + header.nodeTableOffset);
+    for (uint32_t i = 0; i < header.nodeCount; i++) {
+        const MeshCacheNode& node = nodes[i];
+        if (node.parent < -1 || node.parent >= (int64_t)i ||
+            !inRange(node.firstMesh, node.meshCount, header.meshCount)) {
+            return fail("node out of range");
+        }
+    }
+    return true;
+}
+
+const MeshCacheEntry& MeshCacheFile::getEntry(const uint32_t index) const {
+    return ((const MeshCacheEntry*)(data + getHeader().meshTableOffset))[index];
+}
+
+std::string MeshCacheFile::getString(const uint32_t offset, const uint32_t length) const {
+    return {(const char*)data + getHeader().stringOffset + offset, length};
+}
+
+MeshView MeshCacheFile::getMesh(const uint32_t index) const {
+    const MeshCacheHeader& header = getHeader();
+    const MeshCacheEntry& entry = getEntry(index);
+    const auto* lods = (const MeshCacheLod*)(data + header.lodTableOffset);
+
+    MeshView view;
+    view.vertexCount = entry.vertexCount;
+    view.indexCount = entry.indexCount;
+    for (uint32_t i = 0; i < entry.lodCount; i++) {
+        const MeshCacheLod& lod = lods[entry.firstLod + i];
+        view.lods.push_back({nullptr, lod.indexCount, lod.error});
+    }
+    view.meshlets = (const Meshlet*)(data + header.meshletOffset) + entry.firstMeshlet;
+    view.meshletCount = entry.meshletCount;
+    view.center = glm::vec3(entry.center[0], entry.center[1], entry.center[2]);
+    return view;
+}
+
+MeshView MeshCacheFile::getPackedView() const {
+    const MeshCacheHeader& header = getHeader();
+    const auto* levels = (const MeshCacheLevel*)(data + header.levelTableOffset);
+    const auto* draws = (const MeshCacheDraw*)(data + header.drawTableOffset);
+
+    MeshView view;
+    view.vertexCount = (uint32_t)header.vertexCount;
+    view.quantizedVertices = (const QuantizedVertex*)(data + header.vertexOffset);
+    view.quantization.offset = glm::make_vec3(header.quantizationOffset);
+    view.quantization.scale = glm::make_vec3(header.quantizationScale);
+    view.shortIndices = (const GLushort*)(data + header.indexOffset);
+    view.shortIndexCount = (uint32_t)header.indexCount;
+    view.levelDraws.resize(header.levelCount);
+    for (uint32_t level = 0; level < header.levelCount; level++) {
+        for (uint32_t i = 0; i < levels[level].drawCount; i++) {
+            const MeshCacheDraw& draw = draws[levels[level].firstDraw + i];
+            view.levelDraws[level].push_back({draw.firstIndex * sizeof(GLushort), draw.count, draw.baseVertex});
+        }
+    }
+    return view;
+}
+
+std::vector<SubmeshRange> MeshCacheFile::getSubmeshes() const {
+    const MeshCacheHeader& header = getHeader();
+    const auto* submeshes = (const MeshCacheSubmesh*)(data + header.submeshTableOffset);
+    const auto* submeshLevels = (const MeshletRange*)(data + header.submeshLevelOffset);
+    std::vector<SubmeshRange> result(header.submeshCount);
+    for (uint32_t i = 0; i < header.submeshCount; i++) {
+        result[i].mesh = submeshes[i].mesh;
+        result[i].group = submeshes[i].group;
+        result[i].baseVertex = submeshes[i].baseVertex;
+        result[i].vertexCount = submeshes[i].vertexCount;
+        const MeshletRange* levels = submeshLevels + (size_t)i * header.levelCount;
+        result[i].levels.assign(levels, levels + header.levelCount);
+    }
+    return result;
+}
+
+std::vector<SubmeshGroup> MeshCacheFile::getGroups() const {
+    const MeshCacheHeader& header = getHeader();
+    const auto* groups = (const MeshCacheGroup*)(data + header.groupTableOffset);
+    std::vector<SubmeshGroup> result;
+    for (uint32_t i = 0; i < header.groupCount; i++) {
+        result.push_back({groups[i].group, groups[i].firstSubmesh, groups[i].submeshCount});
+    }
+    return result;
+}
+
+std::string MeshCacheFile::getMeshName(const uint32_t index) const {
+    const MeshCacheEntry& entry = getEntry(index);
+    return getString(entry.nameOffset, entry.nameLength);
+}
+
+std::vector<TextureRef> MeshCacheFile::getTextures(const uint32_t index) const {
+    const MeshCacheEntry& entry = getEntry(index);
+    const auto* textures = (const MeshCacheTexture*)(data + getHeader().textureTableOffset);
+    std::vector<TextureRef> result;
+    for (uint32_t i = 0; i < entry.textureCount; i++) {
+        const MeshCacheTexture& texture = textures[entry.firstTexture + i];
+        result.push_back({getString(texture.typeOffset, texture.typeLength),
+                          getString(texture.pathOffset, texture.pathLength)});
+    }
+    return result;
+}
+
+std::vector<ModelNode> MeshCacheFile::getNodes() const {
+    const MeshCacheHeader& header = getHeader();
+    if (header.nodeCount == 0) {
+        return NodeHierarchy::makeRoot(header.meshCount);
+    }
+    const auto* nodes = (const MeshCacheNode*)(data + header.nodeTableOffset);
+    std::vector<ModelNode> result(header.nodeCount);
+    for (uint32_t i = 0; i < header.nodeCount; i++) {
+        result[i].parent = nodes[i].parent;
+        std::memcpy(&result[i].local, nodes[i].local, sizeof(nodes[i].local));
+        result[i].firstMesh = nodes[i].firstMesh;
+        result[i].meshCount = nodes[i].meshCount;
+    }
+    return result;
+}
+
+std::string MeshCache::getCachePath(const std::string& sourcePath) {
+    return sourcePath + EXTENSION;
+}
+
+bool MeshCache::isFresh(const std::string& cachePath, const std::string& sourcePath) {
+    // 只读文件头, 不映射整个文件
+    std::ifstream file(cachePath, std::ios::binary);
+    MeshCacheHeader header{};
+    if (!file.read((char*)&header, sizeof(header))) {
+        return false;
+    }
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+        header.vertexSize != sizeof(QuantizedVertex) || header.meshletSize != sizeof(Meshlet)) {
+        return false;
+    }
+    uint64_t sourceSize;
+    int64_t sourceTime;
+    if (!getSourceStamp(sourcePath, sourceSize, sourceTime)) {
+        return true;
+    }
+    return header.sourceSize == sourceSize && header.sourceTime == sourceTime;
+}
+
+bool MeshCache::write(const std::string& cachePath, const std::string& sourcePath, const std::vector<CookedMesh>& meshes,
+                      const PackedModel& packed, const std::vector<ModelNode>& nodes) {
+    if (packed.quantized.size() != packed.vertices.size()) {
+        std::cout << "ERROR::MESH_CACHE::packed model is not quantized: " << cachePath << std::endl;
+        return false;
+    }
+    MeshCacheHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.vertexSize = sizeof(QuantizedVertex);
+    header.meshletSize = sizeof(Meshlet);
+    getSourceStamp(sourcePath, header.sourceSize, header.sourceTime);
+    std::memcpy(header.quantizationOffset, &packed.quantization.offset, sizeof(header.quantizationOffset));
+    std::memcpy(header.quantizationScale, &packed.quantization.scale, sizeof(header.quantizationScale));
+
+    // 先建立所有的表, 确定每一段的大小
+    std::vector<MeshCacheEntry> entries;
+    std::vector<MeshCacheLod> lods;
+    std::vector<MeshCacheTexture> textures;
+    std::string strings;
+    auto addString = [&strings](const std::string& value, uint32_t& offset, uint32_t& length) {
+        offset = (uint32_t)strings.size();
+        length = (uint32_t)value.size();
+        strings += value;
+    };
+    for (const CookedMesh& mesh : meshes) {
+        MeshCacheEntry entry{};
+        addString(mesh.name, entry.nameOffset, entry.nameLength);
+        entry.vertexCount = (uint32_t)mesh.vertices.size();
+        entry.indexCount = (uint32_t)mesh.indices.size();
+        entry.firstLod = (uint32_t)lods.size();
+        entry.lodCount = (uint32_t)mesh.lods.size();
+        for (const LodLevel& level : mesh.lods) {
+            lods.push_back({(uint32_t)level.indices.size(), level.error});
+        }
+        entry.firstMeshlet = header.meshletCount;
+        entry.meshletCount = (uint32_t)mesh.meshlets.size();
+        header.meshletCount += (uint32_t)mesh.meshlets.size();
+        entry.firstTexture = (uint32_t)textures.size();
+        entry.textureCount = (uint32_t)mesh.textures.size();
+        for (const TextureRef& texture : mesh.textures) {
+            MeshCacheTexture reference{};
+            addString(texture.type, reference.typeOffset, reference.typeLength);
+            addString(texture.path, reference.pathOffset, reference.pathLength);
+            textures.push_back(reference);
+        }
+        const glm::vec3 center = Mesh::getCenter(mesh.vertices.data(), (uint32_t)mesh.vertices.size());
+        std::memcpy(entry.center, &center, sizeof(entry.center));
+        entries.push_back(entry);
+    }
+    std::vector<MeshCacheNode> nodeTable;
+    for (const ModelNode& node : nodes) {
+        MeshCacheNode entry{};
+        entry.parent = node.parent;
+        entry.firstMesh = node.firstMesh;
+        entry.meshCount = node.meshCount;
+        std::memcpy(entry.local, &node.local, sizeof(entry.local));
+        nodeTable.push_back(entry);
+    }
+    std::vector<MeshCacheSubmesh> submeshes;
+    std::vector<MeshletRange> submeshLevels;
+    for (const SubmeshRange& submesh : packed.submeshes) {
+        submeshes.push_back({submesh.mesh, submesh.group, submesh.baseVertex, submesh.vertexCount});
+        submeshLevels.insert(submeshLevels.end(), submesh.levels.begin(), submesh.levels.end());
+    }
+    std::vector<MeshCacheGroup> groups;
+    for (const SubmeshGroup& group : packed.groups) {
+        groups.push_back({group.group, group.firstSubmesh, group.submeshCount, 0});
+    }
+    std::vector<MeshCacheLevel> levels;
+    std::vector<MeshCacheDraw> draws;
+    for (const auto& level : packed.levelDraws) {
+        levels.push_back({(uint32_t)draws.size(), (uint32_t)level.size()});
+        for (const IndexedDraw& draw : level) {
+            draws.push_back({(uint32_t)(draw.byteOffset / sizeof(GLushort)), draw.count, draw.baseVertex, 0});
+        }
+    }
+    header.meshCount = (uint32_t)entries.size();
+    header.lodCount = (uint32_t)lods.size();
+    header.textureCount = (uint32_t)textures.size();
+    header.nodeCount = (uint32_t)nodeTable.size();
+    header.submeshCount = (uint32_t)submeshes.size();
+    header.groupCount = (uint32_t)groups.size();
+    header.levelCount = (uint32_t)levels.size();
+    header.drawCount = (uint32_t)draws.size();
+    header.vertexCount = packed.quantized.size();
+    header.indexCount = packed.shortIndices.size();
+    header.stringSize = strings.size();
+    if (submeshLevels.size() != (size_t)header.submeshCount * header.levelCount) {
+        std::cout << "ERROR::MESH_CACHE::submesh levels do not match the packed levels: " << cachePath << std::endl;
+        return false;
+    }
+
+    header.meshTableOffset = alignUp(sizeof(MeshCacheHeader));
+    header.lodTableOffset = alignUp(header.meshTableOffset + entries.size() * sizeof(MeshCacheEntry));
+    header.textureTableOffset = alignUp(header.lodTableOffset + lods.size() * sizeof(MeshCacheLod));
+    header.nodeTableOffset = alignUp(header.textureTableOffset + textures.size() * sizeof(MeshCacheTexture));
+    header.submeshTableOffset = alignUp(header.nodeTableOffset + nodeTable.size() * sizeof(MeshCacheNode));
+    header.submeshLevelOffset = alignUp(header.submeshTableOffset + submeshes.size() * sizeof(MeshCacheSubmesh));
+    header.groupTableOffset = alignUp(header.submeshLevelOffset + submeshLevels.size() * sizeof(MeshletRange));
+    header.levelTableOffset = alignUp(header.groupTableOffset + groups.size() * sizeof(MeshCacheGroup));
+    header.drawTableOffset = alignUp(header.levelTableOffset + levels.size() * sizeof(MeshCacheLevel));
+    header.stringOffset = alignUp(header.drawTableOffset + draws.size() * sizeof(MeshCacheDraw));
+    header.vertexOffset = alignUp(header.stringOffset + header.stringSize);
+    header.indexOffset = alignUp(header.vertexOffset + header.vertexCount * sizeof(QuantizedVertex));
+    header.meshletOffset = alignUp(header.indexOffset + header.indexCount * sizeof(GLushort));
+    header.fileSize = header.meshletOffset + header.meshletCount * sizeof(Meshlet);
+
+    const std::string temporaryPath = cachePath + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cout << "ERROR::MESH_CACHE::cannot write " << temporaryPath << std::endl;
+            return false;
+        }
+        writeAt(file, 0, &header, sizeof(header));
+        writeAt(file, header.meshTableOffset, entries.data(), entries.size() * sizeof(MeshCacheEntry));
+        writeAt(file, header.lodTableOffset, lods.data(), lods.size() * sizeof(MeshCacheLod));
+        writeAt(file, header.textureTableOffset, textures.data(), textures.size() * sizeof(MeshCacheTexture));
+        writeAt(file, header.nodeTableOffset, nodeTable.data(), nodeTable.size() * sizeof(MeshCacheNode));
+        writeAt(file, header.submeshTableOffset, submeshes.data(), submeshes.size() * sizeof(MeshCacheSubmesh));
+        writeAt(file, header.submeshLevelOffset, submeshLevels.data(), submeshLevels.size() * sizeof(MeshletRange));
+        writeAt(file, header.groupTableOffset, groups.data(), groups.size() * sizeof(MeshCacheGroup));
+        writeAt(file, header.levelTableOffset, levels.data(), levels.size() * sizeof(MeshCacheLevel));
+        writeAt(file, header.drawTableOffset, draws.data(), draws.size() * sizeof(MeshCacheDraw));
+        writeAt(file, header.stringOffset, strings.data(), strings.size());
+        writeAt(file, header.vertexOffset, packed.quantized.data(), packed.quantized.size() * sizeof(QuantizedVertex));
+        writeAt(file, header.indexOffset, packed.shortIndices.data(), packed.shortIndices.size() * sizeof(GLushort));
+        writeAt(file, header.meshletOffset, nullptr, 0);
+        for (const CookedMesh& mesh : meshes) {
+            file.write((const char*)mesh.meshlets.data(), (std::streamsize)(mesh.meshlets.size() * sizeof(Meshlet)));
+        }
+        if (!file.good()) {
+            file.close();
+            std::error_code error;
+            std::filesystem::remove(temporaryPath, error);
+            std::cout << "ERROR::MESH_CACHE::failed writing " << temporaryPath << std::endl;
+            return false;
+        }
+    }
+
+    // Windows上rename不会覆盖已有的文件, 先删除旧缓存
+    std::error_code error;
+    std::filesystem::remove(cachePath, error);
+    std::filesystem::rename(temporaryPath, cachePath, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        std::cout << "ERROR::MESH_CACHE::cannot replace " << cachePath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool MeshCache::isIdentical(const CookedMesh& mesh, const MeshView& view, const std::vector<TextureRef>& textures) {
+    if (view.vertexCount != mesh.vertices.size() || view.indexCount != mesh.indices.size() ||
+        view.lods.size() != mesh.lods.size() || view.meshletCount != mesh.meshlets.size() ||
+        textures.size() != mesh.textures.size()) {
+        return false;
+    }
+    if (std::memcmp(view.meshlets, mesh.meshlets.data(), mesh.meshlets.size() * sizeof(Meshlet)) != 0) {
+        return false;
+    }
+    if (view.vertices) {
+        if (std::memcmp(view.vertices, mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex)) != 0 ||
+            std::memcmp(view.indices, mesh.indices.data(), mesh.indices.size() * sizeof(unsigned int)) != 0) {
+            return false;
+        }
+    } else {
+        const glm::vec3 center = Mesh::getCenter(mesh.vertices.data(), (uint32_t)mesh.vertices.size());
+        if (std::memcmp(&view.center, &center, sizeof(center)) != 0) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < mesh.lods.size(); i++) {
+        const MeshLodView& lod = view.lods[i];
+        const LodLevel& level = mesh.lods[i];
+        if (lod.indexCount != level.indices.size() || std::memcmp(&lod.error, &level.error, sizeof(float)) != 0 ||
+            (lod.indices && std::memcmp(lod.indices, level.indices.data(), level.indices.size() * sizeof(unsigned int)) != 0)) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < textures.size(); i++) {
+        if (textures[i].type != mesh.textures[i].type || textures[i].path != mesh.textures[i].path) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MeshCache::isIdentical(const PackedModel& packed, const MeshCacheFile& file) {
+    const MeshView view = file.getPackedView();
+    if (view.vertexCount != packed.quantized.size() || view.shortIndexCount != packed.shortIndices.size() ||
+        view.levelDraws.size() != packed.levelDraws.size() ||
+        std::memcmp(view.quantizedVertices, packed.quantized.data(), packed.quantized.size() * sizeof(QuantizedVertex)) != 0 ||
+        std::memcmp(view.shortIndices, packed.shortIndices.data(), packed.shortIndices.size() * sizeof(GLushort)) != 0 ||
+        std::memcmp(&view.quantization.offset, &packed.quantization.offset, sizeof(glm::vec3)) != 0 ||
+        std::memcmp(&view.quantization.scale, &packed.quantization.scale, sizeof(glm::vec3)) != 0) {
+        return false;
+    }
+    for (size_t level = 0; level < packed.levelDraws.size(); level++) {
+        const auto& a = view.levelDraws[level];
+        const auto& b = packed.levelDraws[level];
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i].byteOffset != b[i].byteOffset || a[i].count != b[i].count || a[i].baseVertex != b[i].baseVertex) {
+                return false;
+            }
+        }
+    }
+    const std::vector<SubmeshRange> submeshes = file.getSubmeshes();
+    const std::vector<SubmeshGroup> groups = file.getGroups();
+    if (submeshes.size() != packed.submeshes.size() || groups.size() != packed.groups.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < submeshes.size(); i++) {
+        const SubmeshRange& a = submeshes[i];
+        const SubmeshRange& b = packed.submeshes[i];
+        if (a.mesh != b.mesh || a.group != b.group || a.baseVertex != b.baseVertex || a.vertexCount != b.vertexCount ||
+            a.levels.size() != b.levels.size() ||
+            std::memcmp(a.levels.data(), b.levels.data(), b.levels.size() * sizeof(MeshletRange)) != 0) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < groups.size(); i++) {
+        if (groups[i].group != packed.groups[i].group || groups[i].firstSubmesh != packed.groups[i].firstSubmesh ||
+            groups[i].submeshCount != packed.groups[i].submeshCount) {
+            return false;
+        }
+    }
+    return true;
+}
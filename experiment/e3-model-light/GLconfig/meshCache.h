@@ -0,0 +1,208 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mesh.h"
+#include "modelPacker.h"
+#include "nodeHierarchy.h"
+
+/**
+ * 网格缓存(.e3mesh): 把assimp导入并经过Mesh::cook处理, 再由ModelPacker打包后的模型保存为二进制文件, 下次启动直接映射到内存,
+ * 量化后的顶点和切分好的16位索引从映射中直接上传, 跳过assimp的解析, 逐顶点转换, 优化, 简化, meshlet划分, 打包, 量化和切分
+ *
+ * 文件布局(小端, 每一段按16字节对齐, 所有偏移都相对于文件开头):
+ *  - MeshCacheHeader, 包括打包后模型的反量化参数
+ *  - 网格表: MeshCacheEntry * meshCount, 打包前的网格(名字, LOD误差, meshlet, 纹理, 包围盒中心)
+ *  - LOD表: MeshCacheLod * lodCount
+ *  - 纹理表: MeshCacheTexture * textureCount
+ *  - 节点表: MeshCacheNode * nodeCount, 深度优先的先序(见nodeHierarchy.h)
+ *  - 子网格表: MeshCacheSubmesh * submeshCount, 按材质分组排列(见modelPacker.h)
+ *  - 子网格的范围: MeshletRange * submeshCount * levelCount, 每个子网格每一级在这一级索引中的范围
+ *  - 分组表: MeshCacheGroup * groupCount
+ *  - 级别表: MeshCacheLevel * levelCount, 每一级的绘制调用在绘制表中的范围
+ *  - 绘制表: MeshCacheDraw * drawCount
+ *  - 字符串: 网格名, 纹理类型和路径, 不以0结尾
+ *  - 顶点: QuantizedVertex, 打包后的整个模型(包括16位切分时复制的顶点)
+ *  - 索引: 16位, 所有级依次存放, 已经加上子网格的baseVertex并切分为段(段的起始顶点在绘制表中)
+ *  - meshlet: Meshlet * meshletCount
+ * 数据与内存中的结构逐字节相同, 所以要求读写双方的QuantizedVertex和Meshlet布局一致(头中记录了两者的大小)
+ */
+struct MeshCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t vertexSize;
+    uint32_t meshletSize;
+    // 生成缓存时源文件的大小和修改时间, 用于判断缓存是否过期
+    uint64_t sourceSize;
+    int64_t sourceTime;
+
+    uint32_t meshCount;
+    uint32_t lodCount;
+    uint32_t textureCount;
+    uint32_t meshletCount;
+    uint32_t nodeCount;
+    uint32_t submeshCount;
+    uint32_t groupCount;
+    uint32_t levelCount;
+    uint32_t drawCount;
+    uint32_t reserved;
+    uint64_t vertexCount;
+    uint64_t indexCount;
+    uint64_t stringSize;
+    // 顶点位置的反量化参数(见VertexQuantization)
+    float quantizationOffset[3];
+    float quantizationScale[3];
+
+    uint64_t meshTableOffset;
+    uint64_t lodTableOffset;
+    uint64_t textureTableOffset;
+    uint64_t nodeTableOffset;
+    uint64_t submeshTableOffset;
+    uint64_t submeshLevelOffset;
+    uint64_t groupTableOffset;
+    uint64_t levelTableOffset;
+    uint64_t drawTableOffset;
+    uint64_t stringOffset;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t meshletOffset;
+    uint64_t fileSize;
+};
+
+// 打包前的一个网格. 各个first都是在对应段中的下标(单位是元素, 不是字节)
+// 顶点和索引只在打包后的模型中, 这里记录数量(LOD选择和统计用)和包围盒的中心
+struct MeshCacheEntry {
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t firstLod;
+    uint32_t lodCount;
+    uint32_t firstMeshlet;
+    uint32_t meshletCount;
+    uint32_t firstTexture;
+    uint32_t textureCount;
+    float center[3];
+    uint32_t reserved;
+};
+
+struct MeshCacheLod {
+    uint32_t indexCount;
+    float error;
+};
+
+// 纹理引用, 字符串在字符串段中
+struct MeshCacheTexture {
+    uint32_t typeOffset;
+    uint32_t typeLength;
+    uint32_t pathOffset;
+    uint32_t pathLength;
+};
+
+// 模型的一个节点. 局部矩阵按列存放(与glm::mat4相同)
+struct MeshCacheNode {
+    int32_t parent;
+    uint32_t firstMesh;
+    uint32_t meshCount;
+    uint32_t reserved;
+    float local[16];
+};
+
+// 子网格(见SubmeshRange), 每一级的范围在子网格范围段中
+struct MeshCacheSubmesh {
+    uint32_t mesh;
+    uint32_t group;
+    uint32_t baseVertex;
+    uint32_t vertexCount;
+};
+
+struct MeshCacheGroup {
+    uint32_t group;
+    uint32_t firstSubmesh;
+    uint32_t submeshCount;
+    uint32_t reserved;
+};
+
+struct MeshCacheLevel {
+    uint32_t firstDraw;
+    uint32_t drawCount;
+};
+
+// 一次绘制调用(见IndexedDraw). firstIndex是在索引段中的下标
+struct MeshCacheDraw {
+    uint32_t firstIndex;
+    uint32_t count;
+    int32_t baseVertex;
+    uint32_t reserved;
+};
+
+/**
+ * 只读映射一个网格缓存文件. 打开时校验文件头和所有表项的范围, 之后返回的视图直接指向映射的内存,
+ * 在close(或析构)之前有效
+ */
+class MeshCacheFile {
+public:
+    MeshCacheFile() = default;
+    ~MeshCacheFile();
+    MeshCacheFile(const MeshCacheFile&) = delete;
+    MeshCacheFile& operator=(const MeshCacheFile&) = delete;
+
+    // 文件不存在, 格式不对或者被截断时返回false, 并打印原因
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    const MeshCacheHeader& getHeader() const { return *(const MeshCacheHeader*)data; }
+    uint32_t getMeshCount() const { return getHeader().meshCount; }
+    // 打包前的网格: 数量, LOD误差, meshlet和包围盒中心, 用于创建子网格. 没有顶点和索引
+    MeshView getMesh(uint32_t index) const;
+    // 打包后的整个模型: 量化后的顶点和切分好的索引都直接指向映射, 可以直接交给UploadBackend::uploadMesh
+    MeshView getPackedView() const;
+    std::vector<SubmeshRange> getSubmeshes() const;
+    std::vector<SubmeshGroup> getGroups() const;
+    std::string getMeshName(uint32_t index) const;
+    std::vector<TextureRef> getTextures(uint32_t index) const;
+    // 模型的节点层级. 打开时已经检查过父节点的顺序和网格范围
+    std::vector<ModelNode> getNodes() const;
+    size_t getSize() const { return size; }
+
+private:
+    const uint8_t* data{nullptr};
+    size_t size{0};
+
+    const MeshCacheEntry& getEntry(uint32_t index) const;
+    std::string getString(uint32_t offset, uint32_t length) const;
+    bool validate(const std::string& path) const;
+};
+
+class MeshCache {
+public:
+    // 2: 增加节点表
+    // 3: 导入时合并相同的顶点
+    // 4: 保存打包后的模型(量化后的顶点, 切分好的16位索引, 子网格和分组), 不再保存float顶点和32位索引
+    static constexpr uint32_t VERSION = 4;
+    static constexpr const char* EXTENSION = ".e3mesh";
+
+    // 缓存放在源文件旁边: eagle.obj -> eagle.obj.e3mesh
+    static std::string getCachePath(const std::string& sourcePath);
+    // 缓存存在, 版本和顶点格式一致, 并且源文件的大小和修改时间与生成时相同. 源文件不存在时只要缓存有效就使用
+    static bool isFresh(const std::string& cachePath, const std::string& sourcePath);
+    // 先写到临时文件再改名, 写到一半失败不会留下损坏的缓存. nodes为空时没有节点表, 读取时是一个引用所有网格的根节点
+    // packed是meshes打包的结果(ModelPacker::pack), 需要已经量化
+    static bool write(const std::string& cachePath, const std::string& sourcePath, const std::vector<CookedMesh>& meshes,
+                      const PackedModel& packed, const std::vector<ModelNode>& nodes = {});
+    // 逐字节比较视图中的网格与内存中的网格(LOD误差, meshlet, 纹理引用). 视图有顶点时比较顶点和索引,
+    // 否则(网格缓存)比较数量和包围盒中心
+    static bool isIdentical(const CookedMesh& mesh, const MeshView& view, const std::vector<TextureRef>& textures);
+    // 逐字节比较映射中打包后的模型(量化后的顶点, 16位索引, 绘制调用, 子网格, 分组, 反量化参数)与内存中的结果
+    static bool isIdentical(const PackedModel& packed, const MeshCacheFile& file);
+};
+
+#endif //MESHCACHE_H
@@ -0,0 +1,172 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "meshCacheBenchmark.h"
+#include "benchmarkCheck.h"
+#include "meshCache.h"
+#include "meshGenerator.h"
+#include "modelPacker.h"
+#include "uploadBackend.h"
+
+using namespace benchmark;
+
+namespace {
+    // 生成的网格转换为模型使用的Vertex, 相当于processMesh从assimp读出的数据
+    CookedMesh cookGenerated(const GeneratedMesh& mesh, const std::string& name, const uint32_t lodLevels) {
+        std::vector<Vertex> vertices(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            vertices[i].position = mesh.vertices[i].position;
+            unpackVertex(mesh.vertices[i], mesh.uvScale, vertices[i].normal, vertices[i].uv);
+        }
+        std::vector<unsigned int> indices(mesh.indices.begin(), mesh.indices.end());
+        return Mesh::cook(std::move(vertices), std::move(indices), lodLevels, name);
+    }
+
+    std::vector<CookedMesh> cookScene(const uint32_t sphereSegments) {
+        std::vector<CookedMesh> meshes;
+        meshes.push_back(cookGenerated(MeshGenerator::sphere(1.0f, sphereSegments, sphereSegments), "sphere", 4));
+        meshes.push_back(cookGenerated(MeshGenerator::torus(1.0f, 0.3f, 192, 96), "torus", 4));
+        meshes.push_back(cookGenerated(MeshGenerator::box(1.0f, 1.0f, 1.0f, 8), "box", 0));
+        meshes[0].textures = {{"texture_diffuse", "eagle_diffuse.png"}, {"texture_specular", "eagle_specular.png"}};
+        meshes[1].textures = {{"texture_diffuse", "eagle_diffuse.png"}};
+        return meshes;
+    }
+
+    // 在临时目录中放一个假的源文件, 只用于记录大小和修改时间
+    std::string makeSource(const std::string& name) {
+        const std::string path = (std::filesystem::temp_directory_path() / name).string();
+        std::ofstream(path, std::ios::binary) << "# stand-in for an imported model\n";
+        return path;
+    }
+
+    bool matchesAll(const std::vector<CookedMesh>& meshes, const PackedModel& packed, const MeshCacheFile& file) {
+        if (file.getMeshCount() != meshes.size() || !MeshCache::isIdentical(packed, file)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < meshes.size(); i++) {
+            if (file.getMeshName(i) != meshes[i].name ||
+                !MeshCache::isIdentical(meshes[i], file.getMesh(i), file.getTextures(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // pointer是否指向映射的文件内
+    bool inMapping(const void* pointer, const MeshCacheFile& file) {
+        const auto* begin = (const uint8_t*)&file.getHeader();
+        return (const uint8_t*)pointer >= begin && (const uint8_t*)pointer < begin + file.getSize();
+    }
+}
+
+void checkMeshCacheRoundTrip() {
+    std::cout << "mesh cache round trip:" << std::endl;
+    const std::vector<CookedMesh> meshes = cookScene(64);
+    const std::string source = makeSource("e3_mesh_cache_check.obj");
+    const std::string cache = MeshCache::getCachePath(source);
+
+    const PackedModel packed = ModelPacker::pack(meshes);
+    check(!MeshCache::isFresh(cache + ".missing", source), "missing cache is not fresh");
+    check(MeshCache::write(cache, source, meshes, packed), "write cache");
+    check(MeshCache::isFresh(cache, source), "cache is fresh after writing");
+    {
+        MeshCacheFile file;
+        check(file.open(cache), "map cache");
+        check(file.isOpen() && matchesAll(meshes, packed, file),
+              "mapped meshes and packed model are bit-identical to the cooked and packed ones");
+        // 缓存命中时直接上传映射中量化后的顶点和16位索引, 不再打包, 量化和切分
+        const MeshView view = file.getPackedView();
+        check(!view.vertices && !view.indices && inMapping(view.quantizedVertices, file) && inMapping(view.shortIndices, file),
+              "packed view points straight into the mapping");
+        NullUploadBackend backend;
+        const ArenaMesh uploaded = backend.uploadMesh(view);
+        check(uploaded.indexCount == packed.shortIndices.size() && uploaded.levels.size() == packed.levelDraws.size() &&
+              backend.uploadedBytes == packed.quantized.size() * sizeof(QuantizedVertex)
+                                       + packed.shortIndices.size() * sizeof(GLushort),
+              "upload takes " + std::to_string(backend.uploadedBytes) + " bytes of 12-byte vertices and 16-bit indices");
+    }
+
+    // 源文件变新: 缓存过期, 重新写入后恢复
+    std::filesystem::last_write_time(source, std::filesystem::last_write_time(source) + std::chrono::hours(1));
+    check(!MeshCache::isFresh(cache, source), "cache is stale after source changes");
+    MeshCache::write(cache, source, meshes, packed);
+    check(MeshCache::isFresh(cache, source), "cache is fresh after rewriting");
+
+    // 截断的文件: 文件头仍然有效, 映射时必须被拒绝
+    const std::string truncated = cache + ".truncated";
+    std::filesystem::copy_file(cache, truncated, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::resize_file(truncated, std::filesystem::file_size(cache) / 2);
+    {
+        MeshCacheFile file;
+        check(!file.open(truncated), "truncated cache is rejected");
+    }
+
+    std::filesystem::remove(truncated);
+    std::filesystem::remove(cache);
+    std::filesystem::remove(source);
+}
+
+void benchmarkMeshCacheLoad() {
+    std::cout << "mesh cache load:" << std::endl;
+    const std::string source = makeSource("e3_mesh_cache_benchmark.obj");
+    const std::string cache = MeshCache::getCachePath(source);
+
+    auto start = Clock::now();
+    const std::vector<CookedMesh> meshes = cookScene(256);
+    const PackedModel packed = ModelPacker::pack(meshes);
+    const double cookMs = elapsedMs(start);
+    size_t triangles = 0, floatBytes = 0;
+    for (const auto& mesh : meshes) {
+        triangles += mesh.indices.size() / 3;
+        floatBytes += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(unsigned int);
+        for (const auto& level : mesh.lods) {
+            floatBytes += level.indices.size() * sizeof(unsigned int);
+        }
+    }
+
+    start = Clock::now();
+    MeshCache::write(cache, source, meshes, packed);
+    const double writeMs = elapsedMs(start);
+
+    // 映射并读完打包后的顶点和索引(上传时同样要读一遍). 文件刚写入, 在系统的页缓存中
+    start = Clock::now();
+    MeshCacheFile file;
+    file.open(cache);
+    uint64_t checksum = 0;
+    const MeshView view = file.getPackedView();
+    const auto* bytes = (const uint32_t*)view.quantizedVertices;
+    for (size_t i = 0; i < view.vertexCount * sizeof(QuantizedVertex) / sizeof(uint32_t); i++) {
+        checksum += bytes[i];
+    }
+    for (uint32_t i = 0; i < view.shortIndexCount; i++) {
+        checksum += view.shortIndices[i];
+    }
+    const double loadMs = elapsedMs(start);
+    const double megabytes = (double)file.getSize() / (1024.0 * 1024.0);
+
+    std::cout << "  " << meshes.size() << " meshes, " << triangles << " triangles, cache " << megabytes
+              << " MB (float vertices and 32-bit indices: " << (double)floatBytes / (1024.0 * 1024.0) << " MB)" << std::endl;
+    std::cout << "  cook + pack " << cookMs << " ms, write " << writeMs << " ms, map + read " << loadMs << " ms ("
+              << megabytes / (loadMs / 1000.0) << " MB/s, " << cookMs / loadMs << "x faster than cooking, checksum "
+              << checksum % 1000 << ")" << std::endl;
+    check(file.getSize() < floatBytes, "cache is smaller than the float vertices and 32-bit indices alone");
+
+    file.close();
+    std::filesystem::remove(cache);
+    std::filesystem::remove(source);
+}
+
+void runMeshCacheBenchmarks() {
+    beginChecks("mesh cache");
+    checkMeshCacheRoundTrip();
+    benchmarkMeshCacheLoad();
+    endChecks();
+}
@@ -0,0 +1,22 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHCACHEBENCHMARK_H
+#define MESHCACHEBENCHMARK_H
+
+/**
+ * 网格缓存的测试, 在窗口中按B键运行. 只读写文件, 不需要OpenGL上下文
+ * 用生成器的网格代替assimp导入的结果(转换为Vertex后同样经过Mesh::cook), 缓存写在系统临时目录中
+ */
+
+// 写入后映射读回, 检查每个网格和打包后的模型与内存中的结果逐字节相同, 上传的视图直接指向映射;
+// 源文件变新后缓存过期; 截断的文件被拒绝
+void checkMeshCacheRoundTrip();
+
+// 处理(优化, LOD, meshlet, 打包), 写缓存, 映射读取三者的耗时, 映射读取的吞吐量, 以及与float顶点和32位索引相比的大小
+void benchmarkMeshCacheLoad();
+
+void runMeshCacheBenchmarks();
+
+#endif //MESHCACHEBENCHMARK_H
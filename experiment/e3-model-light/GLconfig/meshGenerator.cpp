@@ -0,0 +1,338 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <thread>
+
+#include "meshGenerator.h"
+
+namespace {
+    // 回转体的一行(一圈顶点): 到Y轴的距离, 高度, 法线的径向/Y分量, 以及这一行的v坐标
+    struct LatheRow {
+        float radius;
+        float y;
+        float normalRadial;
+        float normalY;
+        float v;
+    };
+
+    // 平面网格的一个面: origin为(u, v) = (0, 0)的角点, uAxis/vAxis为两条完整的边
+    // uAxis × vAxis与normal同向时三角形为逆时针
+    struct GridFace {
+        glm::vec3 origin;
+        glm::vec3 uAxis;
+        glm::vec3 vAxis;
+        glm::vec3 normal;
+    };
+
+    // 把[0, rowCount)按行拆分给多个线程执行fn(begin, end). 顶点数较少时直接在当前线程执行
+    template <typename Fn>
+    void parallelRows(const uint32_t rowCount, const size_t vertexCount, const Fn& fn) {
+        uint32_t threads = 1;
+        if (vertexCount >= MeshGenerator::PARALLEL_VERTEX_THRESHOLD) {
+            threads = std::min(MeshGenerator::getThreadCount(), rowCount);
+        }
+        if (threads <= 1) {
+            fn(0u, rowCount);
+            return;
+        }
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (uint32_t t = 1; t < threads; t++) {
+            const uint32_t begin = (uint64_t)rowCount * t / threads;
+            const uint32_t end = (uint64_t)rowCount * (t + 1) / threads;
+            workers.emplace_back([&fn, begin, end] { fn(begin, end); });
+        }
+        fn(0u, rowCount / threads);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * 生成回转体: 每一行绕Y轴一圈, columns段(columns + 1个顶点, 首尾重合以便uv连续)
+     * 顶点写入vertices[vertexOffset...], 索引写入indices[indexOffset...], 需要预先分配好
+     */
+    void lathe(GeneratedMesh& mesh, const uint32_t vertexOffset, const size_t indexOffset,
+               const std::vector<LatheRow>& rows, const uint32_t columns) {
+        const uint32_t stride = columns + 1;
+        // 三角函数表, 每一列只计算一次. 最后一列与第一列完全重合
+        std::vector<float> cosTable(stride), sinTable(stride), uTable(stride);
+        for (uint32_t j = 0; j < stride; j++) {
+            const float theta = 2 * glm::pi<float>() * j / columns;
+            cosTable[j] = j == columns ? 1.0f : std::cos(theta);
+            sinTable[j] = j == columns ? 0.0f : std::sin(theta);
+            uTable[j] = 1.0f - (float)j / (float)columns;
+        }
+
+        const auto rowCount = (uint32_t)rows.size();
+        parallelRows(rowCount, (size_t)rowCount * stride, [&](const uint32_t begin, const uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                const LatheRow& row = rows[i];
+                PackedVertex* out = mesh.vertices.data() + vertexOffset + (size_t)i * stride;
+                for (uint32_t j = 0; j < stride; j++) {
+                    out[j] = packVertex(
+                        glm::vec3(row.radius * cosTable[j], row.y, row.radius * sinTable[j]),
+                        glm::vec3(row.normalRadial * cosTable[j], row.normalY, row.normalRadial * sinTable[j]),
+                        glm::vec2(uTable[j], row.v),
+                        mesh.uvScale
+                    );
+                }
+                // 这一行与下一行之间的三角形
+                if (i + 1 == rowCount) {
+                    continue;
+                }
+                GLuint* index = mesh.indices.data() + indexOffset + (size_t)i * columns * 6;
+                for (uint32_t j = 0; j < columns; j++) {
+                    const GLuint p1 = vertexOffset + i * stride + j; // 当前点
+                    const GLuint p2 = p1 + stride; // 下一行的同一列
+                    const GLuint p3 = p1 + 1; // 当前行的下一列
+                    const GLuint p4 = p2 + 1; // 下一行的下一列
+                    *index++ = p1;
+                    *index++ = p3;
+                    *index++ = p2;
+                    *index++ = p3;
+                    *index++ = p4;
+                    *index++ = p2;
+                }
+            }
+        });
+    }
+
+    // 生成一个细分的平面网格: (uSegments + 1) * (vSegments + 1)个顶点
+    void grid(GeneratedMesh& mesh, const uint32_t vertexOffset, const size_t indexOffset, const GridFace& face,
+              const uint32_t uSegments, const uint32_t vSegments, const float uvRepeat) {
+        const uint32_t stride = uSegments + 1;
+        const uint32_t rowCount = vSegments + 1;
+        parallelRows(rowCount, (size_t)rowCount * stride, [&](const uint32_t begin, const uint32_t end) {
+            for (uint32_t b = begin; b < end; b++) {
+                const float v = (float)b / (float)vSegments;
+                const glm::vec3 rowOrigin = face.origin + face.vAxis * v;
+                PackedVertex* out = mesh.vertices.data() + vertexOffset + (size_t)b * stride;
+                for (uint32_t a = 0; a < stride; a++) {
+                    const float u = (float)a / (float)uSegments;
+                    out[a] = packVertex(rowOrigin + face.uAxis * u, face.normal, glm::vec2(u, v) * uvRepeat, mesh.uvScale);
+                }
+                if (b == vSegments) {
+                    continue;
+                }
+                GLuint* index = mesh.indices.data() + indexOffset + (size_t)b * uSegments * 6;
+                for (uint32_t a = 0; a < uSegments; a++) {
+                    const GLuint p = vertexOffset + b * stride + a;
+                    *index++ = p;
+                    *index++ = p + 1;
+                    *index++ = p + 1 + stride;
+                    *index++ = p + 1 + stride;
+                    *index++ = p + stride;
+                    *index++ = p;
+                }
+            }
+        });
+    }
+
+    // 预先分配好顶点和索引. PackedVertex和索引随后会被逐个覆盖写入
+    void allocate(GeneratedMesh& mesh, const size_t vertexCount, const size_t indexCount) {
+        mesh.vertices.resize(vertexCount);
+        mesh.indices.resize(indexCount);
+    }
+
+    void setBounds(GeneratedMesh& mesh, const glm::vec3& halfExtent, const float radius) {
+        mesh.boundingSphere.center = glm::vec3(0.0f);
+        mesh.boundingSphere.radius = radius;
+        mesh.boundingBox.min = -halfExtent;
+        mesh.boundingBox.max = halfExtent;
+    }
+}
+
+uint32_t MeshGenerator::getThreadCount() {
+    if (threadCount) {
+        return threadCount;
+    }
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+GeneratedMesh MeshGenerator::sphere(const float radius, uint32_t latitudeSegments, uint32_t longitudeSegments) {
+    latitudeSegments = std::max(latitudeSegments, 2u);
+    longitudeSegments = std::max(longitudeSegments, 3u);
+
+    // 每条纬线计算一次sin/cos
+    std::vector<LatheRow> rows(latitudeSegments + 1);
+    for (uint32_t i = 0; i <= latitudeSegments; i++) {
+        const float phi = glm::pi<float>() * i / latitudeSegments; // 纬线角度
+        const float sinPhi = i == latitudeSegments ? 0.0f : std::sin(phi);
+        const float cosPhi = std::cos(phi);
+        rows[i] = {radius * sinPhi, radius * cosPhi, sinPhi, cosPhi, 1.0f - (float)i / (float)latitudeSegments};
+    }
+
+    GeneratedMesh mesh;
+    allocate(mesh, (size_t)rows.size() * (longitudeSegments + 1), (size_t)latitudeSegments * longitudeSegments * 6);
+    lathe(mesh, 0, 0, rows, longitudeSegments);
+    setBounds(mesh, glm::vec3(radius), radius);
+    return mesh;
+}
+
+GeneratedMesh MeshGenerator::box(const float length, const float width, const float height, uint32_t segments) {
+    segments = std::max(segments, 1u);
+    const glm::vec3 half(length / 2.0f, height / 2.0f, width / 2.0f);
+    const glm::vec3 x(1.0f, 0.0f, 0.0f), y(0.0f, 1.0f, 0.0f), z(0.0f, 0.0f, 1.0f);
+
+    // 每个面: 法线, u方向, v方向(u × v = 法线)
+    const glm::vec3 faces[6][3] = {
+        {z, x, y}, // 正面
+        {-z, -x, y}, // 背面
+        {-x, z, y}, // 左面
+        {x, -z, y}, // 右面
+        {y, x, -z}, // 顶面
+        {-y, x, z}, // 底面
+    };
+
+    const uint32_t faceVertexCount = (segments + 1) * (segments + 1);
+    const size_t faceIndexCount = (size_t)segments * segments * 6;
+    GeneratedMesh mesh;
+    allocate(mesh, faceVertexCount * 6, faceIndexCount * 6);
+    for (int i = 0; i < 6; i++) {
+        const glm::vec3& normal = faces[i][0];
+        const glm::vec3 uHalf = faces[i][1] * half;
+        const glm::vec3 vHalf = faces[i][2] * half;
+        const GridFace face{normal * half - uHalf - vHalf, uHalf * 2.0f, vHalf * 2.0f, normal};
+        grid(mesh, faceVertexCount * i, faceIndexCount * i, face, segments, segments, 1.0f);
+    }
+    setBounds(mesh, half, glm::length(half));
+    return mesh;
+}
+
+GeneratedMesh MeshGenerator::plane(const float length, const float width, uint32_t lengthSegments,
+                                   uint32_t widthSegments, const float uvRepeat) {
+    lengthSegments = std::max(lengthSegments, 1u);
+    widthSegments = std::max(widthSegments, 1u);
+    const float halfLength = length / 2.0f, halfWidth = width / 2.0f;
+
+    GeneratedMesh mesh;
+    // 平面的uv会超出[0, 1], 以重复次数为缩放存储
+    mesh.uvScale = glm::max(uvRepeat, 1.0f);
+    allocate(mesh, (size_t)(lengthSegments + 1) * (widthSegments + 1), (size_t)lengthSegments * widthSegments * 6);
+    // v方向指向-Z, 与原来的平面一致: (-X, +Z)角的uv为(0, 0)
+    const GridFace face{
+        glm::vec3(-halfLength, 0.0f, halfWidth),
+        glm::vec3(length, 0.0f, 0.0f),
+        glm::vec3(0.0f, 0.0f, -width),
+        glm::vec3(0.0f, 1.0f, 0.0f)
+    };
+    grid(mesh, 0, 0, face, lengthSegments, widthSegments, uvRepeat);
+
+    mesh.boundingSphere.center = glm::vec3(0.0f);
+    mesh.boundingSphere.radius = glm::length(glm::vec3(halfLength, 0.0f, halfWidth));
+    // 平面增加些许厚度以免碰撞检测不到
+    mesh.boundingBox.min = glm::vec3(-halfLength, -0.005f, -halfWidth);
+    mesh.boundingBox.max = glm::vec3(halfLength, 0.005f, halfWidth);
+    return mesh;
+}
+
+GeneratedMesh MeshGenerator::cylinder(const float radius, const float height, uint32_t radialSegments,
+                                      uint32_t heightSegments, const bool capped) {
+    radialSegments = std::max(radialSegments, 3u);
+    heightSegments = std::max(heightSegments, 1u);
+    const float halfHeight = height / 2.0f;
+
+    // 侧面从上到下
+    std::vector<LatheRow> rows(heightSegments + 1);
+    for (uint32_t i = 0; i <= heightSegments; i++) {
+        const float t = (float)i / (float)heightSegments;
+        rows[i] = {radius, halfHeight - height * t, 1.0f, 0.0f, 1.0f - t};
+    }
+
+    const uint32_t sideVertexCount = (heightSegments + 1) * (radialSegments + 1);
+    const size_t sideIndexCount = (size_t)heightSegments * radialSegments * 6;
+    // 每个底面: 中心点 + 一圈radialSegments + 1个顶点(法线与侧面不同, 不能共用)
+    const uint32_t capVertexCount = radialSegments + 2;
+    const size_t capIndexCount = (size_t)radialSegments * 3;
+
+    GeneratedMesh mesh;
+    allocate(mesh, sideVertexCount + (capped ? capVertexCount * 2 : 0), sideIndexCount + (capped ? capIndexCount * 2 : 0));
+    lathe(mesh, 0, 0, rows, radialSegments);
+
+    if (capped) {
+        for (int cap = 0; cap < 2; cap++) {
+            const bool top = cap == 0;
+            const float y = top ? halfHeight : -halfHeight;
+            const glm::vec3 normal(0.0f, top ? 1.0f : -1.0f, 0.0f);
+            const uint32_t center = sideVertexCount + capVertexCount * cap;
+            PackedVertex* out = mesh.vertices.data() + center;
+            GLuint* index = mesh.indices.data() + sideIndexCount + capIndexCount * cap;
+
+            out[0] = packVertex(glm::vec3(0.0f, y, 0.0f), normal, glm::vec2(0.5f));
+            for (uint32_t j = 0; j <= radialSegments; j++) {
+                const float theta = 2 * glm::pi<float>() * j / radialSegments;
+                const float c = j == radialSegments ? 1.0f : std::cos(theta);
+                const float s = j == radialSegments ? 0.0f : std::sin(theta);
+                out[j + 1] = packVertex(glm::vec3(radius * c, y, radius * s), normal, glm::vec2(0.5f + 0.5f * c, 0.5f + 0.5f * s));
+            }
+            // 从外侧看逆时针: 顶面绕序与底面相反
+            for (uint32_t j = 0; j < radialSegments; j++) {
+                *index++ = center;
+                *index++ = center + 1 + (top ? j + 1 : j);
+                *index++ = center + 1 + (top ? j : j + 1);
+            }
+        }
+    }
+    setBounds(mesh, glm::vec3(radius, halfHeight, radius), glm::length(glm::vec2(radius, halfHeight)));
+    return mesh;
+}
+
+GeneratedMesh MeshGenerator::torus(const float majorRadius, const float minorRadius, uint32_t radialSegments,
+                                   uint32_t tubularSegments) {
+    radialSegments = std::max(radialSegments, 3u);
+    tubularSegments = std::max(tubularSegments, 3u);
+
+    // 每一行是管道截面圆上的一个点绕Y轴转一圈. 从外侧赤道开始先向下, 与球体的行方向一致
+    std::vector<LatheRow> rows(tubularSegments + 1);
+    for (uint32_t i = 0; i <= tubularSegments; i++) {
+        const float phi = 2 * glm::pi<float>() * i / tubularSegments;
+        const float c = i == tubularSegments ? 1.0f : std::cos(phi);
+        const float s = i == tubularSegments ? 0.0f : std::sin(phi);
+        rows[i] = {majorRadius + minorRadius * c, -minorRadius * s, c, -s, 1.0f - (float)i / (float)tubularSegments};
+    }
+
+    GeneratedMesh mesh;
+    allocate(mesh, (size_t)rows.size() * (radialSegments + 1), (size_t)tubularSegments * radialSegments * 6);
+    lathe(mesh, 0, 0, rows, radialSegments);
+    const float outer = majorRadius + minorRadius;
+    setBounds(mesh, glm::vec3(outer, minorRadius, outer), outer);
+    return mesh;
+}
+
+GeneratedMesh MeshGenerator::capsule(const float radius, const float height, uint32_t radialSegments,
+                                     uint32_t hemisphereSegments, uint32_t heightSegments) {
+    radialSegments = std::max(radialSegments, 3u);
+    hemisphereSegments = std::max(hemisphereSegments, 1u);
+    heightSegments = std::max(heightSegments, 1u);
+    const float halfHeight = height / 2.0f;
+
+    // 上半球(含赤道), 中间圆柱的内部行, 下半球(含赤道). 两个赤道之间就是圆柱侧面
+    std::vector<LatheRow> rows;
+    rows.reserve(hemisphereSegments * 2 + heightSegments + 1);
+    for (uint32_t k = 0; k <= hemisphereSegments; k++) {
+        const float phi = glm::half_pi<float>() * k / hemisphereSegments;
+        const float s = std::sin(phi), c = k == hemisphereSegments ? 0.0f : std::cos(phi);
+        rows.push_back({radius * s, halfHeight + radius * c, s, c, 0.0f});
+    }
+    for (uint32_t k = 1; k < heightSegments; k++) {
+        rows.push_back({radius, halfHeight - height * k / heightSegments, 1.0f, 0.0f, 0.0f});
+    }
+    for (uint32_t k = 0; k <= hemisphereSegments; k++) {
+        const float phi = glm::half_pi<float>() * (1.0f + (float)k / hemisphereSegments);
+        const float s = k == hemisphereSegments ? 0.0f : std::sin(phi), c = k == 0 ? 0.0f : std::cos(phi);
+        rows.push_back({radius * s, -halfHeight + radius * c, s, c, 0.0f});
+    }
+    const auto rowCount = (uint32_t)rows.size();
+    for (uint32_t i = 0; i < rowCount; i++) {
+        rows[i].v = 1.0f - (float)i / (float)(rowCount - 1);
+    }
+
+    GeneratedMesh mesh;
+    allocate(mesh, (size_t)rowCount * (radialSegments + 1), (size_t)(rowCount - 1) * radialSegments * 6);
+    lathe(mesh, 0, 0, rows, radialSegments);
+    setBounds(mesh, glm::vec3(radius, halfHeight + radius, radius), halfHeight + radius);
+    return mesh;
+}
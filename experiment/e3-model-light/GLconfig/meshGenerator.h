@@ -0,0 +1,65 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHGENERATOR_H
+#define MESHGENERATOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+#include "geometry.h"
+#include "vertexFormat.h"
+
+// CPU端生成的网格数据, 不涉及任何OpenGL调用. 交给Geometry::createFromMesh上传
+struct GeneratedMesh {
+    std::vector<PackedVertex> vertices;
+    std::vector<GLuint> indices;
+    // 模型空间的包围体
+    BoundingSphere boundingSphere;
+    BoundingBox boundingBox;
+    // uv的量化缩放, 见packVertex
+    float uvScale{1.0f};
+};
+
+/**
+ * 程序化网格生成器: 球体, 长方体, 平面网格, 圆柱, 圆环, 胶囊体
+ * 原来的createSphere每个顶点都要调用sin/cos, 并且往几个没有reserve的vector里push_back, 细分数很大时启动明显变慢
+ *  - 三角函数只在每一行/每一列计算一次(三角函数表), 每个顶点只剩乘法
+ *  - 顶点和索引的数量可以预先算出, 一次分配好后直接按下标写入交错的PackedVertex
+ *  - 每一行顶点/索引写入的位置互不重叠, 顶点数较多时按行拆分给多个线程
+ *
+ * 所有三角形从外侧看都是逆时针(GL默认的正面), 可以直接开启背面剔除
+ * 回转体(球, 圆柱侧面, 圆环, 胶囊体)的uv: u = 1 - 列/列数, v = 1 - 行/行数, 与原来的球体一致
+ */
+class MeshGenerator {
+public:
+    // 球体. latitudeSegments为纬线方向的段数, longitudeSegments为经线方向的段数
+    static GeneratedMesh sphere(float radius, uint32_t latitudeSegments, uint32_t longitudeSegments);
+    // 长方体. 长宽高分别对应X, Z, Y轴, 每个面细分为segments * segments个格子
+    static GeneratedMesh box(float length, float width, float height, uint32_t segments = 1);
+    // XZ平面上的网格, 法线朝+Y. uvRepeat: 纹理在平面上重复的次数
+    static GeneratedMesh plane(float length, float width, uint32_t lengthSegments = 1, uint32_t widthSegments = 1,
+                               float uvRepeat = 1.0f);
+    // 沿Y轴的圆柱. capped: 是否生成上下底面
+    static GeneratedMesh cylinder(float radius, float height, uint32_t radialSegments, uint32_t heightSegments = 1,
+                                  bool capped = true);
+    // 躺在XZ平面上的圆环. majorRadius: 圆环中心线半径, minorRadius: 管道半径
+    static GeneratedMesh torus(float majorRadius, float minorRadius, uint32_t radialSegments, uint32_t tubularSegments);
+    // 沿Y轴的胶囊体. height为中间圆柱部分的高度(不含两端的半球), hemisphereSegments为每个半球纬线方向的段数
+    static GeneratedMesh capsule(float radius, float height, uint32_t radialSegments, uint32_t hemisphereSegments,
+                                 uint32_t heightSegments = 1);
+
+    // 生成时使用的线程数. 0表示使用硬件线程数
+    static void setThreadCount(const uint32_t count) { threadCount = count; }
+    static uint32_t getThreadCount();
+
+    // 顶点数不少于这个值时才拆分给多个线程, 小网格创建线程反而更慢
+    static constexpr size_t PARALLEL_VERTEX_THRESHOLD = 1 << 16;
+
+private:
+    static inline uint32_t threadCount{0};
+};
+
+#endif //MESHGENERATOR_H
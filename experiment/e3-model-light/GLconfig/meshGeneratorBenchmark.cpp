@@ -0,0 +1,212 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "meshGeneratorBenchmark.h"
+#include "benchmarkCheck.h"
+#include "meshGenerator.h"
+
+using namespace benchmark;
+
+namespace {
+    // 原来Geometry::createSphere的生成方式: 每个顶点调用sin/cos, 分开的vector逐个push_back, 最后再打包
+    void legacySphere(const float radius, const int latitudeSegments, const int longitudeSegments,
+                      std::vector<PackedVertex>& vertices, std::vector<GLuint>& indices) {
+        std::vector<GLfloat> positions{};
+        std::vector<GLfloat> uvs{};
+        std::vector<GLfloat> normals{};
+        for (int i = 0; i <= latitudeSegments; i++) {
+            float phi = glm::pi<float>() * i / latitudeSegments;
+            for (int j = 0; j <= longitudeSegments; j++) {
+                float theta = 2 * glm::pi<float>() * j / longitudeSegments;
+                float x = sin(phi) * cos(theta);
+                float y = cos(phi);
+                float z = sin(phi) * sin(theta);
+                normals.push_back(x);
+                normals.push_back(y);
+                normals.push_back(z);
+                positions.push_back(x * radius);
+                positions.push_back(y * radius);
+                positions.push_back(z * radius);
+                uvs.push_back(1.0f - (float)j / (float)longitudeSegments);
+                uvs.push_back(1.0f - (float)i / (float)latitudeSegments);
+            }
+        }
+        for (int i = 0; i < latitudeSegments; i++) {
+            for (int j = 0; j < longitudeSegments; j++) {
+                int p1 = i * (longitudeSegments + 1) + j;
+                int p2 = p1 + longitudeSegments + 1;
+                int p3 = p1 + 1;
+                int p4 = p2 + 1;
+                indices.push_back(p1);
+                indices.push_back(p2);
+                indices.push_back(p3);
+                indices.push_back(p3);
+                indices.push_back(p2);
+                indices.push_back(p4);
+            }
+        }
+        const size_t vertexCount = positions.size() / 3;
+        vertices.reserve(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++) {
+            vertices.push_back(packVertex(
+                glm::vec3(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]),
+                glm::vec3(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]),
+                glm::vec2(uvs[i * 2], uvs[i * 2 + 1])
+            ));
+        }
+    }
+
+    // 每个三角形从外侧看逆时针: 按绕序算出的面法线与顶点法线同向. 返回绕序错误的三角形数(退化的三角形不计)
+    size_t countWrongWinding(const GeneratedMesh& mesh) {
+        size_t wrong = 0;
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            const glm::vec3& a = mesh.vertices[mesh.indices[i]].position;
+            const glm::vec3& b = mesh.vertices[mesh.indices[i + 1]].position;
+            const glm::vec3& c = mesh.vertices[mesh.indices[i + 2]].position;
+            const glm::vec3 faceNormal = glm::cross(b - a, c - a);
+            if (glm::length(faceNormal) < 1e-12f) {
+                continue;
+            }
+            glm::vec3 normal;
+            glm::vec2 uv;
+            unpackVertex(mesh.vertices[mesh.indices[i]], mesh.uvScale, normal, uv);
+            if (glm::dot(faceNormal, normal) <= 0.0f) {
+                wrong++;
+            }
+        }
+        return wrong;
+    }
+
+    // 所有顶点都在包围盒和包围球内, 并且包围盒是紧的(每个面上至少有一个顶点)
+    // 平面的包围盒在Y方向上故意留了0.01的厚度(见MeshGenerator::plane), 紧的程度按这个容差判断
+    bool boundsFit(const GeneratedMesh& mesh) {
+        constexpr float epsilon = 1e-4f;
+        constexpr float slack = 0.01f;
+        glm::vec3 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
+        for (const auto& vertex : mesh.vertices) {
+            if (glm::length(vertex.position - mesh.boundingSphere.center) > mesh.boundingSphere.radius + epsilon) {
+                return false;
+            }
+            min = glm::min(min, vertex.position);
+            max = glm::max(max, vertex.position);
+        }
+        return glm::all(glm::lessThanEqual(mesh.boundingBox.min, min + epsilon)) && glm::all(glm::lessThanEqual(max - epsilon, mesh.boundingBox.max))
+               && glm::all(glm::lessThan(min - mesh.boundingBox.min, glm::vec3(slack)))
+               && glm::all(glm::lessThan(mesh.boundingBox.max - max, glm::vec3(slack)));
+    }
+
+    bool hasValidIndices(const GeneratedMesh& mesh) {
+        return mesh.indices.size() % 3 == 0 && std::all_of(mesh.indices.begin(), mesh.indices.end(), [&mesh](const GLuint index) {
+            return index < mesh.vertices.size();
+        });
+    }
+
+    // 生成耗时(毫秒)以及每秒生成的顶点数
+    void printTiming(const std::string& name, const double ms, const size_t vertexCount) {
+        std::cout << "  " << name << ": " << ms << " ms (" << vertexCount / ms / 1000.0 << " M vertices/s)" << std::endl;
+    }
+}
+
+void checkMeshGenerator() {
+    std::cout << "shapes:" << std::endl;
+    const std::pair<const char*, GeneratedMesh> shapes[] = {
+        {"sphere", MeshGenerator::sphere(1.0f, 16, 24)},
+        {"box", MeshGenerator::box(1.0f, 2.0f, 3.0f, 3)},
+        {"plane", MeshGenerator::plane(4.0f, 2.0f, 3, 2, 5.0f)},
+        {"cylinder", MeshGenerator::cylinder(1.0f, 2.0f, 12, 3)},
+        {"uncapped cylinder", MeshGenerator::cylinder(1.0f, 2.0f, 12, 3, false)},
+        {"torus", MeshGenerator::torus(1.0f, 0.3f, 24, 12)},
+        {"capsule", MeshGenerator::capsule(0.5f, 1.0f, 16, 6, 3)},
+    };
+    for (const auto& [name, mesh] : shapes) {
+        const size_t wrong = countWrongWinding(mesh);
+        check(hasValidIndices(mesh) && !mesh.indices.empty(), std::string(name) + ": " + std::to_string(mesh.indices.size() / 3)
+              + " triangles, indices in range");
+        check(wrong == 0, std::string(name) + ": counter-clockwise from outside (" + std::to_string(wrong) + " wrong)");
+        check(boundsFit(mesh), std::string(name) + ": vertices inside tight bounding box and sphere");
+    }
+
+    // 多线程按行拆分, 结果与单线程逐字节相同
+    const uint32_t threads = MeshGenerator::getThreadCount();
+    MeshGenerator::setThreadCount(1);
+    const GeneratedMesh single = MeshGenerator::sphere(1.0f, 512, 512);
+    MeshGenerator::setThreadCount(4);
+    const GeneratedMesh parallel = MeshGenerator::sphere(1.0f, 512, 512);
+    MeshGenerator::setThreadCount(threads);
+    check(single.vertices.size() == parallel.vertices.size() && single.indices == parallel.indices
+          && std::memcmp(single.vertices.data(), parallel.vertices.data(), single.vertices.size() * sizeof(PackedVertex)) == 0,
+          "4 threads generate the same sphere as 1 thread");
+}
+
+void benchmarkSphereGeneration(const uint32_t segments) {
+    const float radius = 1.0f;
+    std::cout << "sphere " << segments << "x" << segments << ":" << std::endl;
+
+    std::vector<PackedVertex> legacyVertices;
+    std::vector<GLuint> legacyIndices;
+    auto start = Clock::now();
+    legacySphere(radius, (int)segments, (int)segments, legacyVertices, legacyIndices);
+    const double legacyMs = elapsedMs(start);
+    printTiming("legacy (sin/cos per vertex, push_back)", legacyMs, legacyVertices.size());
+
+    const uint32_t threads = MeshGenerator::getThreadCount();
+    MeshGenerator::setThreadCount(1);
+    start = Clock::now();
+    const GeneratedMesh single = MeshGenerator::sphere(radius, segments, segments);
+    const double singleMs = elapsedMs(start);
+    printTiming("MeshGenerator, 1 thread", singleMs, single.vertices.size());
+
+    MeshGenerator::setThreadCount(threads);
+    start = Clock::now();
+    const GeneratedMesh parallel = MeshGenerator::sphere(radius, segments, segments);
+    const double parallelMs = elapsedMs(start);
+    printTiming("MeshGenerator, " + std::to_string(threads) + " threads", parallelMs, parallel.vertices.size());
+
+    // 顶点顺序与原来一致, 逐个比较位置. 三角形的绕序改成了从外侧看逆时针, 索引只比较数量
+    float maxError = 0.0f;
+    bool sameSize = legacyVertices.size() == parallel.vertices.size() && legacyIndices.size() == parallel.indices.size();
+    for (size_t i = 0; sameSize && i < legacyVertices.size(); i++) {
+        maxError = std::max(maxError, glm::length(legacyVertices[i].position - parallel.vertices[i].position));
+    }
+    std::cout << "  " << parallel.vertices.size() << " vertices, " << parallel.indices.size() / 3 << " triangles, speedup "
+              << legacyMs / parallelMs << "x" << std::endl;
+    check(sameSize && maxError < 1e-5f, "same counts and vertex positions as legacy (max error " + std::to_string(maxError) + ")");
+}
+
+void benchmarkShapeGeneration() {
+    const std::pair<const char*, std::function<GeneratedMesh()>> shapes[] = {
+        {"box 1024 per face", [] { return MeshGenerator::box(1.0f, 1.0f, 1.0f, 1024); }},
+        {"plane 4096x4096", [] { return MeshGenerator::plane(100.0f, 100.0f, 4096, 4096, 16.0f); }},
+        {"cylinder 4096x1024", [] { return MeshGenerator::cylinder(1.0f, 2.0f, 4096, 1024); }},
+        {"torus 4096x1024", [] { return MeshGenerator::torus(1.0f, 0.25f, 4096, 1024); }},
+        {"capsule 4096x512", [] { return MeshGenerator::capsule(0.5f, 1.0f, 4096, 512, 64); }},
+    };
+    for (const auto& [name, generate] : shapes) {
+        const auto start = Clock::now();
+        const GeneratedMesh mesh = generate();
+        const double ms = elapsedMs(start);
+        std::cout << name << ": " << mesh.vertices.size() << " vertices, " << mesh.indices.size() / 3
+                  << " triangles, " << ms << " ms" << std::endl;
+    }
+}
+
+void runMeshGeneratorBenchmarks() {
+    beginChecks("mesh generator");
+    std::cout << MeshGenerator::getThreadCount() << " threads" << std::endl;
+    checkMeshGenerator();
+    for (const uint32_t segments : {64u, 1024u, 4096u}) {
+        benchmarkSphereGeneration(segments);
+    }
+    benchmarkShapeGeneration();
+    endChecks();
+}
@@ -0,0 +1,27 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHGENERATORBENCHMARK_H
+#define MESHGENERATORBENCHMARK_H
+
+#include <cstdint>
+
+/**
+ * 程序化网格生成器的测试和性能测试, 在窗口中按B键运行(会阻塞渲染几秒)
+ * 只生成CPU端的数据, 不需要OpenGL上下文
+ */
+
+// 每种形状的索引合法, 所有三角形从外侧看逆时针, 包围盒和包围球包住所有顶点; 多线程与单线程的结果相同
+void checkMeshGenerator();
+
+// 对比原来的球体生成方式(逐顶点sin/cos + push_back)与MeshGenerator单线程/多线程的耗时, 并检查两者的顶点是否一致
+void benchmarkSphereGeneration(uint32_t segments);
+
+// 其余形状在大细分数下的生成耗时
+void benchmarkShapeGeneration();
+
+// 先运行检查, 再依次测试64, 1024, 4096段的球体, 以及其余形状
+void runMeshGeneratorBenchmarks();
+
+#endif //MESHGENERATORBENCHMARK_H
@@ -0,0 +1,108 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+#include <thread>
+
+#include "meshImporter.h"
+
+static_assert(sizeof(aiVector3D) == sizeof(glm::vec3), "按块复制要求aiVector3D为3个float(没有定义ASSIMP_DOUBLE_PRECISION)");
+
+void MeshImporter::convert(const aiMesh* mesh, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    const uint32_t vertexCount = mesh->mNumVertices;
+    vertices.assign(vertexCount, Vertex{});
+    for (uint32_t i = 0; i < vertexCount; i++) {
+        std::memcpy(&vertices[i].position, &mesh->mVertices[i], sizeof(glm::vec3));
+    }
+    if (mesh->mNormals) {
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            std::memcpy(&vertices[i].normal, &mesh->mNormals[i], sizeof(glm::vec3));
+        }
+    }
+    if (mesh->mTextureCoords[0]) {
+        // 纹理坐标也是aiVector3D, 只取前两个分量
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            std::memcpy(&vertices[i].uv, &mesh->mTextureCoords[0][i], sizeof(glm::vec2));
+        }
+    }
+
+    // 三角化之后通常全是三角形, 可以直接按面数分配; 混有点和线时先数一遍
+    uint32_t triangleCount = mesh->mNumFaces;
+    if (mesh->mPrimitiveTypes != aiPrimitiveType_TRIANGLE) {
+        triangleCount = 0;
+        for (uint32_t i = 0; i < mesh->mNumFaces; i++) {
+            triangleCount += mesh->mFaces[i].mNumIndices == 3;
+        }
+    }
+    indices.resize((size_t)triangleCount * 3);
+    unsigned int* out = indices.data();
+    for (uint32_t i = 0; i < mesh->mNumFaces; i++) {
+        const aiFace& face = mesh->mFaces[i];
+        if (face.mNumIndices == 3) {
+            out[0] = face.mIndices[0];
+            out[1] = face.mIndices[1];
+            out[2] = face.mIndices[2];
+            out += 3;
+        }
+    }
+
+    if (!mesh->mNormals) {
+        // 面法线的叉积长度是三角形面积的两倍, 直接累加就是按面积加权
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            const glm::vec3& a = vertices[indices[i]].position;
+            const glm::vec3& b = vertices[indices[i + 1]].position;
+            const glm::vec3& c = vertices[indices[i + 2]].position;
+            const glm::vec3 normal = glm::cross(b - a, c - a);
+            vertices[indices[i]].normal += normal;
+            vertices[indices[i + 1]].normal += normal;
+            vertices[indices[i + 2]].normal += normal;
+        }
+        for (Vertex& vertex : vertices) {
+            const float length = glm::length(vertex.normal);
+            vertex.normal = length > 0.0f ? vertex.normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+        }
+    }
+}
+
+std::vector<CookedMesh> MeshImporter::cookAll(const std::vector<const aiMesh*>& meshes, const uint32_t lodLevels) {
+    std::vector<CookedMesh> cooked(meshes.size());
+    // 大网格先处理. 按下标稳定排序, 同样的输入每次的分配顺序相同
+    std::vector<uint32_t> order(meshes.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&meshes](const uint32_t a, const uint32_t b) {
+        return meshes[a]->mNumFaces > meshes[b]->mNumFaces;
+    });
+
+    std::atomic<uint32_t> next{0};
+    auto work = [&] {
+        for (uint32_t i = next.fetch_add(1); i < order.size(); i = next.fetch_add(1)) {
+            const aiMesh* mesh = meshes[order[i]];
+            std::vector<Vertex> vertices;
+            std::vector<unsigned int> indices;
+            convert(mesh, vertices, indices);
+            cooked[order[i]] = Mesh::cook(std::move(vertices), std::move(indices), lodLevels, mesh->mName.C_Str());
+        }
+    };
+
+    const uint32_t threads = std::min(getThreadCount(), (uint32_t)meshes.size());
+    std::vector<std::thread> workers;
+    for (uint32_t t = 1; t < threads; t++) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return cooked;
+}
+
+uint32_t MeshImporter::getThreadCount() {
+    if (threadCount) {
+        return threadCount;
+    }
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
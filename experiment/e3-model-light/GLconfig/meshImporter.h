@@ -0,0 +1,37 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHIMPORTER_H
+#define MESHIMPORTER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "mesh.h"
+#include "assimp/mesh.h"
+
+/**
+ * assimp网格的转换和预处理(转换为Vertex和索引, 再经过Mesh::cook), 不涉及OpenGL
+ * 原来Model::processNode边遍历边处理, 网格一个接一个地转换. 现在先收集所有的aiMesh, 再交给多个线程:
+ *  - 每个线程从共享的计数器领取下一个网格, 网格按三角形数从大到小排列, 大网格不会拖到最后
+ *  - 输出预先分配好, 每个网格写入自己的位置, 线程之间没有锁
+ * 纹理和上传仍然由Model在主线程完成
+ */
+class MeshImporter {
+public:
+    // 只转换顶点和索引, 输出按网格大小一次分配好. 位置和法线按块复制(aiVector3D与glm::vec3的布局相同)
+    // 没有法线时按面积加权的面法线生成平滑法线, 没有纹理坐标时uv为0. 点和线(非三角形的面)被跳过
+    static void convert(const aiMesh* mesh, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+    // 转换并cook所有网格, 结果与meshes一一对应. 网格名取aiMesh的名字
+    static std::vector<CookedMesh> cookAll(const std::vector<const aiMesh*>& meshes, uint32_t lodLevels);
+
+    // 使用的线程数. 0表示使用硬件线程数
+    static void setThreadCount(const uint32_t count) { threadCount = count; }
+    static uint32_t getThreadCount();
+
+private:
+    static inline uint32_t threadCount{0};
+};
+
+#endif //MESHIMPORTER_H
@@ -0,0 +1,156 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "meshImporterBenchmark.h"
+#include "benchmarkCheck.h"
+#include "meshCache.h"
+#include "meshGenerator.h"
+#include "meshImporter.h"
+
+using namespace benchmark;
+
+namespace {
+    // 按assimp读取后的布局构造aiMesh. 数组由aiMesh的析构函数释放
+    std::unique_ptr<aiMesh> makeAiMesh(const GeneratedMesh& generated, const std::string& name, const bool withNormals) {
+        auto mesh = std::make_unique<aiMesh>();
+        mesh->mName = name.c_str();
+        mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+        mesh->mNumVertices = (unsigned int)generated.vertices.size();
+        mesh->mVertices = new aiVector3D[mesh->mNumVertices];
+        mesh->mNormals = withNormals ? new aiVector3D[mesh->mNumVertices] : nullptr;
+        mesh->mTextureCoords[0] = new aiVector3D[mesh->mNumVertices];
+        mesh->mNumUVComponents[0] = 2;
+        for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+            glm::vec3 normal;
+            glm::vec2 uv;
+            unpackVertex(generated.vertices[i], generated.uvScale, normal, uv);
+            const glm::vec3& position = generated.vertices[i].position;
+            mesh->mVertices[i] = aiVector3D(position.x, position.y, position.z);
+            if (withNormals) {
+                mesh->mNormals[i] = aiVector3D(normal.x, normal.y, normal.z);
+            }
+            mesh->mTextureCoords[0][i] = aiVector3D(uv.x, uv.y, 0.0f);
+        }
+        mesh->mNumFaces = (unsigned int)(generated.indices.size() / 3);
+        mesh->mFaces = new aiFace[mesh->mNumFaces];
+        for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+            mesh->mFaces[i].mNumIndices = 3;
+            mesh->mFaces[i].mIndices = new unsigned int[3];
+            std::memcpy(mesh->mFaces[i].mIndices, &generated.indices[i * 3], 3 * sizeof(unsigned int));
+        }
+        return mesh;
+    }
+
+    // 类似背包模型的场景: 几个大网格和很多小网格
+    std::vector<std::unique_ptr<aiMesh>> makeScene() {
+        std::vector<std::unique_ptr<aiMesh>> scene;
+        scene.push_back(makeAiMesh(MeshGenerator::sphere(1.0f, 160, 160), "body", true));
+        scene.push_back(makeAiMesh(MeshGenerator::torus(1.0f, 0.3f, 160, 80), "strap", true));
+        for (uint32_t i = 0; i < 8; i++) {
+            scene.push_back(makeAiMesh(MeshGenerator::capsule(0.2f, 0.5f, 48 + i * 8, 12, 4), "buckle" + std::to_string(i), true));
+        }
+        for (uint32_t i = 0; i < 24; i++) {
+            scene.push_back(makeAiMesh(MeshGenerator::cylinder(0.05f, 0.2f, 16 + i * 2, 2), "rivet" + std::to_string(i), true));
+        }
+        return scene;
+    }
+
+    bool sameCooked(const std::vector<CookedMesh>& a, const std::vector<CookedMesh>& b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < a.size(); i++) {
+            if (a[i].name != b[i].name || !MeshCache::isIdentical(a[i], b[i].view(), b[i].textures)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void checkMeshConversion() {
+    std::cout << "mesh conversion:" << std::endl;
+    const GeneratedMesh sphere = MeshGenerator::sphere(1.0f, 32, 32);
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+
+    const std::unique_ptr<aiMesh> withNormals = makeAiMesh(sphere, "sphere", true);
+    MeshImporter::convert(withNormals.get(), vertices, indices);
+    bool copied = vertices.size() == withNormals->mNumVertices && indices.size() == sphere.indices.size();
+    for (size_t i = 0; copied && i < vertices.size(); i++) {
+        copied = vertices[i].position.x == withNormals->mVertices[i].x && vertices[i].normal.z == withNormals->mNormals[i].z &&
+                 vertices[i].uv.y == withNormals->mTextureCoords[0][i].y;
+    }
+    copied = copied && std::memcmp(indices.data(), sphere.indices.data(), indices.size() * sizeof(unsigned int)) == 0;
+    check(copied, "positions, normals, uvs and indices are copied exactly");
+
+    // 没有法线: 球面上生成的平滑法线应当接近径向. 两极的顶点只属于面积为0的三角形, 没有可用的面法线, 不参与比较
+    // 接缝处的顶点只有一侧的面, 允许一定的偏差
+    const std::unique_ptr<aiMesh> withoutNormals = makeAiMesh(sphere, "sphere", false);
+    MeshImporter::convert(withoutNormals.get(), vertices, indices);
+    float worst = 1.0f;
+    for (const Vertex& vertex : vertices) {
+        if (std::abs(vertex.position.y) < 0.999f) {
+            worst = std::min(worst, glm::dot(vertex.normal, glm::normalize(vertex.position)));
+        }
+    }
+    check(worst > 0.9f, "generated normals follow the surface (worst cos " + std::to_string(worst) + ")");
+
+    // 混入一条线: 被跳过, 三角形不受影响
+    const std::unique_ptr<aiMesh> mixed = makeAiMesh(MeshGenerator::box(1.0f, 1.0f, 1.0f), "box", true);
+    mixed->mPrimitiveTypes = aiPrimitiveType_TRIANGLE | aiPrimitiveType_LINE;
+    mixed->mFaces[1].mNumIndices = 2;
+    MeshImporter::convert(mixed.get(), vertices, indices);
+    check(indices.size() == (mixed->mNumFaces - 1) * 3 && indices[3] == mixed->mFaces[2].mIndices[0],
+          "non-triangle faces are skipped");
+}
+
+void benchmarkParallelImport() {
+    std::cout << "parallel import:" << std::endl;
+    const std::vector<std::unique_ptr<aiMesh>> scene = makeScene();
+    std::vector<const aiMesh*> meshes;
+    size_t triangles = 0;
+    for (const auto& mesh : scene) {
+        meshes.push_back(mesh.get());
+        triangles += mesh->mNumFaces;
+    }
+    std::cout << "  " << meshes.size() << " meshes, " << triangles << " triangles, "
+              << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    std::vector<CookedMesh> reference;
+    double serialMs = 0.0;
+    for (const uint32_t threads : {1u, 2u, 4u, 8u}) {
+        MeshImporter::setThreadCount(threads);
+        const auto start = Clock::now();
+        std::vector<CookedMesh> cooked = MeshImporter::cookAll(meshes, 4);
+        const double ms = elapsedMs(start);
+        if (threads == 1) {
+            serialMs = ms;
+            reference = std::move(cooked);
+            std::cout << "  1 thread: " << ms << " ms" << std::endl;
+        } else {
+            std::cout << "  " << threads << " threads: " << ms << " ms (speed-up " << serialMs / ms << "x)" << std::endl;
+            check(sameCooked(reference, cooked), std::to_string(threads) + " threads give the same result as 1 thread");
+        }
+    }
+    // 恢复默认(硬件线程数)
+    MeshImporter::setThreadCount(0);
+}
+
+void runMeshImporterBenchmarks() {
+    beginChecks("mesh importer");
+    checkMeshConversion();
+    benchmarkParallelImport();
+    endChecks();
+}
@@ -0,0 +1,21 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHIMPORTERBENCHMARK_H
+#define MESHIMPORTERBENCHMARK_H
+
+/**
+ * 并行导入的测试, 在窗口中按B键运行. 不需要OpenGL上下文, 也不读取模型文件:
+ * 用生成器的网格在内存中构造aiMesh(相当于assimp读取之后的状态), 再交给MeshImporter
+ */
+
+// 转换的正确性: 位置/法线/uv按块复制的结果, 没有法线时生成的平滑法线, 跳过点和线
+void checkMeshConversion();
+
+// 多网格场景(类似背包模型, 几十个大小不同的网格)在不同线程数下的导入耗时, 并检查结果与单线程逐字节相同
+void benchmarkParallelImport();
+
+void runMeshImporterBenchmarks();
+
+#endif //MESHIMPORTERBENCHMARK_H
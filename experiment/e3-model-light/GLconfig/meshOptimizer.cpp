@@ -0,0 +1,499 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "meshOptimizer.h"
+
+namespace {
+    // ===Forsyth算法的参数(与原文一致)===
+    // 打分时假设的LRU缓存大小. 比实际缓存大一些, 让算法倾向于复用更早的顶点
+    constexpr uint32_t SCORING_CACHE_SIZE = 32;
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    // 刚用过的三个顶点分数稍低, 避免总是生成细长的三角形带
+    constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+    // 剩余三角形越少的顶点分数越高, 尽早把它用完
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+    constexpr float VALENCE_BOOST_POWER = 0.5f;
+    constexpr uint32_t MAX_VALENCE_TABLE = 64;
+
+    // 顶点分数 = 缓存位置分数 + 剩余三角形数的加成. 两部分都查表
+    struct ScoreTable {
+        float cache[SCORING_CACHE_SIZE]{};
+        float valence[MAX_VALENCE_TABLE]{};
+
+        ScoreTable() {
+            for (uint32_t i = 0; i < SCORING_CACHE_SIZE; i++) {
+                if (i < 3) {
+                    cache[i] = LAST_TRIANGLE_SCORE;
+                } else {
+                    const float scale = 1.0f / (float)(SCORING_CACHE_SIZE - 3);
+                    cache[i] = std::pow(1.0f - (float)(i - 3) * scale, CACHE_DECAY_POWER);
+                }
+            }
+            for (uint32_t i = 1; i < MAX_VALENCE_TABLE; i++) {
+                valence[i] = VALENCE_BOOST_SCALE * std::pow((float)i, -VALENCE_BOOST_POWER);
+            }
+        }
+
+        // position < 0表示不在缓存中
+        float score(const int position, const uint32_t remaining) const {
+            if (remaining == 0) {
+                return -1.0f; // 没有剩余三角形, 不再参与
+            }
+            const float boost = remaining < MAX_VALENCE_TABLE ? valence[remaining]
+                                : VALENCE_BOOST_SCALE * std::pow((float)remaining, -VALENCE_BOOST_POWER);
+            return (position >= 0 ? cache[position] : 0.0f) + boost;
+        }
+    };
+
+    /**
+     * 用时间戳模拟FIFO缓存: 每次未命中时钟加一, 某个条目写入时的时钟与当前时钟相差不超过容量就还在缓存中
+     * 不需要真的维护一个队列, reset只需要把时钟往前拨
+     */
+    class FifoCache {
+    public:
+        FifoCache(const size_t entryCount, const uint32_t capacity)
+            : stamps(entryCount, 0), capacity(capacity), clock(capacity + 1) {}
+
+        // 返回是否未命中
+        bool touch(const size_t entry) {
+            if (clock - stamps[entry] <= capacity) {
+                return false;
+            }
+            stamps[entry] = ++clock;
+            return true;
+        }
+
+        void reset() { clock += capacity + 1; }
+
+    private:
+        std::vector<uint32_t> stamps;
+        uint32_t capacity;
+        uint32_t clock;
+    };
+
+    const glm::vec3& positionAt(const void* positions, const size_t stride, const unsigned int index) {
+        return *reinterpret_cast<const glm::vec3*>(static_cast<const char*>(positions) + stride * index);
+    }
+
+    // 二维边函数, c在ab左侧(逆时针)时为正
+    float edge(const glm::vec2& a, const glm::vec2& b, const glm::vec2& c) {
+        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+    }
+}
+
+// ===============================================================
+// ===顶点缓存优化==================================================
+// ===============================================================
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, const uint32_t vertexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+    static const ScoreTable table;
+
+    // 顶点 -> 相邻三角形(CSR格式). 每个顶点只保留未输出的三角形, 数量为remaining
+    std::vector<uint32_t> remaining(vertexCount, 0);
+    for (const unsigned int index : indices) {
+        remaining[index]++;
+    }
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        vertexScore[v] = table.score(-1, remaining[v]);
+    }
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<bool> emitted(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++) {
+        triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+    }
+
+    // 缓存中的顶点, 多留3个位置给新加入的顶点
+    std::vector<uint32_t> cache, nextCache;
+    cache.reserve(SCORING_CACHE_SIZE + 3);
+    nextCache.reserve(SCORING_CACHE_SIZE + 3);
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    // 缓存附近没有可用三角形时, 从这里开始顺序找下一个未输出的三角形
+    size_t cursor = 0;
+    int64_t best = std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin();
+
+    for (size_t count = 0; count < triangleCount; count++) {
+        if (best < 0) {
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            best = (int64_t)cursor;
+        }
+        const unsigned int* triangle = &indices[best * 3];
+        result.insert(result.end(), triangle, triangle + 3);
+        emitted[best] = true;
+
+        // 从三个顶点的邻接表中删除这个三角形
+        for (int k = 0; k < 3; k++) {
+            const uint32_t v = triangle[k];
+            uint32_t* begin = &adjacency[offsets[v]];
+            uint32_t* end = begin + remaining[v];
+            *std::find(begin, end, (uint32_t)best) = *(end - 1);
+            remaining[v]--;
+        }
+
+        // 新的缓存: 三角形的三个顶点放在最前面, 然后是原来的顶点
+        nextCache.assign(triangle, triangle + 3);
+        for (const uint32_t v : cache) {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                nextCache.push_back(v);
+            }
+        }
+        // 被挤出缓存的顶点
+        for (size_t i = SCORING_CACHE_SIZE; i < nextCache.size(); i++) {
+            cachePosition[nextCache[i]] = -1;
+        }
+
+        // 更新缓存内(以及刚被挤出)顶点的分数, 并把分数变化累加到相邻三角形上
+        for (size_t i = 0; i < nextCache.size(); i++) {
+            const uint32_t v = nextCache[i];
+            if (i < SCORING_CACHE_SIZE) {
+                cachePosition[v] = (int)i;
+            }
+            const float score = table.score(cachePosition[v], remaining[v]);
+            const float delta = score - vertexScore[v];
+            vertexScore[v] = score;
+            for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                triangleScore[adjacency[a]] += delta;
+            }
+        }
+        if (nextCache.size() > SCORING_CACHE_SIZE) {
+            nextCache.resize(SCORING_CACHE_SIZE);
+        }
+        cache.swap(nextCache);
+
+        // 下一个三角形只在缓存中顶点的相邻三角形中找
+        best = -1;
+        float bestScore = -1.0f;
+        for (const uint32_t v : cache) {
+            for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                if (triangleScore[adjacency[a]] > bestScore) {
+                    bestScore = triangleScore[adjacency[a]];
+                    best = adjacency[a];
+                }
+            }
+        }
+    }
+    indices.swap(result);
+}
+
+// ===============================================================
+// ===过度绘制优化==================================================
+// ===============================================================
+
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices, const void* positions, const size_t stride,
+                                     const uint32_t vertexCount, const float threshold) {
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+    FifoCache cache(vertexCount, CACHE_SIZE);
+    const auto touchTriangle = [&](const size_t t) {
+        return (int)cache.touch(indices[t * 3]) + (int)cache.touch(indices[t * 3 + 1]) + (int)cache.touch(indices[t * 3 + 2]);
+    };
+
+    // 硬边界: 三个顶点都不在缓存中的三角形, 说明顶点缓存优化在这里跳到了网格的另一处
+    std::vector<size_t> hardBoundaries;
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (touchTriangle(t) == 3) {
+            hardBoundaries.push_back(t);
+        }
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // 软边界: 在每个硬边界簇内部继续切分. 切分点之前的ACMR不超过整簇ACMR * threshold, 保证缓存效率损失有限
+    std::vector<size_t> clusters;
+    for (size_t c = 0; c + 1 < hardBoundaries.size(); c++) {
+        const size_t begin = hardBoundaries[c], end = hardBoundaries[c + 1];
+        cache.reset();
+        int clusterMisses = 0;
+        for (size_t t = begin; t < end; t++) {
+            clusterMisses += touchTriangle(t);
+        }
+        const float limit = threshold * (float)clusterMisses / (float)(end - begin);
+
+        cache.reset();
+        clusters.push_back(begin);
+        size_t start = begin;
+        int misses = 0;
+        for (size_t t = begin; t < end; t++) {
+            misses += touchTriangle(t);
+            if (t + 1 < end && (float)misses / (float)(t + 1 - start) <= limit) {
+                clusters.push_back(t + 1);
+                start = t + 1;
+                misses = 0;
+                cache.reset();
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // 整个网格的质心(按面积加权)
+    const auto triangleArea = [&](const size_t t, glm::vec3& normal, glm::vec3& centroid) {
+        const glm::vec3& a = positionAt(positions, stride, indices[t * 3]);
+        const glm::vec3& b = positionAt(positions, stride, indices[t * 3 + 1]);
+        const glm::vec3& c = positionAt(positions, stride, indices[t * 3 + 2]);
+        normal = glm::cross(b - a, c - a);
+        centroid = (a + b + c) / 3.0f;
+        return glm::length(normal);
+    };
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triangleCount; t++) {
+        glm::vec3 normal, centroid;
+        const float area = triangleArea(t, normal, centroid);
+        meshCentroid += centroid * area;
+        meshArea += area;
+    }
+    meshCentroid /= std::max(meshArea, std::numeric_limits<float>::min());
+
+    // 簇的朝向: (簇质心 - 网格质心)与簇平均法线的点积. 越大越靠外, 越可能遮挡其他簇
+    const size_t clusterCount = clusters.size() - 1;
+    std::vector<float> sortKeys(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++) {
+        glm::vec3 clusterNormal(0.0f), clusterCentroid(0.0f);
+        float clusterArea = 0.0f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+            glm::vec3 normal, centroid;
+            const float area = triangleArea(t, normal, centroid);
+            clusterNormal += normal;
+            clusterCentroid += centroid * area;
+            clusterArea += area;
+        }
+        const float normalLength = glm::length(clusterNormal);
+        if (clusterArea <= 0.0f || normalLength <= 0.0f) {
+            sortKeys[c] = 0.0f;
+            continue;
+        }
+        clusterCentroid /= clusterArea;
+        sortKeys[c] = glm::dot(clusterCentroid - meshCentroid, clusterNormal / normalLength);
+    }
+
+    std::vector<size_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++) {
+        order[c] = c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](const size_t a, const size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (const size_t c : order) {
+        result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    indices.swap(result);
+}
+
+// ===============================================================
+// ===顶点读取优化==================================================
+// ===============================================================
+
+uint32_t MeshOptimizer::buildWeldRemap(const void* vertices, const size_t vertexSize, const uint32_t vertexCount,
+                                       std::vector<uint32_t>& remap) {
+    const auto* bytes = (const uint8_t*)vertices;
+    auto hashVertex = [bytes, vertexSize](const uint32_t vertex) {
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        const uint8_t* data = bytes + vertex * vertexSize;
+        for (size_t i = 0; i < vertexSize; i++) {
+            hash = (hash ^ data[i]) * 16777619u;
+        }
+        return hash;
+    };
+    // 表的大小是2的幂, 至少为顶点数的两倍, 线性探测. 表中存放的是合并后保留的那个旧顶点
+    size_t tableSize = 1;
+    while (tableSize < (size_t)vertexCount * 2) {
+        tableSize <<= 1;
+    }
+    std::vector<uint32_t> table(tableSize, UINT32_MAX);
+    remap.resize(vertexCount);
+    uint32_t next = 0;
+    for (uint32_t vertex = 0; vertex < vertexCount; vertex++) {
+        size_t slot = hashVertex(vertex) & (tableSize - 1);
+        while (table[slot] != UINT32_MAX &&
+               std::memcmp(bytes + table[slot] * vertexSize, bytes + vertex * vertexSize, vertexSize) != 0) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (table[slot] == UINT32_MAX) {
+            table[slot] = vertex;
+            remap[vertex] = next++;
+        } else {
+            remap[vertex] = remap[table[slot]];
+        }
+    }
+    return next;
+}
+
+uint32_t MeshOptimizer::buildFetchRemap(const std::vector<unsigned int>& indices, const uint32_t vertexCount,
+                                        std::vector<uint32_t>& remap) {
+    remap.assign(vertexCount, UINT32_MAX);
+    uint32_t next = 0;
+    for (const unsigned int index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = next++;
+        }
+    }
+    return next;
+}
+
+// ===============================================================
+// ===分析==========================================================
+// ===============================================================
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const std::vector<unsigned int>& indices, const uint32_t vertexCount,
+                                                   const uint32_t cacheSize) {
+    VertexCacheStats stats;
+    if (indices.empty()) {
+        return stats;
+    }
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    uint32_t referencedCount = 0;
+    for (const unsigned int index : indices) {
+        stats.transformedVertices += cache.touch(index);
+        if (!referenced[index]) {
+            referenced[index] = true;
+            referencedCount++;
+        }
+    }
+    stats.acmr = (float)stats.transformedVertices / (float)(indices.size() / 3);
+    stats.atvr = (float)stats.transformedVertices / (float)referencedCount;
+    return stats;
+}
+
+VertexFetchStats MeshOptimizer::analyzeVertexFetch(const std::vector<unsigned int>& indices, const uint32_t vertexCount,
+                                                   const size_t vertexSize) {
+    // 64字节的缓存行, 共16KB
+    constexpr size_t LINE_SIZE = 64;
+    constexpr uint32_t LINE_COUNT = 256;
+
+    VertexFetchStats stats;
+    if (indices.empty()) {
+        return stats;
+    }
+    FifoCache cache((vertexCount * vertexSize + LINE_SIZE - 1) / LINE_SIZE, LINE_COUNT);
+    std::vector<bool> referenced(vertexCount, false);
+    size_t referencedBytes = 0;
+    for (const unsigned int index : indices) {
+        // 一个顶点可能跨越两条缓存行
+        const size_t first = index * vertexSize / LINE_SIZE;
+        const size_t last = ((index + 1) * vertexSize - 1) / LINE_SIZE;
+        for (size_t line = first; line <= last; line++) {
+            stats.bytesFetched += cache.touch(line) ? LINE_SIZE : 0;
+        }
+        if (!referenced[index]) {
+            referenced[index] = true;
+            referencedBytes += vertexSize;
+        }
+    }
+    stats.overfetch = (float)stats.bytesFetched / (float)referencedBytes;
+    return stats;
+}
+
+OverdrawStats MeshOptimizer::analyzeOverdraw(const std::vector<unsigned int>& indices, const void* positions,
+                                             const size_t stride, const uint32_t vertexCount) {
+    constexpr int VIEWPORT = 256;
+
+    OverdrawStats stats;
+    if (indices.empty()) {
+        return stats;
+    }
+    // 索引超出顶点数的三角形不读取位置, 直接跳过
+    const auto valid = [&](const size_t t) {
+        return indices[t] < vertexCount && indices[t + 1] < vertexCount && indices[t + 2] < vertexCount;
+    };
+    glm::vec3 min(std::numeric_limits<float>::max()), max(-std::numeric_limits<float>::max());
+    for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+        if (!valid(t)) {
+            continue;
+        }
+        for (int k = 0; k < 3; k++) {
+            min = glm::min(min, positionAt(positions, stride, indices[t + k]));
+            max = glm::max(max, positionAt(positions, stride, indices[t + k]));
+        }
+    }
+    // 没有有效的三角形
+    if (min.x > max.x) {
+        return stats;
+    }
+    const glm::vec3 size = max - min;
+    const float extent = std::max({size.x, size.y, size.z, std::numeric_limits<float>::min()});
+    const float scale = (float)(VIEWPORT - 1) / extent;
+
+    std::vector<float> depth(VIEWPORT * VIEWPORT);
+    // 沿X, Y, Z轴分别从正反两个方向正交投影. (u, v, 视线反方向)构成右手系, 逆时针的三角形就是正面
+    for (int axis = 0; axis < 3; axis++) {
+        for (int side = 0; side < 2; side++) {
+            const int u = side == 0 ? (axis + 1) % 3 : (axis + 2) % 3;
+            const int v = side == 0 ? (axis + 2) % 3 : (axis + 1) % 3;
+            const float depthSign = side == 0 ? -1.0f : 1.0f;
+            std::fill(depth.begin(), depth.end(), std::numeric_limits<float>::max());
+
+            for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+                if (!valid(t)) {
+                    continue;
+                }
+                glm::vec2 p[3];
+                float z[3];
+                for (int k = 0; k < 3; k++) {
+                    const glm::vec3 position = (positionAt(positions, stride, indices[t + k]) - min) * scale;
+                    p[k] = glm::vec2(position[u], position[v]);
+                    z[k] = depthSign * position[axis];
+                }
+                // 背面剔除
+                const float area = edge(p[0], p[1], p[2]);
+                if (area <= 0.0f) {
+                    continue;
+                }
+                const int minX = std::max((int)std::floor(std::min({p[0].x, p[1].x, p[2].x})), 0);
+                const int maxX = std::min((int)std::ceil(std::max({p[0].x, p[1].x, p[2].x})), VIEWPORT - 1);
+                const int minY = std::max((int)std::floor(std::min({p[0].y, p[1].y, p[2].y})), 0);
+                const int maxY = std::min((int)std::ceil(std::max({p[0].y, p[1].y, p[2].y})), VIEWPORT - 1);
+                for (int y = minY; y <= maxY; y++) {
+                    for (int x = minX; x <= maxX; x++) {
+                        const glm::vec2 center((float)x + 0.5f, (float)y + 0.5f);
+                        const float w0 = edge(p[1], p[2], center);
+                        const float w1 = edge(p[2], p[0], center);
+                        const float w2 = edge(p[0], p[1], center);
+                        if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+                            continue;
+                        }
+                        const float fragmentDepth = (w0 * z[0] + w1 * z[1] + w2 * z[2]) / area;
+                        float& stored = depth[y * VIEWPORT + x];
+                        if (fragmentDepth < stored) {
+                            stats.pixelsCovered += stored == std::numeric_limits<float>::max();
+                            stored = fragmentDepth;
+                            stats.pixelsShaded++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    stats.overdraw = stats.pixelsCovered ? (float)stats.pixelsShaded / (float)stats.pixelsCovered : 0.0f;
+    return stats;
+}
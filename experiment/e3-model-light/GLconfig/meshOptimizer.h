@@ -0,0 +1,123 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+
+// 顶点缓存的统计
+struct VertexCacheStats {
+    uint32_t transformedVertices{0}; // 顶点着色器被调用的次数(缓存未命中)
+    float acmr{0.0f}; // 平均每个三角形变换的顶点数, 最好情况约0.5, 最差3
+    float atvr{0.0f}; // 变换次数 / 被引用的顶点数, 最好情况1
+};
+// 顶点读取的统计
+struct VertexFetchStats {
+    size_t bytesFetched{0}; // 从显存读取的字节数(按缓存行计算)
+    float overfetch{0.0f}; // 读取的字节数 / 被引用的顶点字节数, 最好情况1
+};
+// 过度绘制的统计
+struct OverdrawStats {
+    uint32_t pixelsCovered{0}; // 至少被一个三角形覆盖的像素
+    uint32_t pixelsShaded{0}; // 通过深度测试的片段数(片段着色器被调用的次数)
+    float overdraw{0.0f}; // shaded / covered, 最好情况1
+};
+
+/**
+ * 导入模型后的网格优化, 只改变三角形和顶点的顺序, 不改变网格本身
+ *  0. weldVertices: 合并逐字节相同的顶点. 没有aiProcess_JoinIdenticalVertices时, assimp导入的OBJ每个面的每个角都是
+ *     一个单独的顶点, 相邻三角形之间完全没有共享, 后面的顶点缓存优化也无从谈起
+ *  1. optimizeVertexCache: 按Forsyth的线性时间算法重排三角形, 让相邻三角形尽量复用后变换顶点缓存中的顶点
+ *  2. optimizeOverdraw: 把上一步的结果切分成若干簇(切分点保证缓存效率的损失不超过threshold),
+ *     再按簇的朝向从外到内排序, 先画外侧的簇, 被遮挡的片段更早被深度测试剔除(Tipsify中的做法)
+ *  3. optimizeVertexFetch: 按顶点第一次被索引的顺序重排VBO, 让顶点读取尽量顺序访问, 没有被引用的顶点会被删除
+ * 三步都完成后的顺序: 缓存 -> 过度绘制 -> 顶点读取. 后一步不会破坏前一步的结果
+ *
+ * analyze系列函数在CPU上模拟GPU: 16个顶点的FIFO缓存, 64字节的缓存行, 以及从6个方向正交投影的软件光栅化
+ */
+class MeshOptimizer {
+public:
+    // 模拟的后变换顶点缓存大小(FIFO). 大多数GPU在16~32之间
+    static constexpr uint32_t CACHE_SIZE = 16;
+
+    // 合并位置, 法线, uv都相同(逐字节比较)的顶点, 并更新索引. 返回合并后的顶点数, 顶点按第一次出现的顺序排列
+    template <typename V>
+    static uint32_t weldVertices(std::vector<V>& vertices, std::vector<unsigned int>& indices);
+
+    static void optimizeVertexCache(std::vector<unsigned int>& indices, uint32_t vertexCount);
+    // positions: 顶点位置, stride为相邻两个位置之间的字节数
+    static void optimizeOverdraw(std::vector<unsigned int>& indices, const void* positions, size_t stride,
+                                 uint32_t vertexCount, float threshold = 1.05f);
+    // 按第一次使用的顺序重排顶点, 并更新索引. 返回重排后的顶点数
+    template <typename V>
+    static uint32_t optimizeVertexFetch(std::vector<V>& vertices, std::vector<unsigned int>& indices);
+
+    // 依次执行三步优化. 顶点类型需要有position成员
+    template <typename V>
+    static void optimize(std::vector<V>& vertices, std::vector<unsigned int>& indices, float threshold = 1.05f);
+
+    static VertexCacheStats analyzeVertexCache(const std::vector<unsigned int>& indices, uint32_t vertexCount,
+                                               uint32_t cacheSize = CACHE_SIZE);
+    static VertexFetchStats analyzeVertexFetch(const std::vector<unsigned int>& indices, uint32_t vertexCount,
+                                               size_t vertexSize);
+    static OverdrawStats analyzeOverdraw(const std::vector<unsigned int>& indices, const void* positions,
+                                         size_t stride, uint32_t vertexCount);
+
+private:
+    // 用开放寻址的哈希表找出相同的顶点: 旧顶点 -> 合并后的顶点. 返回合并后的顶点数
+    static uint32_t buildWeldRemap(const void* vertices, size_t vertexSize, uint32_t vertexCount,
+                                   std::vector<uint32_t>& remap);
+    // 按第一次使用的顺序生成旧顶点 -> 新顶点的映射, 未使用的顶点映射为UINT32_MAX. 返回新顶点数
+    static uint32_t buildFetchRemap(const std::vector<unsigned int>& indices, uint32_t vertexCount,
+                                    std::vector<uint32_t>& remap);
+};
+
+template <typename V>
+uint32_t MeshOptimizer::optimizeVertexFetch(std::vector<V>& vertices, std::vector<unsigned int>& indices) {
+    std::vector<uint32_t> remap;
+    const uint32_t count = buildFetchRemap(indices, (uint32_t)vertices.size(), remap);
+    std::vector<V> reordered(count);
+    for (size_t i = 0; i < vertices.size(); i++) {
+        if (remap[i] != UINT32_MAX) {
+            reordered[remap[i]] = vertices[i];
+        }
+    }
+    for (auto& index : indices) {
+        index = remap[index];
+    }
+    vertices.swap(reordered);
+    return count;
+}
+
+template <typename V>
+uint32_t MeshOptimizer::weldVertices(std::vector<V>& vertices, std::vector<unsigned int>& indices) {
+    std::vector<uint32_t> remap;
+    const uint32_t count = buildWeldRemap(vertices.data(), sizeof(V), (uint32_t)vertices.size(), remap);
+    // 合并后的下标不大于原来的下标, 可以原地压缩
+    for (size_t i = 0; i < vertices.size(); i++) {
+        vertices[remap[i]] = vertices[i];
+    }
+    vertices.resize(count);
+    for (auto& index : indices) {
+        index = remap[index];
+    }
+    return count;
+}
+
+template <typename V>
+void MeshOptimizer::optimize(std::vector<V>& vertices, std::vector<unsigned int>& indices, const float threshold) {
+    if (vertices.empty() || indices.empty()) {
+        return;
+    }
+    const auto vertexCount = (uint32_t)vertices.size();
+    optimizeVertexCache(indices, vertexCount);
+    optimizeOverdraw(indices, &vertices[0].position, sizeof(V), vertexCount, threshold);
+    optimizeVertexFetch(vertices, indices);
+}
+
+#endif //MESHOPTIMIZER_H
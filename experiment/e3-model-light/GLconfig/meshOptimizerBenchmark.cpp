@@ -0,0 +1,149 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "meshOptimizerBenchmark.h"
+#include "benchmarkCheck.h"
+#include "meshGenerator.h"
+#include "meshOptimizer.h"
+
+using namespace benchmark;
+
+namespace {
+    struct TestVertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+    };
+
+    // 打乱三角形和顶点的顺序
+    void makeShuffledTorus(const uint32_t radial, const uint32_t tubular, std::vector<TestVertex>& vertices,
+                           std::vector<unsigned int>& indices) {
+        const GeneratedMesh torus = MeshGenerator::torus(1.0f, 0.25f, radial, tubular);
+        std::mt19937 random(1);
+        std::vector<uint32_t> vertexOrder(torus.vertices.size());
+        for (uint32_t i = 0; i < vertexOrder.size(); i++) {
+            vertexOrder[i] = i;
+        }
+        std::shuffle(vertexOrder.begin(), vertexOrder.end(), random);
+        vertices.assign(torus.vertices.size(), {});
+        for (size_t i = 0; i < torus.vertices.size(); i++) {
+            glm::vec2 uv;
+            vertices[vertexOrder[i]].position = torus.vertices[i].position;
+            unpackVertex(torus.vertices[i], torus.uvScale, vertices[vertexOrder[i]].normal, uv);
+        }
+        std::vector<uint32_t> triangleOrder(torus.indices.size() / 3);
+        for (uint32_t i = 0; i < triangleOrder.size(); i++) {
+            triangleOrder[i] = i;
+        }
+        std::shuffle(triangleOrder.begin(), triangleOrder.end(), random);
+        indices.clear();
+        for (const uint32_t triangle : triangleOrder) {
+            for (int corner = 0; corner < 3; corner++) {
+                indices.push_back(vertexOrder[torus.indices[triangle * 3 + corner]]);
+            }
+        }
+    }
+
+    // 三角形的规范形式: 三个角按位置排列, 从最小的角开始轮换(保留绕序). 排序后比较整个集合
+    std::vector<std::array<float, 9>> canonicalTriangles(const std::vector<TestVertex>& vertices,
+                                                         const std::vector<unsigned int>& indices) {
+        std::vector<std::array<float, 9>> triangles;
+        triangles.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            std::array<std::array<float, 3>, 3> corners;
+            for (int k = 0; k < 3; k++) {
+                const glm::vec3& p = vertices[indices[i + k]].position;
+                corners[k] = {p.x, p.y, p.z};
+            }
+            const auto first = std::min_element(corners.begin(), corners.end()) - corners.begin();
+            std::array<float, 9> triangle;
+            for (int k = 0; k < 3; k++) {
+                std::copy(corners[(first + k) % 3].begin(), corners[(first + k) % 3].end(), triangle.begin() + k * 3);
+            }
+            triangles.push_back(triangle);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+}
+
+void checkMeshOptimizer() {
+    std::cout << "shuffled torus:" << std::endl;
+    std::vector<TestVertex> vertices;
+    std::vector<unsigned int> indices;
+    makeShuffledTorus(200, 100, vertices, indices);
+    const auto triangles = canonicalTriangles(vertices, indices);
+    const auto vertexCount = (uint32_t)vertices.size();
+    const VertexCacheStats cacheBefore = MeshOptimizer::analyzeVertexCache(indices, vertexCount);
+    const VertexFetchStats fetchBefore = MeshOptimizer::analyzeVertexFetch(indices, vertexCount, sizeof(TestVertex));
+    const OverdrawStats overdrawBefore = MeshOptimizer::analyzeOverdraw(indices, &vertices[0].position, sizeof(TestVertex), vertexCount);
+
+    MeshOptimizer::optimize(vertices, indices);
+
+    const VertexCacheStats cacheAfter = MeshOptimizer::analyzeVertexCache(indices, (uint32_t)vertices.size());
+    const VertexFetchStats fetchAfter = MeshOptimizer::analyzeVertexFetch(indices, (uint32_t)vertices.size(), sizeof(TestVertex));
+    const OverdrawStats overdrawAfter = MeshOptimizer::analyzeOverdraw(indices, &vertices[0].position, sizeof(TestVertex),
+                                                                       (uint32_t)vertices.size());
+    std::cout << "  ACMR " << cacheBefore.acmr << " -> " << cacheAfter.acmr << ", overfetch " << fetchBefore.overfetch
+              << " -> " << fetchAfter.overfetch << ", overdraw " << overdrawBefore.overdraw << " -> "
+              << overdrawAfter.overdraw << std::endl;
+    check(vertices.size() == vertexCount && canonicalTriangles(vertices, indices) == triangles,
+          "same triangle multiset (positions and winding) after optimizing");
+    check(cacheAfter.acmr < cacheBefore.acmr * 0.5f && cacheAfter.acmr < 1.0f, "ACMR more than halved and below 1.0");
+    // 24字节的顶点会跨越64字节的缓存行, 按首次使用排列后也达不到1
+    check(fetchAfter.overfetch < fetchBefore.overfetch * 0.25f && fetchAfter.overfetch < 2.0f, "vertex fetch overfetch cut by more than 4x");
+    // 过度绘制的优化允许ACMR变差到阈值(1.05倍)以内, 过度绘制本身不应该比打乱的顺序差
+    check(overdrawAfter.overdraw <= overdrawBefore.overdraw * 1.05f, "overdraw not worse than the shuffled order");
+    std::vector<unsigned int> outOfRange = indices;
+    outOfRange.insert(outOfRange.end(), {0, 1, vertexCount});
+    const OverdrawStats overdrawOutOfRange = MeshOptimizer::analyzeOverdraw(outOfRange, &vertices[0].position,
+                                                                            sizeof(TestVertex), vertexCount);
+    check(overdrawOutOfRange.pixelsShaded == overdrawAfter.pixelsShaded, "overdraw skips triangles with out-of-range indices");
+
+    // 再优化一次结果不变差
+    MeshOptimizer::optimize(vertices, indices);
+    check(MeshOptimizer::analyzeVertexCache(indices, (uint32_t)vertices.size()).acmr <= cacheAfter.acmr * 1.01f,
+          "optimizing again does not make ACMR worse");
+
+    std::cout << "edge cases:" << std::endl;
+    // 只有一个三角形, 还有一个没有被引用的顶点
+    const glm::vec3 up(0.0f, 0.0f, 1.0f);
+    std::vector<TestVertex> tiny = {{{0.0f, 0.0f, 0.0f}, up}, {{5.0f, 5.0f, 5.0f}, up}, {{1.0f, 0.0f, 0.0f}, up},
+                                    {{0.0f, 1.0f, 0.0f}, up}};
+    std::vector<unsigned int> tinyIndices = {0, 2, 3};
+    const auto tinyTriangles = canonicalTriangles(tiny, tinyIndices);
+    MeshOptimizer::optimize(tiny, tinyIndices);
+    check(tiny.size() == 3 && canonicalTriangles(tiny, tinyIndices) == tinyTriangles, "unreferenced vertex dropped, single triangle kept");
+    std::vector<TestVertex> none;
+    std::vector<unsigned int> noIndices;
+    MeshOptimizer::optimize(none, noIndices);
+    check(none.empty() && noIndices.empty(), "empty mesh is left empty");
+}
+
+void benchmarkMeshOptimizer() {
+    std::cout << "optimize:" << std::endl;
+    for (const uint32_t segments : {64u, 256u, 512u}) {
+        std::vector<TestVertex> vertices;
+        std::vector<unsigned int> indices;
+        makeShuffledTorus(segments * 2, segments, vertices, indices);
+        const auto start = Clock::now();
+        MeshOptimizer::optimize(vertices, indices);
+        const double ms = elapsedMs(start);
+        std::cout << "  " << indices.size() / 3 << " triangles: " << ms << " ms (" << indices.size() / 3 / ms / 1000.0
+                  << " M triangles/s)" << std::endl;
+    }
+}
+
+void runMeshOptimizerBenchmarks() {
+    beginChecks("mesh optimizer");
+    checkMeshOptimizer();
+    benchmarkMeshOptimizer();
+    endChecks();
+}
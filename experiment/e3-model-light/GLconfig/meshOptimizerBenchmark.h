@@ -0,0 +1,21 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHOPTIMIZERBENCHMARK_H
+#define MESHOPTIMIZERBENCHMARK_H
+
+/**
+ * 顶点缓存/过度绘制/顶点读取优化的测试, 在窗口中按B键运行. 只处理CPU端的数据, 不需要OpenGL上下文
+ * 用打乱了三角形和顶点顺序的圆环模拟导入的网格(文件中的顺序对GPU的缓存很不友好)
+ */
+
+// 优化只改变顺序: 三角形的集合(包括绕序)不变; ACMR和顶点读取变好, 过度绘制不变差; 没有被引用的顶点被删除
+void checkMeshOptimizer();
+
+// 不同规模的网格三步优化的耗时
+void benchmarkMeshOptimizer();
+
+void runMeshOptimizerBenchmarks();
+
+#endif //MESHOPTIMIZERBENCHMARK_H
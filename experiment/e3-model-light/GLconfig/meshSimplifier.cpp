@@ -0,0 +1,422 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "meshSimplifier.h"
+
+namespace {
+    // 边界平面的权重(相对于三角形平面). 越大边界越不容易收缩
+    constexpr double BORDER_WEIGHT = 4.0;
+
+    // 对称4x4矩阵表示的二次误差: Q(p) = p^T A p + 2 b^T p + c. weight为累加的权重(面积)
+    struct Quadric {
+        double a00{0}, a01{0}, a02{0}, a11{0}, a12{0}, a22{0};
+        double b0{0}, b1{0}, b2{0};
+        double c{0};
+        double weight{0};
+
+        // 平面n·p + d = 0, n为单位向量
+        void addPlane(const glm::dvec3& n, const double d, const double w) {
+            a00 += w * n.x * n.x;
+            a01 += w * n.x * n.y;
+            a02 += w * n.x * n.z;
+            a11 += w * n.y * n.y;
+            a12 += w * n.y * n.z;
+            a22 += w * n.z * n.z;
+            b0 += w * n.x * d;
+            b1 += w * n.y * d;
+            b2 += w * n.z * d;
+            c += w * d * d;
+            weight += w;
+        }
+
+        Quadric& operator+=(const Quadric& q) {
+            a00 += q.a00;
+            a01 += q.a01;
+            a02 += q.a02;
+            a11 += q.a11;
+            a12 += q.a12;
+            a22 += q.a22;
+            b0 += q.b0;
+            b1 += q.b1;
+            b2 += q.b2;
+            c += q.c;
+            weight += q.weight;
+            return *this;
+        }
+
+        // 到所有平面距离平方的加权和
+        double evaluate(const glm::vec3& p) const {
+            const double x = p.x, y = p.y, z = p.z;
+            const double result = a00 * x * x + a11 * y * y + a22 * z * z
+                                  + 2 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                                  + 2 * (b0 * x + b1 * y + b2 * z) + c;
+            return std::max(result, 0.0);
+        }
+    };
+
+    // 顶点的类型, 决定了它能否被移动
+    enum class VertexKind : uint8_t {
+        MANIFOLD, // 内部顶点, 可以合并到任意相邻顶点
+        BORDER, // 开放边界上的顶点, 只能沿边界移动
+        SEAM, // 同一位置有多个顶点(uv接缝或者硬边法线), 不移动
+        LOCKED, // 既是接缝又在边界上, 不移动
+    };
+
+    uint64_t edgeKey(const uint32_t a, const uint32_t b) {
+        return (uint64_t)a << 32 | b;
+    }
+
+    struct PositionHash {
+        size_t operator()(const glm::vec3& p) const {
+            uint32_t bits[3];
+            std::memcpy(bits, &p, sizeof(bits));
+            return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+        }
+    };
+
+    struct Collapse {
+        uint32_t from;
+        uint32_t to;
+        double cost;
+    };
+}
+
+float MeshSimplifier::getScale(const std::vector<glm::vec3>& positions) {
+    if (positions.empty()) {
+        return 0.0f;
+    }
+    glm::vec3 min(std::numeric_limits<float>::max()), max(-std::numeric_limits<float>::max());
+    for (const auto& p : positions) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    const glm::vec3 size = max - min;
+    return std::max({size.x, size.y, size.z});
+}
+
+std::vector<unsigned int> MeshSimplifier::simplify(const std::vector<unsigned int>& indices,
+                                                   const std::vector<glm::vec3>& positions,
+                                                   const std::vector<glm::vec3>& normals,
+                                                   const size_t targetIndexCount, const float targetError,
+                                                   float* resultError) {
+    std::vector<unsigned int> result = indices;
+    const auto vertexCount = (uint32_t)positions.size();
+    const float scale = getScale(positions);
+    if (resultError) {
+        *resultError = 0.0f;
+    }
+    if (result.size() <= targetIndexCount || scale <= 0.0f) {
+        return result;
+    }
+
+    // ===按位置焊接: 位置完全相同的顶点共用一个位置编号, 拓扑和误差都在位置上计算===
+    std::vector<uint32_t> positionId(vertexCount);
+    std::vector<uint32_t> wedgeCount;
+    {
+        std::unordered_map<glm::vec3, uint32_t, PositionHash> ids;
+        ids.reserve(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            positionId[v] = ids.emplace(positions[v], (uint32_t)ids.size()).first->second;
+        }
+        // 只统计被引用的顶点, 没用到的重复顶点不算接缝
+        wedgeCount.assign(ids.size(), 0);
+        std::vector<bool> referenced(vertexCount, false);
+        for (const unsigned int index : result) {
+            if (!referenced[index]) {
+                referenced[index] = true;
+                wedgeCount[positionId[index]]++;
+            }
+        }
+    }
+    const auto positionCount = (uint32_t)wedgeCount.size();
+
+    // ===边界: 有向边(a, b)没有反向边(b, a)时就是开放边界===
+    std::unordered_set<uint64_t> edges;
+    edges.reserve(result.size());
+    for (size_t i = 0; i < result.size(); i += 3) {
+        for (int k = 0; k < 3; k++) {
+            edges.insert(edgeKey(positionId[result[i + k]], positionId[result[i + (k + 1) % 3]]));
+        }
+    }
+    std::unordered_set<uint64_t> borderEdges;
+    std::vector<bool> borderPosition(positionCount, false);
+    for (const uint64_t edge : edges) {
+        const auto a = (uint32_t)(edge >> 32), b = (uint32_t)edge;
+        if (!edges.count(edgeKey(b, a))) {
+            borderEdges.insert(edge);
+            borderPosition[a] = borderPosition[b] = true;
+        }
+    }
+    std::vector<VertexKind> kinds(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++) {
+        const uint32_t p = positionId[v];
+        const bool seam = wedgeCount[p] > 1;
+        kinds[v] = seam ? (borderPosition[p] ? VertexKind::LOCKED : VertexKind::SEAM)
+                        : (borderPosition[p] ? VertexKind::BORDER : VertexKind::MANIFOLD);
+    }
+
+    // ===二次误差: 三角形平面按面积加权, 边界边再加上一个垂直于三角形的平面===
+    std::vector<Quadric> quadrics(positionCount);
+    for (size_t i = 0; i < result.size(); i += 3) {
+        const glm::dvec3 p0 = positions[result[i]], p1 = positions[result[i + 1]], p2 = positions[result[i + 2]];
+        const glm::dvec3 cross = glm::cross(p1 - p0, p2 - p0);
+        const double length = glm::length(cross);
+        if (length <= 0.0) {
+            continue;
+        }
+        const glm::dvec3 normal = cross / length;
+        Quadric plane;
+        plane.addPlane(normal, -glm::dot(normal, p0), length * 0.5);
+        for (int k = 0; k < 3; k++) {
+            quadrics[positionId[result[i + k]]] += plane;
+        }
+        for (int k = 0; k < 3; k++) {
+            const uint32_t a = positionId[result[i + k]], b = positionId[result[i + (k + 1) % 3]];
+            if (!borderEdges.count(edgeKey(a, b))) {
+                continue;
+            }
+            const glm::dvec3 pa = positions[result[i + k]], pb = positions[result[i + (k + 1) % 3]];
+            const glm::dvec3 edge = pb - pa;
+            const double edgeLength = glm::length(edge);
+            if (edgeLength <= 0.0) {
+                continue;
+            }
+            const glm::dvec3 edgeNormal = glm::normalize(glm::cross(edge, normal));
+            Quadric border;
+            border.addPlane(edgeNormal, -glm::dot(edgeNormal, pa), edgeLength * edgeLength * BORDER_WEIGHT);
+            quadrics[a] += border;
+            quadrics[b] += border;
+        }
+    }
+
+    const auto canCollapse = [&](const uint32_t from, const uint32_t to) {
+        if (kinds[from] == VertexKind::SEAM || kinds[from] == VertexKind::LOCKED) {
+            return false;
+        }
+        if (kinds[from] == VertexKind::BORDER) {
+            const uint32_t a = positionId[from], b = positionId[to];
+            if (!borderEdges.count(edgeKey(a, b)) && !borderEdges.count(edgeKey(b, a))) {
+                return false;
+            }
+        }
+        return normals.empty() || glm::dot(normals[from], normals[to]) >= NORMAL_THRESHOLD;
+    };
+    // 坍缩后的平均距离平方
+    const auto collapseCost = [&](const uint32_t from, const uint32_t to) {
+        Quadric q = quadrics[positionId[from]];
+        q += quadrics[positionId[to]];
+        return q.weight > 0.0 ? q.evaluate(positions[to]) / q.weight : 0.0;
+    };
+
+    const size_t targetTriangles = targetIndexCount / 3;
+    const double errorLimit = (double)targetError * scale;
+    double maxError = 0.0;
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1), adjacency;
+    std::vector<uint32_t> collapseTo(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<Collapse> candidates;
+
+    // ===每一轮: 收集候选边, 按代价排序, 依次坍缩互不相邻的边===
+    while (result.size() / 3 > targetTriangles) {
+        const size_t triangleCount = result.size() / 3;
+
+        // 顶点 -> 三角形
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (const unsigned int index : result) {
+            adjacencyOffsets[index + 1]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        }
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); i++) {
+                adjacency[fill[result[i]]++] = (uint32_t)(i / 3);
+            }
+        }
+
+        // 候选边. 每条边只保留代价较小的方向
+        candidates.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                const uint32_t a = result[i + k], b = result[i + (k + 1) % 3];
+                // 内部边会从两侧的三角形各出现一次, 只处理a < b的那次. 边界边只出现一次
+                if (a > b && !borderEdges.count(edgeKey(positionId[a], positionId[b]))) {
+                    continue;
+                }
+                Collapse best{a, b, std::numeric_limits<double>::max()};
+                if (canCollapse(a, b)) {
+                    best.cost = collapseCost(a, b);
+                }
+                if (canCollapse(b, a)) {
+                    const double cost = collapseCost(b, a);
+                    if (cost < best.cost) {
+                        best = {b, a, cost};
+                    }
+                }
+                if (best.cost != std::numeric_limits<double>::max()) {
+                    candidates.push_back(best);
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& x, const Collapse& y) {
+            return x.cost < y.cost;
+        });
+
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            collapseTo[v] = v;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+        size_t removed = 0, collapses = 0;
+        const size_t goal = triangleCount - targetTriangles;
+
+        for (const Collapse& collapse : candidates) {
+            if (std::sqrt(collapse.cost) > errorLimit) {
+                break;
+            }
+            const uint32_t from = collapse.from, to = collapse.to;
+            if (touched[from] || touched[to]) {
+                continue;
+            }
+            // 翻面检查: from周围不包含to的三角形, 把from换成to后法线不能反向
+            bool flipped = false;
+            size_t degenerate = 0;
+            for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1] && !flipped; a++) {
+                const unsigned int* triangle = &result[adjacency[a] * 3];
+                glm::vec3 before[3], after[3];
+                bool collapsesAway = false;
+                for (int k = 0; k < 3; k++) {
+                    before[k] = positions[triangle[k]];
+                    after[k] = triangle[k] == from ? positions[to] : before[k];
+                    collapsesAway |= positionId[triangle[k]] == positionId[to];
+                }
+                if (collapsesAway) {
+                    degenerate++;
+                    continue;
+                }
+                const glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+                const glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+                flipped = glm::dot(n0, n1) <= 0.0f;
+            }
+            if (flipped) {
+                continue;
+            }
+
+            collapseTo[from] = to;
+            quadrics[positionId[to]] += quadrics[positionId[from]];
+            maxError = std::max(maxError, collapse.cost);
+            // 沿边界移动后, 与from相连的边界边变成与to相连
+            if (kinds[from] == VertexKind::BORDER) {
+                const uint32_t pf = positionId[from], pt = positionId[to];
+                for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; a++) {
+                    for (int k = 0; k < 3; k++) {
+                        const uint32_t p = positionId[result[adjacency[a] * 3 + k]];
+                        if (p == pf || p == pt) {
+                            continue;
+                        }
+                        if (borderEdges.count(edgeKey(pf, p))) {
+                            borderEdges.insert(edgeKey(pt, p));
+                        }
+                        if (borderEdges.count(edgeKey(p, pf))) {
+                            borderEdges.insert(edgeKey(p, pt));
+                        }
+                    }
+                }
+            }
+            // from周围的顶点在这一轮中都不再参与, 保证邻接信息不会过期
+            touched[to] = true;
+            for (uint32_t a = adjacencyOffsets[from]; a < adjacencyOffsets[from + 1]; a++) {
+                for (int k = 0; k < 3; k++) {
+                    touched[result[adjacency[a] * 3 + k]] = true;
+                }
+            }
+            collapses++;
+            removed += degenerate;
+            if (removed >= goal) {
+                break;
+            }
+        }
+        if (collapses == 0) {
+            break;
+        }
+
+        // 应用坍缩, 删除退化的三角形(包括两个顶点位置相同的)
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            const unsigned int a = collapseTo[result[i]], b = collapseTo[result[i + 1]], c = collapseTo[result[i + 2]];
+            const uint32_t pa = positionId[a], pb = positionId[b], pc = positionId[c];
+            if (pa == pb || pb == pc || pa == pc) {
+                continue;
+            }
+            result[write++] = a;
+            result[write++] = b;
+            result[write++] = c;
+        }
+        result.resize(write);
+    }
+
+    if (resultError) {
+        *resultError = (float)(std::sqrt(maxError) / scale);
+    }
+    return result;
+}
+
+std::vector<LodLevel> MeshSimplifier::buildLodChain(const std::vector<unsigned int>& indices,
+                                                    const std::vector<glm::vec3>& positions,
+                                                    const std::vector<glm::vec3>& normals,
+                                                    const uint32_t levelCount, const float ratio) {
+    std::vector<LodLevel> levels;
+    const float scale = getScale(positions);
+    const std::vector<unsigned int>* current = &indices;
+    float accumulatedError = 0.0f;
+    for (uint32_t level = 0; level < levelCount; level++) {
+        const size_t target = (size_t)((float)(current->size() / 3) * ratio) * 3;
+        float error = 0.0f;
+        // 每一级在上一级的基础上简化, 误差累加
+        std::vector<unsigned int> simplified = simplify(*current, positions, normals, target, 1.0f, &error);
+        // 几乎没有减少(接缝/边界太多)就不再继续
+        if (simplified.size() > current->size() * 9 / 10) {
+            break;
+        }
+        accumulatedError += error;
+        levels.push_back({std::move(simplified), accumulatedError * scale});
+        current = &levels.back().indices;
+    }
+    return levels;
+}
+
+float MeshSimplifier::getPixelsPerUnit(const glm::vec3& localCenter, const glm::mat4& modelMatrix,
+                                       const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix,
+                                       const float viewportHeight) {
+    // 投影矩阵的[1][1]把观察空间的y映射到NDC([-1, 1]), 再乘半个视口高度就是像素
+    float pixels = projectionMatrix[1][1] * viewportHeight * 0.5f;
+    // 透视投影的w = -z, 需要除以深度
+    if (projectionMatrix[3][3] == 0.0f) {
+        const glm::vec4 center = viewMatrix * modelMatrix * glm::vec4(localCenter, 1.0f);
+        pixels /= std::max(-center.z, 1e-4f);
+    }
+    // 模型矩阵的最大缩放
+    const float scale = std::max({glm::length(glm::vec3(modelMatrix[0])), glm::length(glm::vec3(modelMatrix[1])),
+                                  glm::length(glm::vec3(modelMatrix[2]))});
+    return pixels * scale;
+}
+
+uint32_t MeshSimplifier::selectLod(const std::vector<float>& errors, const float pixelsPerUnit,
+                                   const float maxPixelError) {
+    for (auto level = (uint32_t)errors.size(); level-- > 0;) {
+        if (errors[level] * pixelsPerUnit <= maxPixelError) {
+            return level;
+        }
+    }
+    return 0;
+}
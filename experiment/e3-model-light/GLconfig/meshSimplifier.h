@@ -0,0 +1,63 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+
+// 简化后的一级LOD: 新的索引(仍然引用原来的顶点缓冲), 以及模型空间中的误差
+struct LodLevel {
+    std::vector<unsigned int> indices;
+    float error{0.0f};
+};
+
+/**
+ * 基于二次误差度量(QEM, Garland & Heckbert)的网格简化, 纯CPU实现
+ * 只做"半边坍缩": 顶点u合并到相邻顶点v上, 不产生新顶点, 所以简化结果只是一份新的索引, 与原网格共用同一个VBO
+ *
+ * 每个顶点累积相邻三角形所在平面的二次误差, 坍缩u -> v的代价就是v到u累积的那些平面的距离平方和
+ * 每一轮按代价从小到大坍缩, 同一轮中被改动过的顶点不再参与, 直到三角形数量降到目标或者误差超过上限
+ *
+ * 为了保持外观, 以下坍缩会被拒绝:
+ *  - uv接缝/硬边法线: 同一位置有多个顶点(属性不同)的顶点不会被移动, 接缝线保持原样
+ *  - 开放边界: 边界上的顶点只能沿着边界移动, 并额外加上垂直于边界的平面, 防止轮廓收缩
+ *  - 三角形翻面, 以及两个顶点的法线夹角过大
+ */
+class MeshSimplifier {
+public:
+    // normals可以为空, 为空时不检查法线夹角. targetError为相对于网格尺寸(包围盒最长边)的误差上限
+    // resultError返回实际的误差(相对值)
+    static std::vector<unsigned int> simplify(const std::vector<unsigned int>& indices,
+                                              const std::vector<glm::vec3>& positions,
+                                              const std::vector<glm::vec3>& normals,
+                                              size_t targetIndexCount, float targetError = 0.05f,
+                                              float* resultError = nullptr);
+
+    // 生成LOD链(不含原始网格): 每一级的三角形数量约为上一级的ratio倍. 简化不动时提前停止
+    // 返回的误差为模型空间中的绝对误差
+    static std::vector<LodLevel> buildLodChain(const std::vector<unsigned int>& indices,
+                                               const std::vector<glm::vec3>& positions,
+                                               const std::vector<glm::vec3>& normals,
+                                               uint32_t levelCount = 4, float ratio = 0.5f);
+
+    // 网格尺寸: 包围盒的最长边. 相对误差乘上它就是模型空间的误差
+    static float getScale(const std::vector<glm::vec3>& positions);
+
+    // 法线夹角的余弦下限, 约60度
+    static constexpr float NORMAL_THRESHOLD = 0.5f;
+
+    // ===按屏幕尺寸选择LOD===
+    // 模型空间中位于localCenter处的单位长度, 经过模型矩阵(取最大的缩放)和投影后在屏幕上是多少像素
+    // 透视投影要除以深度, 正交投影与距离无关
+    static float getPixelsPerUnit(const glm::vec3& localCenter, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                                  const glm::mat4& projectionMatrix, float viewportHeight);
+    // 选择屏幕误差不超过maxPixelError的最粗的一级. errors[0]为原始网格(误差0), pixelsPerUnit来自getPixelsPerUnit
+    static uint32_t selectLod(const std::vector<float>& errors, float pixelsPerUnit, float maxPixelError = 1.0f);
+};
+
+#endif //MESHSIMPLIFIER_H
@@ -0,0 +1,125 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "meshSimplifierBenchmark.h"
+#include "benchmarkCheck.h"
+#include "meshGenerator.h"
+#include "meshSimplifier.h"
+
+using namespace benchmark;
+
+namespace {
+    // 点到三角形的最近距离(Ericson, Real-Time Collision Detection 5.1.5)
+    float pointTriangleDistance(const glm::vec3& p, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        const glm::vec3 ab = b - a, ac = c - a, ap = p - a;
+        const float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+        if (d1 <= 0.0f && d2 <= 0.0f) return glm::length(p - a);
+        const glm::vec3 bp = p - b;
+        const float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+        if (d3 >= 0.0f && d4 <= d3) return glm::length(p - b);
+        const float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return glm::length(p - (a + ab * (d1 / (d1 - d3))));
+        const glm::vec3 cp = p - c;
+        const float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+        if (d6 >= 0.0f && d5 <= d6) return glm::length(p - c);
+        const float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return glm::length(p - (a + ac * (d2 / (d2 - d6))));
+        const float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && d4 - d3 >= 0.0f && d5 - d6 >= 0.0f) {
+            return glm::length(p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))));
+        }
+        const float denominator = 1.0f / (va + vb + vc);
+        return glm::length(p - (a + ab * (vb * denominator) + ac * (vc * denominator)));
+    }
+
+    // 原始网格的每个顶点到简化后表面的最大距离. 简化不产生新顶点, 所以反方向的距离总是0
+    float measureError(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices) {
+        float maxDistance = 0.0f;
+        for (const auto& p : positions) {
+            float best = FLT_MAX;
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                best = std::min(best, pointTriangleDistance(p, positions[indices[i]], positions[indices[i + 1]],
+                                                            positions[indices[i + 2]]));
+            }
+            maxDistance = std::max(maxDistance, best);
+        }
+        return maxDistance;
+    }
+
+    // 测量的误差最多是报告的误差的这么多倍. 报告的误差是二次误差的估计, 不是严格的上界, 实测最大约1.5倍
+    constexpr float MEASURED_ERROR_FACTOR = 2.0f;
+
+    void simplifyShape(const std::string& name, const GeneratedMesh& mesh, const bool measure) {
+        std::vector<glm::vec3> positions(mesh.vertices.size()), normals(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            glm::vec2 uv;
+            positions[i] = mesh.vertices[i].position;
+            unpackVertex(mesh.vertices[i], mesh.uvScale, normals[i], uv);
+        }
+        const std::vector<unsigned int> indices(mesh.indices.begin(), mesh.indices.end());
+        const float scale = MeshSimplifier::getScale(positions);
+
+        const auto start = Clock::now();
+        const std::vector<LodLevel> lods = MeshSimplifier::buildLodChain(indices, positions, normals, 5);
+        const double ms = elapsedMs(start);
+
+        std::cout << "  " << name << ": " << indices.size() / 3 << " triangles, " << lods.size() << " LODs in " << ms
+                  << " ms" << std::endl;
+        size_t previousTriangles = indices.size() / 3;
+        float previousError = 0.0f;
+        bool decreasing = !lods.empty();
+        bool errorGrowing = true;
+        bool errorBounded = true;
+        for (size_t i = 0; i < lods.size(); i++) {
+            const size_t triangles = lods[i].indices.size() / 3;
+            std::cout << "    LOD" << i + 1 << ": " << triangles << " triangles, error "
+                      << lods[i].error << " (" << lods[i].error / scale * 100.0f << "%)";
+            decreasing = decreasing && triangles < previousTriangles;
+            errorGrowing = errorGrowing && lods[i].error >= previousError;
+            previousTriangles = triangles;
+            previousError = lods[i].error;
+            if (measure) {
+                const float measured = measureError(positions, lods[i].indices);
+                std::cout << ", measured " << measured;
+                // 没有误差的简化(平面)只允许浮点舍入
+                errorBounded = errorBounded && measured <= MEASURED_ERROR_FACTOR * lods[i].error + 1e-5f * scale;
+            }
+            std::cout << std::endl;
+        }
+        check(decreasing, name + ": triangle count falls at every LOD level");
+        check(errorGrowing, name + ": reported error never decreases along the chain");
+        if (measure) {
+            check(errorBounded, name + ": measured error <= " + std::to_string((int)MEASURED_ERROR_FACTOR) + " x reported error at every level");
+        }
+    }
+}
+
+void benchmarkSphereSimplification(const uint32_t segments) {
+    std::cout << "sphere " << segments << "x" << segments << ":" << std::endl;
+    simplifyShape("sphere", MeshGenerator::sphere(1.0f, (int)segments, (int)segments), true);
+}
+
+void benchmarkShapeSimplification() {
+    std::cout << "shapes:" << std::endl;
+    simplifyShape("torus", MeshGenerator::torus(1.0f, 0.3f, 96, 48), true);
+    simplifyShape("capsule", MeshGenerator::capsule(0.5f, 1.0f, 48, 16, 4), true);
+    simplifyShape("plane", MeshGenerator::plane(2.0f, 2.0f, 40, 40), true);
+    simplifyShape("box", MeshGenerator::box(1.0f, 1.0f, 1.0f, 8), true);
+    // 大网格只统计耗时
+    simplifyShape("sphere 512x512", MeshGenerator::sphere(1.0f, 512, 512), false);
+}
+
+void runMeshSimplifierBenchmarks() {
+    beginChecks("mesh simplifier");
+    benchmarkSphereSimplification(60);
+    benchmarkShapeSimplification();
+    endChecks();
+}
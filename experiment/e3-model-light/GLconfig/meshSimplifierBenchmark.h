@@ -0,0 +1,25 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHSIMPLIFIERBENCHMARK_H
+#define MESHSIMPLIFIERBENCHMARK_H
+
+#include <cstdint>
+
+/**
+ * 网格简化(LOD生成)的测试, 在窗口中按B键运行. 只处理CPU端的数据, 不需要OpenGL上下文
+ * 对每个形状生成LOD链, 打印每一级的三角形数量, 耗时, 报告的误差,
+ * 以及实际测量的误差(原始网格的每个顶点到简化后网格表面的最大距离), 用于检查误差估计是否可信
+ * 检查: 每一级的三角形数都比上一级少, 报告的误差不减小, 测量的误差不超过报告的误差的2倍
+ */
+
+// 单个球体, 每一级LOD都测量实际误差. 测量是O(顶点数 * 三角形数)的, segments不宜过大
+void benchmarkSphereSimplification(uint32_t segments);
+
+// 各种形状的LOD链: 闭合曲面, 带边界的平面, 带uv接缝/硬边的长方体
+void benchmarkShapeSimplification();
+
+void runMeshSimplifierBenchmarks();
+
+#endif //MESHSIMPLIFIERBENCHMARK_H
@@ -0,0 +1,271 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "meshlet.h"
+#include "meshOptimizer.h"
+
+namespace {
+    constexpr uint8_t UNUSED_LOCAL = 0xFF;
+
+    glm::vec3 triangleNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+        const glm::vec3 normal = glm::cross(b - a, c - a);
+        const float length = glm::length(normal);
+        return length > 0.0f ? normal / length : glm::vec3(0.0f);
+    }
+}
+
+MeshletData MeshletBuilder::build(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions,
+                                  uint32_t maxVertices, const uint32_t maxTriangles) {
+    MeshletData data;
+    // 局部下标是8位的
+    maxVertices = std::min<uint32_t>(maxVertices, UNUSED_LOCAL);
+    const size_t triangleCount = indices.size() / 3;
+    const size_t vertexCount = positions.size();
+    if (triangleCount == 0) {
+        return data;
+    }
+
+    // 顶点 -> 相邻三角形
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        adjacencyOffsets[indices[i] + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; i++) {
+            adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+        }
+    }
+    std::vector<glm::vec3> normals(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++) {
+        normals[t] = triangleNormal(positions[indices[t * 3]], positions[indices[t * 3 + 1]], positions[indices[t * 3 + 2]]);
+    }
+
+    std::vector<bool> used(triangleCount, false);
+    // 原顶点在当前meshlet中的局部下标
+    std::vector<uint8_t> localIndex(vertexCount, UNUSED_LOCAL);
+    Meshlet current;
+    glm::vec3 normalSum(0.0f);
+
+    // 加入三角形t需要新增的顶点数
+    auto newVertices = [&](const size_t t) {
+        const unsigned int a = indices[t * 3], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+        uint32_t count = localIndex[a] == UNUSED_LOCAL;
+        count += localIndex[b] == UNUSED_LOCAL && b != a;
+        count += localIndex[c] == UNUSED_LOCAL && c != a && c != b;
+        return count;
+    };
+    auto addTriangle = [&](const size_t t) {
+        used[t] = true;
+        for (int k = 0; k < 3; k++) {
+            const unsigned int v = indices[t * 3 + k];
+            if (localIndex[v] == UNUSED_LOCAL) {
+                localIndex[v] = (uint8_t)current.vertexCount++;
+                data.vertices.push_back(v);
+            }
+            data.triangles.push_back(localIndex[v]);
+        }
+        current.triangleCount++;
+        normalSum += normals[t];
+    };
+    std::vector<unsigned int> localTriangles;
+    auto finishMeshlet = [&] {
+        // 贪心扩展的顺序对顶点缓存不友好, meshlet内部再按顶点缓存重排一次三角形
+        uint8_t* triangles = &data.triangles[current.triangleOffset * 3];
+        localTriangles.assign(triangles, triangles + current.triangleCount * 3);
+        MeshOptimizer::optimizeVertexCache(localTriangles, current.vertexCount);
+        std::copy(localTriangles.begin(), localTriangles.end(), triangles);
+        computeBounds(current, data, positions);
+        for (uint32_t i = 0; i < current.vertexCount; i++) {
+            localIndex[data.vertices[current.vertexOffset + i]] = UNUSED_LOCAL;
+        }
+        data.meshlets.push_back(current);
+        current = Meshlet();
+        current.vertexOffset = (uint32_t)data.vertices.size();
+        current.triangleOffset = (uint32_t)(data.triangles.size() / 3);
+        normalSum = glm::vec3(0.0f);
+    };
+
+    size_t cursor = 0;
+    for (size_t remaining = triangleCount; remaining > 0; remaining--) {
+        size_t best = SIZE_MAX;
+        if (current.triangleCount > 0 && current.triangleCount < maxTriangles) {
+            const float sumLength = glm::length(normalSum);
+            const glm::vec3 axis = sumLength > 0.0f ? normalSum / sumLength : glm::vec3(0.0f);
+            float bestScore = FLT_MAX;
+            for (uint32_t i = 0; i < current.vertexCount; i++) {
+                const uint32_t v = data.vertices[current.vertexOffset + i];
+                for (uint32_t j = adjacencyOffsets[v]; j < adjacencyOffsets[v + 1]; j++) {
+                    const uint32_t t = adjacency[j];
+                    if (used[t]) {
+                        continue;
+                    }
+                    const uint32_t extra = newVertices(t);
+                    if (current.vertexCount + extra > maxVertices) {
+                        continue;
+                    }
+                    const float score = (float)extra + CONE_WEIGHT * (1.0f - glm::dot(normals[t], axis));
+                    if (score < bestScore) {
+                        bestScore = score;
+                        best = t;
+                    }
+                }
+            }
+        }
+        if (best == SIZE_MAX) {
+            // 当前meshlet已满或者没有相邻的三角形, 从原顺序中下一个未使用的三角形开始新的meshlet
+            if (current.triangleCount > 0) {
+                finishMeshlet();
+            }
+            while (used[cursor]) {
+                cursor++;
+            }
+            best = cursor;
+        }
+        addTriangle(best);
+    }
+    finishMeshlet();
+    return data;
+}
+
+std::vector<unsigned int> MeshletBuilder::flatten(const MeshletData& data) {
+    std::vector<unsigned int> indices;
+    indices.reserve(data.triangles.size());
+    for (const Meshlet& meshlet : data.meshlets) {
+        for (uint32_t i = 0; i < meshlet.triangleCount * 3; i++) {
+            indices.push_back(data.vertices[meshlet.vertexOffset + data.triangles[meshlet.triangleOffset * 3 + i]]);
+        }
+    }
+    return indices;
+}
+
+void MeshletBuilder::computeBounds(Meshlet& meshlet, const MeshletData& data, const std::vector<glm::vec3>& positions) {
+    // 包围球: 包围盒中心, 半径为到最远顶点的距离
+    glm::vec3 minPosition(FLT_MAX), maxPosition(-FLT_MAX);
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        const glm::vec3& p = positions[data.vertices[meshlet.vertexOffset + i]];
+        minPosition = glm::min(minPosition, p);
+        maxPosition = glm::max(maxPosition, p);
+    }
+    meshlet.center = (minPosition + maxPosition) * 0.5f;
+    meshlet.radius = 0.0f;
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+        meshlet.radius = std::max(meshlet.radius, glm::length(positions[data.vertices[meshlet.vertexOffset + i]] - meshlet.center));
+    }
+
+    // 法线锥: 轴为平均法线, 半角由偏离轴最远的法线决定
+    std::vector<glm::vec3> normals(meshlet.triangleCount);
+    glm::vec3 normalSum(0.0f);
+    for (uint32_t t = 0; t < meshlet.triangleCount; t++) {
+        const uint8_t* triangle = &data.triangles[(meshlet.triangleOffset + t) * 3];
+        normals[t] = triangleNormal(positions[data.vertices[meshlet.vertexOffset + triangle[0]]],
+                                    positions[data.vertices[meshlet.vertexOffset + triangle[1]]],
+                                    positions[data.vertices[meshlet.vertexOffset + triangle[2]]]);
+        normalSum += normals[t];
+    }
+    meshlet.coneCutoff = 1.0f;
+    const float sumLength = glm::length(normalSum);
+    if (sumLength <= 1e-6f) {
+        return;
+    }
+    meshlet.coneAxis = normalSum / sumLength;
+    float minDot = 1.0f;
+    for (const glm::vec3& normal : normals) {
+        // 面积为0的三角形不会被光栅化, 不影响法线锥
+        if (normal != glm::vec3(0.0f)) {
+            minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+        }
+    }
+    // 锥半角超过90度时任何方向都能看到其中的某个三角形
+    if (minDot > 0.0f) {
+        meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+void MeshletCuller::cull(const std::vector<Meshlet>& meshlets, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                         const glm::mat4& projectionMatrix, std::vector<MeshletRange>& ranges, MeshletCullStats* stats) {
+    ranges.clear();
+    // 从模型空间的裁剪矩阵中提取6个裁剪平面(Gribb & Hartmann), 法线朝内
+    const glm::mat4 clip = projectionMatrix * viewMatrix * modelMatrix;
+    glm::vec4 planes[6];
+    for (int i = 0; i < 3; i++) {
+        const glm::vec4 row(clip[0][i], clip[1][i], clip[2][i], clip[3][i]);
+        const glm::vec4 w(clip[0][3], clip[1][3], clip[2][3], clip[3][3]);
+        planes[i * 2] = w + row;
+        planes[i * 2 + 1] = w - row;
+    }
+    for (glm::vec4& plane : planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    // 相机位置和视线方向变换到模型空间. 镜像的模型矩阵会翻转三角形的绕序, 正面和背面也随之互换
+    const glm::mat4 inverseModel = glm::inverse(modelMatrix);
+    const glm::mat4 inverseView = glm::inverse(viewMatrix);
+    const bool orthographic = projectionMatrix[3][3] != 0.0f;
+    const glm::vec3 cameraPosition = glm::vec3(inverseModel * inverseView[3]);
+    const glm::vec3 viewDirection = glm::normalize(glm::vec3(inverseModel * -inverseView[2]));
+    const float winding = glm::determinant(glm::mat3(modelMatrix)) < 0.0f ? -1.0f : 1.0f;
+
+    MeshletCullStats result;
+    result.meshlets = (uint32_t)meshlets.size();
+    for (const Meshlet& meshlet : meshlets) {
+        result.triangles += meshlet.triangleCount;
+
+        bool outside = false;
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), meshlet.center) + plane.w < -meshlet.radius) {
+                outside = true;
+                break;
+            }
+        }
+        if (outside) {
+            result.frustumCulled++;
+            continue;
+        }
+
+        if (meshlet.coneCutoff < 1.0f) {
+            const glm::vec3 axis = meshlet.coneAxis * winding;
+            bool backface;
+            if (orthographic) {
+                backface = glm::dot(viewDirection, axis) >= meshlet.coneCutoff;
+            } else {
+                const glm::vec3 toCenter = meshlet.center - cameraPosition;
+                backface = glm::dot(toCenter, axis) >= meshlet.coneCutoff * glm::length(toCenter) + meshlet.radius;
+            }
+            if (backface) {
+                result.backfaceCulled++;
+                continue;
+            }
+        }
+
+        result.visibleMeshlets++;
+        result.visibleTriangles += meshlet.triangleCount;
+        const uint32_t firstIndex = meshlet.triangleOffset * 3;
+        if (!ranges.empty() && ranges.back().firstIndex + ranges.back().count == firstIndex) {
+            ranges.back().count += meshlet.triangleCount * 3;
+        } else {
+            ranges.push_back({firstIndex, meshlet.triangleCount * 3});
+        }
+    }
+    result.culledFraction = result.triangles > 0 ? 1.0f - (float)result.visibleTriangles / (float)result.triangles : 0.0f;
+    if (stats) {
+        *stats = result;
+    }
+}
+
+void MeshletCuller::compactIndices(const std::vector<unsigned int>& indices, const std::vector<MeshletRange>& ranges,
+                                   std::vector<unsigned int>& result) {
+    result.clear();
+    for (const MeshletRange& range : ranges) {
+        result.insert(result.end(), indices.begin() + range.firstIndex, indices.begin() + range.firstIndex + range.count);
+    }
+}
@@ -0,0 +1,99 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+
+/**
+ * 一个meshlet(簇): 不超过64个顶点, 124个三角形的一小块网格
+ * 顶点和三角形存放在MeshletData的大数组中, 这里只记录偏移和数量
+ * 剔除用的包围信息(都在模型空间):
+ *  - 包围球: 中心和半径
+ *  - 法线锥: 所有三角形法线都在以coneAxis为轴的锥内, coneCutoff为锥半角的正弦值.
+ *    三角形法线分布超过半球时无法背面剔除, coneCutoff为1
+ */
+struct Meshlet {
+    uint32_t vertexOffset{0};
+    uint32_t vertexCount{0};
+    uint32_t triangleOffset{0};
+    uint32_t triangleCount{0};
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+    glm::vec3 coneAxis{0.0f, 0.0f, 1.0f};
+    float coneCutoff{1.0f};
+};
+
+// 划分的结果. vertices为每个meshlet引用的原网格顶点下标, triangles为meshlet内的局部下标(每个三角形3个)
+struct MeshletData {
+    std::vector<Meshlet> meshlets;
+    std::vector<uint32_t> vertices;
+    std::vector<uint8_t> triangles;
+};
+
+// 一段可见的三角形: 在按meshlet顺序排列的索引中的起始位置和索引数量. 相邻的可见meshlet会合并成一段
+struct MeshletRange {
+    uint32_t firstIndex{0};
+    uint32_t count{0};
+};
+
+// 一次剔除的统计
+struct MeshletCullStats {
+    uint32_t meshlets{0};
+    uint32_t visibleMeshlets{0};
+    uint32_t backfaceCulled{0}; // 被法线锥剔除的meshlet
+    uint32_t frustumCulled{0}; // 被视锥剔除的meshlet
+    uint32_t triangles{0};
+    uint32_t visibleTriangles{0};
+    float culledFraction{0.0f}; // 被剔除的三角形比例
+};
+
+/**
+ * 把网格划分为meshlet
+ * 贪心地扩展当前meshlet: 候选三角形来自与当前meshlet共享顶点的三角形, 优先选择新增顶点少的,
+ * 其次是法线与当前法线锥轴接近的(让法线锥更窄, 更容易被背面剔除). 没有候选时按原索引顺序找下一个未使用的三角形
+ * 输入最好先经过MeshOptimizer的顶点缓存优化, 这样原顺序本身就是空间连续的
+ */
+class MeshletBuilder {
+public:
+    static constexpr uint32_t MAX_VERTICES = 64;
+    static constexpr uint32_t MAX_TRIANGLES = 124;
+    // 挑选候选三角形时法线偏离的权重, 相对于新增一个顶点的代价
+    static constexpr float CONE_WEIGHT = 0.5f;
+
+    // maxVertices最多255(局部下标为8位)
+    static MeshletData build(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions,
+                             uint32_t maxVertices = MAX_VERTICES, uint32_t maxTriangles = MAX_TRIANGLES);
+
+    // 按meshlet顺序展开为普通的32位索引, meshlet的第i个三角形在triangleOffset + i处
+    static std::vector<unsigned int> flatten(const MeshletData& data);
+
+private:
+    static void computeBounds(Meshlet& meshlet, const MeshletData& data, const std::vector<glm::vec3>& positions);
+};
+
+/**
+ * 在CPU上按meshlet剔除, 变换都在模型空间中进行(把相机和视锥变换到模型空间), 不需要变换每个meshlet
+ *  - 视锥剔除: 包围球完全在某个裁剪平面外
+ *  - 背面剔除: 从相机看过去, 包围球内每一点上法线锥内的每个法线都背向相机.
+ *    透视投影用相机位置判断, 正交投影只看视线方向
+ * 剔除是保守的: 被剔除的meshlet中不会有可见的三角形
+ */
+class MeshletCuller {
+public:
+    // 输出按meshlet顺序的可见范围(相邻的已合并), stats可以为空
+    static void cull(const std::vector<Meshlet>& meshlets, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                     const glm::mat4& projectionMatrix, std::vector<MeshletRange>& ranges,
+                     MeshletCullStats* stats = nullptr);
+
+    // 把可见范围压缩为一份新的索引流, indices为flatten后的索引
+    static void compactIndices(const std::vector<unsigned int>& indices, const std::vector<MeshletRange>& ranges,
+                               std::vector<unsigned int>& result);
+};
+
+#endif //MESHLET_H
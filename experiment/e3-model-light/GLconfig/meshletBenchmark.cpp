@@ -0,0 +1,104 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "meshletBenchmark.h"
+#include "benchmarkCheck.h"
+#include "meshGenerator.h"
+#include "meshlet.h"
+#include "meshOptimizer.h"
+
+using namespace benchmark;
+
+namespace {
+    // 三角形是否可能可见: 正面朝向相机, 并且没有完全在某个裁剪平面外
+    bool triangleVisible(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& cameraPosition,
+                         const glm::mat4& clip) {
+        if (glm::dot(glm::cross(b - a, c - a), a - cameraPosition) >= 0.0f) {
+            return false;
+        }
+        const glm::vec4 pa = clip * glm::vec4(a, 1.0f), pb = clip * glm::vec4(b, 1.0f), pc = clip * glm::vec4(c, 1.0f);
+        for (int axis = 0; axis < 3; axis++) {
+            if (pa[axis] > pa.w && pb[axis] > pb.w && pc[axis] > pc.w) return false;
+            if (pa[axis] < -pa.w && pb[axis] < -pb.w && pc[axis] < -pc.w) return false;
+        }
+        return true;
+    }
+
+    void cullShape(const std::string& name, const GeneratedMesh& mesh) {
+        std::vector<glm::vec3> positions(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            positions[i] = mesh.vertices[i].position;
+        }
+        std::vector<unsigned int> indices(mesh.indices.begin(), mesh.indices.end());
+        MeshOptimizer::optimizeVertexCache(indices, (uint32_t)positions.size());
+
+        const auto start = Clock::now();
+        const MeshletData data = MeshletBuilder::build(indices, positions);
+        const double ms = elapsedMs(start);
+        const std::vector<unsigned int> flattened = MeshletBuilder::flatten(data);
+        std::cout << "  " << name << ": " << indices.size() / 3 << " triangles -> " << data.meshlets.size()
+                  << " meshlets (avg " << (float)data.vertices.size() / (float)data.meshlets.size() << " vertices, "
+                  << (float)(indices.size() / 3) / (float)data.meshlets.size() << " triangles) in " << ms << " ms"
+                  << std::endl;
+
+        const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 4.0f / 3.0f, 0.1f, 100.0f);
+        const glm::mat4 model(1.0f);
+        const float distance = 4.0f * mesh.boundingSphere.radius;
+        const glm::vec3 eyes[] = {
+            {0, 0, distance}, {0, 0, -distance}, {distance, 0, 0}, {-distance, 0, 0}, {0, distance, 0.01f},
+            {0, -distance, 0.01f},
+            // 贴近表面, 大部分网格在视锥外
+            {0, 0, mesh.boundingSphere.radius * 1.3f},
+        };
+        std::vector<MeshletRange> ranges;
+        std::vector<unsigned int> visible;
+        for (const glm::vec3& eye : eyes) {
+            const glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f), glm::vec3(0, 1, 0));
+            MeshletCullStats stats;
+            MeshletCuller::cull(data.meshlets, model, view, projection, ranges, &stats);
+            MeshletCuller::compactIndices(flattened, ranges, visible);
+
+            // 被剔除的三角形中可能可见的数量(应为0), 以及逐三角形剔除能达到的比例
+            std::vector<bool> kept(flattened.size() / 3, false);
+            for (const MeshletRange& range : ranges) {
+                for (uint32_t i = 0; i < range.count / 3; i++) {
+                    kept[range.firstIndex / 3 + i] = true;
+                }
+            }
+            const glm::mat4 clip = projection * view * model;
+            uint32_t wronglyCulled = 0, trulyVisible = 0;
+            for (size_t t = 0; t < kept.size(); t++) {
+                const bool triangleIsVisible = triangleVisible(positions[flattened[t * 3]], positions[flattened[t * 3 + 1]],
+                                                               positions[flattened[t * 3 + 2]], eye, clip);
+                trulyVisible += triangleIsVisible;
+                wronglyCulled += triangleIsVisible && !kept[t];
+            }
+            std::cout << "    eye (" << eye.x << ", " << eye.y << ", " << eye.z << "): culled "
+                      << stats.culledFraction * 100.0f << "% triangles (backface " << stats.backfaceCulled
+                      << ", frustum " << stats.frustumCulled << " of " << stats.meshlets << " meshlets), "
+                      << ranges.size() << " draw ranges, " << visible.size() / 3 << " triangles drawn, per-triangle ideal "
+                      << (1.0f - (float)trulyVisible / (float)kept.size()) * 100.0f << "%, wrongly culled "
+                      << wronglyCulled << std::endl;
+        }
+    }
+}
+
+void benchmarkMeshletCulling() {
+    std::cout << "meshlet culling:" << std::endl;
+    cullShape("sphere 128x128", MeshGenerator::sphere(1.0f, 128, 128));
+    cullShape("torus", MeshGenerator::torus(1.0f, 0.3f, 192, 96));
+    cullShape("capsule", MeshGenerator::capsule(0.5f, 1.0f, 96, 32, 8));
+    cullShape("box", MeshGenerator::box(1.0f, 1.0f, 1.0f, 32));
+    cullShape("plane", MeshGenerator::plane(2.0f, 2.0f, 64, 64));
+}
+
+void runMeshletBenchmarks() {
+    std::cout << "==========meshlet benchmark==========" << std::endl;
+    benchmarkMeshletCulling();
+}
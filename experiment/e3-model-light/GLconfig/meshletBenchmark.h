@@ -0,0 +1,19 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MESHLETBENCHMARK_H
+#define MESHLETBENCHMARK_H
+
+/**
+ * meshlet划分和剔除的测试, 在窗口中按B键运行. 只处理CPU端的数据, 不需要OpenGL上下文
+ * 打印每个形状的meshlet数量, 平均顶点数/三角形数, 以及从多个视角剔除的三角形比例
+ * 同时逐个三角形检查剔除是否保守: 被剔除的三角形必须背向相机或者完全在视锥外
+ */
+
+// 划分统计, 以及从6个方向和一个近距离视角剔除的结果
+void benchmarkMeshletCulling();
+
+void runMeshletBenchmarks();
+
+#endif //MESHLETBENCHMARK_H
@@ -0,0 +1,327 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "modelInstancingBenchmark.h"
+#include "benchmarkCheck.h"
+#include "glRecorder.h"
+#include "instanceBuffer.h"
+#include "meshCache.h"
+#include "meshGenerator.h"
+#include "modelPacker.h"
+#include "nodeHierarchy.h"
+#include "renderQueue.h"
+
+using namespace benchmark;
+
+namespace {
+    bool nearlyEqual(const glm::mat4& a, const glm::mat4& b) {
+        for (int column = 0; column < 4; column++) {
+            for (int row = 0; row < 4; row++) {
+                if (glm::abs(a[column][row] - b[column][row]) > 1e-4f) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // 对照: 从节点沿父节点逐级向上相乘
+    glm::mat4 referenceWorld(const std::vector<ModelNode>& nodes, int32_t node) {
+        glm::mat4 world(1.0f);
+        while (node >= 0) {
+            world = nodes[node].local * world;
+            node = nodes[node].parent;
+        }
+        return world;
+    }
+
+    ModelNode makeNode(const int32_t parent, const glm::mat4& local, const uint32_t firstMesh, const uint32_t meshCount) {
+        ModelNode node;
+        node.parent = parent;
+        node.local = local;
+        node.firstMesh = firstMesh;
+        node.meshCount = meshCount;
+        return node;
+    }
+
+    CookedMesh cookGenerated(const GeneratedMesh& mesh, const std::string& name, const uint32_t lodLevels) {
+        std::vector<Vertex> vertices(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            vertices[i].position = mesh.vertices[i].position;
+            unpackVertex(mesh.vertices[i], mesh.uvScale, vertices[i].normal, vertices[i].uv);
+        }
+        std::vector<unsigned int> indices(mesh.indices.begin(), mesh.indices.end());
+        return Mesh::cook(std::move(vertices), std::move(indices), lodLevels, name);
+    }
+
+    // 与Model::appendBatchCommands相同: 分组内同一节点(slot)的子网格相邻, 节点的最后一个子网格处合并范围并生成命令
+    void appendGroupCommands(const PackedModel& packed, const std::vector<std::vector<IndexedDraw>>& levelDraws,
+                             const SubmeshGroup& group, const std::vector<uint32_t>& meshSlots,
+                             const std::vector<uint32_t>& meshLods, const uint32_t count, const uint32_t baseInstance,
+                             std::vector<DrawElementsIndirectCommand>& commands) {
+        std::vector<std::vector<MeshletRange>> levelRanges(packed.levels.size());
+        const uint32_t end = group.firstSubmesh + group.submeshCount;
+        for (uint32_t i = group.firstSubmesh; i < end; i++) {
+            const SubmeshRange& submesh = packed.submeshes[i];
+            const uint32_t lod = meshLods[submesh.mesh];
+            levelRanges[lod].push_back(submesh.levels[lod]);
+            const uint32_t slot = meshSlots[submesh.mesh];
+            if (i + 1 < end && meshSlots[packed.submeshes[i + 1].mesh] == slot) {
+                continue;
+            }
+            for (size_t level = 0; level < levelRanges.size(); level++) {
+                ModelPacker::mergeRanges(levelRanges[level]);
+                appendIndirectCommands(levelDraws[level], sizeof(GLushort), 0, 0, levelRanges[level], commands, count,
+                                       baseInstance + slot * count);
+                levelRanges[level].clear();
+            }
+        }
+    }
+}
+
+void checkNodeHierarchy() {
+    std::cout << "node hierarchy:" << std::endl;
+    // 根节点平移, 子节点绕y轴旋转90度, 孙节点沿z平移; 另一个子节点缩放; 第二个根节点
+    std::vector<ModelNode> nodes{
+        makeNode(-1, glm::translate(glm::mat4(1.0f), glm::vec3(10, 0, 0)), 0, 0),
+        makeNode(0, glm::rotate(glm::mat4(1.0f), glm::half_pi<float>(), glm::vec3(0, 1, 0)), 0, 1),
+        makeNode(1, glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, 5)), 1, 2),
+        makeNode(0, glm::scale(glm::mat4(1.0f), glm::vec3(2.0f)), 3, 1),
+        makeNode(-1, glm::translate(glm::mat4(1.0f), glm::vec3(0, 3, 0)), 4, 0),
+    };
+    std::vector<glm::mat4> world;
+    NodeHierarchy::computeWorldMatrices(nodes, world);
+    bool same = world.size() == nodes.size();
+    for (size_t i = 0; same && i < nodes.size(); i++) {
+        same = nearlyEqual(world[i], referenceWorld(nodes, (int32_t)i));
+    }
+    check(same, "one linear pass matches multiplying up the parent chain");
+    const glm::vec3 origin = glm::vec3(world[2] * glm::vec4(0, 0, 0, 1));
+    check(glm::length(origin - glm::vec3(15, 0, 0)) < 1e-4f, "a grandchild's origin is moved by every ancestor");
+
+    check(NodeHierarchy::isValid(nodes, 4), "pre-order nodes with in-range meshes are valid");
+    std::vector<ModelNode> badParent = nodes;
+    badParent[1].parent = 3;
+    std::vector<ModelNode> badMeshes = nodes;
+    badMeshes[3].meshCount = 2;
+    check(!NodeHierarchy::isValid(badParent, 4) && !NodeHierarchy::isValid(badMeshes, 4),
+          "a parent after its child or a mesh range past the end is rejected");
+
+    // 节点表写入网格缓存再读回
+    std::vector<CookedMesh> meshes;
+    for (int i = 0; i < 4; i++) {
+        meshes.push_back(cookGenerated(MeshGenerator::box(1.0f, 1.0f, 1.0f, 1), "box", 0));
+    }
+    const std::string withNodes = (std::filesystem::temp_directory_path() / "e3-instancing-nodes.e3mesh").string();
+    const std::string withoutNodes = (std::filesystem::temp_directory_path() / "e3-instancing-root.e3mesh").string();
+    const PackedModel packed = ModelPacker::pack(meshes);
+    MeshCacheFile file;
+    bool roundTrip = MeshCache::write(withNodes, withNodes + ".missing", meshes, packed, nodes) && file.open(withNodes);
+    if (roundTrip) {
+        const std::vector<ModelNode> read = file.getNodes();
+        roundTrip = read.size() == nodes.size();
+        for (size_t i = 0; roundTrip && i < nodes.size(); i++) {
+            roundTrip = read[i].parent == nodes[i].parent && read[i].local == nodes[i].local
+                        && read[i].firstMesh == nodes[i].firstMesh && read[i].meshCount == nodes[i].meshCount;
+        }
+    }
+    file.close();
+    check(roundTrip, "node table survives the mesh cache round trip");
+    bool root = MeshCache::write(withoutNodes, withoutNodes + ".missing", meshes, packed) && file.open(withoutNodes);
+    if (root) {
+        const std::vector<ModelNode> read = file.getNodes();
+        root = read.size() == 1 && read[0].parent == -1 && read[0].meshCount == 4 && read[0].local == glm::mat4(1.0f);
+    }
+    file.close();
+    check(root, "a cache without nodes reads back as one root holding every mesh");
+    std::error_code error;
+    std::filesystem::remove(withNodes, error);
+    std::filesystem::remove(withoutNodes, error);
+}
+
+void checkInstanceBuffer() {
+    std::cout << "instance buffer:" << std::endl;
+    const std::vector<glm::mat4> world{
+        glm::mat4(1.0f), glm::translate(glm::mat4(1.0f), glm::vec3(1, 2, 3)), glm::scale(glm::mat4(1.0f), glm::vec3(3.0f))
+    };
+    std::vector<glm::mat4> placements;
+    for (int i = 0; i < 4; i++) {
+        placements.push_back(glm::translate(glm::mat4(1.0f), glm::vec3((float)i * 10.0f, 0, 0)));
+    }
+    // 设置过属性的VAO是全局记录的, 每次运行用一个新的假名字
+    static GLuint fakeVAO = 0xFFFF0000;
+    const GLuint vao = fakeVAO++;
+    {
+        GLRecorder gl;
+        InstanceBuffer instances;
+        instances.append(glm::mat4(1.0f));
+        const uint32_t base = NodeHierarchy::appendInstances(world, {0, 2}, placements.data(), 4, instances);
+        check(base == 1 && instances.size() == 9, "instances are appended after the existing ones, one per node and placement");
+        check(nearlyEqual(instances.getMatrices()[base + 1 * 4 + 2], placements[2] * world[2])
+              && nearlyEqual(instances.getMatrices()[base + 3], placements[3] * world[0]),
+              "a node's placements are contiguous: slot * count + placement");
+
+        instances.upload(vao);
+        const uint32_t firstAttributes = gl.count(GLCall::VertexArrayAttrib);
+        instances.upload(vao);
+        check(gl.count(GLCall::GenBuffers) == 1 && gl.count(GLCall::BufferData) == 2,
+              "one buffer, its storage re-specified on every upload");
+        // 4列各3个调用(启用, 格式, 绑定点)加上一次divisor
+        check(firstAttributes == 13 && gl.count(GLCall::VertexArrayAttrib) == 13,
+              "attribute formats are set once per VAO");
+        bool attached = gl.count(GLCall::VertexArrayVertexBuffer) == 2;
+        for (const GLRecord& record : gl.getRecords()) {
+            if (record.call == GLCall::VertexArrayVertexBuffer) {
+                attached = attached && record.args[0] == vao && record.args[1] == InstanceBuffer::INSTANCE_BINDING
+                           && record.args[2] == instances.getBuffer();
+            }
+        }
+        check(attached, "the buffer is attached to the instance binding point of the VAO");
+    }
+
+    // 渲染队列: 实例化的物体设置instanced, 普通物体把它设置回false
+    GLRecorder gl;
+    UniformTable uniforms;
+    uniforms.add("model", 0);
+    uniforms.add("instanced", 5);
+    RenderQueue queue;
+    const RenderQueue::ShaderId shader = queue.addShader(1, uniforms);
+    queue.begin(glm::mat4(1.0f), 0.1f, 100.0f);
+    ObjectConstants instanced;
+    instanced.instanced = true;
+    const DrawElementsIndirectCommand command{3, 4, 0, 0, 0};
+    queue.submit(RenderPass::Opaque, shader, nullptr, 1, queue.addObject(instanced), glm::vec3(0, 0, -1), &command, 1);
+    queue.submit(RenderPass::Opaque, shader, nullptr, 1, queue.addObject(ObjectConstants()), glm::vec3(0, 0, -2), &command, 1);
+    queue.sort();
+    queue.execute();
+    uint32_t instancedUniforms = 0;
+    for (const GLRecord& record : gl.getRecords()) {
+        instancedUniforms += record.call == GLCall::Uniform && record.args[0] == 5 ? 1 : 0;
+    }
+    check(instancedUniforms == 2, "the render queue sets the instanced uniform per object");
+}
+
+void benchmarkModelInstancing() {
+    std::cout << "benchmark:" << std::endl;
+    // 6个网格, 2个材质分组. 节点: 空的根节点, 节点1有网格0~2, 节点2有网格3~5
+    std::vector<CookedMesh> cooked;
+    std::vector<MeshView> views;
+    std::vector<uint32_t> groups;
+    for (int i = 0; i < 6; i++) {
+        cooked.push_back(i % 2 == 0 ? cookGenerated(MeshGenerator::sphere(1.0f, 48, 48), "sphere", 2)
+                                    : cookGenerated(MeshGenerator::torus(1.0f, 0.3f, 48, 24), "torus", 2));
+        groups.push_back((uint32_t)(i % 2));
+    }
+    for (const CookedMesh& mesh : cooked) {
+        views.push_back(mesh.view());
+    }
+    const PackedModel packed = ModelPacker::pack(views, groups);
+    std::vector<std::vector<IndexedDraw>> levelDraws;
+    for (const auto& level : packed.levels) {
+        levelDraws.push_back(packIndices(level.data(), level.size(), (uint32_t)packed.vertices.size()).draws);
+    }
+    const std::vector<ModelNode> nodes{
+        makeNode(-1, glm::mat4(1.0f), 0, 0),
+        makeNode(0, glm::translate(glm::mat4(1.0f), glm::vec3(0, 1, 0)), 0, 3),
+        makeNode(0, glm::translate(glm::mat4(1.0f), glm::vec3(0, -1, 0)), 3, 3),
+    };
+    std::vector<glm::mat4> world;
+    NodeHierarchy::computeWorldMatrices(nodes, world);
+    const std::vector<uint32_t> drawNodes{1, 2};
+    const std::vector<uint32_t> meshSlots{0, 0, 0, 1, 1, 1};
+    const std::vector<uint32_t> meshLods{0, 1, 2, 0, 1, 2};
+
+    // 8圈共264个放置, 与main中相同
+    std::vector<glm::mat4> placements;
+    for (int ring = 0; ring < 8; ring++) {
+        for (int i = 0; i < 12 + 6 * ring; i++) {
+            placements.push_back(glm::translate(glm::mat4(1.0f), glm::vec3((float)ring, 0.0f, (float)i)));
+        }
+    }
+    const auto count = (uint32_t)placements.size();
+
+    // 逐个绘制: 每个放置一份实例(count = 1), 每个放置都要生成并提交所有分组的命令
+    InstanceBuffer separateInstances;
+    std::vector<DrawElementsIndirectCommand> separate;
+    auto start = Clock::now();
+    for (uint32_t p = 0; p < count; p++) {
+        const uint32_t base = NodeHierarchy::appendInstances(world, drawNodes, &placements[p], 1, separateInstances);
+        for (const SubmeshGroup& group : packed.groups) {
+            appendGroupCommands(packed, levelDraws, group, meshSlots, meshLods, 1, base, separate);
+        }
+    }
+    const double separateMs = elapsedMs(start);
+
+    // 实例化: 一次生成, 命令的实例是所有放置
+    InstanceBuffer instances;
+    std::vector<DrawElementsIndirectCommand> instanced;
+    start = Clock::now();
+    const uint32_t base = NodeHierarchy::appendInstances(world, drawNodes, placements.data(), count, instances);
+    for (const SubmeshGroup& group : packed.groups) {
+        appendGroupCommands(packed, levelDraws, group, meshSlots, meshLods, count, base, instanced);
+    }
+    const double instancedMs = elapsedMs(start);
+
+    std::cout << "  " << count << " placements of a " << views.size() << "-mesh, " << drawNodes.size()
+              << "-node model: separate " << separate.size() << " commands (" << separateMs << " ms), instanced "
+              << instanced.size() << " commands (" << instancedMs << " ms), " << instances.size() << " instance matrices"
+              << std::endl;
+    check(instanced.size() * count == separate.size(), "instancing needs one model's worth of commands");
+
+    // 两种方式画出的(索引范围, 模型矩阵)完全相同
+    using Drawn = std::tuple<GLuint, GLuint, GLint, int, int, int>;
+    auto key = [](const DrawElementsIndirectCommand& command, const glm::mat4& matrix) {
+        return Drawn{command.firstIndex, command.count, command.baseVertex, (int)glm::round(matrix[3].x * 100.0f),
+                     (int)glm::round(matrix[3].y * 100.0f), (int)glm::round(matrix[3].z * 100.0f)};
+    };
+    std::multiset<Drawn> separateDrawn, instancedDrawn;
+    for (const DrawElementsIndirectCommand& command : separate) {
+        separateDrawn.insert(key(command, separateInstances.getMatrices()[command.baseInstance]));
+    }
+    bool inBounds = true;
+    for (const DrawElementsIndirectCommand& command : instanced) {
+        inBounds = inBounds && command.baseInstance + command.instanceCount <= instances.size();
+        for (uint32_t i = 0; inBounds && i < command.instanceCount; i++) {
+            instancedDrawn.insert(key(command, instances.getMatrices()[command.baseInstance + i]));
+        }
+    }
+    check(inBounds && separateDrawn == instancedDrawn, "instanced commands draw the same ranges with the same matrices");
+
+    // 大层级: 线性计算与逐级向上相乘
+    std::mt19937 random(7);
+    std::vector<ModelNode> large(100000);
+    for (size_t i = 1; i < large.size(); i++) {
+        large[i].parent = (int32_t)(random() % i);
+        large[i].local = glm::translate(glm::mat4(1.0f), glm::vec3(0.001f, 0.0f, 0.0f));
+    }
+    start = Clock::now();
+    NodeHierarchy::computeWorldMatrices(large, world);
+    const double linearMs = elapsedMs(start);
+    start = Clock::now();
+    bool same = true;
+    for (size_t i = 0; i < large.size(); i++) {
+        same = nearlyEqual(referenceWorld(large, (int32_t)i), world[i]) && same;
+    }
+    const double recursiveMs = elapsedMs(start);
+    std::cout << "  " << large.size() << " nodes: linear pass " << linearMs << " ms, walking up the parents "
+              << recursiveMs << " ms" << std::endl;
+    check(same, "large hierarchy matches the reference");
+}
+
+void runModelInstancingBenchmarks() {
+    beginChecks("model instancing");
+    checkNodeHierarchy();
+    checkInstanceBuffer();
+    benchmarkModelInstancing();
+    endChecks();
+}
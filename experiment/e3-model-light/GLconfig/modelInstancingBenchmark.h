@@ -0,0 +1,24 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MODELINSTANCINGBENCHMARK_H
+#define MODELINSTANCINGBENCHMARK_H
+
+/**
+ * 模型节点层级和实例化绘制的测试, 在窗口中按B键运行. 实例缓冲的上传通过GLRecorder记录, 不需要OpenGL上下文
+ * 命令的生成按Model中的方式在CPU上模拟(节点的子网格相邻, 同一节点的范围合并, 命令的实例是节点的所有放置)
+ */
+
+// 线性计算的世界矩阵与逐级向上相乘的结果相同; 非法的层级被拒绝; 节点表在网格缓存中往返不变
+void checkNodeHierarchy();
+
+// 实例缓冲的布局(每个节点的放置连续), 上传只设置一次属性格式, 渲染队列设置instanced
+void checkInstanceBuffer();
+
+// 几百个放置: 逐个绘制与实例化绘制的命令数, 以及两者画出的(命令, 实例)完全相同
+void benchmarkModelInstancing();
+
+void runModelInstancingBenchmarks();
+
+#endif //MODELINSTANCINGBENCHMARK_H
@@ -0,0 +1,138 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+
+#include "modelPacker.h"
+#include "vertexQuantizer.h"
+
+MeshView PackedModel::view() const {
+    MeshView view;
+    view.vertices = vertices.data();
+    view.vertexCount = (uint32_t)vertices.size();
+    if (quantized.size() == vertices.size()) {
+        view.quantizedVertices = quantized.data();
+        view.quantization = quantization;
+    }
+    if (!levels.empty()) {
+        view.indices = levels[0].data();
+        view.indexCount = (uint32_t)levels[0].size();
+    }
+    for (size_t level = 1; level < levels.size(); level++) {
+        view.lods.push_back({levels[level].data(), (uint32_t)levels[level].size(), 0.0f});
+    }
+    if (!shortIndices.empty()) {
+        view.shortIndices = shortIndices.data();
+        view.shortIndexCount = (uint32_t)shortIndices.size();
+        view.levelDraws = levelDraws;
+    }
+    return view;
+}
+
+PackedModel ModelPacker::pack(const std::vector<MeshView>& views, const std::vector<uint32_t>& groups) {
+    PackedModel packed;
+    std::vector<uint32_t> order(views.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&groups](const uint32_t a, const uint32_t b) {
+        return groups[a] < groups[b];
+    });
+
+    size_t vertexCount = 0, levelCount = 1;
+    for (const MeshView& view : views) {
+        vertexCount += view.vertexCount;
+        levelCount = std::max(levelCount, view.lods.size() + 1);
+    }
+    packed.vertices.reserve(vertexCount);
+    packed.levels.resize(levelCount);
+
+    for (const uint32_t mesh : order) {
+        const MeshView& view = views[mesh];
+        SubmeshRange submesh;
+        submesh.mesh = mesh;
+        submesh.group = groups[mesh];
+        submesh.baseVertex = (uint32_t)packed.vertices.size();
+        submesh.vertexCount = view.vertexCount;
+        packed.vertices.insert(packed.vertices.end(), view.vertices, view.vertices + view.vertexCount);
+
+        for (size_t level = 0; level < levelCount; level++) {
+            // 0级是原始网格(meshlet顺序), 超出网格LOD数的级别使用它最简化的一级
+            const unsigned int* indices = view.indices;
+            uint32_t count = view.indexCount;
+            if (level > 0 && !view.lods.empty()) {
+                const MeshLodView& lod = view.lods[std::min(level, view.lods.size()) - 1];
+                indices = lod.indices;
+                count = lod.indexCount;
+            }
+            std::vector<unsigned int>& target = packed.levels[level];
+            submesh.levels.push_back({(uint32_t)target.size(), count});
+            for (uint32_t i = 0; i < count; i++) {
+                target.push_back(indices[i] + submesh.baseVertex);
+            }
+        }
+
+        if (packed.groups.empty() || packed.groups.back().group != submesh.group) {
+            packed.groups.push_back({submesh.group, (uint32_t)packed.submeshes.size(), 0});
+        }
+        packed.groups.back().submeshCount++;
+        packed.submeshes.push_back(std::move(submesh));
+    }
+
+    // 每一级切分为16位的段. 复制的顶点接在所有子网格之后, 不影响子网格的范围
+    uint32_t splitVertexCount = (uint32_t)packed.vertices.size();
+    PackedIndices split;
+    for (const auto& level : packed.levels) {
+        const size_t firstDraw = split.draws.size();
+        appendShortIndices(level.data(), level.size(), splitVertexCount, split);
+        packed.levelDraws.emplace_back(split.draws.begin() + (std::ptrdiff_t)firstDraw, split.draws.end());
+    }
+    packed.vertices.reserve(splitVertexCount);
+    for (const GLuint vertex : split.duplicatedVertices) {
+        packed.vertices.push_back(packed.vertices[vertex]);
+    }
+    packed.shortIndices = std::move(split.indices);
+    packed.quantization = VertexQuantizer::quantize(packed.vertices.data(), (uint32_t)packed.vertices.size(),
+                                                    packed.quantized);
+    return packed;
+}
+
+PackedModel ModelPacker::pack(const std::vector<CookedMesh>& meshes) {
+    std::vector<MeshView> views;
+    std::vector<std::vector<TextureRef>> meshTextures;
+    for (const CookedMesh& mesh : meshes) {
+        views.push_back(mesh.view());
+        meshTextures.push_back(mesh.textures);
+    }
+    return pack(views, groupByTextures(meshTextures));
+}
+
+std::vector<uint32_t> ModelPacker::groupByTextures(const std::vector<std::vector<TextureRef>>& meshTextures) {
+    std::unordered_map<std::string, uint32_t> groupIndex;
+    std::vector<uint32_t> groups;
+    for (const auto& references : meshTextures) {
+        std::string key;
+        for (const auto& reference : references) {
+            key += reference.type + ':' + reference.path + ';';
+        }
+        groups.push_back(groupIndex.emplace(key, (uint32_t)groupIndex.size()).first->second);
+    }
+    return groups;
+}
+
+void ModelPacker::mergeRanges(std::vector<MeshletRange>& ranges) {
+    if (ranges.empty()) {
+        return;
+    }
+    size_t last = 0;
+    for (size_t i = 1; i < ranges.size(); i++) {
+        if (ranges[last].firstIndex + ranges[last].count == ranges[i].firstIndex) {
+            ranges[last].count += ranges[i].count;
+        } else {
+            ranges[++last] = ranges[i];
+        }
+    }
+    ranges.resize(last + 1);
+}
@@ -0,0 +1,71 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MODELPACKER_H
+#define MODELPACKER_H
+
+#include <cstdint>
+#include <vector>
+
+#include "mesh.h"
+
+// 子网格在打包后的模型中的位置
+struct SubmeshRange {
+    // 打包前的网格下标, 以及所属的材质分组
+    uint32_t mesh{0};
+    uint32_t group{0};
+    // 在模型顶点中的起点和数量
+    uint32_t baseVertex{0};
+    uint32_t vertexCount{0};
+    // 每一级LOD在模型这一级索引中的范围. 网格自己的LOD较少时, 更高的级别重复它最简化的一级
+    std::vector<MeshletRange> levels;
+};
+
+// 同一材质分组的子网格是连续的一段, 它们每一级的索引也是连续的
+struct SubmeshGroup {
+    uint32_t group{0};
+    uint32_t firstSubmesh{0};
+    uint32_t submeshCount{0};
+};
+
+// 打包的结果: 一份顶点, 每一级一份索引(已经加上子网格的baseVertex)
+// 顶点同时量化为QuantizedVertex, 位置相对于整个模型的包围盒(子网格共用绘制命令, 只能共用一组反量化参数)
+// 每一级的索引也切分好了16位的段(见indexFormat.h), 切分时复制的顶点追加在vertices和quantized的末尾(两者仍然一一对应)
+// 网格缓存保存的就是量化后的顶点和切分后的索引, 上传时不再处理
+struct PackedModel {
+    std::vector<Vertex> vertices;
+    std::vector<QuantizedVertex> quantized;
+    VertexQuantization quantization;
+    std::vector<std::vector<unsigned int>> levels;
+    // 所有级的16位索引依次存放, levelDraws[i]是第i级的绘制调用(字节偏移相对于shortIndices的开头)
+    std::vector<GLushort> shortIndices;
+    std::vector<std::vector<IndexedDraw>> levelDraws;
+    std::vector<SubmeshRange> submeshes;
+    std::vector<SubmeshGroup> groups;
+
+    // 用于上传的视图. 没有meshlet(剔除由每个子网格自己的meshlet完成), LOD误差为0
+    MeshView view() const;
+};
+
+/**
+ * 模型打包. 原来模型的每个网格在共享缓冲中各自分配一段顶点和索引, 上传时每个网格一次,
+ * 绘制时每个网格的每个16位分段都是一条间接命令
+ * 现在导入后(工作线程中)把所有网格按材质分组排列, 拼接成一份顶点和每一级一份索引, 模型只分配一次.
+ * 同一分组的子网格在每一级中相邻, 选择了相同LOD的子网格的范围首尾相接, 合并后只是一条命令(见mergeRanges)
+ * 只处理CPU上的数据, 不调用OpenGL
+ */
+class ModelPacker {
+public:
+    // groups[i]是第i个网格的材质分组编号(从0开始连续). 子网格按分组编号排列, 分组内保持原来的顺序
+    // 量化和16位切分也在这里完成, 上传时不再处理顶点和索引
+    static PackedModel pack(const std::vector<MeshView>& views, const std::vector<uint32_t>& groups);
+    // 导入的网格按纹理组合分组(groupByTextures)后打包
+    static PackedModel pack(const std::vector<CookedMesh>& meshes);
+    // 纹理组合(类型和路径)相同的网格是同一个材质分组, 编号按第一次出现的顺序
+    static std::vector<uint32_t> groupByTextures(const std::vector<std::vector<TextureRef>>& meshTextures);
+    // 把首尾相接的范围合并为一个. ranges需要按位置递增
+    static void mergeRanges(std::vector<MeshletRange>& ranges);
+};
+
+#endif //MODELPACKER_H
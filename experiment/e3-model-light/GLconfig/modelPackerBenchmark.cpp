@@ -0,0 +1,210 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "modelPackerBenchmark.h"
+#include "benchmarkCheck.h"
+#include "indexFormat.h"
+#include "indirectDraw.h"
+#include "meshGenerator.h"
+#include "modelPacker.h"
+
+using namespace benchmark;
+
+namespace {
+    // 网格第level级的索引. 超出网格的LOD数时是最简化的一级(与ModelPacker相同)
+    std::vector<unsigned int> levelIndices(const MeshView& view, const size_t level) {
+        if (level == 0 || view.lods.empty()) {
+            return {view.indices, view.indices + view.indexCount};
+        }
+        const MeshLodView& lod = view.lods[std::min(level, view.lods.size()) - 1];
+        return {lod.indices, lod.indices + lod.indexCount};
+    }
+
+    // 只有位置的网格, 位置的x是顶点的编号
+    std::vector<Vertex> makeVertices(const uint32_t count, const float id) {
+        std::vector<Vertex> vertices(count);
+        for (uint32_t i = 0; i < count; i++) {
+            vertices[i].position = glm::vec3(id * 100.0f + (float)i, 0.0f, 0.0f);
+        }
+        return vertices;
+    }
+
+    MeshView makeView(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                      const std::vector<std::vector<unsigned int>>& lods) {
+        MeshView view;
+        view.vertices = vertices.data();
+        view.vertexCount = (uint32_t)vertices.size();
+        view.indices = indices.data();
+        view.indexCount = (uint32_t)indices.size();
+        for (const auto& lod : lods) {
+            view.lods.push_back({lod.data(), (uint32_t)lod.size(), 0.1f});
+        }
+        return view;
+    }
+
+    // 生成的网格转换为模型使用的Vertex后处理, 相当于导入的一个网格
+    CookedMesh cookGenerated(const GeneratedMesh& mesh, const std::string& name, const uint32_t lodLevels) {
+        std::vector<Vertex> vertices(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            vertices[i].position = mesh.vertices[i].position;
+            unpackVertex(mesh.vertices[i], mesh.uvScale, vertices[i].normal, vertices[i].uv);
+        }
+        std::vector<unsigned int> indices(mesh.indices.begin(), mesh.indices.end());
+        return Mesh::cook(std::move(vertices), std::move(indices), lodLevels, name);
+    }
+}
+
+void checkModelPacking() {
+    std::cout << "packing:" << std::endl;
+    // a: 两级LOD, 分组1; b: 没有LOD, 分组0; c: 一级LOD, 分组1
+    const std::vector<Vertex> verticesA = makeVertices(4, 1), verticesB = makeVertices(3, 2), verticesC = makeVertices(5, 3);
+    const std::vector<unsigned int> indicesA{0, 1, 2, 0, 2, 3}, indicesB{0, 1, 2}, indicesC{0, 1, 2, 2, 3, 4};
+    const std::vector<std::vector<unsigned int>> lodsA{{0, 1, 3}, {0, 2, 3}}, lodsC{{0, 2, 4}};
+    const std::vector<MeshView> views{
+        makeView(verticesA, indicesA, lodsA), makeView(verticesB, indicesB, {}), makeView(verticesC, indicesC, lodsC)
+    };
+    const PackedModel packed = ModelPacker::pack(views, {1, 0, 1});
+
+    const auto& submeshes = packed.submeshes;
+    check(submeshes.size() == 3 && submeshes[0].mesh == 1 && submeshes[1].mesh == 0 && submeshes[2].mesh == 2,
+          "submeshes are ordered by group, keeping the original order inside a group");
+    check(packed.vertices.size() == 12 && submeshes[1].baseVertex == 3 && submeshes[2].baseVertex == 7
+          && packed.vertices[3].position.x == verticesA[0].position.x, "vertices are concatenated in submesh order");
+    check(packed.groups.size() == 2 && packed.groups[0].firstSubmesh == 0 && packed.groups[0].submeshCount == 1
+          && packed.groups[1].firstSubmesh == 1 && packed.groups[1].submeshCount == 2, "one contiguous run per group");
+
+    bool rebased = packed.levels.size() == 3;
+    for (size_t level = 0; rebased && level < packed.levels.size(); level++) {
+        for (const SubmeshRange& submesh : submeshes) {
+            const std::vector<unsigned int> expected = levelIndices(views[submesh.mesh], level);
+            const MeshletRange& range = submesh.levels[level];
+            rebased = rebased && range.count == expected.size();
+            for (uint32_t i = 0; rebased && i < range.count; i++) {
+                rebased = packed.levels[level][range.firstIndex + i] == expected[i] + submesh.baseVertex;
+            }
+        }
+    }
+    check(rebased, "every level holds each submesh's indices offset by its base vertex");
+    check(submeshes[2].levels[2].count == 3 && packed.levels[2][submeshes[2].levels[2].firstIndex] == 7
+          && submeshes[0].levels[1].count == 3, "missing LOD levels repeat the coarsest level");
+
+    const MeshView uploaded = packed.view();
+    check(uploaded.vertexCount == 12 && uploaded.indexCount == 15 && uploaded.lods.size() == 2,
+          "upload view covers the vertices and every level");
+
+    // 每一级已经切分为16位的段, 通过绘制调用还原后与32位的索引相同. 上传和网格缓存直接使用它们
+    bool split = packed.levelDraws.size() == packed.levels.size() && uploaded.shortIndices == packed.shortIndices.data()
+                 && uploaded.levelDraws.size() == packed.levels.size();
+    for (size_t level = 0; split && level < packed.levels.size(); level++) {
+        std::vector<unsigned int> restored;
+        for (const IndexedDraw& draw : packed.levelDraws[level]) {
+            const size_t first = draw.byteOffset / sizeof(GLushort);
+            for (uint32_t i = 0; i < draw.count; i++) {
+                restored.push_back(packed.shortIndices[first + i] + (unsigned int)draw.baseVertex);
+            }
+        }
+        split = restored == packed.levels[level];
+    }
+    check(split, "every level is split into 16-bit draws that restore the packed indices");
+    const std::vector<uint32_t> textureGroups = ModelPacker::groupByTextures(
+        {{{"texture_diffuse", "a.png"}}, {}, {{"texture_diffuse", "a.png"}}, {{"texture_diffuse", "b.png"}}});
+    check(textureGroups == std::vector<uint32_t>{0, 1, 0, 2}, "meshes with the same textures share a group");
+
+    bool adjacent = true;
+    for (size_t level = 0; level < packed.levels.size(); level++) {
+        adjacent = adjacent && submeshes[1].levels[level].firstIndex + submeshes[1].levels[level].count
+                               == submeshes[2].levels[level].firstIndex;
+    }
+    check(adjacent, "submeshes of a group are adjacent on every level");
+
+    std::vector<MeshletRange> ranges{{0, 3}, {3, 6}, {9, 3}, {15, 3}, {18, 0}, {30, 6}};
+    ModelPacker::mergeRanges(ranges);
+    check(ranges.size() == 3 && ranges[0].count == 12 && ranges[1].firstIndex == 15 && ranges[1].count == 3
+          && ranges[2].firstIndex == 30, "touching ranges merge, gaps are kept");
+}
+
+void benchmarkModelPacking() {
+    std::cout << "benchmark:" << std::endl;
+    // 24个网格, 3个材质, 共约8.6万个顶点(超过16位索引的范围)
+    std::vector<CookedMesh> cooked;
+    std::vector<MeshView> views;
+    std::vector<uint32_t> groups;
+    for (int i = 0; i < 24; i++) {
+        switch (i % 3) {
+            case 0: cooked.push_back(cookGenerated(MeshGenerator::sphere(1.0f, 96, 96), "sphere", 2)); break;
+            case 1: cooked.push_back(cookGenerated(MeshGenerator::torus(1.0f, 0.3f, 48, 24), "torus", 2)); break;
+            default: cooked.push_back(cookGenerated(MeshGenerator::box(1.0f, 1.0f, 1.0f, 4), "box", 0)); break;
+        }
+        groups.push_back((uint32_t)std::min(i % 4, 2));
+    }
+    for (const CookedMesh& mesh : cooked) {
+        views.push_back(mesh.view());
+    }
+
+    const auto start = Clock::now();
+    const PackedModel packed = ModelPacker::pack(views, groups);
+    const double packMs = elapsedMs(start);
+
+    bool sameTriangles = true;
+    for (const size_t level : {(size_t)0, (size_t)2}) {
+        // 原来: 每个网格单独分配, 每个网格的每个16位分段一条命令
+        size_t separateCommands = 0;
+        for (const MeshView& view : views) {
+            const std::vector<unsigned int> indices = levelIndices(view, level);
+            const PackedIndices packedIndices = packIndices(indices.data(), indices.size(), view.vertexCount);
+            std::vector<DrawElementsIndirectCommand> commands;
+            appendIndirectCommands(packedIndices.draws, sizeof(GLushort), 0, 0, commands);
+            separateCommands += commands.size();
+        }
+
+        // 打包后: 每个分组选择同一级的子网格范围合并, 与整个模型这一级的16位分段求交
+        const std::vector<unsigned int>& levelIndices16 = packed.levels[level];
+        const PackedIndices packedLevel = packIndices(levelIndices16.data(), levelIndices16.size(), (uint32_t)packed.vertices.size());
+        size_t packedCommands = 0;
+        for (const SubmeshGroup& group : packed.groups) {
+            std::vector<MeshletRange> ranges;
+            std::vector<unsigned int> expected;
+            for (uint32_t i = group.firstSubmesh; i < group.firstSubmesh + group.submeshCount; i++) {
+                const SubmeshRange& submesh = packed.submeshes[i];
+                ranges.push_back(submesh.levels[level]);
+                for (const unsigned int index : levelIndices(views[submesh.mesh], level)) {
+                    expected.push_back(index + submesh.baseVertex);
+                }
+            }
+            ModelPacker::mergeRanges(ranges);
+            std::vector<DrawElementsIndirectCommand> commands;
+            appendIndirectCommands(packedLevel.draws, sizeof(GLushort), 0, 0, ranges, commands);
+            packedCommands += commands.size();
+
+            // 按命令展开的索引与分组中子网格原来的索引(加上baseVertex)逐个相同
+            std::vector<unsigned int> drawn;
+            for (const DrawElementsIndirectCommand& command : commands) {
+                for (uint32_t k = 0; k < command.count; k++) {
+                    drawn.push_back(packedLevel.indices[command.firstIndex + k] + command.baseVertex);
+                }
+            }
+            sameTriangles = sameTriangles && drawn == expected;
+        }
+        std::cout << "  level " << level << ": " << views.size() << " meshes in " << packed.groups.size()
+                  << " groups, separate allocations " << separateCommands << " commands, packed " << packedCommands
+                  << " commands (" << packedLevel.draws.size() << " index segments)" << std::endl;
+        check(packedCommands < separateCommands && packedCommands <= packed.groups.size() + packedLevel.draws.size(),
+              "packed model needs about one command per material");
+    }
+    std::cout << "  packed " << packed.vertices.size() << " vertices in " << packMs << " ms" << std::endl;
+    check(sameTriangles, "packed commands draw exactly the submeshes' triangles");
+}
+
+void runModelPackerBenchmarks() {
+    beginChecks("model packer");
+    checkModelPacking();
+    benchmarkModelPacking();
+    endChecks();
+}
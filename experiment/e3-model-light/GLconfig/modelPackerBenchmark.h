@@ -0,0 +1,21 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef MODELPACKERBENCHMARK_H
+#define MODELPACKERBENCHMARK_H
+
+/**
+ * 模型打包的测试, 在窗口中按B键运行. 只处理CPU上的数据, 不需要OpenGL上下文
+ * 16位索引的切分用packIndices计算(与GeometryArena上传时是同一个函数, 按三角形顺序切分)
+ */
+
+// 子网格按分组排列, 索引加上baseVertex, 缺少的LOD级别使用最简化的一级, 每一级切分为16位的段, 相邻范围合并
+void checkModelPacking();
+
+// 几十个子网格分成几个材质: 每个网格单独分配时的命令数与打包后每个材质的命令数, 以及绘制的三角形是否相同
+void benchmarkModelPacking();
+
+void runModelPackerBenchmarks();
+
+#endif //MODELPACKERBENCHMARK_H
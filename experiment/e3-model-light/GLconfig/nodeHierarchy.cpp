@@ -0,0 +1,46 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include "nodeHierarchy.h"
+#include "instanceBuffer.h"
+
+void NodeHierarchy::computeWorldMatrices(const std::vector<ModelNode>& nodes, std::vector<glm::mat4>& world) {
+    world.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const ModelNode& node = nodes[i];
+        world[i] = node.parent < 0 ? node.local : world[node.parent] * node.local;
+    }
+}
+
+bool NodeHierarchy::isValid(const std::vector<ModelNode>& nodes, const uint32_t meshCount) {
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const ModelNode& node = nodes[i];
+        if (node.parent >= (int64_t)i || node.parent < -1) {
+            return false;
+        }
+        if (node.firstMesh > meshCount || node.meshCount > meshCount - node.firstMesh) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<ModelNode> NodeHierarchy::makeRoot(const uint32_t meshCount) {
+    ModelNode root;
+    root.meshCount = meshCount;
+    return {root};
+}
+
+uint32_t NodeHierarchy::appendInstances(const std::vector<glm::mat4>& world, const std::vector<uint32_t>& drawNodes,
+                                        const glm::mat4* placements, const uint32_t count, InstanceBuffer& instances) {
+    const uint32_t base = instances.size();
+    instances.reserve(base + (uint32_t)drawNodes.size() * count);
+    for (const uint32_t node : drawNodes) {
+        const glm::mat4& nodeMatrix = world[node];
+        for (uint32_t p = 0; p < count; p++) {
+            instances.append(placements[p] * nodeMatrix);
+        }
+    }
+    return base;
+}
@@ -0,0 +1,51 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef NODEHIERARCHY_H
+#define NODEHIERARCHY_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+
+class InstanceBuffer;
+
+// 模型文件中的一个节点. 节点按深度优先的先序排列, 父节点总在子节点之前
+struct ModelNode {
+    // 父节点的下标, 根节点为-1
+    int32_t parent{-1};
+    // 相对父节点的变换
+    glm::mat4 local{1.0f};
+    // 节点引用的网格: 导入的网格按节点的遍历顺序排列, 一个节点的网格是连续的一段
+    uint32_t firstMesh{0};
+    uint32_t meshCount{0};
+};
+
+/**
+ * 模型的节点层级. 原来导入时只收集节点引用的网格, 忽略了节点的变换, 多节点的模型全部叠在原点
+ * 现在保留为扁平的数组(父节点下标, 局部矩阵, 网格范围), 世界矩阵按数组顺序一次线性计算:
+ * world[i] = world[parent] * local[i], 父节点在前, 计算到i时父节点已经算好, 不需要递归
+ * 模型的节点是静态的, 加载完成后只计算一次
+ */
+class NodeHierarchy {
+public:
+    // 节点相对模型原点的矩阵. nodes需要是先序排列的(见isValid)
+    static void computeWorldMatrices(const std::vector<ModelNode>& nodes, std::vector<glm::mat4>& world);
+    // 父节点都在自己之前, 网格范围不超过meshCount
+    static bool isValid(const std::vector<ModelNode>& nodes, uint32_t meshCount);
+    // 没有节点信息时(例如只有网格的缓存)使用: 一个单位矩阵的根节点引用所有网格
+    static std::vector<ModelNode> makeRoot(uint32_t meshCount);
+
+    /**
+     * 把每个放置(placements)下每个有网格的节点的矩阵placement * world[node]追加到instances中
+     * 同一节点的放置是连续的一段: 第slot个有网格的节点的第p个放置在base + slot * count + p,
+     * 节点的网格只需一条命令(instanceCount = count, baseInstance = base + slot * count)就能画出所有放置
+     * drawNodes是有网格的节点的下标, 返回base
+     */
+    static uint32_t appendInstances(const std::vector<glm::mat4>& world, const std::vector<uint32_t>& drawNodes,
+                                    const glm::mat4* placements, uint32_t count, InstanceBuffer& instances);
+};
+
+#endif //NODEHIERARCHY_H
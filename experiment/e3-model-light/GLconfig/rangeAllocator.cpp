@@ -0,0 +1,164 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+
+#include "rangeAllocator.h"
+
+RangeAllocator::RangeAllocator(const uint64_t capacity) : capacity(capacity) {
+    if (capacity > 0) {
+        insertFreeBlock(0, capacity);
+    }
+}
+
+void RangeAllocator::insertFreeBlock(const uint64_t offset, const uint64_t size) {
+    freeBlocks.emplace(offset, size);
+    freeBySize.emplace(size, offset);
+}
+
+void RangeAllocator::eraseFreeBlock(const std::map<uint64_t, uint64_t>::iterator block) {
+    auto [first, last] = freeBySize.equal_range(block->second);
+    for (auto it = first; it != last; ++it) {
+        if (it->second == block->first) {
+            freeBySize.erase(it);
+            break;
+        }
+    }
+    freeBlocks.erase(block);
+}
+
+RangeAllocator::Handle RangeAllocator::allocate(const uint64_t size) {
+    if (size == 0) {
+        return INVALID_HANDLE;
+    }
+    // 最佳适配: 不小于size的最小空闲块. 大小相同时multimap按插入顺序返回, 结果是确定的
+    const auto fit = freeBySize.lower_bound(size);
+    if (fit == freeBySize.end()) {
+        return INVALID_HANDLE;
+    }
+    const uint64_t offset = fit->second;
+    const uint64_t blockSize = fit->first;
+    eraseFreeBlock(freeBlocks.find(offset));
+    if (blockSize > size) {
+        insertFreeBlock(offset + size, blockSize - size);
+    }
+    used += size;
+
+    Handle handle;
+    if (!freeHandles.empty()) {
+        handle = freeHandles.back();
+        freeHandles.pop_back();
+        allocations[handle] = {offset, size};
+    } else {
+        handle = (Handle)allocations.size();
+        allocations.push_back({offset, size});
+    }
+    return handle;
+}
+
+void RangeAllocator::free(const Handle handle) {
+    if (handle == INVALID_HANDLE) {
+        return;
+    }
+    uint64_t offset = allocations[handle].offset;
+    uint64_t size = allocations[handle].size;
+    used -= size;
+    allocations[handle] = {};
+    freeHandles.push_back(handle);
+
+    // 与后一个空闲块合并
+    auto next = freeBlocks.lower_bound(offset);
+    if (next != freeBlocks.end() && next->first == offset + size) {
+        size += next->second;
+        eraseFreeBlock(next);
+    }
+    // 与前一个空闲块合并
+    auto after = freeBlocks.lower_bound(offset);
+    if (after != freeBlocks.begin()) {
+        const auto previous = std::prev(after);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            eraseFreeBlock(previous);
+        }
+    }
+    insertFreeBlock(offset, size);
+}
+
+void RangeAllocator::grow(const uint64_t newCapacity) {
+    if (newCapacity <= capacity) {
+        return;
+    }
+    uint64_t offset = capacity;
+    uint64_t size = newCapacity - capacity;
+    if (!freeBlocks.empty()) {
+        const auto last = std::prev(freeBlocks.end());
+        if (last->first + last->second == capacity) {
+            offset = last->first;
+            size += last->second;
+            eraseFreeBlock(last);
+        }
+    }
+    insertFreeBlock(offset, size);
+    capacity = newCapacity;
+}
+
+std::vector<RangeAllocator::Move> RangeAllocator::compact() {
+    std::vector<Move> moves;
+    // 存活的句柄按偏移排序, 依次向前移动. 后面的区间移动时, 前面的区间已经不再占用它的目标位置
+    std::vector<Handle> live;
+    live.reserve(allocations.size());
+    std::vector<bool> released(allocations.size(), false);
+    for (const Handle handle : freeHandles) {
+        released[handle] = true;
+    }
+    for (Handle handle = 0; handle < allocations.size(); handle++) {
+        if (!released[handle]) {
+            live.push_back(handle);
+        }
+    }
+    std::sort(live.begin(), live.end(), [this](const Handle a, const Handle b) {
+        return allocations[a].offset < allocations[b].offset;
+    });
+
+    uint64_t cursor = 0;
+    for (const Handle handle : live) {
+        Allocation& allocation = allocations[handle];
+        if (allocation.offset != cursor) {
+            // 紧接着的区间合并为一次移动
+            if (!moves.empty() && moves.back().from + moves.back().size == allocation.offset &&
+                moves.back().to + moves.back().size == cursor) {
+                moves.back().size += allocation.size;
+            } else {
+                moves.push_back({allocation.offset, cursor, allocation.size});
+            }
+            allocation.offset = cursor;
+        }
+        cursor += allocation.size;
+    }
+
+    freeBlocks.clear();
+    freeBySize.clear();
+    if (cursor < capacity) {
+        insertFreeBlock(cursor, capacity - cursor);
+    }
+    return moves;
+}
+
+uint64_t RangeAllocator::getLargestFreeBlock() const {
+    return freeBySize.empty() ? 0 : std::prev(freeBySize.end())->first;
+}
+
+float RangeAllocator::getFragmentation() const {
+    const uint64_t freeSpace = getFree();
+    return freeSpace == 0 ? 0.0f : 1.0f - (float)getLargestFreeBlock() / (float)freeSpace;
+}
+
+uint64_t RangeAllocator::getUsedExtent() const {
+    if (freeBlocks.empty()) {
+        return capacity;
+    }
+    const auto last = std::prev(freeBlocks.end());
+    return last->first + last->second == capacity ? last->first : capacity;
+}
@@ -0,0 +1,79 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef RANGEALLOCATOR_H
+#define RANGEALLOCATOR_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/**
+ * 一维区间的子分配器, 不涉及OpenGL. GeometryArena用它在共享的VBO/EBO中为每个网格分配一段连续的顶点/索引
+ * 单位由调用者决定(顶点个数, 索引个数), 分配器只管理[0, capacity)中的偏移
+ *
+ *  - 空闲块按偏移保存在有序表中, 释放时与前后相邻的空闲块合并
+ *  - 分配使用最佳适配(能放下的最小空闲块), 另有一份按大小排序的表, 查找是O(log n)
+ *  - 句柄在整个生命周期内不变. compact()把所有存活的区间依次移到最前面, 只改变句柄对应的偏移,
+ *    返回需要执行的数据移动, 调用者据此复制GPU中的数据
+ */
+class RangeAllocator {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+    // 一次数据移动: 把[from, from + size)复制到[to, to + size). 按返回的顺序执行时to总是不大于from
+    struct Move {
+        uint64_t from{0};
+        uint64_t to{0};
+        uint64_t size{0};
+    };
+
+    explicit RangeAllocator(uint64_t capacity = 0);
+
+    // 空间不足时返回INVALID_HANDLE, 由调用者决定整理(compact)还是扩容(grow). size为0也返回INVALID_HANDLE
+    Handle allocate(uint64_t size);
+    void free(Handle handle);
+
+    uint64_t getOffset(const Handle handle) const { return allocations[handle].offset; }
+    uint64_t getSize(const Handle handle) const { return allocations[handle].size; }
+
+    // 扩容, 新增的空间接在末尾(与末尾的空闲块合并)
+    void grow(uint64_t newCapacity);
+    // 整理碎片: 存活的区间按偏移顺序紧密排列, 之后只剩末尾一个空闲块
+    std::vector<Move> compact();
+
+    // ===统计===
+    uint64_t getCapacity() const { return capacity; }
+    uint64_t getUsed() const { return used; }
+    uint64_t getFree() const { return capacity - used; }
+    uint32_t getAllocationCount() const { return (uint32_t)(allocations.size() - freeHandles.size()); }
+    uint32_t getFreeBlockCount() const { return (uint32_t)freeBlocks.size(); }
+    uint64_t getLargestFreeBlock() const;
+    // 碎片率: 1 - 最大空闲块 / 全部空闲空间. 0表示空闲空间是连续的
+    float getFragmentation() const;
+    // 所有存活区间的末尾, 扩容或整理时只需要复制这之前的数据
+    uint64_t getUsedExtent() const;
+
+private:
+    struct Allocation {
+        uint64_t offset{0};
+        uint64_t size{0};
+    };
+
+    uint64_t capacity{0};
+    uint64_t used{0};
+    // 偏移 -> 大小
+    std::map<uint64_t, uint64_t> freeBlocks;
+    // 大小 -> 偏移, 用于最佳适配
+    std::multimap<uint64_t, uint64_t> freeBySize;
+    std::vector<Allocation> allocations;
+    // 已释放的句柄, 分配时优先复用
+    std::vector<Handle> freeHandles;
+
+    void insertFreeBlock(uint64_t offset, uint64_t size);
+    void eraseFreeBlock(std::map<uint64_t, uint64_t>::iterator block);
+};
+
+#endif //RANGEALLOCATOR_H
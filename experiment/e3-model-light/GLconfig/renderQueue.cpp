@@ -0,0 +1,265 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <iostream>
+
+#include "geometryArena.h"
+#include "renderQueue.h"
+
+RenderQueue::~RenderQueue() {
+    if (indirectBuffer != 0) {
+        glDeleteBuffers(1, &indirectBuffer);
+    }
+}
+
+RenderQueue::ShaderId RenderQueue::addShader(const GLuint program, const UniformTable& uniforms) {
+    for (size_t i = 0; i < shaders.size(); i++) {
+        if (shaders[i].program == program) {
+            return (ShaderId)i;
+        }
+    }
+    if (shaders.size() >= (1u << SHADER_BITS)) {
+        std::cout << "WARNING::RENDER_QUEUE::too many shaders, sharing the last id" << std::endl;
+        return (ShaderId)(shaders.size() - 1);
+    }
+    shaders.push_back({
+        program, uniforms.find("model"), uniforms.find("normalMatrix"), uniforms.find("objectColor"),
+        uniforms.find("uvScale"), uniforms.find("octNormal"), uniforms.find("instanced"),
+        uniforms.find("positionOffset"), uniforms.find("positionScale")
+    });
+    return (ShaderId)(shaders.size() - 1);
+}
+
+uint16_t RenderQueue::getVaoIndex(const GLuint vao) {
+    for (size_t i = 0; i < vaos.size(); i++) {
+        if (vaos[i] == vao) {
+            return (uint16_t)i;
+        }
+    }
+    if (vaos.size() >= (1u << VAO_BITS)) {
+        // 只影响排序的效果, 执行时仍然使用真正的VAO
+        std::cout << "WARNING::RENDER_QUEUE::too many VAOs" << std::endl;
+    }
+    vaos.push_back(vao);
+    return (uint16_t)(vaos.size() - 1);
+}
+
+void RenderQueue::begin(const glm::mat4& viewMatrix, const float nearPlane, const float farPlane) {
+    this->viewMatrix = viewMatrix;
+    this->nearPlane = nearPlane;
+    this->farPlane = farPlane;
+    packets.clear();
+    depths.clear();
+    passes.clear();
+    objects.clear();
+    commands.clear();
+}
+
+uint32_t RenderQueue::addObject(const ObjectConstants& object) {
+    objects.push_back(object);
+    return (uint32_t)(objects.size() - 1);
+}
+
+void RenderQueue::submit(const RenderPass pass, const ShaderId shader, const Material* material, const GLuint vao,
+                         const uint32_t object, const glm::vec3& center, const DrawElementsIndirectCommand* commands,
+                         const size_t commandCount) {
+    if (commandCount == 0) {
+        return;
+    }
+    DrawPacket packet{};
+    packet.material = material;
+    packet.firstCommand = (uint32_t)this->commands.size();
+    packet.commandCount = (uint32_t)commandCount;
+    packet.object = object;
+    packet.shader = shader;
+    packet.vao = getVaoIndex(vao);
+    packets.push_back(packet);
+    this->commands.insert(this->commands.end(), commands, commands + commandCount);
+
+    // 相机看向-Z, 视图空间中的距离是-z
+    const float distance = -(viewMatrix * glm::vec4(center, 1.0f)).z;
+    const float range = std::max(farPlane - nearPlane, 1e-6f);
+    const float normalized = std::clamp((distance - nearPlane) / range, 0.0f, 1.0f);
+    constexpr uint32_t maxDepth = (1u << DEPTH_BITS) - 1;
+    uint32_t depth = (uint32_t)(normalized * (float)maxDepth);
+    // 透明物体由远到近
+    if (pass == RenderPass::Transparent) {
+        depth = maxDepth - depth;
+    }
+    depths.push_back(depth);
+    passes.push_back(pass);
+}
+
+void RenderQueue::sort() {
+    const size_t count = packets.size();
+    // 这一帧用到的材质按Material::getSortKey排名, 纹理相同的材质编号相邻. 没有材质的编号为0
+    frameMaterials.clear();
+    for (const DrawPacket& packet : packets) {
+        if (packet.material) {
+            frameMaterials.push_back(packet.material);
+        }
+    }
+    const auto bySortKey = [](const Material* a, const Material* b) { return a->getSortKey() < b->getSortKey(); };
+    std::sort(frameMaterials.begin(), frameMaterials.end(), bySortKey);
+    frameMaterials.erase(std::unique(frameMaterials.begin(), frameMaterials.end()), frameMaterials.end());
+
+    keys.resize(count);
+    order.resize(count);
+    constexpr uint64_t materialMask = (1u << MATERIAL_BITS) - 1;
+    constexpr uint64_t vaoMask = (1u << VAO_BITS) - 1;
+    for (size_t i = 0; i < count; i++) {
+        DrawPacket& packet = packets[i];
+        uint64_t rank = 0;
+        if (packet.material) {
+            rank = std::lower_bound(frameMaterials.begin(), frameMaterials.end(), packet.material, bySortKey)
+                   - frameMaterials.begin() + 1;
+        }
+        packet.key = (uint64_t)passes[i] << (SHADER_BITS + MATERIAL_BITS + VAO_BITS + DEPTH_BITS)
+                     | (uint64_t)packet.shader << (MATERIAL_BITS + VAO_BITS + DEPTH_BITS)
+                     | std::min(rank, materialMask) << (VAO_BITS + DEPTH_BITS)
+                     | std::min<uint64_t>(packet.vao, vaoMask) << DEPTH_BITS
+                     | depths[i];
+        keys[i] = packet.key;
+        order[i] = (uint32_t)i;
+    }
+    if (!sortEnabled) {
+        return;
+    }
+
+    radixSort(keys, order, tempKeys, tempOrder);
+    sortedPackets.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        sortedPackets[i] = packets[order[i]];
+    }
+    packets.swap(sortedPackets);
+}
+
+void RenderQueue::radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& order,
+                            std::vector<uint64_t>& tempKeys, std::vector<uint32_t>& tempOrder) {
+    const size_t count = keys.size();
+    if (count < 2) {
+        return;
+    }
+    tempKeys.resize(count);
+    tempOrder.resize(count);
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        size_t offsets[256]{};
+        for (const uint64_t key : keys) {
+            offsets[key >> shift & 0xFF]++;
+        }
+        // 所有键在这8位上都相同(例如只有一个通道, 很少的着色器), 这一趟不改变顺序
+        if (offsets[keys[0] >> shift & 0xFF] == count) {
+            continue;
+        }
+        size_t sum = 0;
+        for (size_t& offset : offsets) {
+            const size_t bucket = offset;
+            offset = sum;
+            sum += bucket;
+        }
+        for (size_t i = 0; i < count; i++) {
+            const size_t target = offsets[keys[i] >> shift & 0xFF]++;
+            tempKeys[target] = keys[i];
+            tempOrder[target] = order[i];
+        }
+        keys.swap(tempKeys);
+        order.swap(tempOrder);
+    }
+}
+
+void RenderQueue::uploadObject(const ShaderEntry& shader, const ObjectConstants& object) const {
+    if (shader.model >= 0)
+        Shader::setMat4(shader.model, object.model);
+    if (shader.normalMatrix >= 0)
+        Shader::setMat3(shader.normalMatrix, object.normalMatrix);
+    if (shader.objectColor >= 0)
+        Shader::setVec3(shader.objectColor, object.color);
+    if (shader.uvScale >= 0)
+        Shader::setFloat(shader.uvScale, object.uvScale);
+    if (shader.octNormal >= 0)
+        Shader::setBool(shader.octNormal, object.octNormal);
+    if (shader.instanced >= 0)
+        Shader::setBool(shader.instanced, object.instanced);
+    if (shader.positionOffset >= 0)
+        Shader::setVec3(shader.positionOffset, object.positionOffset);
+    if (shader.positionScale >= 0)
+        Shader::setVec3(shader.positionScale, object.positionScale);
+}
+
+void RenderQueue::execute() {
+    stats = RenderQueueStats();
+    stats.packets = (uint32_t)packets.size();
+    if (packets.empty()) {
+        return;
+    }
+    const MaterialStats materialsBefore = Material::getStats();
+
+    // 所有命令一次上传, 每个包从自己的偏移读取. 每帧重新分配存储(orphan)
+    if (indirectBuffer == 0) {
+        glGenBuffers(1, &indirectBuffer);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, (GLsizeiptr)(commands.size() * sizeof(DrawElementsIndirectCommand)),
+                 commands.data(), GL_STREAM_DRAW);
+
+    // 执行之前的状态未知, 第一个包的状态都要设置
+    uint32_t currentShader = UINT32_MAX;
+    uint32_t currentVao = UINT32_MAX;
+    uint32_t currentObject = UINT32_MAX;
+    const Material* currentMaterial = nullptr;
+    for (const DrawPacket& packet : packets) {
+        const ShaderEntry& shader = shaders[packet.shader];
+        if (packet.shader != currentShader) {
+            glUseProgram(shader.program);
+            currentShader = packet.shader;
+            // uniform属于程序, 换了程序后物体的uniform要重新设置
+            currentObject = UINT32_MAX;
+            stats.programBinds++;
+        } else {
+            stats.elidedProgramBinds++;
+        }
+        if (packet.vao != currentVao) {
+            glBindVertexArray(vaos[packet.vao]);
+            currentVao = packet.vao;
+            stats.vaoBinds++;
+        } else {
+            stats.elidedVaoBinds++;
+        }
+        if (packet.material) {
+            if (packet.material != currentMaterial) {
+                packet.material->bind();
+                currentMaterial = packet.material;
+                stats.materialBinds++;
+            } else {
+                stats.elidedMaterialBinds++;
+            }
+        }
+        if (packet.object != currentObject) {
+            uploadObject(shader, objects[packet.object]);
+            currentObject = packet.object;
+            stats.objectUpdates++;
+        } else {
+            stats.elidedObjectUpdates++;
+        }
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GeometryArena::INDEX_TYPE,
+                                    (const void*)(packet.firstCommand * sizeof(DrawElementsIndirectCommand)),
+                                    (GLsizei)packet.commandCount, 0);
+        stats.draws++;
+    }
+    // GeometryArena::bind之后仍然可以跳过已经绑定的VAO
+    GeometryArena::setBoundVAO(vaos[currentVao]);
+
+    const MaterialStats& materialsAfter = Material::getStats();
+    stats.textureBinds = (uint32_t)(materialsAfter.textureBinds - materialsBefore.textureBinds);
+    stats.elidedTextureBinds = (uint32_t)(materialsAfter.elidedTextureBinds - materialsBefore.elidedTextureBinds);
+}
+
+void RenderQueue::printStats() const {
+    std::cout << "render queue: " << stats.packets << " packets, " << stats.draws << " draws, program "
+              << stats.programBinds << "/" << stats.elidedProgramBinds << ", VAO " << stats.vaoBinds << "/"
+              << stats.elidedVaoBinds << ", material " << stats.materialBinds << "/" << stats.elidedMaterialBinds
+              << ", texture " << stats.textureBinds << "/" << stats.elidedTextureBinds << ", object "
+              << stats.objectUpdates << "/" << stats.elidedObjectUpdates << " (issued/elided)" << std::endl;
+}
@@ -0,0 +1,164 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+#include "indirectDraw.h"
+#include "material.h"
+#include "shader.h"
+
+// 渲染通道, 排序键的最高位. 不透明的先画(由近到远), 透明的后画(由远到近)
+enum class RenderPass : uint8_t {
+    Opaque = 0,
+    Transparent = 1
+};
+
+// 每个物体的uniform. 同一个物体的多个绘制包共用一份
+struct ObjectConstants {
+    glm::mat4 model{1.0f};
+    glm::mat3 normalMatrix{1.0f};
+    glm::vec3 color{1.0f};
+    float uvScale{1.0f};
+    // 法线是否八面体编码(几何体的紧凑顶点格式)
+    bool octNormal{false};
+    // 模型矩阵来自实例缓冲(见instanceBuffer.h), model和normalMatrix不使用
+    bool instanced{false};
+    // 量化位置的反量化参数(模型网格, 见vertexQuantizer.h). float位置为单位变换
+    glm::vec3 positionOffset{0.0f};
+    glm::vec3 positionScale{1.0f};
+};
+
+/**
+ * 一次绘制: 排序键加上执行时需要的状态. 状态都用小整数或指针表示, 排序时只移动这32字节
+ * 排序键从高到低: 通道(2位) | 着色器(10位) | 材质(20位) | VAO(8位) | 深度(24位)
+ */
+struct DrawPacket {
+    uint64_t key;
+    const Material* material;
+    // 队列中间接绘制命令的范围
+    uint32_t firstCommand;
+    uint32_t commandCount;
+    uint32_t object;
+    uint16_t shader;
+    uint16_t vao;
+};
+
+// 每帧的统计. issued是实际发出的调用, elided是因为状态相同而跳过的
+struct RenderQueueStats {
+    uint32_t packets{0};
+    uint32_t draws{0};
+    uint32_t programBinds{0};
+    uint32_t elidedProgramBinds{0};
+    uint32_t vaoBinds{0};
+    uint32_t elidedVaoBinds{0};
+    uint32_t materialBinds{0};
+    uint32_t elidedMaterialBinds{0};
+    uint32_t textureBinds{0};
+    uint32_t elidedTextureBinds{0};
+    uint32_t objectUpdates{0};
+    uint32_t elidedObjectUpdates{0};
+};
+
+/**
+ * 渲染队列. 原来render中按场景顺序绑定着色器, VAO和纹理并立即绘制, 状态在物体之间来回切换
+ *  - 每帧begin之后, 物体通过addObject和submit提交绘制包, 不调用OpenGL
+ *  - sort按排序键做基数排序(每次8位, 所有键在这8位上都相同时跳过这一趟). 同一着色器, 材质, VAO的包相邻,
+ *    组内不透明物体由近到远(先画近处的, 远处被遮挡的片元不再着色), 透明物体由远到近
+ *  - execute一次上传所有间接绘制命令, 按顺序执行, 与上一个包相同的程序, VAO, 材质和物体uniform不再设置
+ * 材质在排序键中的编号在sort时按Material::getSortKey排名得到, 所以同一张纹理的材质也相邻
+ * 着色器需要先用addShader注册(每个着色器一次), 每帧的uniform(相机, 光源)由调用者在execute之前设置
+ */
+class RenderQueue {
+public:
+    using ShaderId = uint16_t;
+
+    RenderQueue() = default;
+    ~RenderQueue();
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // 注册着色器程序, 查询逐物体uniform的位置. 返回的编号也是排序键中的着色器字段
+    ShaderId addShader(GLuint program, const UniformTable& uniforms);
+    ShaderId addShader(const Shader* shader) { return addShader(shader->getProgram(), shader->getUniforms()); }
+
+    // 开始新的一帧: 清空上一帧的包. 深度是视图空间中到相机的距离, 在[nearPlane, farPlane]中量化
+    void begin(const glm::mat4& viewMatrix, float nearPlane, float farPlane);
+    uint32_t addObject(const ObjectConstants& object);
+    // 提交一次绘制. commands被复制到队列中, center是世界空间中用来计算深度的位置
+    void submit(RenderPass pass, ShaderId shader, const Material* material, GLuint vao, uint32_t object,
+                const glm::vec3& center, const DrawElementsIndirectCommand* commands, size_t commandCount);
+    void submit(RenderPass pass, ShaderId shader, const Material* material, GLuint vao, uint32_t object,
+                const glm::vec3& center, const std::vector<DrawElementsIndirectCommand>& commands) {
+        submit(pass, shader, material, vao, object, center, commands.data(), commands.size());
+    }
+
+    // 计算排序键并排序. 关闭排序时保持提交顺序(用于对比)
+    void sort();
+    // 执行所有的包. 需要OpenGL(或者GLRecorder). 结束时保持最后一个包的程序和VAO
+    void execute();
+
+    void setSortEnabled(const bool enabled) { sortEnabled = enabled; }
+    const std::vector<DrawPacket>& getPackets() const { return packets; }
+    const RenderQueueStats& getStats() const { return stats; }
+    void printStats() const;
+
+    // 对(键, 包的序号)做LSD基数排序, 稳定. temp是复用的临时空间
+    static void radixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& order,
+                          std::vector<uint64_t>& tempKeys, std::vector<uint32_t>& tempOrder);
+
+    static constexpr uint32_t SHADER_BITS = 10;
+    static constexpr uint32_t MATERIAL_BITS = 20;
+    static constexpr uint32_t VAO_BITS = 8;
+    static constexpr uint32_t DEPTH_BITS = 24;
+
+private:
+    // 逐物体uniform的位置
+    struct ShaderEntry {
+        GLuint program;
+        GLint model;
+        GLint normalMatrix;
+        GLint objectColor;
+        GLint uvScale;
+        GLint octNormal;
+        GLint instanced;
+        GLint positionOffset;
+        GLint positionScale;
+    };
+    std::vector<ShaderEntry> shaders;
+    // VAO的编号. 场景中的VAO很少(每种顶点格式一个共享缓冲), 线性查找
+    std::vector<GLuint> vaos;
+
+    glm::mat4 viewMatrix{1.0f};
+    float nearPlane{0.1f};
+    float farPlane{100.0f};
+
+    std::vector<DrawPacket> packets;
+    // 提交时量化的深度和通道, 排序键在sort中才拼出(材质编号需要这一帧所有的材质)
+    std::vector<uint32_t> depths;
+    std::vector<RenderPass> passes;
+    std::vector<ObjectConstants> objects;
+    std::vector<DrawElementsIndirectCommand> commands;
+    GLuint indirectBuffer{0};
+    bool sortEnabled{true};
+    RenderQueueStats stats;
+
+    // 排序复用的空间, 每帧不再分配
+    // 这一帧用到的材质, 按排序键排序后的位置就是排名
+    std::vector<const Material*> frameMaterials;
+    std::vector<uint64_t> keys;
+    std::vector<uint32_t> order;
+    std::vector<uint64_t> tempKeys;
+    std::vector<uint32_t> tempOrder;
+    std::vector<DrawPacket> sortedPackets;
+
+    uint16_t getVaoIndex(GLuint vao);
+    void uploadObject(const ShaderEntry& shader, const ObjectConstants& object) const;
+};
+
+#endif //RENDERQUEUE_H
@@ -0,0 +1,302 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "renderQueueBenchmark.h"
+#include "benchmarkCheck.h"
+#include "geometryArena.h"
+#include "glRecorder.h"
+#include "renderQueue.h"
+
+using namespace benchmark;
+
+namespace {
+    // 两个假的着色器程序: 光照着色器有全部5个逐物体uniform, 光源着色器只有3个
+    struct TestShaders {
+        UniformTable lit;
+        UniformTable flat;
+
+        TestShaders() {
+            lit.add("model", 0);
+            lit.add("normalMatrix", 1);
+            lit.add("objectColor", 2);
+            lit.add("uvScale", 3);
+            lit.add("octNormal", 4);
+            flat.add("model", 0);
+            flat.add("objectColor", 1);
+            flat.add("uvScale", 2);
+        }
+    };
+
+    // 16个材质, 共用8张漫反射纹理
+    std::vector<std::unique_ptr<Material>> createMaterials() {
+        std::vector<std::unique_ptr<Material>> materials;
+        for (int i = 0; i < 16; i++) {
+            materials.push_back(std::make_unique<Material>());
+            materials.back()->addTexture("texture_diffuse", 100 + i % 8);
+        }
+        return materials;
+    }
+
+    glm::mat4 testView() {
+        return glm::lookAt(glm::vec3(0.0f, 0.0f, 10.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+
+    // 随机的一帧: count个物体, 两个着色器, 两个VAO, 十分之一透明. 每个物体1~3条间接命令
+    void fillScene(RenderQueue& queue, const RenderQueue::ShaderId lit, const RenderQueue::ShaderId flat,
+                   const std::vector<std::unique_ptr<Material>>& materials, const int count) {
+        std::mt19937 random(11);
+        queue.begin(testView(), 0.1f, 100.0f);
+        std::vector<DrawElementsIndirectCommand> commands;
+        for (int i = 0; i < count; i++) {
+            ObjectConstants object;
+            const glm::vec3 center(0.0f, 0.0f, -(float)(random() % 80));
+            object.model = glm::translate(glm::mat4(1.0f), center);
+            commands.assign(1 + random() % 3, DrawElementsIndirectCommand{(GLuint)(3 * (i + 1))});
+            const RenderQueue::ShaderId shader = random() % 4 == 0 ? flat : lit;
+            const GLuint vao = 10 + random() % 2;
+            const Material* material = materials[random() % materials.size()].get();
+            const RenderPass pass = i % 10 == 0 ? RenderPass::Transparent : RenderPass::Opaque;
+            queue.submit(pass, shader, material, vao, queue.addObject(object), center, commands);
+        }
+    }
+
+    uint32_t countStateCalls(const GLRecorder& gl) {
+        return gl.count(GLCall::UseProgram) + gl.count(GLCall::BindVertexArray) + gl.count(GLCall::BindTexture)
+               + gl.count(GLCall::ActiveTexture) + gl.count(GLCall::BindBufferRange);
+    }
+}
+
+void checkRenderQueueSorting() {
+    std::cout << "sorting:" << std::endl;
+    // 基数排序与稳定的比较排序结果相同. 高位相同的键很多(只有少数几个着色器和材质), 低位随机
+    std::mt19937_64 random(3);
+    std::vector<uint64_t> keys(5000);
+    for (uint64_t& key : keys) {
+        key = (random() % 3) << 62 | (random() % 4) << 40 | random() % 1000;
+    }
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::vector<uint32_t> expected = order;
+    std::stable_sort(expected.begin(), expected.end(), [&keys](const uint32_t a, const uint32_t b) {
+        return keys[a] < keys[b];
+    });
+    std::vector<uint64_t> sortedKeys = keys, tempKeys;
+    std::vector<uint32_t> tempOrder;
+    RenderQueue::radixSort(sortedKeys, order, tempKeys, tempOrder);
+    check(order == expected && std::is_sorted(sortedKeys.begin(), sortedKeys.end()),
+          "radix sort matches std::stable_sort (including ties)");
+
+    TestShaders shaders;
+    RenderQueue queue;
+    const RenderQueue::ShaderId lit = queue.addShader(1, shaders.lit);
+    const RenderQueue::ShaderId flat = queue.addShader(2, shaders.flat);
+    check(lit == 0 && flat == 1 && queue.addShader(1, shaders.lit) == lit, "shaders get dense ids, re-adding is a lookup");
+
+    // 同一状态下的三个不透明和三个透明物体, 距离相机(z=10)分别为40, 15, 25
+    const float distances[] = {40.0f, 15.0f, 25.0f};
+    const DrawElementsIndirectCommand command{3};
+    queue.begin(testView(), 0.1f, 100.0f);
+    for (int pass = 0; pass < 2; pass++) {
+        for (const float distance : distances) {
+            const uint32_t object = queue.addObject({});
+            queue.submit(pass == 0 ? RenderPass::Transparent : RenderPass::Opaque, lit, nullptr, 10, object,
+                         glm::vec3(0.0f, 0.0f, 10.0f - distance), &command, 1);
+        }
+    }
+    queue.sort();
+    std::vector<uint32_t> objects;
+    for (const DrawPacket& packet : queue.getPackets()) {
+        objects.push_back(packet.object);
+    }
+    // 物体0~2是透明的, 3~5是不透明的
+    check(objects == std::vector<uint32_t>{4, 5, 3, 0, 2, 1},
+          "opaque first and front to back, then transparent back to front");
+
+    // 材质按排序键排名: a和c共用纹理5, 排在一起
+    Material a, b, c;
+    a.addTexture("texture_diffuse", 5);
+    b.addTexture("texture_diffuse", 9);
+    c.addTexture("texture_diffuse", 5);
+    queue.begin(testView(), 0.1f, 100.0f);
+    const uint32_t object = queue.addObject({});
+    for (const Material* material : {&b, &a, &c}) {
+        queue.submit(RenderPass::Opaque, lit, material, 10, object, glm::vec3(0.0f), &command, 1);
+    }
+    // 着色器的优先级高于材质和深度
+    queue.submit(RenderPass::Opaque, flat, &a, 10, object, glm::vec3(0.0f, 0.0f, 9.0f), &command, 1);
+    queue.sort();
+    const auto& packets = queue.getPackets();
+    check(packets.size() == 4 && packets[0].material == &a && packets[1].material == &c && packets[2].material == &b
+          && packets[3].shader == flat, "packets group by shader, then by material texture");
+
+    queue.setSortEnabled(false);
+    queue.begin(testView(), 0.1f, 100.0f);
+    for (const Material* material : {&b, &a, &c}) {
+        queue.submit(RenderPass::Opaque, lit, material, 10, object, glm::vec3(0.0f), &command, 1);
+    }
+    queue.sort();
+    check(queue.getPackets()[0].material == &b && queue.getPackets()[0].key != 0,
+          "sorting disabled keeps submission order but still computes keys");
+}
+
+void checkRenderQueueExecution() {
+    std::cout << "execution:" << std::endl;
+    // GLRecorder中绑定的是假的VAO, 结束后恢复GeometryArena记录的绑定, 否则之后真正的bind会被错误地跳过
+    const GLuint boundVAO = GeometryArena::getBoundVAO();
+    Material::releaseBuffer();
+    {
+        GLRecorder gl;
+        TestShaders shaders;
+        const auto materials = createMaterials();
+        RenderQueue queue;
+        const RenderQueue::ShaderId lit = queue.addShader(1, shaders.lit);
+        const RenderQueue::ShaderId flat = queue.addShader(2, shaders.flat);
+
+        fillScene(queue, lit, flat, materials, 300);
+        queue.sort();
+        gl.clear();
+        queue.execute();
+        const RenderQueueStats& stats = queue.getStats();
+        const auto& packets = queue.getPackets();
+
+        // 排序后相同状态的包相邻, 每组只切换一次
+        std::set<std::pair<uint64_t, uint16_t>> programGroups;
+        std::set<std::tuple<uint64_t, uint16_t, const Material*>> materialGroups;
+        for (const DrawPacket& packet : packets) {
+            const uint64_t pass = packet.key >> 62;
+            programGroups.insert({pass, packet.shader});
+            materialGroups.insert({pass, packet.shader, packet.material});
+        }
+        check(gl.count(GLCall::UseProgram) == programGroups.size() && stats.programBinds == programGroups.size(),
+              "one glUseProgram per shader per pass (" + std::to_string(stats.programBinds) + ")");
+        check(stats.materialBinds == materialGroups.size(), "one material bind per material group");
+        check(gl.count(GLCall::BindVertexArray) == stats.vaoBinds
+              && stats.vaoBinds + stats.elidedVaoBinds == packets.size()
+              && stats.programBinds + stats.elidedProgramBinds == packets.size()
+              && stats.materialBinds + stats.elidedMaterialBinds == packets.size(),
+              "issued + elided bind counts cover every packet and match the recorded calls");
+        check(gl.count(GLCall::BindTexture) == stats.textureBinds, "texture binds match the recorded calls");
+
+        uint32_t indirectUploads = 0;
+        bool offsetsMatch = true;
+        size_t draw = 0;
+        for (const GLRecord& record : gl.getRecords()) {
+            if (record.call == GLCall::BufferData && record.args[0] == GL_DRAW_INDIRECT_BUFFER) {
+                indirectUploads++;
+            }
+            if (record.call == GLCall::MultiDrawElementsIndirect) {
+                const DrawPacket& packet = packets[draw++];
+                offsetsMatch = offsetsMatch && record.args[1] == packet.commandCount
+                               && record.args[2] == packet.firstCommand * sizeof(DrawElementsIndirectCommand);
+            }
+        }
+        check(indirectUploads == 1 && draw == packets.size() && stats.draws == packets.size() && offsetsMatch,
+              "all commands are uploaded once, each packet draws its own range");
+
+        // 一个模型的三个材质共用一个物体, 物体的uniform只设置一次
+        queue.begin(testView(), 0.1f, 100.0f);
+        const uint32_t object = queue.addObject({});
+        const DrawElementsIndirectCommand command{3};
+        for (int i = 0; i < 3; i++) {
+            queue.submit(RenderPass::Opaque, lit, materials[i].get(), 10, object, glm::vec3(0.0f), &command, 1);
+        }
+        queue.sort();
+        gl.clear();
+        queue.execute();
+        check(queue.getStats().objectUpdates == 1 && queue.getStats().elidedObjectUpdates == 2
+              && gl.count(GLCall::Uniform) == 5, "object uniforms shared by consecutive packets are set once");
+        check(gl.count(GLCall::UseProgram) == 1 && gl.count(GLCall::BindVertexArray) == 1,
+              "state is unknown at the start of a frame and set again");
+        Material::releaseBuffer();
+    }
+    Material::resetBindings();
+    GeometryArena::setBoundVAO(boundVAO);
+}
+
+void benchmarkRenderQueue() {
+    std::cout << "benchmark:" << std::endl;
+    // GLRecorder中绑定的是假的VAO, 结束后恢复GeometryArena记录的绑定, 否则之后真正的bind会被错误地跳过
+    const GLuint boundVAO = GeometryArena::getBoundVAO();
+    Material::releaseBuffer();
+    {
+        GLRecorder gl;
+        TestShaders shaders;
+        const auto materials = createMaterials();
+        RenderQueue queue;
+        const RenderQueue::ShaderId lit = queue.addShader(1, shaders.lit);
+        const RenderQueue::ShaderId flat = queue.addShader(2, shaders.flat);
+
+        const auto runFrame = [&](const bool sorted) {
+            queue.setSortEnabled(sorted);
+            fillScene(queue, lit, flat, materials, 1000);
+            queue.sort();
+            Material::resetBindings();
+            gl.clear();
+            queue.execute();
+            return countStateCalls(gl);
+        };
+        const uint32_t unsortedCalls = runFrame(false);
+        const RenderQueueStats unsorted = queue.getStats();
+        const uint32_t sortedCalls = runFrame(true);
+        const RenderQueueStats sorted = queue.getStats();
+        std::cout << "  1000 packets, scene order: " << unsortedCalls << " state calls (program " << unsorted.programBinds
+                  << ", VAO " << unsorted.vaoBinds << ", texture " << unsorted.textureBinds << ")" << std::endl;
+        std::cout << "  1000 packets, sorted:      " << sortedCalls << " state calls (program " << sorted.programBinds
+                  << ", VAO " << sorted.vaoBinds << ", texture " << sorted.textureBinds << ")" << std::endl;
+        check(sortedCalls * 4 < unsortedCalls, "sorting cuts state calls by more than 4x");
+        Material::releaseBuffer();
+    }
+    Material::resetBindings();
+    GeometryArena::setBoundVAO(boundVAO);
+
+    // 排序本身的耗时: 10万个键
+    std::mt19937_64 random(5);
+    std::vector<uint64_t> keys(100000);
+    for (uint64_t& key : keys) {
+        key = (random() % 2) << 62 | (random() % 2) << 52 | (random() % 64) << 32 | (random() % 2) << 24
+              | random() % (1u << 24);
+    }
+    std::vector<uint64_t> radixKeys, tempKeys;
+    std::vector<uint32_t> order, tempOrder;
+    constexpr int rounds = 10;
+    auto start = Clock::now();
+    for (int round = 0; round < rounds; round++) {
+        radixKeys = keys;
+        order.resize(keys.size());
+        std::iota(order.begin(), order.end(), 0u);
+        RenderQueue::radixSort(radixKeys, order, tempKeys, tempOrder);
+    }
+    const double radixMs = elapsedMs(start) / rounds;
+    std::vector<std::pair<uint64_t, uint32_t>> pairs;
+    start = Clock::now();
+    for (int round = 0; round < rounds; round++) {
+        pairs.clear();
+        for (uint32_t i = 0; i < keys.size(); i++) {
+            pairs.emplace_back(keys[i], i);
+        }
+        std::sort(pairs.begin(), pairs.end());
+    }
+    const double compareMs = elapsedMs(start) / rounds;
+    std::cout << "  100000 keys: radix sort " << radixMs << " ms, std::sort " << compareMs << " ms" << std::endl;
+    check(std::is_sorted(radixKeys.begin(), radixKeys.end()), "radix sorted keys are ordered");
+}
+
+void runRenderQueueBenchmarks() {
+    beginChecks("render queue");
+    checkRenderQueueSorting();
+    checkRenderQueueExecution();
+    benchmarkRenderQueue();
+    endChecks();
+}
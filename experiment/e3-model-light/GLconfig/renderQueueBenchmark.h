@@ -0,0 +1,23 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef RENDERQUEUEBENCHMARK_H
+#define RENDERQUEUEBENCHMARK_H
+
+/**
+ * 渲染队列的测试, 在窗口中按B键运行. 执行部分通过GLRecorder记录发出的OpenGL调用, 不需要OpenGL上下文
+ */
+
+// 基数排序与std::stable_sort结果相同; 排序键的字段顺序, 不透明由近到远, 透明由远到近
+void checkRenderQueueSorting();
+
+// 排序后执行: 每个着色器只切换一次程序, 每个材质只绑定一次, 统计与实际发出的调用一致
+void checkRenderQueueExecution();
+
+// 模拟一帧的状态切换(场景顺序和排序后), 以及基数排序和std::sort的耗时
+void benchmarkRenderQueue();
+
+void runRenderQueueBenchmarks();
+
+#endif //RENDERQUEUEBENCHMARK_H
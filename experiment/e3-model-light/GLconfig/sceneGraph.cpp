@@ -0,0 +1,273 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+
+#include "sceneGraph.h"
+
+glm::mat4 SceneTransform::toMatrix() const {
+    // 与GeometryInstance相同, T * R * S
+    return glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation) * glm::scale(glm::mat4(1.0f), scale);
+}
+
+SceneGraph::SceneGraph() {
+    Node root;
+    root.id = ROOT;
+    nodes.push_back(root);
+    slotOf.push_back(0);
+}
+
+// ===============================================================
+// ===层级结构=====================================================
+// ===============================================================
+
+SceneGraph::NodeId SceneGraph::createNode(const NodeId parent, const SceneTransform& local, Geometry* geometry) {
+    NodeId id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = static_cast<NodeId>(slotOf.size());
+        slotOf.push_back(0);
+    }
+
+    Node node;
+    node.id = id;
+    node.parent = parent;
+    node.local = local;
+    node.geometry = geometry;
+
+    // 插入到父节点子树的末尾, 保持深度优先的顺序
+    const uint32_t parentSlot = slotOf[parent];
+    const uint32_t slot = parentSlot + nodes[parentSlot].subtreeSize;
+    nodes.insert(nodes.begin() + slot, node);
+    addToAncestors(parent, 1);
+    reindex(slot);
+    markDirty(id);
+    return id;
+}
+
+void SceneGraph::destroyNode(const NodeId node) {
+    if (node == ROOT) {
+        return;
+    }
+    const uint32_t slot = slotOf[node];
+    const uint32_t size = nodes[slot].subtreeSize;
+    const NodeId parent = nodes[slot].parent;
+    for (uint32_t i = slot; i < slot + size; i++) {
+        slotOf[nodes[i].id] = INVALID_NODE;
+        freeIds.push_back(nodes[i].id);
+    }
+    nodes.erase(nodes.begin() + slot, nodes.begin() + slot + size);
+    addToAncestors(parent, -static_cast<int32_t>(size));
+    reindex(slot);
+    // 父节点的世界矩阵没变, 只需要重新计算包围盒
+    markBoundsDirty(parent);
+    markSubtreeDirty(parent);
+}
+
+void SceneGraph::setParent(const NodeId node, const NodeId parent) {
+    const uint32_t slot = slotOf[node];
+    const uint32_t size = nodes[slot].subtreeSize;
+    const uint32_t parentSlot = slotOf[parent];
+    // 不能挂到自己的子树下
+    if (node == ROOT || (parentSlot >= slot && parentSlot < slot + size)) {
+        return;
+    }
+    const NodeId oldParent = nodes[slot].parent;
+    markBoundsDirty(oldParent);
+    markSubtreeDirty(oldParent);
+
+    // 整棵子树取出来, 再插入到新父节点子树的末尾
+    std::vector<Node> subtree(nodes.begin() + slot, nodes.begin() + slot + size);
+    nodes.erase(nodes.begin() + slot, nodes.begin() + slot + size);
+    addToAncestors(oldParent, -static_cast<int32_t>(size));
+    reindex(slot);
+
+    subtree.front().parent = parent;
+    const uint32_t newParentSlot = slotOf[parent];
+    const uint32_t insertSlot = newParentSlot + nodes[newParentSlot].subtreeSize;
+    nodes.insert(nodes.begin() + insertSlot, subtree.begin(), subtree.end());
+    addToAncestors(parent, static_cast<int32_t>(size));
+    reindex(std::min(slot, insertSlot));
+    // 父节点变了, 整棵子树的世界矩阵都要重新计算
+    markDirty(node);
+}
+
+void SceneGraph::reindex(const uint32_t from) {
+    for (auto i = from; i < nodes.size(); i++) {
+        slotOf[nodes[i].id] = i;
+    }
+}
+
+void SceneGraph::addToAncestors(NodeId parent, const int32_t delta) {
+    while (parent != INVALID_NODE) {
+        Node& node = nodes[slotOf[parent]];
+        node.subtreeSize += delta;
+        parent = node.parent;
+    }
+}
+
+// ===============================================================
+// ===局部变换=====================================================
+// ===============================================================
+
+void SceneGraph::markDirty(const NodeId node) {
+    nodes[slotOf[node]].localDirty = true;
+    markSubtreeDirty(node);
+}
+
+void SceneGraph::markSubtreeDirty(NodeId node) {
+    // 祖先已经被标记时, 再往上的祖先也一定被标记了
+    bool first = true;
+    while (node != INVALID_NODE) {
+        Node& n = nodes[slotOf[node]];
+        if (n.subtreeDirty && !first) {
+            break;
+        }
+        n.subtreeDirty = true;
+        first = false;
+        node = n.parent;
+    }
+}
+
+void SceneGraph::markBoundsDirty(NodeId node) {
+    while (node != INVALID_NODE) {
+        Node& n = nodes[slotOf[node]];
+        if (n.boundsDirty) {
+            break;
+        }
+        n.boundsDirty = true;
+        dirtyBounds.push_back(node);
+        node = n.parent;
+    }
+}
+
+void SceneGraph::setTransform(const NodeId node, const SceneTransform& local) {
+    nodes[slotOf[node]].local = local;
+    markDirty(node);
+}
+
+void SceneGraph::setPosition(const NodeId node, const glm::vec3& position) {
+    nodes[slotOf[node]].local.position = position;
+    markDirty(node);
+}
+
+void SceneGraph::setRotation(const NodeId node, const glm::quat& rotation) {
+    nodes[slotOf[node]].local.rotation = rotation;
+    markDirty(node);
+}
+
+void SceneGraph::setScale(const NodeId node, const glm::vec3& scale) {
+    nodes[slotOf[node]].local.scale = scale;
+    markDirty(node);
+}
+
+void SceneGraph::translate(const NodeId node, const glm::vec3& translation) {
+    nodes[slotOf[node]].local.position += translation;
+    markDirty(node);
+}
+
+void SceneGraph::rotate(const NodeId node, const float angle, const glm::vec3& axis) {
+    glm::quat& rotation = nodes[slotOf[node]].local.rotation;
+    rotation = glm::normalize(rotation * glm::angleAxis(glm::radians(angle), glm::normalize(axis)));
+    markDirty(node);
+}
+
+// ===============================================================
+// ===世界矩阵与包围盒==============================================
+// ===============================================================
+
+const glm::mat4& SceneGraph::getWorldMatrix(const NodeId node) {
+    update();
+    return nodes[slotOf[node]].world;
+}
+
+glm::vec3 SceneGraph::getWorldPosition(const NodeId node) {
+    return glm::vec3(getWorldMatrix(node)[3]);
+}
+
+const BoundingBox& SceneGraph::getWorldBounds(const NodeId node) {
+    update();
+    return nodes[slotOf[node]].worldBounds;
+}
+
+uint32_t SceneGraph::update() {
+    updatedMatrixCount = 0;
+    updatedBoundsCount = 0;
+    if (!nodes[0].subtreeDirty) {
+        return 0;
+    }
+
+    // 前序遍历: 父节点总在子节点之前, 父节点的世界矩阵一定已经是最新的
+    for (uint32_t i = 0; i < nodes.size();) {
+        Node& node = nodes[i];
+        const Node* parent = node.parent == INVALID_NODE ? nullptr : &nodes[slotOf[node.parent]];
+        const bool parentChanged = parent && parent->changed;
+        // 整棵子树都没有变化, 直接跳过
+        if (!node.subtreeDirty && !parentChanged) {
+            i += node.subtreeSize;
+            continue;
+        }
+        node.changed = node.localDirty || parentChanged;
+        if (node.changed) {
+            node.world = parent ? parent->world * node.local.toMatrix() : node.local.toMatrix();
+            updatedMatrixCount++;
+            markBoundsDirty(node.id);
+        }
+        node.localDirty = false;
+        node.subtreeDirty = false;
+        i++;
+    }
+
+    // 后序重新计算包围盒: 子节点的下标总比父节点大, 按下标从大到小处理
+    std::vector<uint32_t> slots;
+    slots.reserve(dirtyBounds.size());
+    for (const NodeId id : dirtyBounds) {
+        if (slotOf[id] != INVALID_NODE && nodes[slotOf[id]].boundsDirty) {
+            slots.push_back(slotOf[id]);
+        }
+    }
+    dirtyBounds.clear();
+    std::sort(slots.begin(), slots.end(), std::greater<>());
+    slots.erase(std::unique(slots.begin(), slots.end()), slots.end());
+    for (const uint32_t slot : slots) {
+        updateBounds(slot);
+        nodes[slot].boundsDirty = false;
+        updatedBoundsCount++;
+    }
+    return updatedMatrixCount;
+}
+
+void SceneGraph::updateBounds(const uint32_t slot) {
+    Node& node = nodes[slot];
+    node.emptyBounds = true;
+    if (node.geometry) {
+        // 变换后的AABB: 中心直接变换, 半长取矩阵绝对值与半长的乘积
+        const BoundingBox& box = node.geometry->boundingBox;
+        const glm::vec3 center = glm::vec3(node.world * glm::vec4((box.min + box.max) * 0.5f, 1.0f));
+        const glm::mat3 absMatrix(glm::abs(glm::vec3(node.world[0])), glm::abs(glm::vec3(node.world[1])),
+                                  glm::abs(glm::vec3(node.world[2])));
+        const glm::vec3 extent = absMatrix * ((box.max - box.min) * 0.5f);
+        node.worldBounds = {center - extent, center + extent};
+        node.emptyBounds = false;
+    }
+    // 合并直接子节点的子树包围盒
+    for (uint32_t child = slot + 1; child < slot + node.subtreeSize; child += nodes[child].subtreeSize) {
+        const Node& childNode = nodes[child];
+        if (childNode.emptyBounds) {
+            continue;
+        }
+        if (node.emptyBounds) {
+            node.worldBounds = childNode.worldBounds;
+            node.emptyBounds = false;
+        } else {
+            node.worldBounds.min = glm::min(node.worldBounds.min, childNode.worldBounds.min);
+            node.worldBounds.max = glm::max(node.worldBounds.max, childNode.worldBounds.max);
+        }
+    }
+    if (node.emptyBounds) {
+        node.worldBounds = {glm::vec3(node.world[3]), glm::vec3(node.world[3])};
+    }
+}
@@ -0,0 +1,140 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef SCENEGRAPH_H
+#define SCENEGRAPH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "core.h"
+#include "geometry.h"
+#include <glm/gtc/quaternion.hpp>
+
+// 场景图节点的局部变换
+struct SceneTransform {
+    glm::vec3 position{0.0f};
+    glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
+    glm::vec3 scale{1.0f};
+
+    glm::mat4 toMatrix() const;
+};
+
+/**
+ * 场景图(变换层级)
+ * 每个节点保存相对父节点的局部变换(T * R * S), 世界矩阵 = 父节点世界矩阵 * 局部矩阵
+ * 以前"绕自身中心旋转"只能用translate * rotate * translate拼进updateMatrix, 现在直接旋转节点即可;
+ * 光源绕物体公转则是把光源挂在一个旋转的父节点下
+ *
+ * 节点按深度优先的顺序平铺存放在数组中: 父节点总在子节点之前, 一棵子树占据连续的一段[slot, slot + subtreeSize)
+ * 修改局部变换只会标记节点以及它的祖先, 世界矩阵在被读取时才重新计算(惰性), 并且只遍历被标记的子树,
+ * 没有变化的兄弟子树整段跳过. 世界包围盒(整棵子树的并集)也只对变化的节点及其祖先重新计算
+ */
+class SceneGraph {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId ROOT = 0;
+    static constexpr NodeId INVALID_NODE = 0xFFFFFFFF;
+
+    // 创建时自带一个根节点
+    SceneGraph();
+    ~SceneGraph() = default;
+
+    // 在parent下创建子节点. geometry可以为空(只用于组织层级), 不为空时用它的包围盒参与世界包围盒的计算
+    NodeId createNode(NodeId parent = ROOT, const SceneTransform& local = {}, Geometry* geometry = nullptr);
+    // 删除节点以及它的整棵子树
+    void destroyNode(NodeId node);
+    // 把节点(连同子树)移动到新的父节点下, 局部变换保持不变
+    void setParent(NodeId node, NodeId parent);
+
+    // 修改局部变换
+    void setTransform(NodeId node, const SceneTransform& local);
+    void setPosition(NodeId node, const glm::vec3& position);
+    void setRotation(NodeId node, const glm::quat& rotation);
+    void setScale(NodeId node, const glm::vec3& scale);
+    // 累加变换. angle为角度, 绕节点自身的原点旋转
+    void translate(NodeId node, const glm::vec3& translation);
+    void rotate(NodeId node, float angle, const glm::vec3& axis);
+
+    const SceneTransform& getTransform(NodeId node) const { return nodes[slotOf[node]].local; }
+    Geometry* getGeometry(NodeId node) const { return nodes[slotOf[node]].geometry; }
+    NodeId getParent(NodeId node) const { return nodes[slotOf[node]].parent; }
+
+    // 世界矩阵/世界空间位置/子树的世界包围盒. 有节点被修改时会先执行update
+    const glm::mat4& getWorldMatrix(NodeId node);
+    glm::vec3 getWorldPosition(NodeId node);
+    const BoundingBox& getWorldBounds(NodeId node);
+
+    // 重新计算被修改的子树的世界矩阵和包围盒. 返回重新计算的世界矩阵数量
+    uint32_t update();
+
+    // 按深度优先顺序访问所有带几何体的节点: callback(NodeId, Geometry*, const glm::mat4& worldMatrix)
+    template <typename Callback>
+    void forEachGeometry(Callback&& callback);
+
+    uint32_t getNodeCount() const { return static_cast<uint32_t>(nodes.size()); }
+    // 上一次update重新计算的世界矩阵/包围盒数量
+    uint32_t getUpdatedMatrixCount() const { return updatedMatrixCount; }
+    uint32_t getUpdatedBoundsCount() const { return updatedBoundsCount; }
+
+private:
+    struct Node {
+        NodeId id{INVALID_NODE};
+        NodeId parent{INVALID_NODE};
+        // 包括自身在内的子树节点数
+        uint32_t subtreeSize{1};
+
+        SceneTransform local;
+        glm::mat4 world{1.0f};
+
+        Geometry* geometry{nullptr};
+        // 整棵子树的世界空间包围盒. empty表示子树中没有几何体
+        BoundingBox worldBounds;
+        bool emptyBounds{true};
+
+        // 局部变换被修改
+        bool localDirty{true};
+        // 自身或子树中有节点被修改
+        bool subtreeDirty{true};
+        // update过程中世界矩阵发生了变化
+        bool changed{false};
+        // 包围盒需要重新计算
+        bool boundsDirty{false};
+    };
+
+    // 深度优先顺序存放的节点
+    std::vector<Node> nodes;
+    // 节点id -> 数组下标. 插入删除会移动节点, id保持不变
+    std::vector<uint32_t> slotOf;
+    std::vector<NodeId> freeIds;
+    // 等待重新计算包围盒的节点
+    std::vector<NodeId> dirtyBounds;
+
+    uint32_t updatedMatrixCount{0};
+    uint32_t updatedBoundsCount{0};
+
+    // 标记节点的局部变换被修改, 并沿祖先向上标记subtreeDirty
+    void markDirty(NodeId node);
+    void markSubtreeDirty(NodeId node);
+    // 标记节点及其祖先的包围盒需要重新计算
+    void markBoundsDirty(NodeId node);
+    // 从from开始的节点重新计算slotOf
+    void reindex(uint32_t from);
+    // 把子树的大小变化累加到所有祖先
+    void addToAncestors(NodeId parent, int32_t delta);
+    // 重新计算一个节点的包围盒(自身几何体 + 直接子节点的包围盒)
+    void updateBounds(uint32_t slot);
+};
+
+template <typename Callback>
+void SceneGraph::forEachGeometry(Callback&& callback) {
+    update();
+    for (const auto& node : nodes) {
+        if (node.geometry) {
+            callback(node.id, node.geometry, node.world);
+        }
+    }
+}
+
+#endif //SCENEGRAPH_H
@@ -0,0 +1,207 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "sceneGraphBenchmark.h"
+#include "benchmarkCheck.h"
+#include "sceneGraph.h"
+
+using namespace benchmark;
+
+namespace {
+    using NodeId = SceneGraph::NodeId;
+
+    SceneTransform randomTransform(std::mt19937& random) {
+        SceneTransform transform;
+        transform.position = glm::vec3((float)(random() % 5), (float)(random() % 3), (float)(random() % 7));
+        transform.rotation = glm::angleAxis(0.1f * (float)(random() % 10), glm::normalize(glm::vec3(1.0f, 2.0f, (float)(random() % 3))));
+        transform.scale = glm::vec3(1.0f + 0.1f * (float)(random() % 3));
+        return transform;
+    }
+
+    // 暴力计算: 沿父节点链逐个相乘
+    glm::mat4 chainProduct(const SceneGraph& graph, NodeId node) {
+        glm::mat4 world(1.0f);
+        while (node != SceneGraph::ROOT) {
+            world = graph.getTransform(node).toMatrix() * world;
+            node = graph.getParent(node);
+        }
+        return graph.getTransform(SceneGraph::ROOT).toMatrix() * world;
+    }
+
+    // 所有存活节点的世界矩阵与暴力计算结果的最大误差(相对误差, 矩阵随层级的缩放可能很大)
+    float maxWorldError(SceneGraph& graph, const std::vector<NodeId>& alive) {
+        float maxError = 0.0f;
+        for (const NodeId node : alive) {
+            const glm::mat4 expected = chainProduct(graph, node);
+            const glm::mat4& world = graph.getWorldMatrix(node);
+            for (int c = 0; c < 4; c++) {
+                for (int r = 0; r < 4; r++) {
+                    maxError = glm::max(maxError, std::abs(world[c][r] - expected[c][r]) / glm::max(1.0f, std::abs(expected[c][r])));
+                }
+            }
+        }
+        return maxError;
+    }
+
+    // node是否在ancestor的子树中(包括自身), 按记录的父节点判断
+    bool isInSubtree(const std::unordered_map<NodeId, NodeId>& parents, NodeId node, const NodeId ancestor) {
+        while (node != SceneGraph::ROOT) {
+            if (node == ancestor) {
+                return true;
+            }
+            node = parents.at(node);
+        }
+        return ancestor == SceneGraph::ROOT;
+    }
+}
+
+void checkSceneGraphHierarchy() {
+    std::cout << "hierarchy:" << std::endl;
+    Geometry box;
+    box.boundingBox = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+    SceneGraph graph;
+    std::mt19937 random(3);
+    std::vector<NodeId> alive;
+    // 记录每个节点的父节点, 与场景图分开维护
+    std::unordered_map<NodeId, NodeId> parents;
+    for (int i = 0; i < 200; i++) {
+        const NodeId parent = alive.empty() || random() % 4 == 0 ? SceneGraph::ROOT : alive[random() % alive.size()];
+        const NodeId node = graph.createNode(parent, randomTransform(random), random() % 2 ? &box : nullptr);
+        alive.push_back(node);
+        parents[node] = parent;
+    }
+    check(graph.getNodeCount() == 201 && maxWorldError(graph, alive) < 1e-5f, "200 nodes: world matrices match the parent-chain product");
+
+    // 随机移动子树. 挂到自己子树下的请求应当被忽略
+    int rejected = 0;
+    bool parentsMatch = true;
+    for (int i = 0; i < 100; i++) {
+        const NodeId node = alive[random() % alive.size()];
+        const NodeId parent = alive[random() % alive.size()];
+        graph.setParent(node, parent);
+        if (isInSubtree(parents, parent, node)) {
+            rejected++;
+        } else {
+            parents[node] = parent;
+        }
+        parentsMatch = parentsMatch && graph.getParent(node) == parents[node];
+    }
+    check(parentsMatch, "100 reparents: " + std::to_string(rejected) + " cycles rejected, the rest moved");
+    check(maxWorldError(graph, alive) < 1e-5f, "world matrices match after reparenting");
+
+    // 删除一棵子树, 它的所有后代一起删除
+    const NodeId removed = alive[7];
+    std::vector<NodeId> survivors;
+    for (const NodeId node : alive) {
+        if (!isInSubtree(parents, node, removed)) {
+            survivors.push_back(node);
+        }
+    }
+    graph.destroyNode(removed);
+    check(graph.getNodeCount() == survivors.size() + 1, "destroying a node removes its " + std::to_string(alive.size() - survivors.size())
+          + "-node subtree");
+    alive = survivors;
+    // 新节点复用删除的id, 仍然正确
+    for (int i = 0; i < 10; i++) {
+        const NodeId parent = alive[random() % alive.size()];
+        const NodeId node = graph.createNode(parent, randomTransform(random), &box);
+        alive.push_back(node);
+        parents[node] = parent;
+    }
+    check(maxWorldError(graph, alive) < 1e-5f, "world matrices match after destroy and id reuse");
+
+    // 根的包围盒是所有几何体变换后的包围盒的并集
+    glm::vec3 min(std::numeric_limits<float>::max()), max(std::numeric_limits<float>::lowest());
+    graph.forEachGeometry([&](NodeId, const Geometry* geometry, const glm::mat4& world) {
+        for (int corner = 0; corner < 8; corner++) {
+            const glm::vec3 local(corner & 1 ? geometry->boundingBox.max.x : geometry->boundingBox.min.x,
+                                  corner & 2 ? geometry->boundingBox.max.y : geometry->boundingBox.min.y,
+                                  corner & 4 ? geometry->boundingBox.max.z : geometry->boundingBox.min.z);
+            const glm::vec3 point = glm::vec3(world * glm::vec4(local, 1.0f));
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+    });
+    const BoundingBox& bounds = graph.getWorldBounds(SceneGraph::ROOT);
+    const float boundsError = glm::max(glm::length(bounds.min - min), glm::length(bounds.max - max));
+    check(boundsError < 1e-3f * glm::max(1.0f, glm::length(max - min)), "root bounds are the union of every geometry's bounds");
+}
+
+void checkSceneGraphLazyUpdate() {
+    std::cout << "lazy update:" << std::endl;
+    Geometry box;
+    box.boundingBox = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+    SceneGraph graph;
+    // 10个分支, 每个分支是一条10个节点的链
+    std::vector<NodeId> branches;
+    std::vector<NodeId> leaves;
+    for (int b = 0; b < 10; b++) {
+        NodeId parent = graph.createNode(SceneGraph::ROOT, {glm::vec3((float)b, 0.0f, 0.0f)}, &box);
+        branches.push_back(parent);
+        for (int i = 1; i < 10; i++) {
+            parent = graph.createNode(parent, {glm::vec3(0.0f, 1.0f, 0.0f)}, &box);
+        }
+        leaves.push_back(parent);
+    }
+    graph.update();
+    check(graph.update() == 0 && graph.getUpdatedBoundsCount() == 0, "update without changes recomputes nothing");
+
+    // 旋转一个分支的根: 只有这个分支的10个节点重新计算
+    graph.rotate(branches[3], 30.0f, glm::vec3(0.0f, 0.0f, 1.0f));
+    const uint32_t updated = graph.update();
+    check(updated == 10, "rotating one branch recomputes its 10 nodes of 101 (" + std::to_string(updated) + ")");
+    // 包围盒: 分支的10个节点 + 根
+    check(graph.getUpdatedBoundsCount() == 11, "bounds refreshed for the branch and its ancestors ("
+          + std::to_string(graph.getUpdatedBoundsCount()) + ")");
+
+    // 修改叶子: 只重新计算叶子自己. 读取世界矩阵时自动更新
+    graph.translate(leaves[7], glm::vec3(1.0f, 0.0f, 0.0f));
+    const glm::vec3 position = graph.getWorldPosition(leaves[7]);
+    check(graph.getUpdatedMatrixCount() == 1 && glm::length(position - glm::vec3(8.0f, 9.0f, 0.0f)) < 1e-5f,
+          "moving a leaf recomputes one matrix, read triggers the update");
+}
+
+void benchmarkSceneGraph(const int count, const int dirtyPercent) {
+    SceneGraph graph;
+    std::mt19937 random(7);
+    std::vector<NodeId> nodes;
+    nodes.reserve(count);
+    for (int i = 0; i < count; i++) {
+        // 浅而宽的层级: 每个节点挂在前面最近的64个节点之一下
+        const NodeId parent = nodes.empty() || i % 64 == 0 ? SceneGraph::ROOT : nodes[i - 1 - random() % glm::min(i, 64)];
+        nodes.push_back(graph.createNode(parent, randomTransform(random)));
+    }
+    graph.update();
+
+    constexpr int frames = 10;
+    const int dirtyCount = count * dirtyPercent / 100;
+    uint32_t updated = 0;
+    const auto start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        for (int i = 0; i < dirtyCount; i++) {
+            graph.rotate(nodes[random() % nodes.size()], 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+        }
+        updated += graph.update();
+    }
+    const double ms = elapsedMs(start) / frames;
+    std::cout << "  " << count << " nodes, " << dirtyCount << " modified per frame: " << ms << " ms/frame, "
+              << updated / frames << " matrices recomputed" << std::endl;
+}
+
+void runSceneGraphBenchmarks() {
+    beginChecks("scene graph");
+    checkSceneGraphHierarchy();
+    checkSceneGraphLazyUpdate();
+    std::cout << "update:" << std::endl;
+    for (const int dirtyPercent : {1, 10, 100}) {
+        benchmarkSceneGraph(100000, dirtyPercent);
+    }
+    endChecks();
+}
@@ -0,0 +1,24 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef SCENEGRAPHBENCHMARK_H
+#define SCENEGRAPHBENCHMARK_H
+
+/**
+ * 场景图的测试, 在窗口中按B键运行. 只计算矩阵和包围盒, 不需要OpenGL上下文
+ * 世界矩阵与沿父节点链逐个相乘的结果比较
+ */
+
+// 随机建树, 随机移动子树和删除子树后, 每个节点的世界矩阵与父节点链的乘积一致, 根的包围盒是所有几何体的并集
+void checkSceneGraphHierarchy();
+
+// 惰性更新: 修改一个节点只重新计算它的子树, 没有修改时update不做任何计算
+void checkSceneGraphLazyUpdate();
+
+// count个节点中每帧修改dirtyPercent%的节点, update的耗时
+void benchmarkSceneGraph(int count, int dirtyPercent);
+
+void runSceneGraphBenchmarks();
+
+#endif //SCENEGRAPHBENCHMARK_H
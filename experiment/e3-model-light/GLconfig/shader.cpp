@@ -4,6 +4,7 @@
 
 #include "shader.h"
 
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -69,6 +70,8 @@ Shader::Shader(const char* vsSrcPath, const char* fsSrcPath) {
     // 编译链接形成可执行Shader程序后, 着色器对象就不需要了
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
+    // 所有uniform的位置只在这里查询一次
+    reflectUniforms();
 }
 
 Shader::~Shader() = default;
@@ -81,35 +84,64 @@ void Shader::end() {
     glUseProgram(0);
 }
 
-void Shader::setBool(const std::string &name, const bool value) const {
-    glUniform1i(glGetUniformLocation(program, name.c_str()), (int)value);
+void Shader::setBool(const GLint location, const bool value) {
+    glUniform1i(location, (int)value);
 }
-void Shader::setVec3(const std::string& name, const float v0, const float v1, const float v2) const {
-    glUniform3f(glGetUniformLocation(program, name.c_str()), v0, v1, v2);
+void Shader::setVec3(const GLint location, const float v0, const float v1, const float v2) {
+    glUniform3f(location, v0, v1, v2);
 }
-void Shader::setVec3(const std::string& name, const float* values) const {
-    glUniform3fv(glGetUniformLocation(program, name.c_str()), 1, values);
+void Shader::setVec3(const GLint location, const float* values) {
+    glUniform3fv(location, 1, values);
 }
-void Shader::setVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(glGetUniformLocation(program, name.c_str()), 1, &value[0]);
+void Shader::setVec3(const GLint location, const glm::vec3& value) {
+    glUniform3fv(location, 1, &value[0]);
 }
-void Shader::setInt(const std::string& name, const int value) const {
-    glUniform1i(glGetUniformLocation(program, name.c_str()), value);
+void Shader::setInt(const GLint location, const int value) {
+    glUniform1i(location, value);
 }
-void Shader::setFloat(const std::string& name, const float value) const {
-    glUniform1f(glGetUniformLocation(program, name.c_str()), value);
+void Shader::setFloat(const GLint location, const float value) {
+    glUniform1f(location, value);
 }
-void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
+void Shader::setMat4(const GLint location, const glm::mat4& mat) {
     // count: 要传递的矩阵数量
     // transpose参数: 是否转置矩阵
     // 📌📌OpenGL和GLM的矩阵存储方式都是列主序, 所以不需要转置
     // 列主序: 列优先存储, 先存储列, 再存储行. 比如mat2((1, 2), (3, 4))会被存储为(1, 3, 2, 4)
-    glUniformMatrix4fv(glGetUniformLocation(program, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+    glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
 }
-void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const {
-    glUniformMatrix3fv(glGetUniformLocation(program, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat));
+void Shader::setMat3(const GLint location, const glm::mat3& mat) {
+    glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(mat));
 }
 
+void Shader::reflectUniforms() {
+    uniforms.clear();
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::string buffer(std::max(maxLength, 1), '\0');
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type;
+        glGetActiveUniform(program, (GLuint)i, (GLsizei)buffer.size(), &length, &size, &type, buffer.data());
+        const std::string name(buffer.data(), length);
+        const GLint location = glGetUniformLocation(program, name.c_str());
+        // uniform块中的成员没有位置
+        if (location < 0) {
+            continue;
+        }
+        uniforms.add(name, location);
+        // 数组返回的名字是"name[0]"
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            const std::string base = name.substr(0, name.size() - 3);
+            uniforms.add(base, location);
+            for (GLint element = 1; element < size; element++) {
+                const std::string elementName = base + '[' + std::to_string(element) + ']';
+                uniforms.add(elementName, glGetUniformLocation(program, elementName.c_str()));
+            }
+        }
+    }
+}
 
 void Shader::checkShaderError(GLuint target, const std::string& type) {
     int success = 0;
@@ -7,6 +7,7 @@
 
 #include "core.h"
 #include <string>
+#include "uniformTable.h"
 
 /**
  * Shader封装为一个类
@@ -23,19 +24,36 @@ public:
 
     GLuint getProgram() const { return program; } // 获取当前的program
 
+    // uniform的位置, 从链接时反射的表中查找(不调用OpenGL). 不存在时为-1
+    GLint getLocation(const UniformName name) const { return uniforms.find(name); }
+    const UniformTable& getUniforms() const { return uniforms; }
+
     // 设置uniform变量(注意着色器中得先有uniform定义)
-    void setBool(const std::string& name, bool value) const;
-    void setVec3(const std::string& name, float v0, float v1, float v2) const;
-    void setVec3(const std::string& name, const float* values) const;
-    void setVec3(const std::string& name, const glm::vec3& value) const;
-    void setInt(const std::string& name, int value) const;
-    void setFloat(const std::string& name, float value) const;
-    void setMat4(const std::string& name, const glm::mat4& mat) const;
-    void setMat3(const std::string& name, const glm::mat3& mat) const;
+    // 名字是字符串字面量时哈希在编译期算好, 只查一次表; 也可以先用getLocation取得位置, 直接按位置设置
+    void setBool(UniformName name, bool value) const { setBool(getLocation(name), value); }
+    void setVec3(UniformName name, float v0, float v1, float v2) const { setVec3(getLocation(name), v0, v1, v2); }
+    void setVec3(UniformName name, const float* values) const { setVec3(getLocation(name), values); }
+    void setVec3(UniformName name, const glm::vec3& value) const { setVec3(getLocation(name), value); }
+    void setInt(UniformName name, int value) const { setInt(getLocation(name), value); }
+    void setFloat(UniformName name, float value) const { setFloat(getLocation(name), value); }
+    void setMat4(UniformName name, const glm::mat4& mat) const { setMat4(getLocation(name), mat); }
+    void setMat3(UniformName name, const glm::mat3& mat) const { setMat3(getLocation(name), mat); }
+
+    static void setBool(GLint location, bool value);
+    static void setVec3(GLint location, float v0, float v1, float v2);
+    static void setVec3(GLint location, const float* values);
+    static void setVec3(GLint location, const glm::vec3& value);
+    static void setInt(GLint location, int value);
+    static void setFloat(GLint location, float value);
+    static void setMat4(GLint location, const glm::mat4& mat);
+    static void setMat3(GLint location, const glm::mat3& mat);
 private:
     // 对于shader程序, 检查编译错误; 对于program, 检查链接错误
     void checkShaderError(GLuint target, const std::string& type);
+    // 链接后查询所有活动uniform的位置. 数组同时记录"name", "name[0]"和每个元素"name[i]"
+    void reflectUniforms();
     GLuint program{0};
+    UniformTable uniforms;
 };
 
 #endif //SHADER_H
\ No newline at end of file
@@ -0,0 +1,228 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "shaderBenchmark.h"
+#include "benchmarkCheck.h"
+#include "material.h"
+#include "uniformTable.h"
+
+using namespace benchmark;
+
+namespace {
+    // 统计经过它的分配次数, 再转给默认的内存资源. 只对显式使用它的std::pmr容器生效, 不影响程序的其他部分
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        uint64_t allocations{0};
+
+    private:
+        void* do_allocate(const size_t bytes, const size_t alignment) override {
+            allocations++;
+            return std::pmr::get_default_resource()->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* pointer, const size_t bytes, const size_t alignment) override {
+            std::pmr::get_default_resource()->deallocate(pointer, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    // materials着色器中的活动uniform, 再加上模型网格的采样器和一个数组. 位置按顺序编号
+    const std::vector<std::string>& getUniformNames() {
+        static const std::vector<std::string> names = {
+            "model", "viewMatrix", "projectionMatrix", "normalMatrix", "objectColor", "uvScale", "octNormal",
+            "sampler", "useTexture", "lightColor", "lightPosition", "viewPosition",
+            "material.ambient", "material.diffuse", "material.specular", "material.shininess",
+            "lightSource.position", "lightSource.ambient", "lightSource.diffuse", "lightSource.specular",
+            "material.texture_diffuse1", "material.texture_diffuse2", "material.texture_specular1",
+            "bones[0]", "bones[1]", "bones[2]", "bones[3]"
+        };
+        return names;
+    }
+
+    UniformTable makeTable() {
+        UniformTable table;
+        const auto& names = getUniformNames();
+        for (size_t i = 0; i < names.size(); i++) {
+            table.add(names[i], (GLint)i);
+        }
+        return table;
+    }
+
+    // 模拟render中一帧设置的uniform(与main.cpp相同的名字)
+    GLint setFrameUniforms(const UniformTable& table) {
+        GLint sum = 0;
+        sum += table.find("viewMatrix");
+        sum += table.find("projectionMatrix");
+        sum += table.find("lightPosition");
+        sum += table.find("viewPosition");
+        sum += table.find("lightSource.ambient");
+        sum += table.find("lightSource.diffuse");
+        sum += table.find("lightSource.specular");
+        sum += table.find("useTexture");
+        sum += table.find("objectColor");
+        sum += table.find("uvScale");
+        sum += table.find("octNormal");
+        sum += table.find("model");
+        sum += table.find("normalMatrix");
+        sum += table.find("material.ambient");
+        sum += table.find("material.diffuse");
+        sum += table.find("material.specular");
+        sum += table.find("material.shininess");
+        return sum;
+    }
+
+    constexpr int FRAME_UNIFORMS = 17;
+
+    using StringTable = std::unordered_map<std::pmr::string, GLint>;
+
+    // 原来的做法: 每次由字面量构造字符串, 再按字符串查找(驱动中的glGetUniformLocation至少要做这些)
+    // 字符串从resource分配, 用来统计分配次数
+    GLint setFrameUniformsByString(const StringTable& table, std::pmr::memory_resource* resource) {
+        const auto find = [&table, resource](const char* name) {
+            const auto it = table.find(std::pmr::string(name, resource));
+            return it == table.end() ? -1 : it->second;
+        };
+        GLint sum = 0;
+        sum += find("viewMatrix");
+        sum += find("projectionMatrix");
+        sum += find("lightPosition");
+        sum += find("viewPosition");
+        sum += find("lightSource.ambient");
+        sum += find("lightSource.diffuse");
+        sum += find("lightSource.specular");
+        sum += find("useTexture");
+        sum += find("objectColor");
+        sum += find("uvScale");
+        sum += find("octNormal");
+        sum += find("model");
+        sum += find("normalMatrix");
+        sum += find("material.ambient");
+        sum += find("material.diffuse");
+        sum += find("material.specular");
+        sum += find("material.shininess");
+        return sum;
+    }
+
+    // Mesh原来每次绑定纹理时拼接的采样器名字
+    std::pmr::string concatenateSampler(const std::string& type, const unsigned int number,
+                                        std::pmr::memory_resource* resource) {
+        std::pmr::string name("material.", resource);
+        name += type;
+        name += std::to_string(number);
+        return name;
+    }
+
+    volatile GLint sink = 0;
+}
+
+void checkUniformTable() {
+    std::cout << "uniform table:" << std::endl;
+    const UniformTable table = makeTable();
+    const auto& names = getUniformNames();
+    bool allFound = true;
+    for (size_t i = 0; i < names.size(); i++) {
+        allFound = allFound && table.find(names[i]) == (GLint)i;
+    }
+    check(allFound && table.getCount() == names.size(), std::to_string(names.size()) + " uniforms found after growing the table");
+    check(table.find("bones[2]") == 25, "array elements have their own entries");
+    check(table.find("missing") == -1 && table.find("material") == -1, "unknown names return -1");
+    check(UniformName("projectionMatrix").hash == UniformName(std::string("projectionMatrix")).hash,
+          "compile-time and run-time hashes agree");
+    // 字面量在编译期哈希为4字节的值(consteval), 查找只读表. 热路径上的分配次数见benchmark/uniformAllocationBenchmark.cpp
+    constexpr UniformName literal = "viewMatrix";
+    check(std::is_trivially_copyable_v<UniformName> && sizeof(UniformName) == sizeof(uint32_t) &&
+          table.find(literal) == 1, "literal uniform names are compile-time hashes");
+    check(Material::getSamplerUniform("texture_diffuse", 2).hash == UniformName("material.texture_diffuse2").hash
+          && Material::getSamplerUniform("texture_specular", 7).hash == UniformName("material.texture_specular7").hash
+          && Material::getSamplerUniform("texture_normal", 0).hash == UniformName("material.texture_normal").hash,
+          "texture sampler names match the old concatenation");
+    Material::resetStats();
+    sink = sink + table.find(Material::getSamplerUniform("texture_diffuse", 1));
+    sink = sink + table.find(Material::getSamplerUniform("texture_normal", 1));
+    check(Material::getStats().samplerNameConcatenations == 1, "only texture types without a constant are concatenated");
+    Material::resetStats();
+
+    UniformTable updated = makeTable();
+    updated.add("model", 100);
+    check(updated.find("model") == 100 && updated.getCount() == names.size(), "adding a name again updates its location");
+}
+
+void benchmarkUniformLookup() {
+    std::cout << "lookup cost:" << std::endl;
+    const UniformTable table = makeTable();
+    StringTable byString;
+    const auto& names = getUniformNames();
+    for (size_t i = 0; i < names.size(); i++) {
+        byString[std::pmr::string(names[i])] = (GLint)i;
+    }
+    std::vector<GLint> locations;
+    for (const char* name : {"viewMatrix", "projectionMatrix", "lightPosition", "viewPosition", "lightSource.ambient",
+                             "lightSource.diffuse", "lightSource.specular", "useTexture", "objectColor", "uvScale",
+                             "octNormal", "model", "normalMatrix", "material.ambient", "material.diffuse",
+                             "material.specular", "material.shininess"}) {
+        locations.push_back(table.find(std::string(name)));
+    }
+    const std::string diffuse = "texture_diffuse";
+
+    constexpr int frames = 20000;
+    constexpr double perFrame = 1e6 / frames / FRAME_UNIFORMS;
+    CountingResource resource;
+    auto start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        sink = sink + setFrameUniformsByString(byString, &resource);
+    }
+    const double stringMs = elapsedMs(start);
+    const uint64_t stringAllocations = resource.allocations;
+
+    start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        sink = sink + setFrameUniforms(table);
+    }
+    const double hashedMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        GLint sum = 0;
+        for (const GLint location : locations) {
+            sum += location;
+        }
+        sink = sink + sum;
+    }
+    const double locationMs = elapsedMs(start);
+
+    start = Clock::now();
+    for (int draw = 0; draw < frames; draw++) {
+        sink = sink + byString.at(concatenateSampler(diffuse, 1, &resource));
+    }
+    const double oldMeshMs = elapsedMs(start);
+    start = Clock::now();
+    for (int draw = 0; draw < frames; draw++) {
+        sink = sink + table.find(Material::getSamplerUniform(diffuse, 1));
+    }
+    const double meshMs = elapsedMs(start);
+
+    std::cout << "  string lookup:      " << stringMs * perFrame << " ns per uniform (" << stringAllocations / frames
+              << " allocations per frame)" << std::endl;
+    std::cout << "  compile-time hash:  " << hashedMs * perFrame << " ns per uniform" << std::endl;
+    std::cout << "  cached location:    " << locationMs * perFrame << " ns per uniform" << std::endl;
+    std::cout << "  mesh sampler, concatenated: " << oldMeshMs * 1e6 / frames << " ns, hashed: " << meshMs * 1e6 / frames
+              << " ns" << std::endl;
+    check(hashedMs < stringMs, "hashed lookup is cheaper than string lookup");
+}
+
+void runShaderBenchmarks() {
+    beginChecks("shader uniform");
+    checkUniformTable();
+    benchmarkUniformLookup();
+    endChecks();
+}
@@ -0,0 +1,24 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef SHADERBENCHMARK_H
+#define SHADERBENCHMARK_H
+
+/**
+ * uniform位置表的测试, 在窗口中按B键运行. 只测CPU端: 用materials着色器中的uniform名字填一张UniformTable,
+ * 不需要OpenGL上下文
+ */
+
+// 查找结果正确(包括数组元素和不存在的名字), 扩容后不丢条目
+// 热路径(查表, Shader::set*, Material::getSamplerUniform)不分配内存由单独的e3-allocation-benchmark检查,
+// 它替换了全局的operator new, 见benchmark/uniformAllocationBenchmark.cpp
+void checkUniformTable();
+
+// 每次设置uniform的CPU开销: 原来的做法(构造std::string + 按字符串查找, 代替驱动中的glGetUniformLocation),
+// Mesh原来拼接采样器名字, 编译期哈希查表, 以及预先取得的位置
+void benchmarkUniformLookup();
+
+void runShaderBenchmarks();
+
+#endif //SHADERBENCHMARK_H
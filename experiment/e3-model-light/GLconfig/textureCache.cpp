@@ -0,0 +1,255 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <filesystem>
+#include <iostream>
+
+#include "textureCache.h"
+
+//=====================================================================
+//============================TextureHandle============================
+//=====================================================================
+
+TextureHandle::TextureHandle(const TextureHandle& other) : cache(other.cache), entry(other.entry) {
+    if (cache) {
+        cache->addRef(entry);
+    }
+}
+
+TextureHandle::TextureHandle(TextureHandle&& other) noexcept : cache(other.cache), entry(other.entry) {
+    other.cache = nullptr;
+}
+
+TextureHandle& TextureHandle::operator=(TextureHandle other) noexcept {
+    std::swap(cache, other.cache);
+    std::swap(entry, other.entry);
+    return *this;
+}
+
+TextureHandle::~TextureHandle() {
+    if (cache) {
+        cache->release(entry);
+    }
+}
+
+GLuint TextureHandle::getId() const {
+    return cache ? cache->getId(entry) : 0;
+}
+
+//=====================================================================
+//============================TextureCache=============================
+//=====================================================================
+
+TextureCache::TextureCache(UploadBackend& backend, const size_t unusedBudget)
+    : backend(backend), unusedBudget(unusedBudget) {
+}
+
+TextureCache::~TextureCache() {
+    for (const auto& entry : entries) {
+        if (entry && entry->id != 0) {
+            backend.deleteTexture(entry->id);
+        }
+    }
+}
+
+TextureCache* TextureCache::getInstance() {
+    static GLUploadBackend backend;
+    static auto* instance = new TextureCache(backend);
+    return instance;
+}
+
+std::string TextureCache::canonicalPath(const std::string& path) {
+    std::error_code error;
+    // weakly_canonical允许文件不存在(解码时再报错)
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    if (error) {
+        return std::filesystem::path(path).lexically_normal().generic_string();
+    }
+    return canonical.generic_string();
+}
+
+std::string TextureCache::makeKey(const std::string& path, const TextureParams& params) {
+    return path + '|' + std::to_string(params.flipVertically) + ',' + std::to_string(params.desiredChannels) + ','
+           + std::to_string(params.minFilter) + ',' + std::to_string(params.magFilter) + ',' + std::to_string(params.wrap);
+}
+
+TextureHandle TextureCache::acquire(const std::string& path, const TextureParams& params, bool& claimed) {
+    // 规范化路径会访问文件系统, 放在锁外
+    const std::string canonical = canonicalPath(path);
+    std::lock_guard lock(mutex);
+    return acquireLocked(canonical, params, claimed);
+}
+
+TextureHandle TextureCache::acquireLocked(const std::string& path, const TextureParams& params, bool& claimed) {
+    stats.lookups++;
+    std::string key = makeKey(path, params);
+    if (const auto it = lookup.find(key); it != lookup.end()) {
+        stats.hits++;
+        claimed = false;
+        Entry& entry = *entries[it->second];
+        if (entry.refCount++ == 0 && entry.unused) {
+            unused.erase(entry.unusedPosition);
+            unusedBytes -= entry.bytes;
+            entry.unused = false;
+        }
+        return {this, it->second};
+    }
+
+    uint32_t index;
+    if (!freeEntries.empty()) {
+        index = freeEntries.back();
+        freeEntries.pop_back();
+    } else {
+        index = (uint32_t)entries.size();
+        entries.emplace_back();
+    }
+    entries[index] = std::make_unique<Entry>();
+    Entry& entry = *entries[index];
+    entry.key = key;
+    entry.path = path;
+    entry.params = params;
+    entry.refCount = 1;
+    lookup.emplace(std::move(key), index);
+    claimed = true;
+    return {this, index};
+}
+
+void TextureCache::provide(const TextureHandle& handle, DecodedImage image, const bool success) {
+    {
+        std::lock_guard lock(mutex);
+        Entry& entry = *entries[handle.entry];
+        stats.decodes++;
+        if (success) {
+            entry.bytes = image.pixels.size() * 4 / 3;
+            entry.image = std::move(image);
+            entry.state = State::Decoded;
+        } else {
+            entry.state = State::Failed;
+        }
+    }
+    decoded.notify_all();
+}
+
+bool TextureCache::upload(const TextureHandle& handle) {
+    std::lock_guard lock(mutex);
+    Entry& entry = *entries[handle.entry];
+    if (entry.state == State::Decoding) {
+        return false;
+    }
+    uploadLocked(entry);
+    evictLocked(unusedBudget);
+    return true;
+}
+
+void TextureCache::uploadLocked(Entry& entry) {
+    if (entry.state != State::Decoded) {
+        return;
+    }
+    entry.id = backend.createTexture(entry.image, entry.params);
+    entry.image = DecodedImage();
+    entry.state = State::Resident;
+    stats.uploads++;
+    stats.residentTextures++;
+    stats.residentBytes += entry.bytes;
+}
+
+TextureHandle TextureCache::load(const std::string& path, const TextureParams& params) {
+    const std::string canonical = canonicalPath(path);
+    bool claimed;
+    TextureHandle handle;
+    {
+        std::lock_guard lock(mutex);
+        handle = acquireLocked(canonical, params, claimed);
+    }
+    if (claimed) {
+        DecodedImage image;
+        const bool success = Texture::decodeImage(canonical, params, image);
+        provide(handle, std::move(image), success);
+    }
+
+    std::unique_lock lock(mutex);
+    Entry& entry = *entries[handle.entry];
+    decoded.wait(lock, [&entry] { return entry.state != State::Decoding; });
+    uploadLocked(entry);
+    evictLocked(unusedBudget);
+    return handle;
+}
+
+void TextureCache::addRef(const uint32_t index) {
+    std::lock_guard lock(mutex);
+    entries[index]->refCount++;
+}
+
+void TextureCache::release(const uint32_t index) {
+    std::lock_guard lock(mutex);
+    Entry& entry = *entries[index];
+    if (--entry.refCount > 0) {
+        return;
+    }
+    if (entry.state == State::Decoding) {
+        // 认领的线程没有交付就放弃了, 删除表项, 下次acquire重新认领
+        lookup.erase(entry.key);
+        entries[index].reset();
+        freeEntries.push_back(index);
+        return;
+    }
+    entry.unusedPosition = unused.insert(unused.end(), index);
+    entry.unused = true;
+    unusedBytes += entry.bytes;
+}
+
+GLuint TextureCache::getId(const uint32_t index) const {
+    std::lock_guard lock(mutex);
+    return entries[index]->id;
+}
+
+void TextureCache::evictLocked(const size_t budget) {
+    while (!unused.empty() && unusedBytes > budget) {
+        const uint32_t index = unused.front();
+        unused.pop_front();
+        Entry& entry = *entries[index];
+        unusedBytes -= entry.bytes;
+        if (entry.state == State::Resident) {
+            backend.deleteTexture(entry.id);
+            stats.residentTextures--;
+            stats.residentBytes -= entry.bytes;
+        }
+        stats.evictions++;
+        lookup.erase(entry.key);
+        entries[index].reset();
+        freeEntries.push_back(index);
+    }
+}
+
+void TextureCache::trim() {
+    std::lock_guard lock(mutex);
+    // 失败的纹理大小为0, 也一起删除(文件可能已经修复)
+    evictLocked(0);
+    while (!unused.empty()) {
+        const uint32_t index = unused.front();
+        unused.pop_front();
+        lookup.erase(entries[index]->key);
+        entries[index].reset();
+        freeEntries.push_back(index);
+        stats.evictions++;
+    }
+}
+
+void TextureCache::setUnusedBudget(const size_t bytes) {
+    std::lock_guard lock(mutex);
+    unusedBudget = bytes;
+    evictLocked(unusedBudget);
+}
+
+TextureCacheStats TextureCache::getStats() const {
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+void TextureCache::printStats() const {
+    const TextureCacheStats current = getStats();
+    std::cout << "texture cache: " << current.residentTextures << " textures (" << current.residentBytes / 1024
+              << " KB), " << current.lookups << " lookups, " << current.hits << " hits, " << current.decodes
+              << " decodes, " << current.uploads << " uploads, " << current.evictions << " evictions" << std::endl;
+}
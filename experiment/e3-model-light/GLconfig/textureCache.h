@@ -0,0 +1,149 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "uploadBackend.h"
+
+class TextureCache;
+
+struct TextureCacheStats {
+    uint64_t lookups{0};
+    uint64_t hits{0};
+    uint64_t decodes{0};
+    uint64_t uploads{0};
+    uint64_t evictions{0};
+    uint32_t residentTextures{0};
+    // 估算的显存(含MipMap)
+    size_t residentBytes{0};
+};
+
+/**
+ * 缓存中一张纹理的引用. 复制时增加引用计数, 析构时减少. 句柄存在时纹理不会被释放
+ * 只能在TextureCache存活期间使用(全局缓存永不释放)
+ */
+class TextureHandle {
+public:
+    TextureHandle() = default;
+    TextureHandle(const TextureHandle& other);
+    TextureHandle(TextureHandle&& other) noexcept;
+    TextureHandle& operator=(TextureHandle other) noexcept;
+    ~TextureHandle();
+
+    bool isValid() const { return cache != nullptr; }
+    // 纹理对象. 还没有上传或者解码失败时为0
+    GLuint getId() const;
+
+private:
+    friend class TextureCache;
+    TextureHandle(TextureCache* cache, uint32_t entry) : cache(cache), entry(entry) {}
+    TextureCache* cache{nullptr};
+    uint32_t entry{0};
+};
+
+/**
+ * 进程内共享的纹理缓存. 原来每个Model各自按路径去重, 每个Geometry各自new Texture,
+ * 两个模型用到同一张图片, 或者一百个几何体都用wall.jpg时, 图片会被解码和上传多次
+ *  - 键是规范化后的路径(见canonicalPath)加上纹理参数, 哈希表O(1)查找
+ *  - 每张纹理只解码一次, 上传一次. 异步加载时, 第一个acquire到的线程负责解码(claimed), 其他线程只拿句柄
+ *  - 没有句柄引用的纹理留在缓存中, 按最久未使用的顺序排列. 它们的总大小超过预算时从最旧的开始释放
+ *  - 释放纹理需要OpenGL, 所以只在GL线程的调用中进行(load, upload, trim, setUnusedBudget), 句柄析构时不释放
+ * 所有方法都是线程安全的. 标注为GL线程的方法会调用UploadBackend
+ */
+class TextureCache {
+public:
+    explicit TextureCache(UploadBackend& backend, size_t unusedBudget = DEFAULT_UNUSED_BUDGET);
+    // 释放所有纹理. 之后不能再使用它的句柄
+    ~TextureCache();
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // 全局缓存, 使用GLUploadBackend
+    static TextureCache* getInstance();
+
+    // GL线程: 同步加载. 命中时直接返回, 另一个线程正在解码时等待它完成
+    TextureHandle load(const std::string& path, const TextureParams& params = {});
+
+    // 异步加载分三步:
+    //  1. acquire(任意线程): 返回句柄. claimed为true时调用者负责解码, 解码完成后调用provide
+    //  2. provide(任意线程): 交付解码结果, success为false时纹理标记为失败(id为0), 不会再次解码
+    //  3. upload(GL线程): 图像已经解码时上传. 返回纹理是否已经可用(已上传或失败), 否则下一帧再试
+    // 纹理的创建和释放都通过构造时传入的backend, 它必须比缓存存活得更久
+    TextureHandle acquire(const std::string& path, const TextureParams& params, bool& claimed);
+    void provide(const TextureHandle& handle, DecodedImage image, bool success);
+    bool upload(const TextureHandle& handle);
+
+    // GL线程: 释放所有没有引用的纹理
+    void trim();
+    // GL线程: 没有引用的纹理最多保留的字节数
+    void setUnusedBudget(size_t bytes);
+
+    TextureCacheStats getStats() const;
+    void printStats() const;
+
+    // 去掉./, ../和重复的分隔符, 并转换为绝对路径. 同一个文件的不同写法得到相同的键
+    static std::string canonicalPath(const std::string& path);
+
+    static constexpr size_t DEFAULT_UNUSED_BUDGET = 64 * 1024 * 1024;
+
+private:
+    friend class TextureHandle;
+
+    enum class State {
+        Decoding, // 已经被某个线程认领, 还没有provide
+        Decoded,  // 图像在内存中, 等待上传
+        Resident,
+        Failed
+    };
+
+    struct Entry {
+        std::string key;
+        std::string path;
+        TextureParams params;
+        State state{State::Decoding};
+        DecodedImage image;
+        GLuint id{0};
+        size_t bytes{0};
+        uint32_t refCount{0};
+        // 没有引用时在unused中的位置
+        std::list<uint32_t>::iterator unusedPosition;
+        bool unused{false};
+    };
+
+    UploadBackend& backend;
+    mutable std::mutex mutex;
+    std::condition_variable decoded;
+    size_t unusedBudget;
+    size_t unusedBytes{0};
+    std::unordered_map<std::string, uint32_t> lookup;
+    // 表项的地址不变, 删除后的位置放入freeEntries复用
+    std::vector<std::unique_ptr<Entry>> entries;
+    std::vector<uint32_t> freeEntries;
+    // 没有引用的已上传纹理, 最近释放的在末尾
+    std::list<uint32_t> unused;
+    TextureCacheStats stats;
+
+    static std::string makeKey(const std::string& path, const TextureParams& params);
+    // 以下都需要持有锁
+    TextureHandle acquireLocked(const std::string& path, const TextureParams& params, bool& claimed);
+    void uploadLocked(Entry& entry);
+    void evictLocked(size_t budget);
+    void addRef(uint32_t index);
+    void release(uint32_t index);
+    GLuint getId(uint32_t index) const;
+};
+
+#define TEXTURE_CACHE TextureCache::getInstance()
+
+#endif //TEXTURECACHE_H
@@ -0,0 +1,182 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "textureCacheBenchmark.h"
+#include "benchmarkCheck.h"
+#include "textureCache.h"
+
+using namespace benchmark;
+
+namespace {
+    // 测试图片都写在临时目录的texture_cache子目录中
+    std::filesystem::path imagePath(const std::string& name) {
+        return std::filesystem::temp_directory_path() / "texture_cache" / name;
+    }
+
+    // 与Model相同的异步流程: 加载线程中acquire, 认领到的才解码; GL线程中upload直到纹理可用
+    std::vector<TextureHandle> loadModelTextures(TextureCache& cache, const std::vector<std::string>& paths) {
+        std::vector<TextureHandle> handles;
+        for (const auto& path : paths) {
+            bool claimed;
+            handles.push_back(cache.acquire(path, TextureParams::model(), claimed));
+            if (claimed) {
+                DecodedImage image;
+                const bool success = Texture::decodeImage(path, TextureParams::model(), image);
+                cache.provide(handles.back(), std::move(image), success);
+            }
+        }
+        return handles;
+    }
+}
+
+void checkTextureCacheSharing() {
+    std::cout << "sharing:" << std::endl;
+    const std::string wood = writeImage(imagePath("wood.ppm"), 256, 256, 64);
+    const std::string metal = writeImage(imagePath("metal.ppm"), 128, 128, 64);
+    const std::string glass = writeImage(imagePath("glass.ppm"), 64, 64, 64);
+    const std::string wall = writeImage(imagePath("wall.ppm"), 512, 512, 64);
+    // 第二个模型用另一种写法引用同一个文件
+    const std::filesystem::path directory = std::filesystem::path(wood).parent_path();
+    const std::string woodAlias = (directory / "." / ".." / directory.filename() / "wood.ppm").string();
+    const std::string metalAlias = (directory / "./metal.ppm").string();
+
+    NullUploadBackend backend;
+    TextureCache cache(backend);
+    check(TextureCache::canonicalPath(woodAlias) == TextureCache::canonicalPath(wood), "different spellings of a path share one key");
+
+    // 两个模型同时在各自的加载线程中获取纹理
+    std::vector<TextureHandle> first, second;
+    std::thread firstLoader([&] { first = loadModelTextures(cache, {wood, metal, glass}); });
+    std::thread secondLoader([&] { second = loadModelTextures(cache, {woodAlias, metalAlias}); });
+    firstLoader.join();
+    secondLoader.join();
+    // GL线程按模型顺序上传
+    for (const auto& handle : first) {
+        cache.upload(handle);
+    }
+    for (const auto& handle : second) {
+        cache.upload(handle);
+    }
+    TextureCacheStats stats = cache.getStats();
+    check(stats.decodes == 3 && stats.uploads == 3 && backend.textureCount == 3, "two models sharing textures: 3 decodes, 3 uploads for 5 references ("
+          + std::to_string(stats.decodes) + ", " + std::to_string(stats.uploads) + ")");
+    check(first[0].getId() == second[0].getId() && first[1].getId() == second[1].getId() && first[0].getId() != first[1].getId(),
+          "shared references resolve to the same texture object");
+
+    // 一百个几何体加载同一张图片
+    std::vector<TextureHandle> geometries;
+    for (int i = 0; i < 100; i++) {
+        geometries.push_back(cache.load(wall, TextureParams::nearest()));
+    }
+    stats = cache.getStats();
+    check(stats.decodes == 4 && stats.uploads == 4, "100 geometries using wall.ppm: 1 decode, 1 upload");
+    check(stats.hits == 2 + 99, "hits: " + std::to_string(stats.hits) + " of " + std::to_string(stats.lookups) + " lookups");
+
+    // 参数不同是另一张纹理
+    const TextureHandle wallLinear = cache.load(wall, TextureParams::model());
+    check(cache.getStats().uploads == 5 && wallLinear.getId() != geometries[0].getId(), "same image with different sampler params is a separate texture");
+
+    // 解码失败只尝试一次
+    const TextureHandle missing = cache.load(directory.string() + "/missing.ppm");
+    const TextureHandle missingAgain = cache.load(directory.string() + "/missing.ppm");
+    check(missing.getId() == 0 && cache.getStats().decodes == 6, "missing file fails once and stays failed (id 0)");
+    check(backend.deletedTextureCount == 0, "nothing evicted while referenced");
+    cache.printStats();
+}
+
+void checkTextureCacheEviction() {
+    std::cout << "eviction:" << std::endl;
+    // 每张 64*64*3 * 4/3 = 16384 字节
+    std::vector<std::string> paths;
+    for (int i = 0; i < 4; i++) {
+        paths.push_back(writeImage(imagePath("evict" + std::to_string(i) + ".ppm"), 64, 64, 64));
+    }
+    constexpr size_t textureBytes = 64 * 64 * 3 * 4 / 3;
+
+    NullUploadBackend backend;
+    TextureCache cache(backend, 2 * textureBytes);
+    {
+        std::vector<TextureHandle> handles;
+        for (const auto& path : paths) {
+            handles.push_back(cache.load(path));
+        }
+        check(cache.getStats().residentTextures == 4 && backend.deletedTextureCount == 0, "referenced textures stay resident over budget");
+        // 复制的句柄增加引用
+        TextureHandle copy = handles[0];
+        handles.clear();
+        // 按0 1 2 3的顺序释放(0被copy持有, 最后释放)
+        cache.setUnusedBudget(2 * textureBytes);
+        check(cache.getStats().residentTextures == 3 && backend.deletedTextureCount == 1, "unused textures beyond the budget are evicted");
+        check(copy.getId() != 0, "copied handle keeps its texture alive");
+    }
+    // 0也没有引用了. 最久未使用的是2(1已经被淘汰)
+    cache.setUnusedBudget(2 * textureBytes);
+    TextureCacheStats stats = cache.getStats();
+    check(stats.residentTextures == 2 && stats.evictions == 2, "least recently used evicted first");
+    // 3还在缓存中, 命中; 1被淘汰了, 重新解码
+    const uint64_t decodes = stats.decodes;
+    const TextureHandle three = cache.load(paths[3]);
+    check(cache.getStats().decodes == decodes, "cached unused texture is reused without decoding");
+    const TextureHandle one = cache.load(paths[1]);
+    check(cache.getStats().decodes == decodes + 1, "evicted texture is decoded again on next use");
+
+    cache.trim();
+    stats = cache.getStats();
+    check(stats.residentTextures == 2 && three.getId() != 0 && one.getId() != 0, "trim keeps referenced textures");
+    check(backend.deletedTextureCount == stats.evictions, "every eviction deleted its texture object ("
+          + std::to_string(backend.deletedTextureCount) + ")");
+    cache.printStats();
+}
+
+void checkTextureCacheUploadBackend() {
+    std::cout << "upload backend:" << std::endl;
+    const std::string path = writeImage(imagePath("injected.ppm"), 32, 32, 64);
+    NullUploadBackend cacheBackend;
+    TextureCache cache(cacheBackend, 0);
+    {
+        // 与同步加载的Model相同: 上传网格的后端是局部变量, 纹理仍然只通过缓存自己的后端创建
+        auto* modelBackend = new NullUploadBackend();
+        const std::vector<TextureHandle> handles = loadModelTextures(cache, {path});
+        check(cache.upload(handles[0]) && handles[0].getId() != 0, "texture uploaded through the cache's backend");
+        check(cacheBackend.textureCount == 1 && modelBackend->textureCount == 0, "model's backend is not used for textures");
+        delete modelBackend;
+    }
+    // 模型的后端已经销毁. 预算为0, 淘汰时由缓存自己的后端释放
+    cache.trim();
+    check(cacheBackend.deletedTextureCount == 1 && cache.getStats().residentTextures == 0,
+          "texture evicted after the model's backend is gone, deleted by the cache's backend");
+}
+
+void benchmarkTextureCacheLookup() {
+    std::cout << "lookup:" << std::endl;
+    const std::string path = writeImage(imagePath("lookup.ppm"), 16, 16, 64);
+    NullUploadBackend backend;
+    TextureCache cache(backend);
+    const TextureHandle keep = cache.load(path);
+
+    constexpr int count = 10000;
+    const auto start = Clock::now();
+    for (int i = 0; i < count; i++) {
+        const TextureHandle handle = cache.load(path);
+    }
+    const double ms = elapsedMs(start);
+    check(cache.getStats().decodes == 1, "10000 hits, 1 decode");
+    std::cout << "  " << count << " cached loads: " << ms << " ms (" << ms * 1000.0 / count << " us each)" << std::endl;
+}
+
+void runTextureCacheBenchmarks() {
+    beginChecks("texture cache");
+    checkTextureCacheSharing();
+    checkTextureCacheEviction();
+    checkTextureCacheUploadBackend();
+    benchmarkTextureCacheLookup();
+    endChecks();
+}
@@ -0,0 +1,25 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef TEXTURECACHEBENCHMARK_H
+#define TEXTURECACHEBENCHMARK_H
+
+/**
+ * 全局纹理缓存的测试, 在窗口中按B键运行. 使用NullUploadBackend和临时目录中生成的PPM图片
+ * 每个测试使用自己的TextureCache, 不影响全局缓存
+ */
+
+// 两个模型在各自的加载线程中获取同一组纹理(路径写法不同), 一百个几何体同步加载同一张图片:
+// 每张图片只解码一次, 上传一次. 参数不同的同一张图片是不同的纹理
+void checkTextureCacheSharing();
+
+// 引用计数和淘汰: 有引用的纹理不会被释放, 没有引用的超出预算时按最久未使用的顺序释放, 再次加载时重新解码
+void checkTextureCacheEviction();
+
+// 命中时的查找耗时(规范化路径 + 哈希表)
+void benchmarkTextureCacheLookup();
+
+void runTextureCacheBenchmarks();
+
+#endif //TEXTURECACHEBENCHMARK_H
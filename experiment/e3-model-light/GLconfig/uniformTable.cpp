@@ -0,0 +1,58 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <algorithm>
+#include <iostream>
+
+#include "uniformTable.h"
+
+bool UniformTable::add(const std::string& name, const GLint location) {
+    const uint32_t hash = UniformName::hashName(name.data(), name.size());
+    // 只在链接时调用, 条目很少, 直接线性检查
+    for (size_t i = 0; i < hashes.size(); i++) {
+        if (hashes[i] != hash) {
+            continue;
+        }
+        if (names[i] != name) {
+            std::cerr << "ERROR::SHADER::UNIFORM_HASH_COLLISION: " << names[i] << " and " << name << std::endl;
+            return false;
+        }
+        locations[i] = location;
+        insert(hash, location);
+        return true;
+    }
+    names.push_back(name);
+    hashes.push_back(hash);
+    locations.push_back(location);
+    if (slots.size() < names.size() * 2) {
+        rehash(std::max<size_t>(16, slots.size() * 2));
+    } else {
+        insert(hash, location);
+    }
+    return true;
+}
+
+void UniformTable::clear() {
+    slots.clear();
+    names.clear();
+    hashes.clear();
+    locations.clear();
+}
+
+void UniformTable::rehash(const size_t capacity) {
+    slots.assign(capacity, Slot());
+    for (size_t i = 0; i < hashes.size(); i++) {
+        insert(hashes[i], locations[i]);
+    }
+}
+
+void UniformTable::insert(const uint32_t hash, const GLint location) {
+    const uint32_t mask = (uint32_t)slots.size() - 1;
+    uint32_t i = hash & mask;
+    while (slots[i].hash != 0 && slots[i].hash != hash) {
+        i = (i + 1) & mask;
+    }
+    slots[i].hash = hash;
+    slots[i].location = location;
+}
@@ -0,0 +1,80 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef UNIFORMTABLE_H
+#define UNIFORMTABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core.h"
+
+/**
+ * uniform名字的哈希(32位FNV-1a). 字符串字面量在编译期计算(consteval), 调用setter时既不构造std::string也不计算哈希;
+ * 运行时拼出来的std::string也可以使用, 在运行时计算
+ */
+struct UniformName {
+    uint32_t hash;
+
+    template <size_t N>
+    consteval UniformName(const char (&name)[N]) : hash(hashName(name, N - 1)) {}
+    UniformName(const std::string& name) : hash(hashName(name.data(), name.size())) {}
+
+    // 0表示空槽, 哈希为0的名字映射为1
+    static constexpr uint32_t hashName(const char* name, const size_t length) {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < length; i++) {
+            hash = (hash ^ (uint8_t)name[i]) * 16777619u;
+        }
+        return hash == 0 ? 1 : hash;
+    }
+};
+
+/**
+ * 着色器中所有活动uniform的位置表: 链接后一次性反射(见Shader), 之后按名字的哈希查找, 不再调用glGetUniformLocation
+ * 开放寻址(线性探测), 容量是2的幂并且至少是条目数的两倍. 只比较哈希, 所以添加时检查活动uniform之间没有哈希冲突;
+ * 不在表中的名字返回-1(与glGetUniformLocation相同, glUniform*会忽略它)
+ */
+class UniformTable {
+public:
+    // 名字相同时覆盖. 与已有的另一个名字哈希冲突时打印错误并返回false
+    bool add(const std::string& name, GLint location);
+    void clear();
+
+    GLint find(const UniformName name) const {
+        if (slots.empty()) {
+            return -1;
+        }
+        const uint32_t mask = (uint32_t)slots.size() - 1;
+        for (uint32_t i = name.hash & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            if (slot.hash == name.hash) {
+                return slot.location;
+            }
+            if (slot.hash == 0) {
+                return -1;
+            }
+        }
+    }
+
+    size_t getCount() const { return names.size(); }
+    const std::vector<std::string>& getNames() const { return names; }
+
+private:
+    struct Slot {
+        uint32_t hash{0};
+        GLint location{-1};
+    };
+    std::vector<Slot> slots;
+    // 按添加顺序的条目, 用于冲突检查, 扩容和打印
+    std::vector<std::string> names;
+    std::vector<uint32_t> hashes;
+    std::vector<GLint> locations;
+
+    void rehash(size_t capacity);
+    void insert(uint32_t hash, GLint location);
+};
+
+#endif //UNIFORMTABLE_H
@@ -0,0 +1,63 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <thread>
+
+#include "uploadBackend.h"
+#include "vertexQuantizer.h"
+
+GLuint GLUploadBackend::createTexture(const DecodedImage& image, const TextureParams& params) {
+    return Texture::createFromImage(image, params);
+}
+
+void GLUploadBackend::deleteTexture(const GLuint texture) {
+    glDeleteTextures(1, &texture);
+}
+
+ArenaMesh GLUploadBackend::uploadMesh(const MeshView& view) {
+    return Mesh::upload(view);
+}
+
+void NullUploadBackend::simulateCost() const {
+    if (uploadCostMs > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(uploadCostMs));
+    }
+}
+
+GLuint NullUploadBackend::createTexture(const DecodedImage& image, const TextureParams& /*params*/) {
+    simulateCost();
+    uploadedBytes += image.pixels.size();
+    return ++textureCount;
+}
+
+void NullUploadBackend::deleteTexture(const GLuint texture) {
+    // 与glDeleteTextures相同, 0被忽略
+    if (texture != 0) {
+        deletedTextureCount++;
+    }
+}
+
+ArenaMesh NullUploadBackend::uploadMesh(const MeshView& view) {
+    simulateCost();
+    meshCount++;
+    ArenaMesh mesh;
+    mesh.vertexCount = view.vertexCount;
+    if (view.shortIndices) {
+        // 打包好的模型: 16位索引直接上传
+        mesh.indexCount = view.shortIndexCount;
+        mesh.levels = view.levelDraws;
+        uploadedBytes += (size_t)view.shortIndexCount * sizeof(GLushort);
+    } else {
+        for (const IndexSpan& level : Mesh::getIndexSpans(view)) {
+            mesh.indexCount += (uint32_t)level.count;
+            uploadedBytes += level.count * sizeof(unsigned int);
+        }
+        mesh.levels.resize(view.lods.size() + 1);
+    }
+    mesh.quantization = view.quantizedVertices ? view.quantization
+                                               : VertexQuantizer::computeQuantization(view.vertices, view.vertexCount);
+    uploadedBytes += (size_t)view.vertexCount * sizeof(QuantizedVertex);
+    return mesh;
+}
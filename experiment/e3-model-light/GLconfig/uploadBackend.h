@@ -0,0 +1,54 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef UPLOADBACKEND_H
+#define UPLOADBACKEND_H
+
+#include <cstdint>
+
+#include "mesh.h"
+#include "Texture.h"
+
+/**
+ * GPU上传的接口. 资源的上传步骤只通过它创建GPU对象, 测试时换成NullUploadBackend就不需要OpenGL上下文
+ */
+class UploadBackend {
+public:
+    virtual ~UploadBackend() = default;
+    virtual GLuint createTexture(const DecodedImage& image, const TextureParams& params) = 0;
+    virtual void deleteTexture(GLuint texture) = 0;
+    // 上传网格的顶点(量化后, 见Mesh::upload)和所有LOD的索引(见Mesh::getIndexSpans, 打包好的模型是切分好的16位索引)
+    virtual ArenaMesh uploadMesh(const MeshView& view) = 0;
+};
+
+// 真正的OpenGL上传: 纹理见Texture::createFromImage, 网格上传到Mesh::getArena()
+class GLUploadBackend : public UploadBackend {
+public:
+    GLuint createTexture(const DecodedImage& image, const TextureParams& params) override;
+    void deleteTexture(GLuint texture) override;
+    ArenaMesh uploadMesh(const MeshView& view) override;
+};
+
+/**
+ * 不调用OpenGL, 只统计上传的次数和字节数. 纹理返回递增的假ID(从1开始), 网格没有分配(句柄无效, 绘制时被跳过)
+ * uploadCostMs: 每次上传模拟的耗时, 用来测试每帧的时间预算
+ */
+class NullUploadBackend : public UploadBackend {
+public:
+    explicit NullUploadBackend(const double uploadCostMs = 0.0) : uploadCostMs(uploadCostMs) {}
+    GLuint createTexture(const DecodedImage& image, const TextureParams& params) override;
+    void deleteTexture(GLuint texture) override;
+    ArenaMesh uploadMesh(const MeshView& view) override;
+
+    uint32_t textureCount{0};
+    uint32_t deletedTextureCount{0};
+    uint32_t meshCount{0};
+    size_t uploadedBytes{0};
+
+private:
+    double uploadCostMs;
+    void simulateCost() const;
+};
+
+#endif //UPLOADBACKEND_H
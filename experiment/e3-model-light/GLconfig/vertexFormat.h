@@ -0,0 +1,142 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef VERTEXFORMAT_H
+#define VERTEXFORMAT_H
+
+#include <cstdint>
+#include <cmath>
+
+#include "core.h"
+#include <glm/gtc/packing.hpp>
+
+/**
+ * 几何体使用的交错(interleaved)紧凑顶点格式. 所有属性放在同一个VBO中, 按顶点依次排列
+ *  - 位置: 3 * float, 12字节
+ *  - 法线: 八面体编码后的2 * snorm16, 4字节
+ *  - uv: 2 * unorm16, 4字节. 超出[0, 1]的uv先除以uvScale再存, 着色器中乘回来
+ * 共20字节. 原来分开存放的位置 + 颜色 + uv + 法线全用float需要44字节
+ * 颜色不再逐顶点存储, 直接使用材质颜色(uniform objectColor)
+ */
+struct PackedVertex {
+    glm::vec3 position;
+    int16_t normal[2];
+    uint16_t uv[2];
+};
+static_assert(sizeof(PackedVertex) == 20, "PackedVertex应当紧密排列为20字节");
+
+// 原来每个顶点的字节数: 位置3 + 颜色3 + uv2 + 法线3个float
+constexpr size_t UNPACKED_VERTEX_SIZE = (3 + 3 + 2 + 3) * sizeof(float);
+
+// 有符号归一化整数. 与OpenGL的snorm规则一致: c / 32767, 并截断到-1
+inline int16_t packSnorm16(const float v) {
+    return (int16_t)std::round(glm::clamp(v, -1.0f, 1.0f) * 32767.0f);
+}
+inline float unpackSnorm16(const int16_t c) {
+    return glm::max((float)c / 32767.0f, -1.0f);
+}
+// 无符号归一化整数: c / 65535
+inline uint16_t packUnorm16(const float v) {
+    return (uint16_t)std::round(glm::clamp(v, 0.0f, 1.0f) * 65535.0f);
+}
+inline float unpackUnorm16(const uint16_t c) {
+    return (float)c / 65535.0f;
+}
+
+// 取符号, 0按正数处理(八面体编码的折叠需要)
+inline glm::vec2 signNotZero(const glm::vec2 v) {
+    return {v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f};
+}
+
+/**
+ * 八面体编码: 把单位球面投影到八面体|x| + |y| + |z| = 1上, 再把下半部分折叠到上半部分,
+ * 得到[-1, 1]^2正方形中的一个点. 只需要两个分量就能表示一个方向
+ */
+inline glm::vec2 octEncode(const glm::vec3& n) {
+    glm::vec2 p = glm::vec2(n.x, n.y) * (1.0f / (std::abs(n.x) + std::abs(n.y) + std::abs(n.z)));
+    if (n.z < 0.0f) {
+        p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * signNotZero(p);
+    }
+    return p;
+}
+// 八面体解码. 着色器中有同样的实现(见assets/shader/lightMap/vertex.glsl)
+inline glm::vec3 octDecode(const glm::vec2 e) {
+    glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    if (n.z < 0.0f) {
+        const glm::vec2 xy = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * signNotZero(glm::vec2(n.x, n.y));
+        n.x = xy.x;
+        n.y = xy.y;
+    }
+    return glm::normalize(n);
+}
+
+// 把一个顶点压缩为PackedVertex. uvScale: uv分量的最大值, uv会先除以它再量化
+inline PackedVertex packVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv, const float uvScale = 1.0f) {
+    PackedVertex v{};
+    v.position = position;
+    const glm::vec2 oct = octEncode(normal);
+    v.normal[0] = packSnorm16(oct.x);
+    v.normal[1] = packSnorm16(oct.y);
+    v.uv[0] = packUnorm16(uv.x / uvScale);
+    v.uv[1] = packUnorm16(uv.y / uvScale);
+    return v;
+}
+// 还原顶点, 与着色器中的解码一致. 用于在CPU上检查量化误差
+inline void unpackVertex(const PackedVertex& v, const float uvScale, glm::vec3& normal, glm::vec2& uv) {
+    normal = octDecode(glm::vec2(unpackSnorm16(v.normal[0]), unpackSnorm16(v.normal[1])));
+    uv = glm::vec2(unpackUnorm16(v.uv[0]), unpackUnorm16(v.uv[1])) * uvScale;
+}
+
+/**
+ * 模型网格使用的量化顶点格式, 12字节. 导入时的Vertex是8个float, 32字节
+ *  - 位置: 3 * unorm16, 相对于网格(一次上传的分配)的包围盒, 着色器中position = positionOffset + aPos * positionScale
+ *  - 法线: 八面体编码后的2 * snorm8
+ *  - uv: 2 * 半精度浮点数. 模型的uv可能超出[0, 1](重复的纹理), 不需要像几何体那样先除以uvScale
+ * 法线的偏移是6, 只按2字节对齐. OpenGL对顶点属性的偏移没有对齐的要求
+ */
+struct QuantizedVertex {
+    uint16_t position[3];
+    int8_t normal[2];
+    uint16_t uv[2];
+};
+static_assert(sizeof(QuantizedVertex) == 12, "QuantizedVertex应当紧密排列为12字节");
+
+// 位置的反量化参数: position = offset + unorm * scale. offset是包围盒的最小点, scale是包围盒的尺寸
+struct VertexQuantization {
+    glm::vec3 offset{0.0f};
+    glm::vec3 scale{1.0f};
+};
+
+inline int8_t packSnorm8(const float v) {
+    return (int8_t)std::round(glm::clamp(v, -1.0f, 1.0f) * 127.0f);
+}
+inline float unpackSnorm8(const int8_t c) {
+    return glm::max((float)c / 127.0f, -1.0f);
+}
+
+inline QuantizedVertex quantizeVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& uv,
+                                      const VertexQuantization& quantization) {
+    QuantizedVertex v{};
+    for (int i = 0; i < 3; i++) {
+        // 包围盒在这个轴上没有厚度(平面网格)时, 所有顶点都在offset上
+        const float scale = quantization.scale[i];
+        v.position[i] = scale > 0.0f ? packUnorm16((position[i] - quantization.offset[i]) / scale) : 0;
+    }
+    const glm::vec2 oct = octEncode(normal);
+    v.normal[0] = packSnorm8(oct.x);
+    v.normal[1] = packSnorm8(oct.y);
+    v.uv[0] = (uint16_t)glm::packHalf1x16(uv.x);
+    v.uv[1] = (uint16_t)glm::packHalf1x16(uv.y);
+    return v;
+}
+// 还原顶点, 与着色器中的解码一致. 用于在CPU上测量量化误差
+inline void dequantizeVertex(const QuantizedVertex& v, const VertexQuantization& quantization, glm::vec3& position,
+                             glm::vec3& normal, glm::vec2& uv) {
+    position = quantization.offset + glm::vec3(unpackUnorm16(v.position[0]), unpackUnorm16(v.position[1]),
+                                               unpackUnorm16(v.position[2])) * quantization.scale;
+    normal = octDecode(glm::vec2(unpackSnorm8(v.normal[0]), unpackSnorm8(v.normal[1])));
+    uv = glm::vec2(glm::unpackHalf1x16(v.uv[0]), glm::unpackHalf1x16(v.uv[1]));
+}
+
+#endif //VERTEXFORMAT_H
@@ -0,0 +1,264 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "vertexQuantizationBenchmark.h"
+#include "benchmarkCheck.h"
+#include "meshGenerator.h"
+#include "meshOptimizer.h"
+#include "modelPacker.h"
+#include "uploadBackend.h"
+#include "vertexQuantizer.h"
+
+using namespace benchmark;
+
+namespace {
+    // 生成的网格转换为模型使用的Vertex(与导入的网格相同的格式)
+    std::vector<Vertex> toVertices(const GeneratedMesh& mesh) {
+        std::vector<Vertex> vertices(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            vertices[i].position = mesh.vertices[i].position;
+            unpackVertex(mesh.vertices[i], mesh.uvScale, vertices[i].normal, vertices[i].uv);
+        }
+        return vertices;
+    }
+
+    // 展开为三角形汤: 每个角一个顶点, 相当于没有JoinIdenticalVertices时assimp导入的OBJ
+    std::vector<Vertex> toSoup(const std::vector<Vertex>& vertices, const std::vector<GLuint>& indices,
+                               std::vector<unsigned int>& soupIndices) {
+        std::vector<Vertex> soup;
+        soup.reserve(indices.size());
+        soupIndices.clear();
+        for (const GLuint index : indices) {
+            soupIndices.push_back((unsigned int)soup.size());
+            soup.push_back(vertices[index]);
+        }
+        return soup;
+    }
+
+    // 每个角的顶点与三角形汤中的逐字节相同
+    bool sameCorners(const std::vector<Vertex>& soup, const std::vector<Vertex>& vertices,
+                     const std::vector<unsigned int>& indices) {
+        if (indices.size() != soup.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < indices.size(); i++) {
+            if (indices[i] >= vertices.size() || std::memcmp(&vertices[indices[i]], &soup[i], sizeof(Vertex)) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 20字节几何体顶点(PackedVertex)中snorm16八面体法线的误差上界. 量化步长为1/32767, 实测约0.003度
+    constexpr float PACKED_NORMAL_ERROR_BOUND_DEGREES = 0.01f;
+
+    QuantizationReport quantizeAndMeasure(const std::vector<Vertex>& vertices) {
+        std::vector<QuantizedVertex> quantized;
+        const VertexQuantization quantization =
+            VertexQuantizer::quantize(vertices.data(), (uint32_t)vertices.size(), quantized);
+        return VertexQuantizer::measure(vertices.data(), quantized.data(), (uint32_t)vertices.size(), quantization);
+    }
+}
+
+void checkVertexWelding() {
+    std::cout << "welding:" << std::endl;
+    for (const auto& [name, mesh] : {std::make_pair("box", MeshGenerator::box(1.0f, 2.0f, 3.0f, 2)),
+                                     std::make_pair("sphere", MeshGenerator::sphere(1.0f, 24, 32))}) {
+        const std::vector<Vertex> original = toVertices(mesh);
+        std::vector<unsigned int> indices;
+        const std::vector<Vertex> soup = toSoup(original, mesh.indices, indices);
+        std::vector<Vertex> welded = soup;
+        const uint32_t count = MeshOptimizer::weldVertices(welded, indices);
+
+        // 生成器的顶点没有重复, 合并后的顶点数应当与它相同
+        std::vector<Vertex> reference = original;
+        std::vector<unsigned int> referenceIndices(mesh.indices.begin(), mesh.indices.end());
+        const uint32_t referenceCount = MeshOptimizer::weldVertices(reference, referenceIndices);
+        std::cout << "  " << name << ": " << soup.size() << " corners -> " << count << " vertices (generated "
+                  << original.size() << ")" << std::endl;
+        check(count == welded.size() && count == referenceCount && referenceCount == original.size(),
+              std::string(name) + " soup welds back to the indexed vertex count");
+        check(sameCorners(soup, welded, indices), std::string(name) + " every triangle corner keeps its vertex");
+
+        const std::vector<unsigned int> before = indices;
+        check(MeshOptimizer::weldVertices(welded, indices) == count && indices == before,
+              std::string(name) + " welding again changes nothing");
+    }
+
+    // 位置相同但法线或uv不同的顶点(硬边, uv接缝)必须保留
+    std::vector<Vertex> vertices(4);
+    vertices[1].normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    vertices[2].uv = glm::vec2(1.0f, 0.0f);
+    std::vector<unsigned int> indices = {0, 1, 2, 3, 2, 1};
+    const uint32_t count = MeshOptimizer::weldVertices(vertices, indices);
+    check(count == 3 && indices == std::vector<unsigned int>({0, 1, 2, 0, 2, 1}),
+          "vertices differing only in normal or uv are kept apart");
+}
+
+void checkPackedVertexFormat() {
+    std::cout << "packed vertex:" << std::endl;
+    // snorm16八面体法线往返: 在单位球面上密集采样(包括两极和z = 0的折叠边界)
+    float maxNormalError = 0.0f;
+    for (int i = 0; i <= 256; i++) {
+        for (int j = 0; j < 512; j++) {
+            const float theta = glm::pi<float>() * (float)i / 256.0f;
+            const float phi = glm::two_pi<float>() * (float)j / 512.0f;
+            const glm::vec3 normal(std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+            glm::vec3 decoded;
+            glm::vec2 uv;
+            unpackVertex(packVertex(glm::vec3(0.0f), normal, glm::vec2(0.0f)), 1.0f, decoded, uv);
+            // 误差只有千分之几度, acos在1附近的float精度不够, 用atan2(|a x b|, a · b)
+            const float angle = std::atan2(glm::length(glm::cross(decoded, normal)), glm::dot(decoded, normal));
+            maxNormalError = glm::max(maxNormalError, glm::degrees(angle));
+        }
+    }
+    std::cout << "  snorm16 octahedral normals: max error " << maxNormalError << " deg" << std::endl;
+    check(maxNormalError <= PACKED_NORMAL_ERROR_BOUND_DEGREES, "packed normal error bound holds on the sphere");
+
+    // uv先除以uvScale再量化为unorm16, 还原的误差不超过半个量化步长乘以uvScale
+    bool uvWithinBound = true;
+    bool positionExact = true;
+    for (const float uvScale : {1.0f, 4.0f, 16.0f, 100.0f}) {
+        float maxUvError = 0.0f;
+        for (int i = 0; i <= 1000; i++) {
+            const glm::vec2 uv((float)i / 1000.0f * uvScale, (float)(1000 - i) / 1000.0f * uvScale);
+            const glm::vec3 position((float)i * 0.37f, -1.5f, 1e4f);
+            const PackedVertex v = packVertex(position, glm::vec3(0.0f, 1.0f, 0.0f), uv, uvScale);
+            glm::vec3 normal;
+            glm::vec2 decoded;
+            unpackVertex(v, uvScale, normal, decoded);
+            const glm::vec2 error = glm::abs(decoded - uv);
+            maxUvError = glm::max(maxUvError, glm::max(error.x, error.y));
+            positionExact = positionExact && v.position == position;
+        }
+        // 半个量化步长, 另外留一点float舍入的余量
+        const float bound = 0.5f / 65535.0f * uvScale * 1.01f;
+        std::cout << "  uvScale " << uvScale << ": max uv error " << maxUvError << " (bound " << bound << ")" << std::endl;
+        uvWithinBound = uvWithinBound && maxUvError <= bound;
+    }
+    check(uvWithinBound, "uv error within half a unorm16 step times uvScale");
+    check(positionExact, "positions are stored as float and round-trip exactly");
+}
+
+void checkVertexQuantization() {
+    std::cout << "quantization:" << std::endl;
+    // 八面体编码的snorm8法线: 在单位球面上密集采样, 误差不超过上界
+    float maxNormalError = 0.0f;
+    for (int i = 0; i < 256; i++) {
+        for (int j = 0; j < 512; j++) {
+            const float theta = glm::pi<float>() * ((float)i + 0.5f) / 256.0f;
+            const float phi = glm::two_pi<float>() * (float)j / 512.0f;
+            const glm::vec3 normal(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            const QuantizedVertex v = quantizeVertex(glm::vec3(0.0f), normal, glm::vec2(0.0f), VertexQuantization());
+            const glm::vec3 decoded = octDecode(glm::vec2(unpackSnorm8(v.normal[0]), unpackSnorm8(v.normal[1])));
+            const float cosine = glm::clamp(glm::dot(decoded, normal), -1.0f, 1.0f);
+            maxNormalError = glm::max(maxNormalError, glm::degrees(std::acos(cosine)));
+        }
+    }
+    std::cout << "  snorm8 octahedral normals: max error " << maxNormalError << " deg" << std::endl;
+    check(maxNormalError <= QuantizationReport::NORMAL_ERROR_BOUND_DEGREES, "normal error bound holds on the sphere");
+
+    // 远离原点的网格: 位置相对于包围盒量化, 误差只与网格本身的尺寸有关
+    GeneratedMesh shifted = MeshGenerator::sphere(2.0f, 48, 64);
+    for (auto& vertex : shifted.vertices) {
+        vertex.position += glm::vec3(1000.0f, -250.0f, 40.0f);
+    }
+    for (const auto& [name, mesh] : {std::make_pair("sphere", MeshGenerator::sphere(1.0f, 48, 64)),
+                                     std::make_pair("torus", MeshGenerator::torus(3.0f, 0.5f, 48, 24)),
+                                     std::make_pair("box", MeshGenerator::box(10.0f, 1.0f, 0.1f, 4)),
+                                     std::make_pair("shifted sphere", shifted)}) {
+        const QuantizationReport report = quantizeAndMeasure(toVertices(mesh));
+        report.print(name);
+        check(report.isWithinBounds(), std::string(name) + " quantization error within bounds");
+    }
+
+    // 平面网格的包围盒在y轴上没有厚度, 不能除以0
+    const std::vector<Vertex> plane = toVertices(MeshGenerator::plane(4.0f, 4.0f, 4, 4));
+    std::vector<QuantizedVertex> quantized;
+    const VertexQuantization quantization = VertexQuantizer::quantize(plane.data(), (uint32_t)plane.size(), quantized);
+    bool finite = true;
+    for (const QuantizedVertex& v : quantized) {
+        glm::vec3 position, normal;
+        glm::vec2 uv;
+        dequantizeVertex(v, quantization, position, normal, uv);
+        finite = finite && !glm::any(glm::isnan(position)) && !glm::any(glm::isnan(normal));
+    }
+    const QuantizationReport planeReport =
+        VertexQuantizer::measure(plane.data(), quantized.data(), (uint32_t)plane.size(), quantization);
+    check(quantization.scale.y == 0.0f && finite && planeReport.isWithinBounds(), "flat plane quantizes without NaN");
+
+    // 打包的模型在工作线程中量化, 上传时视图带着量化后的顶点, 上传后端记录反量化参数
+    const std::vector<Vertex> box = toVertices(MeshGenerator::box(1.0f, 1.0f, 1.0f));
+    const std::vector<unsigned int> boxIndices = {0, 1, 2};
+    std::vector<Vertex> far = box;
+    for (auto& vertex : far) {
+        vertex.position += glm::vec3(5.0f, 0.0f, 0.0f);
+    }
+    MeshView a, b;
+    a.vertices = box.data();
+    a.vertexCount = (uint32_t)box.size();
+    a.indices = boxIndices.data();
+    a.indexCount = (uint32_t)boxIndices.size();
+    b = a;
+    b.vertices = far.data();
+    const PackedModel packed = ModelPacker::pack({a, b}, {0, 1});
+    const MeshView view = packed.view();
+    NullUploadBackend backend;
+    const ArenaMesh uploaded = backend.uploadMesh(view);
+    check(view.quantizedVertices == packed.quantized.data() && packed.quantized.size() == packed.vertices.size() &&
+          packed.quantization.offset == glm::vec3(-0.5f) && packed.quantization.scale == glm::vec3(6.0f, 1.0f, 1.0f),
+          "packed model is quantized against the whole model's bounds");
+    check(uploaded.quantization.offset == packed.quantization.offset &&
+          uploaded.quantization.scale == packed.quantization.scale &&
+          backend.uploadedBytes == packed.vertices.size() * sizeof(QuantizedVertex) + 6 * sizeof(GLushort),
+          "upload backend keeps the dequantization parameters");
+}
+
+void benchmarkVertexQuantization() {
+    std::cout << "benchmark:" << std::endl;
+    // 约50万个角的三角形汤
+    const GeneratedMesh mesh = MeshGenerator::sphere(1.0f, 256, 512);
+    const std::vector<Vertex> original = toVertices(mesh);
+    std::vector<unsigned int> indices;
+    std::vector<Vertex> vertices = toSoup(original, mesh.indices, indices);
+    const size_t corners = vertices.size();
+
+    auto start = Clock::now();
+    const uint32_t welded = MeshOptimizer::weldVertices(vertices, indices);
+    const double weldMs = elapsedMs(start);
+
+    start = Clock::now();
+    std::vector<QuantizedVertex> quantized;
+    const VertexQuantization quantization =
+        VertexQuantizer::quantize(vertices.data(), (uint32_t)vertices.size(), quantized);
+    const double quantizeMs = elapsedMs(start);
+    const QuantizationReport report =
+        VertexQuantizer::measure(vertices.data(), quantized.data(), (uint32_t)vertices.size(), quantization);
+
+    const size_t soupBytes = corners * sizeof(Vertex);
+    std::cout << "  welded " << corners << " corners into " << welded << " vertices in " << weldMs
+              << " ms, quantized in " << quantizeMs << " ms" << std::endl;
+    std::cout << "  vertex memory: soup " << soupBytes << " bytes, welded " << report.floatBytes << " bytes, quantized "
+              << report.quantizedBytes << " bytes (" << (double)report.floatBytes / (double)report.quantizedBytes
+              << "x smaller than welded)" << std::endl;
+    check(welded == original.size(), "imported soup welds to the indexed vertex count");
+    check(report.quantizedBytes * 2 <= report.floatBytes, "quantized vertices take at most half the memory");
+    check(report.isWithinBounds(), "quantization error within bounds");
+}
+
+void runVertexQuantizationBenchmarks() {
+    beginChecks("vertex quantization");
+    checkVertexWelding();
+    checkPackedVertexFormat();
+    checkVertexQuantization();
+    benchmarkVertexQuantization();
+    endChecks();
+}
@@ -0,0 +1,27 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef VERTEXQUANTIZATIONBENCHMARK_H
+#define VERTEXQUANTIZATIONBENCHMARK_H
+
+/**
+ * 顶点合并和顶点量化的测试, 在窗口中按B键运行. 只处理CPU上的数据, 不需要OpenGL上下文
+ * 量化的误差按着色器的方式在CPU上还原后测量(见VertexQuantizer::measure)
+ */
+
+// 三角形汤合并后顶点数与原来的索引网格相同, 每个三角形的顶点不变; 只差法线或uv的顶点不合并; 合并是幂等的
+void checkVertexWelding();
+
+// 几何体的20字节顶点(PackedVertex)往返: snorm16八面体法线在整个球面上的角度误差, uv相对uvScale的误差
+void checkPackedVertexFormat();
+
+// 几种生成的网格量化后误差不超过上界; 平面网格(包围盒没有厚度)不产生NaN; 打包的模型和上传后端带着反量化参数
+void checkVertexQuantization();
+
+// 导入的三角形汤合并的耗时, 量化的耗时, 以及顶点内存的变化
+void benchmarkVertexQuantization();
+
+void runVertexQuantizationBenchmarks();
+
+#endif //VERTEXQUANTIZATIONBENCHMARK_H
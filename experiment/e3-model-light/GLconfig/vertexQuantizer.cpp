@@ -0,0 +1,74 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <iostream>
+
+#include "vertexQuantizer.h"
+
+bool QuantizationReport::isWithinBounds() const {
+    // 允许float计算本身的舍入误差
+    return maxPositionError <= positionErrorBound * 1.001f + 1e-6f &&
+           maxNormalErrorDegrees <= NORMAL_ERROR_BOUND_DEGREES && maxUvError <= uvErrorBound * 1.001f + 1e-7f;
+}
+
+void QuantizationReport::print(const std::string& name) const {
+    std::cout << "quantized " << name << ": " << vertexCount << " vertices, " << floatBytes << " -> " << quantizedBytes
+              << " bytes, position error " << maxPositionError << " (bound " << positionErrorBound << "), normal error "
+              << maxNormalErrorDegrees << " deg (bound " << NORMAL_ERROR_BOUND_DEGREES << "), uv error " << maxUvError
+              << " (bound " << uvErrorBound << ")" << (isWithinBounds() ? "" : " EXCEEDS BOUNDS") << std::endl;
+}
+
+VertexQuantization VertexQuantizer::computeQuantization(const Vertex* vertices, const uint32_t count) {
+    VertexQuantization quantization;
+    if (count == 0) {
+        return quantization;
+    }
+    glm::vec3 minPosition = vertices[0].position, maxPosition = vertices[0].position;
+    for (uint32_t i = 1; i < count; i++) {
+        minPosition = glm::min(minPosition, vertices[i].position);
+        maxPosition = glm::max(maxPosition, vertices[i].position);
+    }
+    quantization.offset = minPosition;
+    quantization.scale = maxPosition - minPosition;
+    return quantization;
+}
+
+VertexQuantization VertexQuantizer::quantize(const Vertex* vertices, const uint32_t count,
+                                             std::vector<QuantizedVertex>& quantized) {
+    const VertexQuantization quantization = computeQuantization(vertices, count);
+    quantized.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        quantized[i] = quantizeVertex(vertices[i].position, vertices[i].normal, vertices[i].uv, quantization);
+    }
+    return quantization;
+}
+
+QuantizationReport VertexQuantizer::measure(const Vertex* vertices, const QuantizedVertex* quantized,
+                                            const uint32_t count, const VertexQuantization& quantization) {
+    QuantizationReport report;
+    report.vertexCount = count;
+    report.floatBytes = (size_t)count * sizeof(Vertex);
+    report.quantizedBytes = (size_t)count * sizeof(QuantizedVertex);
+    report.positionErrorBound = glm::length(quantization.scale * (0.5f / 65535.0f));
+    float maxUv = 0.0f;
+    float minCos = 1.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        glm::vec3 position, normal;
+        glm::vec2 uv;
+        dequantizeVertex(quantized[i], quantization, position, normal, uv);
+        const Vertex& original = vertices[i];
+        report.maxPositionError = glm::max(report.maxPositionError, glm::length(position - original.position));
+        // 没有法线(长度为0)的顶点不参与比较
+        const float length = glm::length(original.normal);
+        if (length > 0.0f) {
+            minCos = glm::min(minCos, glm::dot(normal, original.normal / length));
+        }
+        const glm::vec2 uvError = glm::abs(uv - original.uv);
+        report.maxUvError = glm::max(report.maxUvError, glm::max(uvError.x, uvError.y));
+        maxUv = glm::max(maxUv, glm::max(glm::abs(original.uv.x), glm::abs(original.uv.y)));
+    }
+    report.maxNormalErrorDegrees = glm::degrees(glm::acos(glm::clamp(minCos, -1.0f, 1.0f)));
+    report.uvErrorBound = maxUv * (1.0f / 2048.0f);
+    return report;
+}
@@ -0,0 +1,50 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#ifndef VERTEXQUANTIZER_H
+#define VERTEXQUANTIZER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mesh.h"
+#include "vertexFormat.h"
+
+// 量化误差的报告. 在CPU上把量化后的顶点按着色器的方式还原, 与原来的float顶点比较
+struct QuantizationReport {
+    uint32_t vertexCount{0};
+    size_t floatBytes{0};
+    size_t quantizedBytes{0};
+    // 位置的最大误差(模型空间中的距离), 以及上界: 每个轴半个量化步长
+    float maxPositionError{0.0f};
+    float positionErrorBound{0.0f};
+    // 法线的最大夹角(度). 上界是snorm8八面体编码的量化误差: 在单位球面上密集采样测得约0.93度, 取1度
+    float maxNormalErrorDegrees{0.0f};
+    // uv的最大误差, 以及上界: 半精度浮点数有11位有效数字, 相对误差不超过2^-11
+    float maxUvError{0.0f};
+    float uvErrorBound{0.0f};
+
+    static constexpr float NORMAL_ERROR_BOUND_DEGREES = 1.0f;
+
+    bool isWithinBounds() const;
+    void print(const std::string& name) const;
+};
+
+/**
+ * 把模型网格的Vertex量化为QuantizedVertex(见vertexFormat.h). 位置相对于所有顶点的包围盒,
+ * 一次上传的分配(打包后的整个模型, 或者单独上传的一个网格)共用一组反量化参数, 作为物体的uniform传给着色器
+ * 网格的处理(优化, 简化, meshlet)仍然使用float的Vertex, 打包模型时量化(见ModelPacker), 网格缓存保存的是量化后的顶点
+ */
+class VertexQuantizer {
+public:
+    // 包围盒: offset为最小点, scale为尺寸
+    static VertexQuantization computeQuantization(const Vertex* vertices, uint32_t count);
+    // 量化所有顶点, 返回使用的反量化参数
+    static VertexQuantization quantize(const Vertex* vertices, uint32_t count, std::vector<QuantizedVertex>& quantized);
+    static QuantizationReport measure(const Vertex* vertices, const QuantizedVertex* quantized, uint32_t count,
+                                      const VertexQuantization& quantization);
+};
+
+#endif //VERTEXQUANTIZER_H
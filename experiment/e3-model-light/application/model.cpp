@@ -2,13 +2,96 @@
 // Created by ROG on 2025/5/8.
 //
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <limits>
 
 #include "model.h"
 #include "../GLconfig/Texture.h"
+#include "../GLconfig/assetLoader.h"
+#include "../GLconfig/meshCache.h"
+#include "../GLconfig/meshImporter.h"
+#include "../GLconfig/modelPacker.h"
+#include "../GLconfig/vertexQuantizer.h"
 
-Model::Model(const char* path) {
-    loadModel(path);
+// 加载过程中的CPU端数据. 在工作线程中由prepareModel生成, 上传完成后随请求一起释放
+struct Model::PendingModel {
+    std::string path;
+    std::chrono::steady_clock::time_point start;
+    // 从缓存加载时, 网格视图指向这里的映射
+    MeshCacheFile cache;
+    bool fromCache{false};
+    // 没有缓存时导入的结果
+    std::vector<CookedMesh> cooked;
+    std::vector<MeshView> views;
+    std::vector<std::vector<TextureRef>> meshTextures;
+    // 节点层级. 节点的网格范围是views中的下标
+    std::vector<ModelNode> nodes;
+    // 所有网格用到的纹理(按路径去重), 路径到下标的映射, 以及纹理缓存中的句柄
+    std::vector<TextureRef> textures;
+    std::unordered_map<std::string, size_t> textureIndex;
+    std::vector<TextureHandle> handles;
+    // 纹理组合(类型和纹理对象)到材质的映射, 纹理相同的网格共用一个材质
+    std::unordered_map<std::string, std::shared_ptr<Material>> materialIndex;
+    // 所有网格按纹理组合分组后打包的结果(导入时在工作线程中生成), 以及顶点量化的误差
+    // 从缓存加载时只有子网格和分组, 顶点和索引在映射中
+    PackedModel packed;
+    QuantizationReport quantization;
+    // 上传用的视图: 导入时指向packed, 从缓存加载时直接指向映射
+    MeshView packedView;
+    size_t nextTexture{0};
+};
+
+namespace {
+    // 离相机最近的放置. 所有放置共用一次LOD选择, 按最近的选择时远处的放置只会更精细
+    uint32_t nearestPlacement(const glm::mat4* placements, const uint32_t count, const glm::mat4& viewMatrix) {
+        uint32_t nearest = 0;
+        float nearestDistance = std::numeric_limits<float>::max();
+        for (uint32_t i = 0; i < count; i++) {
+            const glm::vec3 position = glm::vec3(viewMatrix * placements[i][3]);
+            const float distance = glm::dot(position, position);
+            if (distance < nearestDistance) {
+                nearestDistance = distance;
+                nearest = i;
+            }
+        }
+        return nearest;
+    }
+}
+
+Model::Model(const char* path) : textureCache(TEXTURE_CACHE) {
+    PendingModel pending;
+    beginLoad(path, pending);
+    if (!prepareModel(pending)) {
+        return;
+    }
+    GLUploadBackend backend;
+    while (!uploadStep(pending, backend)) {
+    }
+}
+
+Model::Model(const std::string& path, AssetLoader& loader, TextureCache& textureCache) : textureCache(&textureCache) {
+    auto pending = std::make_shared<PendingModel>();
+    beginLoad(path, *pending);
+    AssetRequest request;
+    request.name = path;
+    request.load = [this, pending] { return prepareModel(*pending); };
+    request.upload = [this, pending](UploadBackend& backend) { return uploadStep(*pending, backend); };
+    loader.submit(std::move(request));
+}
+
+Model::~Model() {
+    // 网格只引用packedMesh, 共享缓冲中的分配由模型释放. 没有上传(或使用NullUploadBackend)时没有分配
+    if (packedMesh.vertices != RangeAllocator::INVALID_HANDLE || packedMesh.indices != RangeAllocator::INVALID_HANDLE) {
+        Mesh::getArena()->release(packedMesh);
+    }
+}
+
+void Model::beginLoad(const std::string& path, PendingModel& pending) {
+    pending.path = path;
+    pending.start = std::chrono::steady_clock::now();
+    directory = path.substr(0, path.find_last_of('/'));
 }
 
 void Model::draw(const Shader* shader) const {
@@ -16,7 +99,268 @@ void Model::draw(const Shader* shader) const {
         mesh.draw(shader);
 }
 
-void Model::loadModel(std::string path) {
+void Model::draw(const Shader* shader, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+                 const glm::mat4& projectionMatrix, const float viewportHeight, const float maxPixelError) const {
+    drawInstanced(shader, &modelMatrix, 1, viewMatrix, projectionMatrix, viewportHeight, maxPixelError);
+}
+
+void Model::drawInstanced(const Shader* shader, const glm::mat4* placements, const uint32_t count,
+                          const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, const float viewportHeight,
+                          const float maxPixelError) const {
+    if (count == 0 || batches.empty()) {
+        return;
+    }
+    GeometryArena* arena = Mesh::getArena();
+    instances.clear();
+    const uint32_t baseInstance = NodeHierarchy::appendInstances(nodeWorld, drawNodes, placements, count, instances);
+    instances.upload(arena->getVAO());
+    const glm::mat4& lodPlacement = placements[nearestPlacement(placements, count, viewMatrix)];
+
+    shader->setBool("instanced", true);
+    Mesh::setDequantization(shader, packedMesh.quantization);
+    // 所有子网格在同一次分配中, 只绑定一次VAO
+    arena->bind();
+    for (const MeshBatch& batch : batches) {
+        appendBatchCommands(batch, lodPlacement, count, baseInstance, viewMatrix, projectionMatrix, viewportHeight,
+                            maxPixelError);
+        if (drawCommands.empty()) {
+            continue;
+        }
+        if (batch.material) {
+            batch.material->bind();
+        }
+        arena->draw(GL_TRIANGLES, drawCommands);
+    }
+    shader->setBool("instanced", false);
+    Mesh::resetDequantization(shader);
+}
+
+void Model::submit(RenderQueue& queue, const RenderQueue::ShaderId shader, InstanceBuffer& instances,
+                   const glm::mat4& modelMatrix, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix,
+                   const float viewportHeight, const float maxPixelError) const {
+    submitInstanced(queue, shader, instances, &modelMatrix, 1, viewMatrix, projectionMatrix, viewportHeight,
+                    maxPixelError);
+}
+
+void Model::submitInstanced(RenderQueue& queue, const RenderQueue::ShaderId shader, InstanceBuffer& instances,
+                            const glm::mat4* placements, const uint32_t count, const glm::mat4& viewMatrix,
+                            const glm::mat4& projectionMatrix, const float viewportHeight,
+                            const float maxPixelError) const {
+    if (count == 0 || batches.empty()) {
+        return;
+    }
+    const uint32_t baseInstance = NodeHierarchy::appendInstances(nodeWorld, drawNodes, placements, count, instances);
+    ObjectConstants object;
+    // 模型矩阵来自实例缓冲. 顶点是量化后的: 位置按整个模型的包围盒还原, 法线是八面体编码
+    object.instanced = true;
+    object.uvScale = 1.0f;
+    object.octNormal = true;
+    object.positionOffset = packedMesh.quantization.offset;
+    object.positionScale = packedMesh.quantization.scale;
+    const uint32_t objectIndex = queue.addObject(object);
+    glm::vec3 center(0.0f);
+    for (uint32_t i = 0; i < count; i++) {
+        center += glm::vec3(placements[i][3]);
+    }
+    center /= (float)count;
+    const glm::mat4& lodPlacement = placements[nearestPlacement(placements, count, viewMatrix)];
+    const GLuint vao = Mesh::getArena()->getVAO();
+    for (const MeshBatch& batch : batches) {
+        appendBatchCommands(batch, lodPlacement, count, baseInstance, viewMatrix, projectionMatrix, viewportHeight,
+                            maxPixelError);
+        queue.submit(RenderPass::Opaque, shader, batch.material, vao, objectIndex, center, drawCommands);
+    }
+}
+
+void Model::appendBatchCommands(const MeshBatch& batch, const glm::mat4& lodPlacement, const uint32_t count,
+                                const uint32_t baseInstance, const glm::mat4& viewMatrix,
+                                const glm::mat4& projectionMatrix, const float viewportHeight,
+                                const float maxPixelError) const {
+    levelRanges.resize(packedMesh.levels.size());
+    for (auto& ranges : levelRanges) {
+        ranges.clear();
+    }
+    drawCommands.clear();
+    const uint32_t end = batch.firstMesh + batch.meshCount;
+    for (uint32_t i = batch.firstMesh; i < end; i++) {
+        const Mesh& mesh = meshes[i];
+        const glm::mat4 meshMatrix = lodPlacement * nodeWorld[drawNodes[meshSlots[i]]];
+        const uint32_t lod = mesh.selectLod(meshMatrix, viewMatrix, projectionMatrix, viewportHeight, maxPixelError);
+        if (count == 1) {
+            // 原始网格按meshlet剔除, 简化后的LOD三角形很少, 直接绘制
+            mesh.appendRanges(lod, meshMatrix, viewMatrix, projectionMatrix, levelRanges[lod]);
+        } else {
+            levelRanges[lod].push_back(mesh.getLevelRange(lod));
+        }
+        // 同一节点的子网格在分组中相邻. 节点的最后一个子网格处生成命令, 命令的实例是这个节点的所有放置
+        if (i + 1 < end && meshSlots[i + 1] == meshSlots[i]) {
+            continue;
+        }
+        const uint32_t nodeInstance = baseInstance + meshSlots[i] * count;
+        for (uint32_t level = 0; level < levelRanges.size(); level++) {
+            // 子网格在每一级中依次相邻, 范围是按位置递增的
+            ModelPacker::mergeRanges(levelRanges[level]);
+            Mesh::getArena()->appendCommands(packedMesh, level, levelRanges[level], drawCommands, count, nodeInstance);
+            levelRanges[level].clear();
+        }
+    }
+}
+
+bool Model::prepareModel(PendingModel& pending) const {
+    const std::string cachePath = MeshCache::getCachePath(pending.path);
+    if (MeshCache::isFresh(cachePath, pending.path) && pending.cache.open(cachePath)) {
+        // 缓存中是打包好的模型: 量化后的顶点和切分好的索引之后直接从映射中上传, 不再打包
+        for (uint32_t i = 0; i < pending.cache.getMeshCount(); i++) {
+            pending.views.push_back(pending.cache.getMesh(i));
+            pending.meshTextures.push_back(pending.cache.getTextures(i));
+        }
+        pending.nodes = pending.cache.getNodes();
+        pending.packed.submeshes = pending.cache.getSubmeshes();
+        pending.packed.groups = pending.cache.getGroups();
+        pending.packedView = pending.cache.getPackedView();
+        pending.fromCache = true;
+    } else {
+        if (!importModel(pending.path, pending.cooked, pending.nodes)) {
+            return false;
+        }
+        for (const auto& mesh : pending.cooked) {
+            pending.views.push_back(mesh.view());
+            pending.meshTextures.push_back(mesh.textures);
+        }
+        // 纹理组合相同的网格是一个材质分组, 按分组打包为一份顶点和索引, GL线程中只需上传一次
+        pending.packed = ModelPacker::pack(pending.cooked);
+        pending.packedView = pending.packed.view();
+#ifdef DEBUG
+        // 量化误差只用于加载完成时的统计
+        const PackedModel& packed = pending.packed;
+        pending.quantization = VertexQuantizer::measure(packed.vertices.data(), packed.quantized.data(),
+                                                        (uint32_t)packed.vertices.size(), packed.quantization);
+#endif
+        if (MeshCache::write(cachePath, pending.path, pending.cooked, pending.packed, pending.nodes)) {
+#ifdef DEBUG
+            // 读回刚写入的缓存, 检查与导入和打包的结果逐字节相同
+            MeshCacheFile written;
+            bool identical = written.open(cachePath) && written.getMeshCount() == pending.cooked.size() &&
+                             written.getNodes().size() == pending.nodes.size() &&
+                             MeshCache::isIdentical(pending.packed, written);
+            for (uint32_t i = 0; identical && i < pending.cooked.size(); i++) {
+                identical = MeshCache::isIdentical(pending.cooked[i], written.getMesh(i), written.getTextures(i));
+            }
+            std::cout << "mesh cache " << cachePath << " round trip: " << (identical ? "identical" : "MISMATCH") << std::endl;
+#endif
+        }
+    }
+
+    // 纹理按路径去重. uv已经由aiProcess_FlipUVs翻转, 图片本身不再翻转
+    for (const auto& references : pending.meshTextures) {
+        for (const auto& reference : references) {
+            if (pending.textureIndex.emplace(reference.path, pending.textures.size()).second) {
+                pending.textures.push_back(reference);
+            }
+        }
+    }
+    // 其他模型已经加载过(或者正在加载)的纹理不再解码
+    const TextureParams params = TextureParams::model();
+    for (const auto& texture : pending.textures) {
+        bool claimed;
+        const std::string path = directory + '/' + texture.path;
+        pending.handles.push_back(textureCache->acquire(path, params, claimed));
+        if (claimed) {
+            DecodedImage image;
+            const bool success = Texture::decodeImage(path, params, image);
+            textureCache->provide(pending.handles.back(), std::move(image), success);
+        }
+    }
+    return true;
+}
+
+bool Model::uploadStep(PendingModel& pending, UploadBackend& backend) {
+    // 先上传纹理, 创建网格时直接引用纹理对象
+    // 纹理由纹理缓存通过它自己的后端上传, 已经上传过的直接取得纹理对象
+    if (pending.nextTexture < pending.textures.size()) {
+        const size_t i = pending.nextTexture;
+        if (!textureCache->upload(pending.handles[i])) {
+            return false;
+        }
+        pending.nextTexture++;
+        TextureInfo texture;
+        // 解码失败的纹理为0(不绑定任何纹理)
+        texture.id = pending.handles[i].getId();
+        texture.type = pending.textures[i].type;
+        texture.path = pending.textures[i].path.c_str();
+        loadedTextures.push_back(texture);
+        textureHandles.push_back(pending.handles[i]);
+        return false;
+    }
+    // 节点是静态的, 世界矩阵只计算一次. 有网格的节点按顺序编号, 是它在实例缓冲中的位置
+    nodes = std::move(pending.nodes);
+    NodeHierarchy::computeWorldMatrices(nodes, nodeWorld);
+    std::vector<uint32_t> viewSlots(pending.views.size(), 0);
+    for (uint32_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].meshCount == 0) {
+            continue;
+        }
+        for (uint32_t mesh = nodes[i].firstMesh; mesh < nodes[i].firstMesh + nodes[i].meshCount; mesh++) {
+            viewSlots[mesh] = (uint32_t)drawNodes.size();
+        }
+        drawNodes.push_back(i);
+    }
+    if (drawNodes.empty()) {
+        nodes = NodeHierarchy::makeRoot((uint32_t)pending.views.size());
+        NodeHierarchy::computeWorldMatrices(nodes, nodeWorld);
+        drawNodes.push_back(0);
+    }
+
+    // 所有网格一次上传到同一次分配中, 子网格只记录自己的范围
+    const PackedModel& packed = pending.packed;
+    packedMesh = backend.uploadMesh(pending.packedView);
+    meshes.reserve(packed.submeshes.size());
+    for (const SubmeshGroup& group : packed.groups) {
+        MeshBatch batch;
+        batch.firstMesh = (uint32_t)meshes.size();
+        batch.meshCount = group.submeshCount;
+        for (uint32_t i = group.firstSubmesh; i < group.firstSubmesh + group.submeshCount; i++) {
+            const SubmeshRange& submesh = packed.submeshes[i];
+            const std::vector<TextureInfo> textures = resolveTextures(pending, pending.meshTextures[submesh.mesh]);
+            meshes.emplace_back(pending.views[submesh.mesh], textures, &packedMesh, submesh);
+            meshes.back().setMaterial(getMaterial(pending, textures));
+            meshSlots.push_back(viewSlots[submesh.mesh]);
+        }
+        batch.material = meshes[batch.firstMesh].getMaterial();
+        batches.push_back(batch);
+    }
+    // 分组按材质的排序键排列, 纹理相同的材质相邻
+    std::stable_sort(batches.begin(), batches.end(), [](const MeshBatch& a, const MeshBatch& b) {
+        return a.material->getSortKey() < b.material->getSortKey();
+    });
+    ready = true;
+#ifdef DEBUG
+    // 加载完成时的统计只在调试构建中输出
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pending.start).count();
+
+    // 索引缓冲的大小. 16位索引, 超过65535个顶点的部分切分为多段
+    const size_t indexBytes = packedMesh.indexCount * sizeof(GLushort);
+    size_t unpackedIndexBytes = 0;
+    for (const auto& mesh : meshes) {
+        unpackedIndexBytes += mesh.getUnpackedIndexBytes();
+    }
+    std::cout << "model " << pending.path << ": " << meshes.size() << " meshes in " << nodes.size() << " nodes and "
+              << batches.size() << " material groups packed into one allocation, " << loadedTextures.size() << " textures, "
+              << materials.size() << " materials "
+              << (pending.fromCache ? "mapped from cache (" + std::to_string(pending.cache.getSize()) + " bytes)" : "imported")
+              << ", ready after " << ms << " ms, indices with LODs " << indexBytes
+              << " bytes (32-bit without LODs: " << unpackedIndexBytes << ")" << std::endl;
+    // 从缓存加载时没有float顶点, 量化误差在生成缓存时已经输出过
+    if (!pending.fromCache) {
+        pending.quantization.print(pending.path);
+    }
+    Mesh::getArena()->printStats();
+    textureCache->printStats();
+#endif
+    return true;
+}
+
+bool Model::importModel(const std::string& path, std::vector<CookedMesh>& cooked, std::vector<ModelNode>& nodes) const {
     Assimp::Importer import;
     /*
      * 读取模型文件. 第二个参数用于配置读取时的处理选项.
@@ -27,99 +371,78 @@ void Model::loadModel(std::string path) {
 
     if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
         std::cout << "ERROR::ASSIMP::" << import.GetErrorString() << std::endl;
-        return;
+        return false;
     }
-    directory = path.substr(0, path.find_last_of('/'));
 
-    processNode(scene->mRootNode, scene);
+    // 先收集所有网格, 转换和预处理在多个线程中进行(见MeshImporter)
+    std::vector<const aiMesh*> sceneMeshes;
+    processNode(scene->mRootNode, scene, -1, sceneMeshes, nodes);
+    cooked = MeshImporter::cookAll(sceneMeshes, LOD_LEVELS);
+    // 处理材质. 这里只记录纹理路径, 纹理在创建Mesh时加载
+    for (size_t i = 0; i < sceneMeshes.size(); i++) {
+        aiMaterial* material = scene->mMaterials[sceneMeshes[i]->mMaterialIndex];
+        std::vector<TextureRef>& textures = cooked[i].textures;
+        std::vector<TextureRef> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
+        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+        std::vector<TextureRef> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
+        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+    }
+    return true;
 }
 
-void Model::processNode(aiNode* node, const aiScene* scene) {
-    // 处理节点所有的网格（如果有的话）
+void Model::processNode(aiNode* node, const aiScene* scene, const int32_t parent,
+                        std::vector<const aiMesh*>& sceneMeshes, std::vector<ModelNode>& nodes) const {
+    // assimp的矩阵按行存放, glm按列存放, 需要转置
+    ModelNode modelNode;
+    modelNode.parent = parent;
+    modelNode.local = glm::transpose(glm::make_mat4(&node->mTransformation.a1));
+    modelNode.firstMesh = (uint32_t)sceneMeshes.size();
+    modelNode.meshCount = node->mNumMeshes;
+    const auto index = (int32_t)nodes.size();
+    nodes.push_back(modelNode);
+    // 收集节点所有的网格（如果有的话）. 被多个节点引用的网格每次都会导入一份
     for(unsigned int i = 0; i < node->mNumMeshes; i++){
-        aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes.push_back(processMesh(mesh, scene));
+        sceneMeshes.push_back(scene->mMeshes[node->mMeshes[i]]);
     }
     // 接下来对它的子节点重复这一过程
     for(unsigned int i = 0; i < node->mNumChildren; i++){
-        processNode(node->mChildren[i], scene);
-    }
-}
-
-Mesh Model::processMesh(aiMesh* mesh, const aiScene* scene) {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
-    std::vector<TextureInfo> textures;
-
-    for(unsigned int i = 0; i < mesh->mNumVertices; i++){
-        Vertex vertex{};
-        // 处理顶点位置、法线和纹理坐标
-        glm::vec3 temp;
-        temp.x = mesh->mVertices[i].x;
-        temp.y = mesh->mVertices[i].y;
-        temp.z = mesh->mVertices[i].z;
-        vertex.position = temp;
-
-        temp.x = mesh->mNormals[i].x;
-        temp.y = mesh->mNormals[i].y;
-        temp.z = mesh->mNormals[i].z;
-        vertex.normal = temp;
-
-        // 先判断网格是否有纹理坐标
-        if(mesh->mTextureCoords[0]) {
-            glm::vec2 vec;
-            vec.x = mesh->mTextureCoords[0][i].x;
-            vec.y = mesh->mTextureCoords[0][i].y;
-            vertex.uv = vec;
-        }
-        else
-            vertex.uv = glm::vec2(0.0f, 0.0f);
-
-        vertices.push_back(vertex);
-    }
-    // 处理索引
-    for(unsigned int i = 0; i < mesh->mNumFaces; i++) {
-        aiFace face = mesh->mFaces[i];
-        for(unsigned int j = 0; j < face.mNumIndices; j++)
-            indices.push_back(face.mIndices[j]);
-    }
-    // 处理材质
-    if(mesh->mMaterialIndex >= 0){
-        aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
-        std::vector<TextureInfo> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-        textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
-        std::vector<TextureInfo> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-        textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+        processNode(node->mChildren[i], scene, index, sceneMeshes, nodes);
     }
-
-    return Mesh(vertices, indices, textures);
 }
 
-std::vector<TextureInfo> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName) {
-    std::vector<TextureInfo> textures;
+std::vector<TextureRef> Model::loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName) const {
+    std::vector<TextureRef> textures;
     for(unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
         aiString str;
         mat->GetTexture(type, i, &str);
-        bool skip = false;
-        for(auto & loadedTexture : loadedTextures) {
-            // 比较loadedTexture的path与当前纹理路径是否相同, 如果相同则跳过
-            if(std::strcmp(loadedTexture.path.C_Str(), str.C_Str()) == 0) {
-                textures.push_back(loadedTexture);
-                skip = true;
-                break;
-            }
-        }
-        if(!skip) {
-            // 如果纹理还没有被加载，则加载它
-            TextureInfo texture;
+        textures.push_back({typeName, str.C_Str()});
+    }
+    return textures;
+}
 
-            texture.id = Texture::TextureFromFile(str.C_Str(), directory);
-            texture.type = typeName;
-            texture.path = str.C_Str();
-            textures.push_back(texture);
-            loadedTextures.push_back(texture); // 添加到已加载的纹理中
-        }
+std::vector<TextureInfo> Model::resolveTextures(const PendingModel& pending, const std::vector<TextureRef>& references) const {
+    std::vector<TextureInfo> textures;
+    for (const auto& reference : references) {
+        // loadedTextures与pending.textures的顺序相同
+        TextureInfo texture = loadedTextures[pending.textureIndex.at(reference.path)];
+        texture.type = reference.type;
+        textures.push_back(texture);
     }
     return textures;
 }
 
+std::shared_ptr<Material> Model::getMaterial(PendingModel& pending, const std::vector<TextureInfo>& textures) {
+    std::string key;
+    for (const auto& texture : textures) {
+        key += texture.type + ':' + std::to_string(texture.id) + ';';
+    }
+    std::shared_ptr<Material>& material = pending.materialIndex[key];
+    if (!material) {
+        material = std::make_shared<Material>();
+        for (const auto& texture : textures) {
+            material->addTexture(texture.type, texture.id);
+        }
+        materials.push_back(material);
+    }
+    return material;
+}
@@ -5,29 +5,119 @@
 #ifndef MODEL_H
 #define MODEL_H
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include "../GLconfig/instanceBuffer.h"
 #include "../GLconfig/mesh.h"
+#include "../GLconfig/nodeHierarchy.h"
+#include "../GLconfig/renderQueue.h"
 #include "../GLconfig/shader.h"
+#include "../GLconfig/textureCache.h"
+
+class AssetLoader;
+class UploadBackend;
 
 class Model {
 public:
     /*  函数   */
+    // 同步加载, 返回时已经上传完成. 纹理使用全局纹理缓存
     Model(const char* path);
+    // 异步加载: 只提交请求. 读取缓存或导入, 以及纹理解码在loader的工作线程中进行,
+    // 纹理和网格在loader.update中每次上传一个. 模型必须存活到加载完成
+    // 纹理通过textureCache自己的后端创建和释放(网格使用loader的后端). 测试时传入使用NullUploadBackend的缓存
+    Model(const std::string& path, AssetLoader& loader, TextureCache& textureCache = *TEXTURE_CACHE);
+    ~Model();
+    // 网格持有&packedMesh, 模型不能复制或移动
+    Model(const Model&) = delete;
+    Model& operator=(const Model&) = delete;
+    Model(Model&&) = delete;
+    Model& operator=(Model&&) = delete;
+    // 所有纹理和网格都已上传. 之前由调用者绘制占位几何体
+    bool isReady() const { return ready; }
+    // 逐个绘制网格, 不使用节点的变换
     void draw(const Shader* shader) const;
+    // 每个网格按自己的屏幕尺寸选择LOD后绘制. 选中原始网格时按meshlet剔除(见Mesh::drawCulled)
+    // 所有网格打包在共享缓冲的同一次分配中(见modelPacker.h), 绘制一个模型只绑定一次VAO, 每个材质分组一次glMultiDrawElementsIndirect.
+    // 分组内同一节点选择了同一级LOD的子网格的范围首尾相接, 合并为一条命令. 相当于只有一个放置的drawInstanced
+    void draw(const Shader* shader, const glm::mat4& modelMatrix, const glm::mat4& viewMatrix,
+              const glm::mat4& projectionMatrix, float viewportHeight, float maxPixelError = 1.0f) const;
+    // 在count个放置处绘制同一个模型, 命令数与绘制一次相同: 每个节点的矩阵(放置 * 节点的世界矩阵)写入实例缓冲,
+    // 命令的instanceCount为count. 着色器的instanced为true时从实例缓冲读取模型矩阵
+    // 所有放置共用一次LOD选择(按离相机最近的一个), 只有一个放置时才按meshlet剔除
+    void drawInstanced(const Shader* shader, const glm::mat4* placements, uint32_t count, const glm::mat4& viewMatrix,
+                       const glm::mat4& projectionMatrix, float viewportHeight, float maxPixelError = 1.0f) const;
+    // 与上面的draw选择相同的LOD和meshlet, 但是每个材质提交一个绘制包到渲染队列, 不调用OpenGL
+    // 节点的矩阵追加到instances中, 调用者需要在执行队列之前上传它(InstanceBuffer::upload, 挂到Mesh::getArena()的VAO上)
+    // 所有网格共用一个物体, 深度按放置的平均位置计算
+    void submit(RenderQueue& queue, RenderQueue::ShaderId shader, InstanceBuffer& instances,
+                const glm::mat4& modelMatrix, const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix,
+                float viewportHeight, float maxPixelError = 1.0f) const;
+    void submitInstanced(RenderQueue& queue, RenderQueue::ShaderId shader, InstanceBuffer& instances,
+                         const glm::mat4* placements, uint32_t count, const glm::mat4& viewMatrix,
+                         const glm::mat4& projectionMatrix, float viewportHeight, float maxPixelError = 1.0f) const;
+    const std::vector<ModelNode>& getNodes() const { return nodes; }
+    // 每个网格生成的简化LOD级数(不含原始网格)
+    static constexpr uint32_t LOD_LEVELS = 4;
 private:
+    struct PendingModel;
     /*  模型数据  */
+    bool ready{false};
     std::vector<TextureInfo> loadedTextures;
+    // 纹理来自textureCache, 模型存活期间持有它们的引用
+    TextureCache* textureCache;
+    std::vector<TextureHandle> textureHandles;
+    // 每种纹理组合一个材质
+    std::vector<std::shared_ptr<Material>> materials;
+    // 子网格, 按材质分组排列. 它们的顶点和索引都在packedMesh中
     std::vector<Mesh> meshes;
+    ArenaMesh packedMesh;
+    // 一个材质分组: meshes中连续的一段, 分组按材质的排序键排列
+    struct MeshBatch {
+        const Material* material{nullptr};
+        uint32_t firstMesh{0};
+        uint32_t meshCount{0};
+    };
+    std::vector<MeshBatch> batches;
+    // 节点层级, 以及每个节点相对模型原点的矩阵(节点是静态的, 加载完成时计算一次)
+    std::vector<ModelNode> nodes;
+    std::vector<glm::mat4> nodeWorld;
+    // 有网格的节点(在实例缓冲中按这个顺序排列), 以及每个子网格所在的节点在其中的位置
+    std::vector<uint32_t> drawNodes;
+    std::vector<uint32_t> meshSlots;
+    // draw/drawInstanced使用的实例缓冲
+    mutable InstanceBuffer instances;
+    // 每帧复用: 分组中每一级LOD要绘制的范围
+    mutable std::vector<std::vector<MeshletRange>> levelRanges;
     std::string directory;
+    // 每帧复用的间接绘制命令
+    mutable std::vector<DrawElementsIndirectCommand> drawCommands;
     /*  函数   */
-    void loadModel(std::string path);
-    void processNode(aiNode* node, const aiScene* scene);
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-    std::vector<TextureInfo> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+    // 生成一个分组的绘制命令(drawCommands): 子网格按lodPlacement选择LOD(只有一个放置时剔除), 同一节点同一级的范围
+    // 合并后与16位索引分段求交. 节点的命令画出它的所有放置(instanceCount = count)
+    void appendBatchCommands(const MeshBatch& batch, const glm::mat4& lodPlacement, uint32_t count, uint32_t baseInstance,
+                             const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix, float viewportHeight,
+                             float maxPixelError) const;
+    void beginLoad(const std::string& path, PendingModel& pending);
+    // 可以在工作线程中执行, 不调用OpenGL: 优先读取网格缓存(见meshCache.h), 缓存不存在或者过期时用assimp导入
+    // 并重新生成缓存, 然后从纹理缓存获取所有纹理, 只解码缓存中还没有的
+    bool prepareModel(PendingModel& pending) const;
+    // 在GL线程中执行: 每次上传一张纹理, 最后一次上传打包好的所有网格, 全部完成时返回true
+    // 纹理正在被另一个模型的加载线程解码时, 这一步什么都不做, 之后再试
+    bool uploadStep(PendingModel& pending, UploadBackend& backend);
+    bool importModel(const std::string& path, std::vector<CookedMesh>& cooked, std::vector<ModelNode>& nodes) const;
+    // 按深度优先的先序收集节点(父节点下标, 局部矩阵)及其引用的网格. 节点的网格是sceneMeshes中连续的一段
+    void processNode(aiNode* node, const aiScene* scene, int32_t parent, std::vector<const aiMesh*>& sceneMeshes,
+                     std::vector<ModelNode>& nodes) const;
+    std::vector<TextureRef> loadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName) const;
+    // 纹理引用对应的已上传纹理
+    std::vector<TextureInfo> resolveTextures(const PendingModel& pending, const std::vector<TextureRef>& references) const;
+    // 纹理组合对应的材质, 第一次遇到时创建
+    std::shared_ptr<Material> getMaterial(PendingModel& pending, const std::vector<TextureInfo>& textures);
 };
 
 #endif //MODEL_H
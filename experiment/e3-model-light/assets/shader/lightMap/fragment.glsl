@@ -6,8 +6,13 @@ out vec4 FragColor;
 struct Material {
     sampler2D diffuse; // 漫反射光照下的颜色. 取自纹理颜色
     sampler2D specular; // 镜面高光的颜色. 取自纹理颜色
-    float shininess; // 镜面高光的散射/半径. 值越大, 散射越小(集中)
 };
+// 材质常量, 由Material写入所有材质共享的uniform缓冲(binding与Material::BLOCK_BINDING一致)
+layout (std140, binding = 1) uniform MaterialBlock {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular; // w为shininess: 镜面高光的散射/半径. 值越大, 散射越小(集中)
+} materialConstants;
 // 光源属性. 三种光强度也可以看做三种颜色, 替代了单一设置一种光照颜色
 struct LightSource {
     vec3 position;
@@ -56,7 +61,7 @@ void main() {
         // ===3. 镜面反射
         vec3 viewDir = normalize(viewPosition - fragPos);
         vec3 reflectDir = reflect(-lightDir, norm);
-        float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), materialConstants.specular.w);
         vec3 specular = lightSource.specular * spec * vec3(texture(material.specular, uvTexCoord));
 
         // 因为物体的颜色属性已经包含进Material结构体中了, 所以这里不需要再乘以物体顶点颜色
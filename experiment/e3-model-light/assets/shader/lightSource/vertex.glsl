@@ -1,6 +1,5 @@
 #version 460 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec2 aTexCoord;
 
 out vec3 color;
@@ -13,6 +12,10 @@ uniform mat4 model;
 uniform mat4 viewMatrix;
 // 投影变换矩阵(projection matrix)
 uniform mat4 projectionMatrix;
+// 物体颜色. 不再作为逐顶点属性传入
+uniform vec3 objectColor = vec3(1.0);
+// uv以归一化的16位整数存储, 超出[0, 1]的部分需要乘回缩放
+uniform float uvScale = 1.0;
 
 void main() {
     // 变换顶点坐标
@@ -22,6 +25,6 @@ void main() {
 
     // 输出的position为裁剪空间坐标, 会经过透视除法. 透视投影时, w分量一般不等于1
     gl_Position = position;
-    color = aColor;
-    uvTexCoord = aTexCoord;
+    color = objectColor;
+    uvTexCoord = aTexCoord * uvScale;
 }
\ No newline at end of file
@@ -1,14 +1,13 @@
 #version 460 core
 out vec4 FragColor;
 
-// 物体的材质属性
-struct Material {
-    vec3 ambient; // 环境光照下的颜色
-    vec3 diffuse; // 漫反射光照下的颜色
+// 物体的材质属性, 由Material写入所有材质共享的uniform缓冲(binding与Material::BLOCK_BINDING一致)
+layout (std140, binding = 1) uniform MaterialBlock {
+    vec4 ambient; // 环境光照下的颜色
+    vec4 diffuse; // 漫反射光照下的颜色
     // ambient 和 diffuse 一般就是物体本身颜色
-    vec3 specular; // 镜面高光的颜色
-    float shininess; // 镜面高光的散射/半径. 值越大, 散射越小(集中)
-};
+    vec4 specular; // 镜面高光的颜色. w为shininess: 镜面高光的散射/半径. 值越大, 散射越小(集中)
+} material;
 // 光源属性. 三种光强度也可以看做三种颜色, 替代了单一设置一种光照颜色
 struct LightSource {
     vec3 position;
@@ -33,7 +32,6 @@ uniform vec3 lightColor = vec3(1.0f, 1.0f, 1.0f);
 uniform vec3 lightPosition;
 // 观察者位置, 用于计算镜面光照
 uniform vec3 viewPosition;
-uniform Material material;
 uniform LightSource lightSource;
 
 void main() {
@@ -43,7 +41,7 @@ void main() {
     } else {
         // 加载光照. blinn-phong模型(📌📌物体颜色取自几何类的Material成员)
         // ===1. 环境光
-        vec3 ambient = lightSource.ambient * material.ambient;
+        vec3 ambient = lightSource.ambient * material.ambient.rgb;
 
         // ===2. 漫反射
         // 先计算光照方向
@@ -52,13 +50,13 @@ void main() {
         vec3 lightDir = normalize(lightPosition - fragPos);
         // 计算漫反射分量(朗伯余弦定律)
         float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = lightSource.diffuse * (diff * material.diffuse);
+        vec3 diffuse = lightSource.diffuse * (diff * material.diffuse.rgb);
 
         // ===3. 镜面反射
         vec3 viewDir = normalize(viewPosition - fragPos);
         vec3 reflectDir = reflect(-lightDir, norm);
-        float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-        vec3 specular = lightSource.specular * (spec * material.specular);
+        float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.specular.w);
+        vec3 specular = lightSource.specular * (spec * material.specular.rgb);
 
         // 因为物体的颜色属性已经包含进Material结构体中了, 所以这里不需要再乘以物体顶点颜色
         // vec3 result = (ambient + diffuse + specular) * color;
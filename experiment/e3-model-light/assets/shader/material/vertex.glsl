@@ -1,7 +1,7 @@
 #version 460 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec2 aTexCoord;
+// 模型网格传入的是float法线; 几何体传入的是八面体编码后的两个分量(z补0), 需要解码
 layout (location = 3) in vec3 aNormal;
 
 out vec3 color;
@@ -19,6 +19,21 @@ uniform mat4 viewMatrix;
 uniform mat4 projectionMatrix;
 // 法线矩阵. 用于将法向从模型空间变换到世界空间(相当于模型矩阵左上角3x3部分的逆矩阵的转置矩阵)
 uniform mat3 normalMatrix;
+// 物体颜色. 不再作为逐顶点属性传入
+uniform vec3 objectColor = vec3(1.0);
+// uv以归一化的16位整数存储, 超出[0, 1]的部分需要乘回缩放
+uniform float uvScale = 1.0;
+// 法线是否为八面体编码
+uniform bool octNormal = false;
+
+// 八面体解码, 与GLconfig/vertexFormat.h中的octDecode一致
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
 
 void main() {
     // 变换顶点坐标
@@ -28,9 +43,10 @@ void main() {
 
     // 输出的position为裁剪空间坐标, 会经过透视除法. 透视投影时, w分量一般不等于1
     gl_Position = position;
-    color = aColor;
-    uvTexCoord = aTexCoord;
+    color = objectColor;
+    uvTexCoord = aTexCoord * uvScale;
     fragPos = vec3(model * vec4(aPos, 1.0));
     // 模型变换也要作用于法向上, 只不过模型矩阵要先处理为法线矩阵
-    normal = normalMatrix * aNormal;
+    vec3 modelNormal = octNormal ? octDecode(aNormal.xy) : aNormal;
+    normal = normalMatrix * modelNormal;
 }
\ No newline at end of file
@@ -0,0 +1,125 @@
+//
+// Created by ROG on 2026/10/17.
+//
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../GLconfig/benchmarkCheck.h"
+#include "../GLconfig/glRecorder.h"
+#include "../GLconfig/material.h"
+#include "../GLconfig/shader.h"
+#include "../GLconfig/uniformTable.h"
+
+/**
+ * uniform热路径的内存分配测试. 替换全局的operator new, 在counting为true时统计分配次数
+ * 这个文件只编译进e3-allocation-benchmark, 主程序和e3-glConfig中的分配不受影响
+ * OpenGL调用由GLRecorder代替, 不需要上下文
+ */
+
+namespace {
+    bool counting = false;
+    uint64_t allocations = 0;
+
+    void* allocate(const size_t size) {
+        if (counting) {
+            allocations++;
+        }
+        if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+// 对齐的版本(超过默认对齐的类型)没有替换, 热路径上不会用到
+void* operator new(const size_t size) { return allocate(size); }
+void* operator new[](const size_t size) { return allocate(size); }
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { std::free(pointer); }
+
+using namespace benchmark;
+
+namespace {
+    // materials着色器中的活动uniform(与main.cpp的render中设置的相同)
+    UniformTable makeTable() {
+        UniformTable table;
+        GLint location = 0;
+        for (const char* name : {"model", "viewMatrix", "projectionMatrix", "normalMatrix", "objectColor", "uvScale",
+                                 "octNormal", "useTexture", "lightPosition", "viewPosition", "lightSource.ambient",
+                                 "lightSource.diffuse", "lightSource.specular", "material.ambient", "material.diffuse",
+                                 "material.specular", "material.shininess", "material.texture_diffuse1",
+                                 "material.texture_diffuse2", "material.texture_specular1"}) {
+            table.add(name, location++);
+        }
+        return table;
+    }
+
+    // 一帧的uniform设置: 与Shader::set*(名字)相同, 先按编译期哈希查表, 再按位置设置
+    void setFrameUniforms(const UniformTable& table, const std::string& diffuse, const std::string& specular) {
+        const glm::mat4 matrix(1.0f);
+        const glm::vec3 vector(0.5f);
+        Shader::setMat4(table.find("viewMatrix"), matrix);
+        Shader::setMat4(table.find("projectionMatrix"), matrix);
+        Shader::setVec3(table.find("lightPosition"), vector);
+        Shader::setVec3(table.find("viewPosition"), vector);
+        Shader::setVec3(table.find("lightSource.ambient"), vector);
+        Shader::setVec3(table.find("lightSource.diffuse"), vector);
+        Shader::setVec3(table.find("lightSource.specular"), vector);
+        Shader::setBool(table.find("useTexture"), true);
+        Shader::setVec3(table.find("objectColor"), vector);
+        Shader::setMat4(table.find("model"), matrix);
+        Shader::setMat3(table.find("normalMatrix"), glm::mat3(matrix));
+        Shader::setFloat(table.find("material.shininess"), 32.0f);
+        // 网格绑定纹理时的采样器名字
+        Shader::setInt(table.find(Material::getSamplerUniform(diffuse, 1)), 0);
+        Shader::setInt(table.find(Material::getSamplerUniform(diffuse, 2)), 1);
+        Shader::setInt(table.find(Material::getSamplerUniform(specular, 1)), 2);
+    }
+
+    constexpr uint32_t FRAME_UNIFORMS = 15;
+}
+
+int main() {
+    beginChecks("uniform allocation");
+    GLRecorder gl;
+    const UniformTable table = makeTable();
+    const std::string diffuse = "texture_diffuse";
+    const std::string specular = "texture_specular";
+
+    // 先预热同样多的帧: GLRecorder的记录缓冲在这里扩容, 之后clear保留容量
+    constexpr int frames = 1000;
+    for (int frame = 0; frame < frames; frame++) {
+        setFrameUniforms(table, diffuse, specular);
+    }
+    gl.clear();
+
+    counting = true;
+    for (int frame = 0; frame < frames; frame++) {
+        setFrameUniforms(table, diffuse, specular);
+    }
+    counting = false;
+    const uint64_t hotAllocations = allocations;
+    check(gl.count(GLCall::Uniform) == frames * FRAME_UNIFORMS, std::to_string(gl.count(GLCall::Uniform))
+          + " uniforms set through Shader::set* in " + std::to_string(frames) + " frames");
+    check(hotAllocations == 0, "table.find + Shader::set* + Material::getSamplerUniform: "
+          + std::to_string(hotAllocations) + " allocations");
+
+    // 对照: 原来每次绑定纹理时拼接采样器名字. 同样的计数能看到它的分配
+    allocations = 0;
+    counting = true;
+    size_t length = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        length += ("material." + diffuse + std::to_string(frame % 4 + 1)).size();
+    }
+    counting = false;
+    check(allocations >= (uint64_t)frames && length > 0,
+          "old concatenation: " + std::to_string(allocations) + " allocations for " + std::to_string(frames) + " bindings");
+    endChecks();
+    return failures == 0 ? 0 : 1;
+}
@@ -7,20 +7,59 @@
 #include "application/camera/orthographicCamera.h"
 #include "application/camera/trackballCameraController.h"
 #include "application/camera/gameCameraController.h"
+#include "GLconfig/assetLoader.h"
 #include "GLconfig/geometry.h"
+#include "GLconfig/instanceBuffer.h"
+#include "GLconfig/material.h"
+#include "GLconfig/renderQueue.h"
+#include "GLconfig/sceneGraphBenchmark.h"
+#include "GLconfig/meshGeneratorBenchmark.h"
+#include "GLconfig/meshOptimizerBenchmark.h"
+#include "GLconfig/indexFormatBenchmark.h"
+#include "GLconfig/meshSimplifierBenchmark.h"
+#include "GLconfig/meshletBenchmark.h"
+#include "GLconfig/geometryArenaBenchmark.h"
+#include "GLconfig/meshCacheBenchmark.h"
+#include "GLconfig/meshImporterBenchmark.h"
+#include "GLconfig/assetLoaderBenchmark.h"
+#include "GLconfig/textureCacheBenchmark.h"
+#include "GLconfig/shaderBenchmark.h"
+#include "GLconfig/materialBenchmark.h"
+#include "GLconfig/renderQueueBenchmark.h"
+#include "GLconfig/modelPackerBenchmark.h"
+#include "GLconfig/modelInstancingBenchmark.h"
+#include "GLconfig/vertexQuantizationBenchmark.h"
+#include "GLconfig/sceneGraph.h"
 #include "GLconfig/shader.h"
 #include "GLconfig/Texture.h"
 #include "application/model.h"
 
-// 渲染的几何体对象
-GeometryInstance* geometry = nullptr;
-// 光源对象
-GeometryInstance* lightSource = nullptr;
-// 模型对象
+// 场景图. 几何体, 光源和模型都挂在场景图的节点上
+SceneGraph* scene = nullptr;
+// 渲染的几何体节点
+SceneGraph::NodeId boxNode = SceneGraph::INVALID_NODE;
+// 光源节点挂在lightPivotNode下, 旋转父节点即可让光源绕模型公转
+SceneGraph::NodeId lightPivotNode = SceneGraph::INVALID_NODE;
+SceneGraph::NodeId lightNode = SceneGraph::INVALID_NODE;
+// 模型节点
+SceneGraph::NodeId modelNode = SceneGraph::INVALID_NODE;
+// 模型对象. 异步加载, 就绪之前在模型的位置绘制占位几何体
 Model* model = nullptr;
+Geometry* modelPlaceholder = nullptr;
+// 同一个模型的一群放置, 实例化绘制, 命令数与画一个模型相同
+std::vector<glm::mat4> flockPlacements;
+// 异步资源加载器. 工作线程解析和解码, 每帧在渲染线程中上传一部分
+GLUploadBackend* uploadBackend = nullptr;
+AssetLoader* assetLoader = nullptr;
 // 封装的着色器程序对象
 Shader* shader = nullptr;
 Shader* lightSourceShader = nullptr;
+// 渲染队列. 着色器在其中注册后的编号
+RenderQueue* renderQueue = nullptr;
+RenderQueue::ShaderId shaderId = 0;
+RenderQueue::ShaderId lightSourceShaderId = 0;
+// 这一帧所有实例化物体的模型矩阵, 执行渲染队列之前一次上传
+InstanceBuffer* frameInstances = nullptr;
 // 纹理对象
 Texture* texture = nullptr;
 
@@ -47,6 +86,32 @@ void keyCallback(const int key, const int action, int mods) {
         APP->closeWindow();
         return;
     }
+    // 按B键运行场景图, 网格生成器, 网格优化, 索引格式, 网格简化, meshlet剔除, 共享缓冲分配器, 资源加载, 纹理缓存, uniform查找, 材质, 渲染队列, 模型打包, 实例化和顶点量化的测试
+    if (key == GLFW_KEY_B && action == GLFW_PRESS) {
+        runSceneGraphBenchmarks();
+        runMeshGeneratorBenchmarks();
+        runMeshOptimizerBenchmarks();
+        runIndexFormatBenchmarks();
+        runMeshSimplifierBenchmarks();
+        runMeshletBenchmarks();
+        runGeometryArenaBenchmarks();
+        runMeshCacheBenchmarks();
+        runMeshImporterBenchmarks();
+        runAssetLoaderBenchmarks();
+        runTextureCacheBenchmarks();
+        runShaderBenchmarks();
+        runMaterialBenchmarks();
+        runRenderQueueBenchmarks();
+        runModelPackerBenchmarks();
+        runModelInstancingBenchmarks();
+        runVertexQuantizationBenchmarks();
+        return;
+    }
+    // 按P键打印上一帧渲染队列的统计
+    if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+        renderQueue->printStats();
+        return;
+    }
     currentCameraController->onKeyboard(key, action, mods);
 }
 
@@ -77,30 +142,58 @@ void prepareShader() {
         "assets/shader/lightSource/vertex.glsl",
         "assets/shader/lightSource/fragment.glsl"
     );
+    // 采样器对应的纹理单元是固定的(见Material), 只需设置一次
+    Material::setupSamplers(shader);
+    Material::setupSamplers(lightSourceShader);
+
+    renderQueue = new RenderQueue();
+    frameInstances = new InstanceBuffer();
+    shaderId = renderQueue->addShader(shader);
+    lightSourceShaderId = renderQueue->addShader(lightSourceShader);
 }
 
 // 创建几何体, 获取对应的VAO
 void prepareGeometries() {
-    // 场景几何体
+    scene = new SceneGraph();
+
+    // 场景几何体. 节点的原点就是几何体中心, 直接旋转节点就是绕自身中心旋转
     Geometry* box = Geometry::createBox(1, 1, 1, glm::vec3(1.0, 0.5, 0.31));
     box->loadTexture("assets/texture/reisen.jpg");
-    geometry = new GeometryInstance(box, -4, 0, 0);
-    // geometry->scale(3, 3, 3);
-    geometry->updateMatrix =
-        glm::translate(geometry->updateMatrix, geometry->getWorldCenter() * 1.0f) *
-        glm::rotate(geometry->updateMatrix, glm::radians(-0.1f), glm::vec3(0, 1, 0)) *
-        glm::translate(geometry->updateMatrix, geometry->getWorldCenter() * -1.0f);
-    geometry->useTexture = false;
-
-    // 光源几何体
-    Geometry* lightBox = Geometry::createSphere(1, 60, 60, glm::vec3(1, 1, 1));
-    lightSource = new GeometryInstance(lightBox, 1.2, 1, 2);
-    lightSource->scale(0.1, 0.1, 0.1);
-    lightSource->updateMatrix = glm::rotate(lightSource->updateMatrix, glm::radians(0.2f), glm::vec3(0, 1, 0));
-    lightSource->useTexture = false;
+    SceneTransform boxTransform;
+    boxTransform.position = glm::vec3(-4, 0, 0);
+    boxNode = scene->createNode(SceneGraph::ROOT, boxTransform, box);
 
-    // 加载的几何模型
-    model = new Model("D:/code/repositories/OpenGlCode/experiment/e3-model-light/assets/model/eagle/eagle.obj");
+    // 光源几何体. 相对公转中心(世界原点, 即模型所在位置)偏移
+    Geometry* lightBox = Geometry::createSphere(1, 60, 60, glm::vec3(1, 1, 1));
+    lightPivotNode = scene->createNode(SceneGraph::ROOT);
+    SceneTransform lightTransform;
+    lightTransform.position = glm::vec3(1.2, 1, 2);
+    lightTransform.scale = glm::vec3(0.1, 0.1, 0.1);
+    lightNode = scene->createNode(lightPivotNode, lightTransform, lightBox);
+
+    // 有些模型太大了缩小一点
+    SceneTransform modelTransform;
+    modelTransform.scale = glm::vec3(0.15f, 0.15f, 0.15f);
+    modelNode = scene->createNode(SceneGraph::ROOT, modelTransform);
+
+    // 加载的几何模型. 只提交请求, 第一帧不用等待解析和上传
+    uploadBackend = new GLUploadBackend();
+    assetLoader = new AssetLoader(*uploadBackend);
+    model = new Model("D:/code/repositories/OpenGlCode/experiment/e3-model-light/assets/model/eagle/eagle.obj", *assetLoader);
+    modelPlaceholder = Geometry::createSphere(5, 16, 16, glm::vec3(0.5, 0.5, 0.5));
+
+    // 模型下方一圈圈的小模型, 每圈朝向圆心
+    for (int ring = 0; ring < 8; ring++) {
+        const float radius = 6.0f + 3.0f * (float)ring;
+        const int count = 12 + 6 * ring;
+        for (int i = 0; i < count; i++) {
+            const float angle = glm::two_pi<float>() * (float)i / (float)count;
+            const glm::vec3 position(radius * glm::cos(angle), -4.0f, radius * glm::sin(angle));
+            glm::mat4 placement = glm::translate(glm::mat4(1.0f), position);
+            placement = glm::rotate(placement, -angle - glm::half_pi<float>(), glm::vec3(0, 1, 0));
+            flockPlacements.push_back(glm::scale(placement, glm::vec3(0.05f)));
+        }
+    }
 }
 
 // 摄像机状态
@@ -149,63 +242,70 @@ void render() {
     // 执行画布清理操作(用glClearColor设置的颜色来清理(填充)画布)
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    currentCameraController->update();
+    // 上传异步加载完成的资源, 每帧最多用DEFAULT_BUDGET_MS毫秒
+    assetLoader->update(AssetLoader::DEFAULT_BUDGET_MS);
+    // 上传纹理会改变纹理绑定, 材质在这一帧中重新绑定
+    Material::resetBindings();
 
-    // ==================绘制光源物体. 采用另一个着色器程序, 防止光源本身被影响==================
-    lightSourceShader->begin();
-    lightSourceShader->setInt("sampler", 0);
-    lightSourceShader->setMat4("viewMatrix", currentCamera->getViewMatrix());
-    lightSourceShader->setMat4("projectionMatrix", currentCamera->getProjectionMatrix());
+    currentCameraController->update();
 
-    const Geometry* lightSourceModel = lightSource->geometry;
-    lightSourceModel->bind();
-    lightSourceShader->setBool("useTexture", lightSource->useTexture);
-    lightSource->update();
-    lightSourceShader->setMat4("model", lightSource->getModelMatrix());
-    glDrawElements(lightSourceModel->getPrimitiveType(), lightSourceModel->getIndicesCount(), GL_UNSIGNED_INT, nullptr);
+    // 每帧的小动画: 几何体绕自身中心自转, 光源随父节点绕模型公转. 世界矩阵在读取时才重新计算
+    scene->rotate(boxNode, -0.1f, glm::vec3(0, 1, 0));
+    scene->rotate(lightPivotNode, 0.2f, glm::vec3(0, 1, 0));
 
-    // ==================绘制几何体场景==================
+    // 相机和光源是每帧的uniform, 在执行渲染队列之前设置到两个着色器上
+    const glm::mat4 viewMatrix = currentCamera->getViewMatrix();
+    const glm::mat4 projectionMatrix = currentCamera->getProjectionMatrix();
+    lightSourceShader->begin();
+    lightSourceShader->setMat4("viewMatrix", viewMatrix);
+    lightSourceShader->setMat4("projectionMatrix", projectionMatrix);
+    lightSourceShader->setBool("useTexture", false);
 
-    // 📌📌绑定当前的shaderProgram(选定一个材质)
-    // glUseProgram(shaderProgram);
     shader->begin();
-    // 通过uniform将采样器绑定到0号纹理单元上
-    // -> 让采样器知道要采样哪个纹理单元
-    shader->setInt("sampler", 0);
-    // 同时也将纹理设置给物体光照材质的采样器(光照贴图. 包含漫反射贴图和镜面反射贴图)
-    shader->setInt("material.diffuse", 0);
-    shader->setInt("material.specular", 0);
-    shader->setMat4("viewMatrix", currentCamera->getViewMatrix());
-    shader->setMat4("projectionMatrix", currentCamera->getProjectionMatrix());
-
+    shader->setMat4("viewMatrix", viewMatrix);
+    shader->setMat4("projectionMatrix", projectionMatrix);
+    shader->setBool("useTexture", false);
     // 光源属性
-    shader->setVec3("lightPosition", lightSource->getWorldCenter());
+    shader->setVec3("lightPosition", scene->getWorldPosition(lightNode));
     shader->setVec3("viewPosition", currentCamera->position);
     shader->setVec3("lightSource.ambient", 0.2f, 0.2f, 0.2f);
     shader->setVec3("lightSource.diffuse", 0.5f, 0.5f, 0.5f);
     shader->setVec3("lightSource.specular", 0.8f, 0.8f, 0.8f);
 
-    const Geometry* geometryModel = geometry->geometry;
-    // 绑定几何体对应的模型的VAO
-    geometryModel->bind();
-    shader->setBool("useTexture", geometry->useTexture);
-    geometry->update();
-    // 设置变换矩阵以及法线矩阵
-    shader->setMat4("model", geometry->getModelMatrix());
-    shader->setMat3("normalMatrix", glm::transpose(glm::inverse(glm::mat3(geometry->getModelMatrix()))));
-    // 物体材质属性
-    shader->setVec3("material.ambient", geometryModel->material.ambient);
-    shader->setVec3("material.diffuse", geometryModel->material.diffuse);
-    shader->setVec3("material.specular", geometryModel->material.specular);
-    shader->setFloat("material.shininess", geometryModel->material.shininess);
-    glDrawElements(geometryModel->getPrimitiveType(), geometryModel->getIndicesCount(), GL_UNSIGNED_INT, nullptr);
-
-    // ======绘制模型
-    auto transform = glm::mat4(1.0f);
-    transform = glm::translate(transform, glm::vec3(0.0f, 0.0f, 0.0f)); // 把模型移到世界原点
-    transform = glm::scale(transform, glm::vec3(0.15f, 0.15f, 0.15f));	// 有些模型太大了缩小一点
-    shader->setMat4("model", transform);
-    model->draw(shader);
+    // ==================提交绘制包. 只记录, 排序之后统一执行==================
+    renderQueue->begin(viewMatrix, perspectiveCamera->near, perspectiveCamera->far);
+    frameInstances->clear();
+    // 按屏幕尺寸选择LOD, 远处的物体画更少的三角形
+    const auto viewportHeight = (float)APP->getHeight();
+
+    // 光源物体采用另一个着色器程序, 防止光源本身被影响
+    const Geometry* lightSourceModel = scene->getGeometry(lightNode);
+    const glm::mat4& lightMatrix = scene->getWorldMatrix(lightNode);
+    lightSourceModel->submit(*renderQueue, lightSourceShaderId, lightMatrix,
+                             lightSourceModel->selectLod(lightMatrix, viewMatrix, projectionMatrix, viewportHeight));
+
+    // 几何体使用紧凑顶点格式: 颜色来自uniform, 法线为八面体编码, uv需要乘回缩放
+    const Geometry* geometryModel = scene->getGeometry(boxNode);
+    const glm::mat4& boxMatrix = scene->getWorldMatrix(boxNode);
+    geometryModel->submit(*renderQueue, shaderId, boxMatrix,
+                          geometryModel->selectLod(boxMatrix, viewMatrix, projectionMatrix, viewportHeight));
+
+    const glm::mat4& modelMatrix = scene->getWorldMatrix(modelNode);
+    if (model->isReady()) {
+        model->submit(*renderQueue, shaderId, *frameInstances, modelMatrix, viewMatrix, projectionMatrix, viewportHeight);
+        model->submitInstanced(*renderQueue, shaderId, *frameInstances, flockPlacements.data(),
+                               (uint32_t)flockPlacements.size(), viewMatrix, projectionMatrix, viewportHeight);
+    } else {
+        // 模型还在加载, 画一个同样使用紧凑顶点格式的占位球体
+        modelPlaceholder->submit(*renderQueue, shaderId, modelMatrix,
+                                 modelPlaceholder->selectLod(modelMatrix, viewMatrix, projectionMatrix, viewportHeight));
+    }
+
+    // 模型的实例矩阵一次上传, 挂到模型网格的VAO上
+    frameInstances->upload(Mesh::getArena()->getVAO());
+    // 按着色器, 材质, VAO和深度排序, 跳过重复的状态切换
+    renderQueue->sort();
+    renderQueue->execute();
 
     Shader::end();
 }